@@ -0,0 +1,923 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// Open addressing hash table shared by unordered_map and unordered_set.
+//
+// Layout follows SwissTable: one control byte per slot holds either a state
+// (empty, deleted, sentinel) or the low 7 bits of the element's hash. Lookups
+// scan a group of control bytes at once (16 with SSE2, 8 with NEON or the
+// portable 64-bit fallback) and compare keys only on a control byte match.
+//
+// Define NANOSTL_HASH_TABLE_PORTABLE to force the scalar group. CUDA builds
+// always use it.
+//
+#ifndef NANOSTL___HASH_TABLE_H_
+#define NANOSTL___HASH_TABLE_H_
+
+// Intrinsic headers must come before nanostl headers(__nullptr defines a
+// `nullptr` macro).
+#if !defined(NANOSTL_HASH_TABLE_PORTABLE) && !defined(__CUDACC__)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NANOSTL_HASH_TABLE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && !defined(NANOSTL_BIG_ENDIAN)
+#define NANOSTL_HASH_TABLE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#include "__bits.h"
+#include "nanoallocator.h"
+#include "nanocommon.h"
+#include "nanocstdint.h"
+#include "nanofunctional.h"
+#include "nanotype_traits.h"
+#include "nanoutility.h"
+
+namespace nanostl {
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+typedef signed char __ctrl_t;
+
+enum {
+  __kCtrlEmpty = -128,   // 0b10000000
+  __kCtrlDeleted = -2,   // 0b11111110
+  __kCtrlSentinel = -1,  // 0b11111111
+};
+
+// Scramble a user hash so that both the probe start(upper bits) and the
+// 7-bit control tag(lower bits) depend on every input bit. A weak user
+// hasher(e.g. the identity on small integers) would otherwise collide on
+// either one. nanostl's own hashers already mix(`__is_avalanching`) and
+// skip this.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __hash_table_mix(size_t h) {
+  uint64_t x = static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull;
+  return static_cast<size_t>(x ^ (x >> 32));
+}
+
+template <class H, class = void>
+struct __hash_is_avalanching : public false_type {};
+
+template <class H>
+struct __hash_is_avalanching<
+    H, typename __void_t<typename H::__is_avalanching>::type>
+    : public true_type {};
+
+// Set of slot positions within a group. `Shift` is 0 when each slot maps to
+// one bit(SSE2 movemask) and 3 when it maps to the high bit of one byte.
+template <class T, int SignificantBits, int Shift>
+class __hash_bitmask {
+ public:
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit __hash_bitmask(T mask) : mask_(mask) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __hash_bitmask& operator++() {
+    mask_ &= (mask_ - 1);
+    return *this;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int operator*() const { return lowest_bit_set(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit operator bool() const { return mask_ != 0; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int lowest_bit_set() const { return __ctz64(mask_) >> Shift; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int trailing_zeros() const { return __ctz64(mask_) >> Shift; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int leading_zeros() const {
+    return __clz64(static_cast<uint64_t>(mask_)
+                        << (64 - (SignificantBits << Shift))) >>
+           Shift;
+  }
+
+ private:
+  T mask_;
+};
+
+#if defined(NANOSTL_HASH_TABLE_SSE2)
+
+struct __hash_group {
+  enum { kWidth = 16 };
+  typedef __hash_bitmask<uint32_t, kWidth, 0> bitmask;
+
+  explicit __hash_group(const __ctrl_t* pos) {
+    ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+  }
+
+  bitmask match(__ctrl_t h2) const {
+    return bitmask(static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+  }
+
+  bitmask match_empty() const { return match(__ctrl_t(__kCtrlEmpty)); }
+
+  bitmask match_empty_or_deleted() const {
+    __m128i special = _mm_set1_epi8(__ctrl_t(__kCtrlSentinel));
+    return bitmask(static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(special, ctrl))));
+  }
+
+  int count_leading_empty_or_deleted() const {
+    __m128i special = _mm_set1_epi8(__ctrl_t(__kCtrlSentinel));
+    return __ctz64(static_cast<uint32_t>(
+                            _mm_movemask_epi8(_mm_cmpgt_epi8(special, ctrl))) +
+                        1);
+  }
+
+  __m128i ctrl;
+};
+
+#elif defined(NANOSTL_HASH_TABLE_NEON)
+
+struct __hash_group {
+  enum { kWidth = 8 };
+  typedef __hash_bitmask<uint64_t, kWidth, 3> bitmask;
+
+  explicit __hash_group(const __ctrl_t* pos) {
+    ctrl = vld1_u8(reinterpret_cast<const unsigned char*>(pos));
+  }
+
+  bitmask match(__ctrl_t h2) const {
+    uint8x8_t eq = vceq_u8(vdup_n_u8(static_cast<unsigned char>(h2)), ctrl);
+    return bitmask(vget_lane_u64(vreinterpret_u64_u8(eq), 0) &
+                   0x8080808080808080ull);
+  }
+
+  bitmask match_empty() const { return match(__ctrl_t(__kCtrlEmpty)); }
+
+  bitmask match_empty_or_deleted() const {
+    return bitmask(__empty_or_deleted() & 0x8080808080808080ull);
+  }
+
+  int count_leading_empty_or_deleted() const {
+    uint64_t m = __empty_or_deleted();
+    return (m == ~0ull) ? kWidth : (__ctz64(~m) >> 3);
+  }
+
+  uint64_t __empty_or_deleted() const {
+    uint8x8_t lt = vclt_s8(vreinterpret_s8_u8(ctrl),
+                           vdup_n_s8(__ctrl_t(__kCtrlSentinel)));
+    return vget_lane_u64(vreinterpret_u64_u8(lt), 0);
+  }
+
+  uint8x8_t ctrl;
+};
+
+#else
+
+// Portable SWAR group over 8 control bytes. Also used for device code.
+struct __hash_group {
+  enum { kWidth = 8 };
+  typedef __hash_bitmask<uint64_t, kWidth, 3> bitmask;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit __hash_group(const __ctrl_t* pos) {
+    // Assemble in little-endian order regardless of the host; compilers
+    // fold this into a single load.
+    ctrl = 0;
+    for (int i = 0; i < kWidth; i++) {
+      ctrl |= static_cast<uint64_t>(static_cast<unsigned char>(pos[i]))
+              << (8 * i);
+    }
+  }
+
+  // May report a false positive for a full slot next to a real match; the
+  // caller compares keys anyway.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bitmask match(__ctrl_t h2) const {
+    const uint64_t lsbs = 0x0101010101010101ull;
+    const uint64_t msbs = 0x8080808080808080ull;
+    uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+    return bitmask((x - lsbs) & ~x & msbs);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bitmask match_empty() const {
+    return bitmask((ctrl & (~ctrl << 6)) & 0x8080808080808080ull);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bitmask match_empty_or_deleted() const {
+    return bitmask((ctrl & (~ctrl << 7)) & 0x8080808080808080ull);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int count_leading_empty_or_deleted() const {
+    const uint64_t gaps = 0x00FEFEFEFEFEFEFEull;
+    return (__ctz64(((~ctrl & (ctrl >> 7)) | gaps) + 1) + 7) >> 3;
+  }
+
+  uint64_t ctrl;
+};
+
+#endif
+
+template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+struct __hash_map_params {
+  typedef Key key_type;
+  typedef nanostl::pair<const Key, T> value_type;
+  typedef value_type& reference;
+  typedef value_type* pointer;
+  typedef Hash hasher;
+  typedef KeyEqual key_equal;
+  typedef Allocator allocator_type;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static const Key& key(const value_type& v) { return v.first; }
+};
+
+template <class Key, class Hash, class KeyEqual, class Allocator>
+struct __hash_set_params {
+  typedef Key key_type;
+  typedef Key value_type;
+  typedef const Key& reference;
+  typedef const Key* pointer;
+  typedef Hash hasher;
+  typedef KeyEqual key_equal;
+  typedef Allocator allocator_type;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static const Key& key(const value_type& v) { return v; }
+};
+
+template <class Params>
+class __raw_hash_table {
+ public:
+  typedef typename Params::key_type key_type;
+  typedef typename Params::value_type value_type;
+  typedef typename Params::reference reference;
+  typedef const value_type& const_reference;
+  typedef typename Params::pointer pointer;
+  typedef const value_type* const_pointer;
+  typedef typename Params::hasher hasher;
+  typedef typename Params::key_equal key_equal;
+  typedef typename Params::allocator_type allocator_type;
+  typedef nanostl::size_type size_type;
+
+ private:
+  typedef __hash_group group;
+  typedef typename nanostl::allocator_traits<allocator_type>::
+      template rebind_alloc<__ctrl_t>::other ctrl_allocator_type;
+  typedef typename nanostl::allocator_traits<allocator_type>::
+      template rebind_alloc<value_type>::other slot_allocator_type;
+
+ public:
+  class const_iterator;
+
+  class iterator {
+    friend class __raw_hash_table;
+    friend class const_iterator;
+
+    const __ctrl_t* ctrl;
+    value_type* slot;
+
+    // Advance to the next full slot, or to end() at the sentinel.
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    void __skip_empty_or_deleted() {
+      while (*ctrl < __kCtrlSentinel) {
+        int shift = group(ctrl).count_leading_empty_or_deleted();
+        ctrl += shift;
+        slot += shift;
+      }
+      if (*ctrl == __kCtrlSentinel) {
+        ctrl = 0;
+        slot = 0;
+      }
+    }
+
+   public:
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator(const __ctrl_t* _ctrl = 0, value_type* _slot = 0)
+        : ctrl(_ctrl), slot(_slot) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator& operator++() {
+      ++ctrl;
+      ++slot;
+      __skip_empty_or_deleted();
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator operator++(int) {
+      iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    reference operator*() const { return *slot; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    pointer operator->() const { return slot; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator==(const iterator& rhs) const { return ctrl == rhs.ctrl; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator!=(const iterator& rhs) const { return ctrl != rhs.ctrl; }
+  };
+
+  class const_iterator {
+    friend class __raw_hash_table;
+
+    iterator it;
+
+   public:
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator() {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator(const iterator& _it) : it(_it) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator& operator++() {
+      ++it;
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      ++it;
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_reference operator*() const { return *it.slot; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_pointer operator->() const { return it.slot; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator==(const const_iterator& rhs) const { return it == rhs.it; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator!=(const const_iterator& rhs) const { return it != rhs.it; }
+  };
+
+  typedef pair<iterator, bool> pair_iterator_bool;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit __raw_hash_table(size_type bucket_count = 0,
+                            const hasher& hash = hasher(),
+                            const key_equal& eq = key_equal(),
+                            const allocator_type& alloc = allocator_type())
+      : ctrl_(0),
+        slots_(0),
+        size_(0),
+        capacity_(0),
+        growth_left_(0),
+        max_load_factor_(0.875f),
+        hash_(hash),
+        eq_(eq),
+        alloc_(alloc) {
+    if (bucket_count) {
+      __resize(__normalize_capacity(bucket_count));
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __raw_hash_table(const __raw_hash_table& rhs)
+      : ctrl_(0),
+        slots_(0),
+        size_(0),
+        capacity_(0),
+        growth_left_(0),
+        max_load_factor_(rhs.max_load_factor_),
+        hash_(rhs.hash_),
+        eq_(rhs.eq_),
+        alloc_(rhs.alloc_) {
+    __copy_from(rhs);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __raw_hash_table(__raw_hash_table&& rhs)
+      : ctrl_(rhs.ctrl_),
+        slots_(rhs.slots_),
+        size_(rhs.size_),
+        capacity_(rhs.capacity_),
+        growth_left_(rhs.growth_left_),
+        max_load_factor_(rhs.max_load_factor_),
+        hash_(rhs.hash_),
+        eq_(rhs.eq_),
+        alloc_(rhs.alloc_) {
+    rhs.ctrl_ = 0;
+    rhs.slots_ = 0;
+    rhs.size_ = 0;
+    rhs.capacity_ = 0;
+    rhs.growth_left_ = 0;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  ~__raw_hash_table() { __destroy_and_deallocate(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __raw_hash_table& operator=(const __raw_hash_table& rhs) {
+    if (this != &rhs) {
+      clear();
+      max_load_factor_ = rhs.max_load_factor_;
+      hash_ = rhs.hash_;
+      eq_ = rhs.eq_;
+      __copy_from(rhs);
+    }
+    return *this;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __raw_hash_table& operator=(__raw_hash_table&& rhs) {
+    if (this != &rhs) {
+      __raw_hash_table tmp(nanostl::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void swap(__raw_hash_table& rhs) {
+    __swap(ctrl_, rhs.ctrl_);
+    __swap(slots_, rhs.slots_);
+    __swap(size_, rhs.size_);
+    __swap(capacity_, rhs.capacity_);
+    __swap(growth_left_, rhs.growth_left_);
+    __swap(max_load_factor_, rhs.max_load_factor_);
+    __swap(hash_, rhs.hash_);
+    __swap(eq_, rhs.eq_);
+    __swap(alloc_, rhs.alloc_);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  allocator_type get_allocator() const { return alloc_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  hasher hash_function() const { return hash_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  key_equal key_eq() const { return eq_; }
+
+  // iterators:
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator begin() {
+    if (!size_) return end();
+    iterator it(ctrl_, slots_);
+    it.__skip_empty_or_deleted();
+    return it;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator begin() const {
+    return const_cast<__raw_hash_table*>(this)->begin();
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator end() { return iterator(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator end() const { return iterator(); }
+
+  // capacity:
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool empty() const { return size_ == 0; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type size() const { return size_; }
+
+  // Number of slots. Always 2^k - 1(or 0).
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type bucket_count() const { return capacity_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  float load_factor() const {
+    return capacity_ ? float(size_) / float(capacity_) : 0.0f;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  float max_load_factor() const { return max_load_factor_; }
+
+  // Clamped to [0.125, 0.9375]; at least one slot stays empty so that
+  // probing always terminates.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void max_load_factor(float ml) {
+    if (ml < 0.125f) ml = 0.125f;
+    if (ml > 0.9375f) ml = 0.9375f;
+    max_load_factor_ = ml;
+    if (capacity_) {
+      __resize(__capacity_for(size_));
+    }
+  }
+
+  // Make room for `n` elements without rehashing.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void reserve(size_type n) {
+    if (n > size_ + growth_left_) {
+      __resize(__capacity_for(n));
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void rehash(size_type n) {
+    size_type cap = __capacity_for(size_);
+    if (n > cap) cap = __normalize_capacity(n);
+    if (cap != capacity_) {
+      __resize(cap);
+    }
+  }
+
+  // modifiers:
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void clear() {
+    __destroy_slots();
+    size_ = 0;
+    if (capacity_) {
+      __reset_ctrl();
+      growth_left_ = __growth(capacity_);
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  pair_iterator_bool insert(const value_type& x) {
+    pair<size_type, bool> r = __find_or_prepare_insert(Params::key(x));
+    if (r.second) {
+      ::new (__placement_tag(), slots_ + r.first) value_type(x);
+    }
+    return make_pair(__iterator_at(r.first), r.second);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  pair_iterator_bool insert(value_type&& x) {
+    pair<size_type, bool> r = __find_or_prepare_insert(Params::key(x));
+    if (r.second) {
+      ::new (__placement_tag(), slots_ + r.first) value_type(nanostl::move(x));
+    }
+    return make_pair(__iterator_at(r.first), r.second);
+  }
+
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL void insert(InputIterator first,
+                                           InputIterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  // Elements never move on erase, so only `pos` is invalidated.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(const_iterator pos) {
+    iterator next = pos.it;
+    ++next;
+    __erase_at(size_type(pos.it.ctrl - ctrl_));
+    return next;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type erase(const key_type& key) {
+    size_type i = __find_index(key);
+    if (i == __npos()) return 0;
+    __erase_at(i);
+    return 1;
+  }
+
+  // lookup:
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator find(const key_type& key) { return __iterator_at(__find_index(key)); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator find(const key_type& key) const {
+    return const_cast<__raw_hash_table*>(this)->find(key);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type count(const key_type& key) const {
+    return (__find_index(key) == __npos()) ? 0 : 1;
+  }
+
+  // Heterogeneous lookup, enabled when both hasher and key_equal declare
+  // `is_transparent`.
+  template <class K, class H = hasher, class E = key_equal,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  NANOSTL_HOST_AND_DEVICE_QUAL iterator find(const K& key) {
+    return __iterator_at(__find_index(key));
+  }
+
+  template <class K, class H = hasher, class E = key_equal,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  NANOSTL_HOST_AND_DEVICE_QUAL const_iterator find(const K& key) const {
+    return const_cast<__raw_hash_table*>(this)->__iterator_at(
+        __find_index(key));
+  }
+
+  template <class K, class H = hasher, class E = key_equal,
+            class = typename H::is_transparent,
+            class = typename E::is_transparent>
+  NANOSTL_HOST_AND_DEVICE_QUAL size_type count(const K& key) const {
+    return (__find_index(key) == __npos()) ? 0 : 1;
+  }
+
+ protected:
+  // Index of the slot holding `key`. If there is none, claims a slot for it
+  // (growing if needed) and returns {index, true}; the caller constructs the
+  // element there.
+  template <class K>
+  NANOSTL_HOST_AND_DEVICE_QUAL pair<size_type, bool> __find_or_prepare_insert(
+      const K& key) {
+    size_t h = __hash(key);
+    if (capacity_) {
+      size_type i = __find_index(key, h);
+      if (i != __npos()) return make_pair(i, false);
+    }
+
+    size_type target = capacity_ ? __find_first_non_full(h) : 0;
+    if ((growth_left_ == 0) &&
+        (!capacity_ || (ctrl_[target] != __kCtrlDeleted))) {
+      __rehash_and_grow();
+      target = __find_first_non_full(h);
+    }
+
+    size_++;
+    growth_left_ -= (ctrl_[target] == __kCtrlEmpty) ? 1 : 0;
+    __set_ctrl(target, __h2(h));
+    return make_pair(target, true);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator __iterator_at(size_type i) {
+    if (i == __npos()) return end();
+    return iterator(ctrl_ + i, slots_ + i);
+  }
+
+ private:
+  __ctrl_t* ctrl_;  // capacity_ + group::kWidth bytes
+  value_type* slots_;
+  size_type size_;
+  size_type capacity_;
+  size_type growth_left_;  // inserts left before a rehash
+  float max_load_factor_;
+  hasher hash_;
+  key_equal eq_;
+  allocator_type alloc_;
+
+  template <class Ty>
+  NANOSTL_HOST_AND_DEVICE_QUAL static void __swap(Ty& x, Ty& y) {
+    Ty c(x);
+    x = y;
+    y = c;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type __npos() { return ~size_type(0); }
+
+  template <class K>
+  NANOSTL_HOST_AND_DEVICE_QUAL size_t __hash(const K& key) const {
+    return __hash_finish(hash_(key), __hash_is_avalanching<hasher>());
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t __hash_finish(size_t h, true_type) { return h; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t __hash_finish(size_t h, false_type) {
+    return __hash_table_mix(h);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t __h1(size_t h) { return h >> 7; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static __ctrl_t __h2(size_t h) { return __ctrl_t(h & 0x7f); }
+
+  // Smallest 2^k - 1 that is >= n.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type __normalize_capacity(size_type n) {
+    size_type cap = 1;
+    while (cap < n) {
+      cap = cap * 2 + 1;
+    }
+    return cap;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __growth(size_type cap) const {
+    size_type g = size_type(float(cap) * max_load_factor_);
+    // Tables smaller than a group see cloned empty bytes in every probe
+    // window and may fill up; larger ones need one real empty slot.
+    if ((cap >= size_type(group::kWidth - 1)) && (g >= cap)) g = cap - 1;
+    if (g == 0) g = 1;
+    return g;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __capacity_for(size_type n) const {
+    size_type cap = __normalize_capacity(size_type(float(n) / max_load_factor_));
+    while (__growth(cap) < n) {
+      cap = cap * 2 + 1;
+    }
+    return cap;
+  }
+
+  // Keep the first kWidth - 1 control bytes mirrored after the sentinel so
+  // a group load starting near the end wraps around.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_ctrl(size_type i, __ctrl_t h) {
+    const size_type cloned = size_type(group::kWidth - 1);
+    ctrl_[i] = h;
+    ctrl_[((i - cloned) & capacity_) + (cloned & capacity_)] = h;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __reset_ctrl() {
+    for (size_type i = 0; i < capacity_ + size_type(group::kWidth); i++) {
+      ctrl_[i] = __ctrl_t(__kCtrlEmpty);
+    }
+    ctrl_[capacity_] = __ctrl_t(__kCtrlSentinel);
+  }
+
+  template <class K>
+  NANOSTL_HOST_AND_DEVICE_QUAL size_type __find_index(const K& key) const {
+    if (!capacity_) return __npos();
+    return __find_index(key, __hash(key));
+  }
+
+  // Triangular probing over groups; visits every group once when the
+  // number of slots is a power of two.
+  template <class K>
+  NANOSTL_HOST_AND_DEVICE_QUAL size_type __find_index(const K& key,
+                                                      size_t h) const {
+    const __ctrl_t h2 = __h2(h);
+    size_type offset = __h1(h) & capacity_;
+    size_type index = 0;
+    for (;;) {
+      group g(ctrl_ + offset);
+      for (typename group::bitmask m = g.match(h2); m; ++m) {
+        size_type i = (offset + size_type(*m)) & capacity_;
+        if (eq_(Params::key(slots_[i]), key)) return i;
+      }
+      if (g.match_empty()) return __npos();
+      index += size_type(group::kWidth);
+      offset = (offset + index) & capacity_;
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __find_first_non_full(size_t h) const {
+    size_type offset = __h1(h) & capacity_;
+    size_type index = 0;
+    for (;;) {
+      typename group::bitmask m = group(ctrl_ + offset).match_empty_or_deleted();
+      if (m) return (offset + size_type(m.lowest_bit_set())) & capacity_;
+      index += size_type(group::kWidth);
+      offset = (offset + index) & capacity_;
+    }
+  }
+
+  // If no probe window around `i` was ever completely full, no lookup
+  // could have continued past it, and the slot can go straight back to
+  // empty instead of becoming a tombstone.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __erase_at(size_type i) {
+    slots_[i].~value_type();
+    size_--;
+
+    size_type before = (i - size_type(group::kWidth)) & capacity_;
+    typename group::bitmask empty_after = group(ctrl_ + i).match_empty();
+    typename group::bitmask empty_before = group(ctrl_ + before).match_empty();
+    bool was_never_full = empty_before && empty_after &&
+                          ((empty_after.trailing_zeros() +
+                            empty_before.leading_zeros()) < group::kWidth);
+
+    __set_ctrl(i, was_never_full ? __ctrl_t(__kCtrlEmpty)
+                                 : __ctrl_t(__kCtrlDeleted));
+    growth_left_ += was_never_full ? 1 : 0;
+  }
+
+  // Out of growth: drop tombstones in place when they make up most of the
+  // load, otherwise at least double the table.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __rehash_and_grow() {
+    if (capacity_ && (size_ * 2 <= __growth(capacity_))) {
+      __resize(capacity_);
+    } else {
+      size_type cap = __capacity_for(size_ + 1);
+      if (cap < capacity_ * 2 + 1) cap = capacity_ * 2 + 1;
+      __resize(cap);
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __resize(size_type new_capacity) {
+    __ctrl_t* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    size_type old_capacity = capacity_;
+
+    ctrl_allocator_type ca(alloc_);
+    slot_allocator_type sa(alloc_);
+    ctrl_ = nanostl::allocator_traits<ctrl_allocator_type>::allocate(
+        ca, new_capacity + size_type(group::kWidth));
+    slots_ =
+        nanostl::allocator_traits<slot_allocator_type>::allocate(sa, new_capacity);
+    capacity_ = new_capacity;
+    __reset_ctrl();
+    growth_left_ = __growth(new_capacity) - size_;
+
+    for (size_type i = 0; i < old_capacity; i++) {
+      if (old_ctrl[i] >= 0) {
+        size_t h = __hash(Params::key(old_slots[i]));
+        size_type target = __find_first_non_full(h);
+        __set_ctrl(target, __h2(h));
+        ::new (__placement_tag(), slots_ + target)
+            value_type(nanostl::move(old_slots[i]));
+        old_slots[i].~value_type();
+      }
+    }
+
+    if (old_ctrl) {
+      nanostl::allocator_traits<ctrl_allocator_type>::deallocate(
+          ca, old_ctrl, old_capacity + size_type(group::kWidth));
+      nanostl::allocator_traits<slot_allocator_type>::deallocate(
+          sa, old_slots, old_capacity);
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __copy_from(const __raw_hash_table& rhs) {
+    reserve(rhs.size_);
+    for (const_iterator it = rhs.begin(); it != rhs.end(); ++it) {
+      insert(*it);
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __destroy_slots() {
+    if (is_trivially_destructible<value_type>::value) return;
+    for (size_type i = 0; i < capacity_; i++) {
+      if (ctrl_[i] >= 0) {
+        slots_[i].~value_type();
+      }
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __destroy_and_deallocate() {
+    if (!ctrl_) return;
+    __destroy_slots();
+
+    ctrl_allocator_type ca(alloc_);
+    slot_allocator_type sa(alloc_);
+    nanostl::allocator_traits<ctrl_allocator_type>::deallocate(
+        ca, ctrl_, capacity_ + size_type(group::kWidth));
+    nanostl::allocator_traits<slot_allocator_type>::deallocate(sa, slots_,
+                                                               capacity_);
+  }
+};
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+}  // namespace nanostl
+
+#endif  // NANOSTL___HASH_TABLE_H_
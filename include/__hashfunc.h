@@ -1,5 +1,10 @@
 //
-// We use SipHash for std::hash
+// Hash primitives for std::hash.
+//
+// The default byte hash is a wyhash-style function: fast on short keys and
+// good enough for hash tables. Define NANOSTL_HASH_USE_SIPHASH to route byte
+// hashing through SipHash-2-4 instead(DoS resistant when keyed with a secret
+// via siphash_key(); requires linking src/hash.cc).
 //
 #ifndef NANOSTL___HASHFUNC_H_
 #define NANOSTL___HASHFUNC_H_
@@ -13,6 +18,149 @@ namespace nanostl {
 int siphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
             uint8_t *out, const size_t outlen);
 
+#if defined(NANOSTL_HASH_USE_SIPHASH)
+// 128-bit SipHash key. Fill with random bytes at startup, before any hash
+// is computed.
+inline uint8_t *siphash_key() {
+  static uint8_t key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                            0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+  return key;
+}
+#endif
+
+// 64x64 -> 128 bit multiply. `a` receives the low half, `b` the high half.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void __wymum(uint64_t *a, uint64_t *b) {
+#if defined(__CUDA_ARCH__)
+  uint64_t lo = (*a) * (*b);
+  uint64_t hi = __umul64hi(*a, *b);
+  *a = lo;
+  *b = hi;
+#elif defined(__SIZEOF_INT128__)
+  __uint128_t r = *a;
+  r *= *b;
+  *a = uint64_t(r);
+  *b = uint64_t(r >> 64);
+#else
+  uint64_t ha = (*a) >> 32, hb = (*b) >> 32, la = uint32_t(*a),
+           lb = uint32_t(*b);
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = (t < rl) ? 1 : 0;
+  uint64_t lo = t + (rm1 << 32);
+  c += (lo < t) ? 1 : 0;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+// Multiply and fold the 128-bit product to 64 bits.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __wymix(uint64_t a, uint64_t b) {
+  __wymum(&a, &b);
+  return a ^ b;
+}
+
+// Little-endian loads, independent of host byte order. Compilers fold the
+// byte assembly into a single load on little-endian targets.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __wyr8(const uint8_t *p) {
+  return uint64_t(p[0]) | (uint64_t(p[1]) << 8) | (uint64_t(p[2]) << 16) |
+         (uint64_t(p[3]) << 24) | (uint64_t(p[4]) << 32) |
+         (uint64_t(p[5]) << 40) | (uint64_t(p[6]) << 48) |
+         (uint64_t(p[7]) << 56);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __wyr4(const uint8_t *p) {
+  return uint64_t(p[0]) | (uint64_t(p[1]) << 8) | (uint64_t(p[2]) << 16) |
+         (uint64_t(p[3]) << 24);
+}
+
+// 1 to 3 bytes.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __wyr3(const uint8_t *p, size_t k) {
+  return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+// Based on wyhash(final version 4) by Wang Yi, released into the public
+// domain.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __wyhash(const void *key, size_t len, uint64_t seed) {
+  const uint64_t s0 = 0x2d358dccaa6c78a5ull;
+  const uint64_t s1 = 0x8bb84b93962eacc9ull;
+  const uint64_t s2 = 0x4b33a62ed433d4a3ull;
+  const uint64_t s3 = 0x4d5a2da51de1aa47ull;
+
+  const uint8_t *p = static_cast<const uint8_t *>(key);
+  seed ^= __wymix(seed ^ s0, s1);
+
+  uint64_t a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (__wyr4(p) << 32) | __wyr4(p + ((len >> 3) << 2));
+      b = (__wyr4(p + len - 4) << 32) |
+          __wyr4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = __wyr3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = __wymix(__wyr8(p) ^ s1, __wyr8(p + 8) ^ seed);
+        see1 = __wymix(__wyr8(p + 16) ^ s2, __wyr8(p + 24) ^ see1);
+        see2 = __wymix(__wyr8(p + 32) ^ s3, __wyr8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = __wymix(__wyr8(p) ^ s1, __wyr8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = __wyr8(p + i - 16);
+    b = __wyr8(p + i - 8);
+  }
+
+  a ^= s1;
+  b ^= seed;
+  __wymum(&a, &b);
+  return __wymix(a ^ s0 ^ len, b ^ s1);
+}
+
+// Finalizer of MurmurHash3(public domain). Bijective, so distinct integers
+// never collide, and every input bit affects every output bit.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __hash_mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+// Byte hash used by hash<string>.
+#if defined(NANOSTL_HASH_USE_SIPHASH)
+inline size_t __hash_bytes(const void *p, size_t len) {
+  uint64_t out;
+  siphash(static_cast<const uint8_t *>(p), len, siphash_key(),
+          reinterpret_cast<uint8_t *>(&out), 8);
+  return size_t(out);
+}
+#else
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __hash_bytes(const void *p, size_t len) {
+  return size_t(__wyhash(p, len, 0));
+}
+#endif
 
 } // namespace nanostl
 
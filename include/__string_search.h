@@ -0,0 +1,425 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+//
+// Byte search primitives for string_view and basic_string<char>.
+//
+// Host builds scan 16 bytes at a time with SSE2 or NEON, falling back to
+// 8 bytes at a time in a 64-bit word(SWAR) elsewhere and for short inputs.
+// CUDA device code uses plain loops.
+//
+// Define NANOSTL_STRING_SEARCH_PORTABLE to disable the SSE2/NEON paths.
+//
+#ifndef NANOSTL___STRING_SEARCH_H_
+#define NANOSTL___STRING_SEARCH_H_
+
+// Intrinsic headers must come before nanostl headers(__nullptr defines a
+// `nullptr` macro).
+#if !defined(NANOSTL_STRING_SEARCH_PORTABLE) && !defined(__CUDACC__)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NANOSTL_STRING_SEARCH_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && !defined(NANOSTL_BIG_ENDIAN)
+#define NANOSTL_STRING_SEARCH_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#include "__bits.h"
+#include "nanocommon.h"
+#include "nanocstdint.h"
+
+namespace nanostl {
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+// "Not found" for the functions below.
+static const size_t __search_npos = ~size_t(0);
+
+// 8 bytes in memory order: byte i lands in bits [8i, 8i + 8) regardless of
+// host endianness.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __search_load64(const unsigned char *p) {
+  return uint64_t(p[0]) | (uint64_t(p[1]) << 8) | (uint64_t(p[2]) << 16) |
+         (uint64_t(p[3]) << 24) | (uint64_t(p[4]) << 32) |
+         (uint64_t(p[5]) << 40) | (uint64_t(p[6]) << 48) |
+         (uint64_t(p[7]) << 56);
+}
+
+// High bit set in exactly the zero bytes of `x`(no false positives, unlike
+// the shorter `(x - 0x01..) & ~x & 0x80..` form, so it can be scanned from
+// either end).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __search_zero_bytes(uint64_t x) {
+  const uint64_t lo7 = 0x7f7f7f7f7f7f7f7full;
+  uint64_t y = (x & lo7) + lo7;
+  return ~(y | x | lo7);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline uint64_t __search_splat(unsigned char c) {
+  return 0x0101010101010101ull * c;
+}
+
+#if defined(NANOSTL_STRING_SEARCH_SSE2)
+
+// 16 byte block. mask() has one bit per byte.
+struct __search_block {
+  typedef __m128i vec;
+  enum { kShift = 0 };
+  static const uint64_t kFull = 0xffffull;
+
+  static vec splat(unsigned char c) { return _mm_set1_epi8(char(c)); }
+  static vec load(const unsigned char *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+  static void store(unsigned char *p, vec v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+  static vec eq(vec a, vec b) { return _mm_cmpeq_epi8(a, b); }
+  static vec vand(vec a, vec b) { return _mm_and_si128(a, b); }
+  static vec vor(vec a, vec b) { return _mm_or_si128(a, b); }
+  static uint64_t mask(vec v) {
+    return static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(v)));
+  }
+};
+
+#define NANOSTL_STRING_SEARCH_BLOCK
+
+#elif defined(NANOSTL_STRING_SEARCH_NEON)
+
+// 16 byte block. mask() has four bits per byte(shift-right-narrow of the
+// compare result).
+struct __search_block {
+  typedef uint8x16_t vec;
+  enum { kShift = 2 };
+  static const uint64_t kFull = ~0ull;
+
+  static vec splat(unsigned char c) { return vdupq_n_u8(c); }
+  static vec load(const unsigned char *p) { return vld1q_u8(p); }
+  static void store(unsigned char *p, vec v) { vst1q_u8(p, v); }
+  static vec eq(vec a, vec b) { return vceqq_u8(a, b); }
+  static vec vand(vec a, vec b) { return vandq_u8(a, b); }
+  static vec vor(vec a, vec b) { return vorrq_u8(a, b); }
+  static uint64_t mask(vec v) {
+    uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(n), 0);
+  }
+};
+
+#define NANOSTL_STRING_SEARCH_BLOCK
+
+#endif
+
+// Index of the first `c` in p[0, n).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __search_memchr(const unsigned char *p, size_t n,
+                              unsigned char c) {
+  size_t i = 0;
+#if !defined(__CUDA_ARCH__)
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  if (n >= 16) {
+    B::vec v = B::splat(c);
+    for (; i + 16 <= n; i += 16) {
+      uint64_t m = B::mask(B::eq(B::load(p + i), v));
+      if (m) {
+        return i + size_t(__ctz64(m) >> B::kShift);
+      }
+    }
+    if (i < n) {
+      // Last partial block: reload the final 16 bytes and drop the ones
+      // already checked.
+      size_t j = n - 16;
+      uint64_t m = B::mask(B::eq(B::load(p + j), v)) >> ((i - j) << B::kShift);
+      if (m) {
+        return i + size_t(__ctz64(m) >> B::kShift);
+      }
+    }
+    return __search_npos;
+  }
+#endif
+  const uint64_t vc = __search_splat(c);
+  for (; i + 8 <= n; i += 8) {
+    uint64_t z = __search_zero_bytes(__search_load64(p + i) ^ vc);
+    if (z) {
+      return i + size_t(__ctz64(z) >> 3);
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (p[i] == c) {
+      return i;
+    }
+  }
+  return __search_npos;
+}
+
+// Index of the last `c` in p[0, n).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __search_memrchr(const unsigned char *p, size_t n,
+                               unsigned char c) {
+  size_t i = n;
+#if !defined(__CUDA_ARCH__)
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  if (n >= 16) {
+    B::vec v = B::splat(c);
+    for (; i >= 16; i -= 16) {
+      uint64_t m = B::mask(B::eq(B::load(p + i - 16), v));
+      if (m) {
+        return i - 16 + size_t((63 - __clz64(m)) >> B::kShift);
+      }
+    }
+    if (i > 0) {
+      // First partial block: only bytes [0, i) are unchecked.
+      uint64_t m = B::mask(B::eq(B::load(p), v));
+      if (i < 16) {
+        m &= (uint64_t(1) << (i << B::kShift)) - 1;
+      }
+      if (m) {
+        return size_t((63 - __clz64(m)) >> B::kShift);
+      }
+    }
+    return __search_npos;
+  }
+#endif
+  const uint64_t vc = __search_splat(c);
+  for (; i >= 8; i -= 8) {
+    uint64_t z = __search_zero_bytes(__search_load64(p + i - 8) ^ vc);
+    if (z) {
+      return i - 8 + size_t((63 - __clz64(z)) >> 3);
+    }
+  }
+#endif
+  while (i > 0) {
+    i--;
+    if (p[i] == c) {
+      return i;
+    }
+  }
+  return __search_npos;
+}
+
+// memcmp: <0, 0 or >0, bytes compared as unsigned.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline int __search_memcmp(const unsigned char *a, const unsigned char *b,
+                           size_t n) {
+  size_t i = 0;
+#if !defined(__CUDA_ARCH__)
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  for (; i + 16 <= n; i += 16) {
+    uint64_t ne = ~B::mask(B::eq(B::load(a + i), B::load(b + i))) & B::kFull;
+    if (ne) {
+      size_t k = i + size_t(__ctz64(ne) >> B::kShift);
+      return (a[k] < b[k]) ? -1 : 1;
+    }
+  }
+#endif
+  for (; i + 8 <= n; i += 8) {
+    uint64_t d = __search_load64(a + i) ^ __search_load64(b + i);
+    if (d) {
+      size_t k = i + size_t(__ctz64(d) >> 3);
+      return (a[k] < b[k]) ? -1 : 1;
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (a[i] != b[i]) {
+      return (a[i] < b[i]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+// First occurrence of needle[0, m) in p[0, n).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __search_find(const unsigned char *p, size_t n,
+                            const unsigned char *needle, size_t m) {
+  if (m == 0) {
+    return 0;
+  }
+  if (m > n) {
+    return __search_npos;
+  }
+  if (m == 1) {
+    return __search_memchr(p, n, needle[0]);
+  }
+
+  const unsigned char first = needle[0];
+  const unsigned char last = needle[m - 1];
+  size_t i = 0;
+
+#if !defined(__CUDA_ARCH__) && defined(NANOSTL_STRING_SEARCH_BLOCK)
+  // Match the first and the last needle byte at 16 candidate positions at
+  // once; only positions where both agree are compared in full.
+  typedef __search_block B;
+  const uint64_t byte_bits = (uint64_t(1) << (1 << B::kShift)) - 1;
+  B::vec vf = B::splat(first);
+  B::vec vl = B::splat(last);
+  for (; i + m - 1 + 16 <= n; i += 16) {
+    uint64_t mask = B::mask(
+        B::vand(B::eq(B::load(p + i), vf), B::eq(B::load(p + i + m - 1), vl)));
+    while (mask) {
+      size_t k = size_t(__ctz64(mask) >> B::kShift);
+      if (__search_memcmp(p + i + k + 1, needle + 1, m - 2) == 0) {
+        return i + k;
+      }
+      mask &= ~(byte_bits << (k << B::kShift));
+    }
+  }
+#endif
+
+  // Jump between occurrences of the first byte.
+  const size_t end = n - m;
+  while (i <= end) {
+    size_t k = __search_memchr(p + i, end - i + 1, first);
+    if (k == __search_npos) {
+      break;
+    }
+    i += k;
+    if ((p[i + m - 1] == last) &&
+        (__search_memcmp(p + i + 1, needle + 1, m - 2) == 0)) {
+      return i;
+    }
+    i++;
+  }
+  return __search_npos;
+}
+
+// Last occurrence of needle[0, m) in p[0, n).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __search_rfind(const unsigned char *p, size_t n,
+                             const unsigned char *needle, size_t m) {
+  if (m > n) {
+    return __search_npos;
+  }
+  if (m == 0) {
+    return n;
+  }
+
+  // Candidate starts are [0, end).
+  size_t end = n - m + 1;
+  while (end > 0) {
+    size_t k = __search_memrchr(p, end, needle[0]);
+    if (k == __search_npos) {
+      break;
+    }
+    if ((p[k + m - 1] == needle[m - 1]) &&
+        (__search_memcmp(p + k + 1, needle + 1, m - 1) == 0)) {
+      return k;
+    }
+    end = k;
+  }
+  return __search_npos;
+}
+
+// 256-bit membership set for find_*_of.
+struct __search_byteset {
+  uint64_t bits[4];
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __search_byteset(const unsigned char *s, size_t n) {
+    bits[0] = bits[1] = bits[2] = bits[3] = 0;
+    for (size_t i = 0; i < n; i++) {
+      bits[s[i] >> 6] |= uint64_t(1) << (s[i] & 63);
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool has(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+};
+
+// First byte of p[0, n) that is(`in` == true) or is not in s[0, m).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __search_find_of(const unsigned char *p, size_t n,
+                               const unsigned char *s, size_t m, bool in) {
+  if (in && (m == 1)) {
+    return __search_memchr(p, n, s[0]);
+  }
+
+  size_t i = 0;
+#if !defined(__CUDA_ARCH__) && defined(NANOSTL_STRING_SEARCH_BLOCK)
+  // Small sets(delimiters, whitespace): one compare per set byte per block.
+  if ((m > 0) && (m <= 8)) {
+    typedef __search_block B;
+    const uint64_t flip = in ? 0 : B::kFull;
+    B::vec set[8];
+    for (size_t k = 0; k < m; k++) {
+      set[k] = B::splat(s[k]);
+    }
+    for (; i + 16 <= n; i += 16) {
+      B::vec v = B::load(p + i);
+      B::vec acc = B::eq(v, set[0]);
+      for (size_t k = 1; k < m; k++) {
+        acc = B::vor(acc, B::eq(v, set[k]));
+      }
+      uint64_t mask = B::mask(acc) ^ flip;
+      if (mask) {
+        return i + size_t(__ctz64(mask) >> B::kShift);
+      }
+    }
+  }
+#endif
+
+  __search_byteset set(s, m);
+  for (; i < n; i++) {
+    if (set.has(p[i]) == in) {
+      return i;
+    }
+  }
+  return __search_npos;
+}
+
+// Last byte of p[0, n) that is(`in` == true) or is not in s[0, m).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t __search_rfind_of(const unsigned char *p, size_t n,
+                                const unsigned char *s, size_t m, bool in) {
+  if (in && (m == 1)) {
+    return __search_memrchr(p, n, s[0]);
+  }
+
+  __search_byteset set(s, m);
+  for (size_t i = n; i > 0; i--) {
+    if (set.has(p[i - 1]) == in) {
+      return i - 1;
+    }
+  }
+  return __search_npos;
+}
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+}  // namespace nanostl
+
+#endif  // NANOSTL___STRING_SEARCH_H_
@@ -1,13 +1,12 @@
 #ifndef FASTFLOAT_ASCII_NUMBER_H
 #define FASTFLOAT_ASCII_NUMBER_H
 
-//#include <cctype>
 #include "nanocstdint.h"
 #include "nanocstring.h"
-#include <iterator>
 
 #include "float_common.h"
 
+namespace nanostl {
 namespace fast_float {
 
 // Next function can be micro-optimized, but compilers are entirely
@@ -27,7 +26,7 @@ fastfloat_really_inline uint64_t byteswap(uint64_t val) {
 
 fastfloat_really_inline uint64_t read_u64(const char *chars) {
   uint64_t val;
-  ::memcpy(&val, chars, sizeof(uint64_t));
+  nanostl::memcpy(&val, chars, sizeof(uint64_t));
 #if FASTFLOAT_IS_BIG_ENDIAN == 1
   // Need to read as-if the number was in little-endian order.
   val = byteswap(val);
@@ -40,7 +39,7 @@ fastfloat_really_inline void write_u64(uint8_t *chars, uint64_t val) {
   // Need to read as-if the number was in little-endian order.
   val = byteswap(val);
 #endif
-  ::memcpy(chars, &val, sizeof(uint64_t));
+  nanostl::memcpy(chars, &val, sizeof(uint64_t));
 }
 
 // credit  @aqrit
@@ -106,7 +105,7 @@ parsed_number_string parse_number_string(const char *p, const char *pend, parse_
 
   uint64_t i = 0; // an unsigned int avoids signed overflows (which are bad)
 
-  while ((std::distance(p, pend) >= 8) && is_made_of_eight_digits_fast(p)) {
+  while (((pend - p) >= 8) && is_made_of_eight_digits_fast(p)) {
     i = i * 100000000 + parse_eight_digits_unrolled(p); // in rare cases, this will overflow, but that's ok
     p += 8;
   }
@@ -126,7 +125,7 @@ parsed_number_string parse_number_string(const char *p, const char *pend, parse_
     const char* before = p;
     // can occur at most twice without overflowing, but let it occur more, since
     // for integers with many digits, digit parsing is the primary bottleneck.
-    while ((std::distance(p, pend) >= 8) && is_made_of_eight_digits_fast(p)) {
+    while (((pend - p) >= 8) && is_made_of_eight_digits_fast(p)) {
       i = i * 100000000 + parse_eight_digits_unrolled(p); // in rare cases, this will overflow, but that's ok
       p += 8;
     }
@@ -227,5 +226,6 @@ parsed_number_string parse_number_string(const char *p, const char *pend, parse_
 }
 
 } // namespace fast_float
+} // namespace nanostl
 
 #endif
@@ -1,13 +1,10 @@
 #ifndef FASTFLOAT_BIGINT_H
 #define FASTFLOAT_BIGINT_H
 
-#include <algorithm>
-#include <cstdint>
-#include <climits>
-#include <cstring>
 
 #include "float_common.h"
 
+namespace nanostl {
 namespace fast_float {
 
 // the limb width: we want efficient multiplication of double the bits in
@@ -99,7 +96,7 @@ struct stackvec {
   // add items to the vector, from a span, without bounds checking
   void extend_unchecked(limb_span s) noexcept {
     limb* ptr = data + length;
-    ::memcpy((void*)ptr, (const void*)s.ptr, sizeof(limb) * s.len());
+    nanostl::memcpy((void*)ptr, (const void*)s.ptr, sizeof(limb) * s.len());
     set_len(len() + s.len());
   }
   // try to add items to the vector, returning if items were added
@@ -119,7 +116,7 @@ struct stackvec {
       size_t count = new_len - len();
       limb* first = data + len();
       limb* last = first + count;
-      ::std::fill(first, last, value);
+      for (limb* p = first; p != last; ++p) { *p = value; }
       set_len(new_len);
     } else {
       set_len(new_len);
@@ -474,11 +471,11 @@ struct bigint {
       // move limbs
       limb* dst = vec.data + n;
       const limb* src = vec.data;
-      ::memmove(dst, src, sizeof(limb) * vec.len());
+      nanostl::memmove(dst, src, sizeof(limb) * vec.len());
       // fill in empty limbs
       limb* first = vec.data;
       limb* last = first + n;
-      ::std::fill(first, last, 0);
+      for (limb* p = first; p != last; ++p) { *p = 0; }
       vec.set_len(n + vec.len());
       return true;
     } else {
@@ -586,5 +583,6 @@ struct bigint {
 };
 
 } // namespace fast_float
+} // namespace nanostl
 
 #endif
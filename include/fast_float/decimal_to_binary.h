@@ -3,13 +3,8 @@
 
 #include "float_common.h"
 #include "fast_table.h"
-#include <cfloat>
-#include <cinttypes>
-#include <cmath>
-#include <cstdint>
-#include <cstdlib>
-#include <cstring>
 
+namespace nanostl {
 namespace fast_float {
 
 // This will compute or rather approximate w * 5**q and return a pair of 64-bit words approximating
@@ -190,5 +185,6 @@ adjusted_mantissa compute_float(int64_t q, uint64_t w)  noexcept  {
 }
 
 } // namespace fast_float
+} // namespace nanostl
 
 #endif
@@ -1,15 +1,12 @@
 #ifndef FASTFLOAT_DIGIT_COMPARISON_H
 #define FASTFLOAT_DIGIT_COMPARISON_H
 
-#include <algorithm>
-#include <cstdint>
-#include <cstring>
-#include <iterator>
 
 #include "float_common.h"
 #include "bigint.h"
 #include "ascii_number.h"
 
+namespace nanostl {
 namespace fast_float {
 
 // 1e0 to 1e19
@@ -52,7 +49,7 @@ fastfloat_really_inline adjusted_mantissa to_extended(T value) noexcept {
   adjusted_mantissa am;
   int32_t bias = binary_format<T>::mantissa_explicit_bits() - binary_format<T>::minimum_exponent();
   equiv_uint bits;
-  ::memcpy(&bits, &value, sizeof(T));
+  nanostl::memcpy(&bits, &value, sizeof(T));
   if ((bits & exponent_mask) == 0) {
     // denormal
     am.power2 = 1 - bias;
@@ -86,7 +83,7 @@ fastfloat_really_inline void round(adjusted_mantissa& am, callback cb) noexcept
   if (-am.power2 >= mantissa_shift) {
     // have a denormal float
     int32_t shift = -am.power2 + 1;
-    cb(am, std::min<int32_t>(shift, 64));
+    cb(am, (shift < 64) ? shift : 64);
     // check for round-up: if rounding-nearest carried us to the hidden bit.
     am.power2 = (am.mantissa < (uint64_t(1) << binary_format<T>::mantissa_explicit_bits())) ? 0 : 1;
     return;
@@ -115,7 +112,7 @@ void round_nearest_tie_even(adjusted_mantissa& am, int32_t shift, callback cb) n
   uint64_t mask;
   uint64_t halfway;
   if (shift == 64) {
-    mask = UINT64_MAX;
+    mask = ~uint64_t(0);
   } else {
     mask = (uint64_t(1) << shift) - 1;
   }
@@ -151,8 +148,8 @@ fastfloat_really_inline void round_down(adjusted_mantissa& am, int32_t shift) no
 
 fastfloat_really_inline void skip_zeros(const char*& first, const char* last) noexcept {
   uint64_t val;
-  while (std::distance(first, last) >= 8) {
-    ::memcpy(&val, first, sizeof(uint64_t));
+  while ((last - first) >= 8) {
+    nanostl::memcpy(&val, first, sizeof(uint64_t));
     if (val != 0x3030303030303030) {
       break;
     }
@@ -171,8 +168,8 @@ fastfloat_really_inline void skip_zeros(const char*& first, const char* last) no
 fastfloat_really_inline bool is_truncated(const char* first, const char* last) noexcept {
   // do 8-bit optimizations, can just compare to 8 literal 0s.
   uint64_t val;
-  while (std::distance(first, last) >= 8) {
-    ::memcpy(&val, first, sizeof(uint64_t));
+  while ((last - first) >= 8) {
+    nanostl::memcpy(&val, first, sizeof(uint64_t));
     if (val != 0x3030303030303030) {
       return true;
     }
@@ -240,7 +237,7 @@ inline void parse_mantissa(bigint& result, parsed_number_string& num, size_t max
   skip_zeros(p, pend);
   // process all digits, in increments of step per loop
   while (p != pend) {
-    while ((std::distance(p, pend) >= 8) && (step - counter >= 8) && (max_digits - digits >= 8)) {
+    while (((pend - p) >= 8) && (step - counter >= 8) && (max_digits - digits >= 8)) {
       parse_eight_digits(p, value, counter, digits);
     }
     while (counter < step && p != pend && digits < max_digits) {
@@ -273,7 +270,7 @@ inline void parse_mantissa(bigint& result, parsed_number_string& num, size_t max
     }
     // process all digits, in increments of step per loop
     while (p != pend) {
-      while ((std::distance(p, pend) >= 8) && (step - counter >= 8) && (max_digits - digits >= 8)) {
+      while (((pend - p) >= 8) && (step - counter >= 8) && (max_digits - digits >= 8)) {
         parse_eight_digits(p, value, counter, digits);
       }
       while (counter < step && p != pend && digits < max_digits) {
@@ -403,5 +400,6 @@ inline adjusted_mantissa digit_comp(parsed_number_string& num, adjusted_mantissa
 }
 
 } // namespace fast_float
+} // namespace nanostl
 
 #endif
@@ -3,6 +3,7 @@
 
 #include "nanosystem_error.h"
 
+namespace nanostl {
 namespace fast_float {
 enum chars_format {
     scientific = 1<<0,
@@ -37,7 +38,7 @@ struct parse_options {
  *
  * Given a successful parse, the pointer (`ptr`) in the returned value is set to point right after the
  * parsed number, and the `value` referenced is set to the parsed value. In case of error, the returned
- * `ec` contains a representative error, otherwise the default (`std::errc()`) value is stored.
+ * `ec` contains a representative error, otherwise the default (`nanostl::errc()`) value is stored.
  *
  * The implementation does not throw and does not allocate memory (e.g., with `new` or `malloc`).
  *
@@ -58,6 +59,7 @@ template<typename T>
 from_chars_result from_chars_advanced(const char *first, const char *last,
                                       T &value, parse_options options)  noexcept;
 
-}
+} // namespace fast_float
+} // namespace nanostl
 #include "parse_number.h"
 #endif // FASTFLOAT_FAST_FLOAT_H
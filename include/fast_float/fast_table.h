@@ -1,8 +1,10 @@
 #ifndef FASTFLOAT_FAST_TABLE_H
 #define FASTFLOAT_FAST_TABLE_H
 
-#include <cstdint>
+#include "nanocstdint.h"
 
+
+namespace nanostl {
 namespace fast_float {
 
 /**
@@ -694,6 +696,7 @@ const uint64_t powers_template<unused>::power_of_five_128[number_of_entries] = {
         0x8e679c2f5e44ff8f,0x570f09eaa7ea7648,};
 using powers = powers_template<>;
 
-}
+} // namespace fast_float
+} // namespace nanostl
 
 #endif
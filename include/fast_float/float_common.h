@@ -1,12 +1,11 @@
 #ifndef FASTFLOAT_FLOAT_COMMON_H
 #define FASTFLOAT_FLOAT_COMMON_H
 
-#include <cfloat>
-#include <cstdint>
-#include <cassert>
-#include <cstring>
-#include <type_traits>
-
+#include "nanocassert.h"
+#include "nanocommon.h"
+#include "nanocstdint.h"
+#include "nanocstring.h"
+#include "nanotype_traits.h"
 #if (defined(__x86_64) || defined(__x86_64__) || defined(_M_X64)   \
        || defined(__amd64) || defined(__aarch64__) || defined(_M_ARM64) \
        || defined(__MINGW64__)                                          \
@@ -19,14 +18,10 @@
      || defined(__MINGW32__))
 #define FASTFLOAT_32BIT
 #else
-  // Need to check incrementally, since SIZE_MAX is a size_t, avoid overflow.
-  // We can never tell the register width, but the SIZE_MAX is a good approximation.
-  // UINTPTR_MAX and INTPTR_MAX are optional, so avoid them for max portability.
-  #if SIZE_MAX == 0xffff
-    #error Unknown platform (16-bit, unsupported)
-  #elif SIZE_MAX == 0xffffffff
+  // nanostl: no SIZE_MAX without libc headers; use the compiler's pointer size.
+  #if defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ == 4)
     #define FASTFLOAT_32BIT
-  #elif SIZE_MAX == 0xffffffffffffffff
+  #elif defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ == 8)
     #define FASTFLOAT_64BIT
   #else
     #error Unknown platform (not 32-bit, not 64-bit?)
@@ -34,41 +29,30 @@
 #endif
 
 #if ((defined(_WIN32) || defined(_WIN64)) && !defined(__clang__))
+#pragma push_macro("nullptr")
+#undef nullptr
 #include <intrin.h>
+#pragma pop_macro("nullptr")
 #endif
 
 #if defined(_MSC_VER) && !defined(__clang__)
 #define FASTFLOAT_VISUAL_STUDIO 1
 #endif
 
-#if defined __BYTE_ORDER__ && defined __ORDER_BIG_ENDIAN__
-#define FASTFLOAT_IS_BIG_ENDIAN (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
-#elif defined _WIN32
-#define FASTFLOAT_IS_BIG_ENDIAN 0
-#else
-#if defined(__APPLE__) || defined(__FreeBSD__)
-#include <machine/endian.h>
-#elif defined(sun) || defined(__sun)
-#include <sys/byteorder.h>
+// nanostl: byte order comes from NANOSTL_BIG_ENDIAN(see nanocommon.h).
+#if defined(NANOSTL_BIG_ENDIAN)
+#define FASTFLOAT_IS_BIG_ENDIAN 1
 #else
-#include <endian.h>
-#endif
-#
-#ifndef __BYTE_ORDER__
-// safe choice
-#define FASTFLOAT_IS_BIG_ENDIAN 0
-#endif
-#
-#ifndef __ORDER_LITTLE_ENDIAN__
-// safe choice
 #define FASTFLOAT_IS_BIG_ENDIAN 0
 #endif
-#
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-#define FASTFLOAT_IS_BIG_ENDIAN 0
+
+// nanostl: <cfloat> is not available; GCC/Clang predefine the same value.
+#if defined(FLT_EVAL_METHOD)
+#define FASTFLOAT_FLT_EVAL_METHOD FLT_EVAL_METHOD
+#elif defined(__FLT_EVAL_METHOD__)
+#define FASTFLOAT_FLT_EVAL_METHOD __FLT_EVAL_METHOD__
 #else
-#define FASTFLOAT_IS_BIG_ENDIAN 1
-#endif
+#define FASTFLOAT_FLT_EVAL_METHOD 0
 #endif
 
 #ifdef FASTFLOAT_VISUAL_STUDIO
@@ -78,17 +62,18 @@
 #endif
 
 #ifndef FASTFLOAT_ASSERT
-#define FASTFLOAT_ASSERT(x)  { if (!(x)) abort(); }
+// nanostl: no abort() without libc.
+#define FASTFLOAT_ASSERT(x) assert(x)
 #endif
 
 #ifndef FASTFLOAT_DEBUG_ASSERT
-#include <cassert>
 #define FASTFLOAT_DEBUG_ASSERT(x) assert(x)
 #endif
 
 // rust style `try!()` macro, or `?` operator
 #define FASTFLOAT_TRY(x) { if (!(x)) return false; }
 
+namespace nanostl {
 namespace fast_float {
 
 // Compares two ASCII strings in a case insensitive manner.
@@ -101,9 +86,6 @@ inline bool fastfloat_strncasecmp(const char *input1, const char *input2,
   return (running_diff == 0) || (running_diff == 32);
 }
 
-#ifndef FLT_EVAL_METHOD
-#error "FLT_EVAL_METHOD should be defined, please include cfloat."
-#endif
 
 // a pointer and a length to a contiguous block of memory
 template <typename T>
@@ -222,7 +204,7 @@ constexpr static float powers_of_ten_float[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5,
                                                 1e6, 1e7, 1e8, 1e9, 1e10};
 
 template <typename T> struct binary_format {
-  using equiv_uint = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+  using equiv_uint = typename nanostl::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
 
   static inline constexpr int mantissa_explicit_bits();
   static inline constexpr int minimum_exponent();
@@ -283,14 +265,14 @@ template <> inline constexpr int binary_format<double>::sign_index() { return 63
 template <> inline constexpr int binary_format<float>::sign_index() { return 31; }
 
 template <> inline constexpr int binary_format<double>::min_exponent_fast_path() {
-#if (FLT_EVAL_METHOD != 1) && (FLT_EVAL_METHOD != 0)
+#if (FASTFLOAT_FLT_EVAL_METHOD != 1) && (FASTFLOAT_FLT_EVAL_METHOD != 0)
   return 0;
 #else
   return -22;
 #endif
 }
 template <> inline constexpr int binary_format<float>::min_exponent_fast_path() {
-#if (FLT_EVAL_METHOD != 1) && (FLT_EVAL_METHOD != 0)
+#if (FASTFLOAT_FLT_EVAL_METHOD != 1) && (FASTFLOAT_FLT_EVAL_METHOD != 0)
   return 0;
 #else
   return -10;
@@ -381,17 +363,18 @@ fastfloat_really_inline void to_float(bool negative, adjusted_mantissa am, T &va
   word = negative
   ? word | (uint64_t(1) << binary_format<T>::sign_index()) : word;
 #if FASTFLOAT_IS_BIG_ENDIAN == 1
-   if (std::is_same<T, float>::value) {
-     ::memcpy(&value, (char *)&word + 4, sizeof(T)); // extract value at offset 4-7 if float on big-endian
+   if (nanostl::is_same<T, float>::value) {
+     nanostl::memcpy(&value, (char *)&word + 4, sizeof(T)); // extract value at offset 4-7 if float on big-endian
    } else {
-     ::memcpy(&value, &word, sizeof(T));
+     nanostl::memcpy(&value, &word, sizeof(T));
    }
 #else
    // For little-endian systems:
-   ::memcpy(&value, &word, sizeof(T));
+   nanostl::memcpy(&value, &word, sizeof(T));
 #endif
 }
 
 } // namespace fast_float
+} // namespace nanostl
 
 #endif
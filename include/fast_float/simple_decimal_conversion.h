@@ -15,8 +15,8 @@
  **/
 #include "ascii_number.h"
 #include "decimal_to_binary.h"
-#include <cstdint>
 
+namespace nanostl {
 namespace fast_float {
 
 namespace detail {
@@ -127,7 +127,7 @@ inline uint64_t round(decimal &h) {
   if ((h.num_digits == 0) || (h.decimal_point < 0)) {
     return 0;
   } else if (h.decimal_point > 18) {
-    return UINT64_MAX;
+    return ~uint64_t(0);
   }
   // at this point, we know that h.decimal_point >= 0
   uint32_t dp = uint32_t(h.decimal_point);
@@ -357,4 +357,5 @@ adjusted_mantissa parse_long_mantissa(const char *first, const char* last, parse
 }
 
 } // namespace fast_float
+} // namespace nanostl
 #endif
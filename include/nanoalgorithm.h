@@ -25,17 +25,19 @@
 #ifndef NANOSTL_ALGORITHM_H_
 #define NANOSTL_ALGORITHM_H_
 
-namespace nanostl {
+#include "__minmax.h"
+#include "nanoallocator.h"
+#include "nanofunctional.h"
+#include "nanoiterator.h"
+#include "nanotype_traits.h"
+#include "nanoutility.h"
 
-template <class T>
-const T& min(const T& a, const T& b) {
-  return !(b < a) ? a : b;
-}
+#if defined(NANOSTL_PSTL)
+#include "nanoexecution.h"
+#include "nanovector.h"
+#endif
 
-template <class T>
-const T& max(const T& a, const T& b) {
-  return !(b > a) ? a : b;
-}
+namespace nanostl {
 
 template <class ForwardIt>
 ForwardIt max_element(ForwardIt first, ForwardIt last) {
@@ -56,16 +58,1302 @@ void fill(ForwardIterator first, ForwardIterator last, const T& value) {
   while (first != last) *first++ = value;
 }
 
+template <class InputIterator, class UnaryFunction>
+UnaryFunction for_each(InputIterator first, InputIterator last,
+                       UnaryFunction f) {
+  for (; first != last; ++first) {
+    f(*first);
+  }
+  return f;
+}
+
+template <class InputIterator, class OutputIterator, class UnaryOperation>
+OutputIterator transform(InputIterator first, InputIterator last,
+                         OutputIterator d_first, UnaryOperation op) {
+  for (; first != last; ++first, ++d_first) {
+    *d_first = op(*first);
+  }
+  return d_first;
+}
+
+template <class InputIterator1, class InputIterator2, class OutputIterator,
+          class BinaryOperation>
+OutputIterator transform(InputIterator1 first1, InputIterator1 last1,
+                         InputIterator2 first2, OutputIterator d_first,
+                         BinaryOperation op) {
+  for (; first1 != last1; ++first1, ++first2, ++d_first) {
+    *d_first = op(*first1, *first2);
+  }
+  return d_first;
+}
+
+template <class InputIterator, class OutputIterator>
+OutputIterator copy(InputIterator first, InputIterator last,
+                    OutputIterator d_first) {
+  for (; first != last; ++first, ++d_first) {
+    *d_first = *first;
+  }
+  return d_first;
+}
+
+template <class InputIterator, class UnaryPredicate>
+typename iterator_traits<InputIterator>::difference_type count_if(
+    InputIterator first, InputIterator last, UnaryPredicate p) {
+  typename iterator_traits<InputIterator>::difference_type n = 0;
+  for (; first != last; ++first) {
+    if (p(*first)) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+template <class InputIterator, class UnaryPredicate>
+InputIterator find_if(InputIterator first, InputIterator last,
+                      UnaryPredicate p) {
+  for (; first != last; ++first) {
+    if (p(*first)) {
+      return first;
+    }
+  }
+  return last;
+}
+
+//
+// Sorting.
+//
+// sort is pattern-defeating quicksort(pdqsort): median-of-3(ninther for
+// large ranges) pivots, insertion sort for short ranges and for ranges
+// which look already sorted, and a heapsort fallback once too many
+// partitions were badly unbalanced, so the worst case stays O(n log n).
+// Arithmetic keys compared with less<T> use a branchless block partition,
+// which avoids mispredicting on random data.
+//
+
+template <class ForwardIterator, class Compare>
+bool is_sorted(ForwardIterator first, ForwardIterator last, Compare comp) {
+  if (first == last) return true;
+
+  ForwardIterator next = first;
+  for (++next; next != last; ++first, ++next) {
+    if (comp(*next, *first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class ForwardIterator>
+bool is_sorted(ForwardIterator first, ForwardIterator last) {
+  return nanostl::is_sorted(
+      first, last,
+      less<typename iterator_traits<ForwardIterator>::value_type>());
+}
+
+// Below this size ranges are insertion sorted.
+static const ptrdiff_t __sort_insertion_threshold = 24;
+// Above this size pivots are the median of three medians.
+static const ptrdiff_t __sort_ninther_threshold = 128;
+// partial insertion sort gives up after this many moved elements.
+static const ptrdiff_t __sort_partial_insertion_limit = 8;
+// Elements classified per block by the branchless partition.
+static const ptrdiff_t __sort_block_size = 64;
+
+template <class T, class Compare>
+struct __sort_is_branchless
+    : public integral_constant<bool, is_arithmetic<T>::value &&
+                                         is_same<Compare, less<T> >::value> {
+};
+
+template <class RandomIterator>
+inline void __sort_iter_swap(RandomIterator a, RandomIterator b) {
+  using nanostl::swap;
+  swap(*a, *b);
+}
+
+template <class RandomIterator, class Compare>
+inline void __sort2(RandomIterator a, RandomIterator b, Compare& comp) {
+  if (comp(*b, *a)) {
+    nanostl::__sort_iter_swap(a, b);
+  }
+}
+
+template <class RandomIterator, class Compare>
+inline void __sort3(RandomIterator a, RandomIterator b, RandomIterator c,
+                    Compare& comp) {
+  nanostl::__sort2(a, b, comp);
+  nanostl::__sort2(b, c, comp);
+  nanostl::__sort2(a, b, comp);
+}
+
+template <class RandomIterator, class Compare>
+void __insertion_sort(RandomIterator first, RandomIterator last,
+                      Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  if (first == last) return;
+
+  for (RandomIterator cur = first + 1; cur != last; ++cur) {
+    RandomIterator sift = cur;
+    RandomIterator sift_1 = cur - 1;
+    if (comp(*sift, *sift_1)) {
+      T tmp(nanostl::move(*sift));
+      do {
+        *sift-- = nanostl::move(*sift_1);
+      } while ((sift != first) && comp(tmp, *--sift_1));
+      *sift = nanostl::move(tmp);
+    }
+  }
+}
+
+// Requires an element before `first` which is not greater than any element
+// in the range, so the inner loop needs no bounds check.
+template <class RandomIterator, class Compare>
+void __unguarded_insertion_sort(RandomIterator first, RandomIterator last,
+                                Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  if (first == last) return;
+
+  for (RandomIterator cur = first + 1; cur != last; ++cur) {
+    RandomIterator sift = cur;
+    RandomIterator sift_1 = cur - 1;
+    if (comp(*sift, *sift_1)) {
+      T tmp(nanostl::move(*sift));
+      do {
+        *sift-- = nanostl::move(*sift_1);
+      } while (comp(tmp, *--sift_1));
+      *sift = nanostl::move(tmp);
+    }
+  }
+}
+
+// Insertion sort which gives up(returns false) once more than
+// __sort_partial_insertion_limit elements were moved.
+template <class RandomIterator, class Compare>
+bool __partial_insertion_sort(RandomIterator first, RandomIterator last,
+                              Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  if (first == last) return true;
+
+  ptrdiff_t moved = 0;
+  for (RandomIterator cur = first + 1; cur != last; ++cur) {
+    RandomIterator sift = cur;
+    RandomIterator sift_1 = cur - 1;
+    if (comp(*sift, *sift_1)) {
+      T tmp(nanostl::move(*sift));
+      do {
+        *sift-- = nanostl::move(*sift_1);
+      } while ((sift != first) && comp(tmp, *--sift_1));
+      *sift = nanostl::move(tmp);
+      moved += cur - sift;
+      if (moved > __sort_partial_insertion_limit) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Heap helpers for the heapsort fallback, partial_sort and nth_element.
+template <class RandomIterator, class Compare>
+void __sift_down(RandomIterator first, ptrdiff_t len, ptrdiff_t hole,
+                 Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  T v(nanostl::move(first[hole]));
+  ptrdiff_t child;
+  while ((child = 2 * hole + 1) < len) {
+    if ((child + 1 < len) && comp(first[child], first[child + 1])) {
+      ++child;
+    }
+    if (!comp(v, first[child])) {
+      break;
+    }
+    first[hole] = nanostl::move(first[child]);
+    hole = child;
+  }
+  first[hole] = nanostl::move(v);
+}
+
+template <class RandomIterator, class Compare>
+void __make_heap(RandomIterator first, ptrdiff_t len, Compare& comp) {
+  for (ptrdiff_t i = len / 2; i-- > 0;) {
+    nanostl::__sift_down(first, len, i, comp);
+  }
+}
+
+template <class RandomIterator, class Compare>
+void __sort_heap(RandomIterator first, ptrdiff_t len, Compare& comp) {
+  for (ptrdiff_t n = len; n > 1; --n) {
+    nanostl::__sort_iter_swap(first, first + (n - 1));
+    nanostl::__sift_down(first, n - 1, 0, comp);
+  }
+}
+
+template <class RandomIterator, class Compare>
+void __partial_sort(RandomIterator first, RandomIterator middle,
+                    RandomIterator last, Compare& comp) {
+  const ptrdiff_t len = middle - first;
+  if (len == 0) return;
+
+  nanostl::__make_heap(first, len, comp);
+  for (RandomIterator it = middle; it != last; ++it) {
+    if (comp(*it, *first)) {
+      nanostl::__sort_iter_swap(it, first);
+      nanostl::__sift_down(first, len, 0, comp);
+    }
+  }
+  nanostl::__sort_heap(first, len, comp);
+}
+
+// Moves the median of the range to `first`. Leaves an element not less
+// than the median at `last - 1`, which bounds the partition scans.
+template <class RandomIterator, class Compare>
+inline void __sort_choose_pivot(RandomIterator first, RandomIterator last,
+                                Compare& comp) {
+  const ptrdiff_t size = last - first;
+  const ptrdiff_t s2 = size / 2;
+  if (size > __sort_ninther_threshold) {
+    nanostl::__sort3(first, first + s2, last - 1, comp);
+    nanostl::__sort3(first + 1, first + (s2 - 1), last - 2, comp);
+    nanostl::__sort3(first + 2, first + (s2 + 1), last - 3, comp);
+    nanostl::__sort3(first + (s2 - 1), first + s2, first + (s2 + 1), comp);
+    nanostl::__sort_iter_swap(first, first + s2);
+  } else {
+    nanostl::__sort3(first + s2, first, last - 1, comp);
+  }
+}
+
+// Partitions [first, last) around the pivot *first. Elements equal to the
+// pivot go to the right. Returns the final pivot position, and whether the
+// range was already partitioned(no element had to be swapped).
+template <class RandomIterator, class Compare>
+pair<RandomIterator, bool> __partition_right(RandomIterator first,
+                                             RandomIterator last,
+                                             Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  RandomIterator begin = first;
+  T pivot(nanostl::move(*first));
+
+  while (comp(*++first, pivot)) {
+  }
+  if (first - 1 == begin) {
+    while ((first < last) && !comp(*--last, pivot)) {
+    }
+  } else {
+    while (!comp(*--last, pivot)) {
+    }
+  }
+
+  const bool already_partitioned = first >= last;
+  while (first < last) {
+    nanostl::__sort_iter_swap(first, last);
+    while (comp(*++first, pivot)) {
+    }
+    while (!comp(*--last, pivot)) {
+    }
+  }
+
+  RandomIterator pivot_pos = first - 1;
+  *begin = nanostl::move(*pivot_pos);
+  *pivot_pos = nanostl::move(pivot);
+  return pair<RandomIterator, bool>(pivot_pos, already_partitioned);
+}
+
+// Swaps the misplaced elements found by the block scans. With use_swaps
+// false the elements are rotated through one temporary instead, which
+// halves the moves but needs num_l == num_r.
+template <class RandomIterator>
+inline void __sort_swap_offsets(RandomIterator first, RandomIterator last,
+                                const unsigned char* offsets_l,
+                                const unsigned char* offsets_r, ptrdiff_t num,
+                                bool use_swaps) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  if (use_swaps) {
+    for (ptrdiff_t i = 0; i < num; ++i) {
+      nanostl::__sort_iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    }
+  } else if (num > 0) {
+    RandomIterator l = first + offsets_l[0];
+    RandomIterator r = last - offsets_r[0];
+    T tmp(nanostl::move(*l));
+    *l = nanostl::move(*r);
+    for (ptrdiff_t i = 1; i < num; ++i) {
+      l = first + offsets_l[i];
+      *r = nanostl::move(*l);
+      r = last - offsets_r[i];
+      *l = nanostl::move(*r);
+    }
+    *r = nanostl::move(tmp);
+  }
+}
+
+// Same contract as __partition_right. Scans a block from each end, storing
+// the offsets of misplaced elements without branching on the comparison,
+// then swaps them in bulk.
+template <class RandomIterator, class Compare>
+pair<RandomIterator, bool> __partition_right_branchless(RandomIterator first,
+                                                        RandomIterator last,
+                                                        Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  RandomIterator begin = first;
+  T pivot(nanostl::move(*first));
+
+  while (comp(*++first, pivot)) {
+  }
+  if (first - 1 == begin) {
+    while ((first < last) && !comp(*--last, pivot)) {
+    }
+  } else {
+    while (!comp(*--last, pivot)) {
+    }
+  }
+
+  const bool already_partitioned = first >= last;
+  if (!already_partitioned) {
+    nanostl::__sort_iter_swap(first, last);
+    ++first;
+
+    unsigned char offsets_l[__sort_block_size];
+    unsigned char offsets_r[__sort_block_size];
+    RandomIterator offsets_l_base = first;
+    RandomIterator offsets_r_base = last;
+    ptrdiff_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+    while (first < last) {
+      // Fill the empty offset buffers from the unknown middle part.
+      const ptrdiff_t num_unknown = last - first;
+      const ptrdiff_t left_split =
+          (num_l == 0) ? ((num_r == 0) ? (num_unknown / 2) : num_unknown) : 0;
+      const ptrdiff_t right_split =
+          (num_r == 0) ? (num_unknown - left_split) : 0;
+
+      if (left_split >= __sort_block_size) {
+        for (ptrdiff_t i = 0; i < __sort_block_size; ++i) {
+          offsets_l[num_l] = static_cast<unsigned char>(i);
+          num_l += !comp(*first, pivot);
+          ++first;
+        }
+      } else {
+        for (ptrdiff_t i = 0; i < left_split; ++i) {
+          offsets_l[num_l] = static_cast<unsigned char>(i);
+          num_l += !comp(*first, pivot);
+          ++first;
+        }
+      }
+
+      if (right_split >= __sort_block_size) {
+        for (ptrdiff_t i = 1; i <= __sort_block_size; ++i) {
+          offsets_r[num_r] = static_cast<unsigned char>(i);
+          num_r += comp(*--last, pivot);
+        }
+      } else {
+        for (ptrdiff_t i = 1; i <= right_split; ++i) {
+          offsets_r[num_r] = static_cast<unsigned char>(i);
+          num_r += comp(*--last, pivot);
+        }
+      }
+
+      const ptrdiff_t num = (num_l < num_r) ? num_l : num_r;
+      nanostl::__sort_swap_offsets(offsets_l_base, offsets_r_base,
+                                   offsets_l + start_l, offsets_r + start_r,
+                                   num, num_l == num_r);
+      num_l -= num;
+      num_r -= num;
+      start_l += num;
+      start_r += num;
+      if (num_l == 0) {
+        start_l = 0;
+        offsets_l_base = first;
+      }
+      if (num_r == 0) {
+        start_r = 0;
+        offsets_r_base = last;
+      }
+    }
+
+    // Leftover offsets on one side: move those elements to the boundary.
+    if (num_l) {
+      while (num_l--) {
+        nanostl::__sort_iter_swap(
+            offsets_l_base + offsets_l[start_l + num_l], --last);
+      }
+      first = last;
+    }
+    if (num_r) {
+      while (num_r--) {
+        nanostl::__sort_iter_swap(
+            offsets_r_base - offsets_r[start_r + num_r], first);
+        ++first;
+      }
+      last = first;
+    }
+  }
+
+  RandomIterator pivot_pos = first - 1;
+  *begin = nanostl::move(*pivot_pos);
+  *pivot_pos = nanostl::move(pivot);
+  return pair<RandomIterator, bool>(pivot_pos, already_partitioned);
+}
+
+template <class RandomIterator, class Compare>
+inline pair<RandomIterator, bool> __sort_partition(RandomIterator first,
+                                                   RandomIterator last,
+                                                   Compare& comp, true_type) {
+  return nanostl::__partition_right_branchless(first, last, comp);
+}
+
+template <class RandomIterator, class Compare>
+inline pair<RandomIterator, bool> __sort_partition(RandomIterator first,
+                                                   RandomIterator last,
+                                                   Compare& comp, false_type) {
+  return nanostl::__partition_right(first, last, comp);
+}
+
+// Partitions [first, last) around the pivot *first, putting elements equal
+// to it on the left. Used when the pivot equals the element before the
+// range, so the whole left part can be skipped.
+template <class RandomIterator, class Compare>
+RandomIterator __partition_left(RandomIterator first, RandomIterator last,
+                                Compare& comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  RandomIterator begin = first;
+  RandomIterator end = last;
+  T pivot(nanostl::move(*first));
+
+  while (comp(pivot, *--last)) {
+  }
+  if (last + 1 == end) {
+    while ((first < last) && !comp(pivot, *++first)) {
+    }
+  } else {
+    while (!comp(pivot, *++first)) {
+    }
+  }
+
+  while (first < last) {
+    nanostl::__sort_iter_swap(first, last);
+    while (comp(pivot, *--last)) {
+    }
+    while (!comp(pivot, *++first)) {
+    }
+  }
+
+  RandomIterator pivot_pos = last;
+  *begin = nanostl::move(*pivot_pos);
+  *pivot_pos = nanostl::move(pivot);
+  return pivot_pos;
+}
+
+// Breaks patterns which made the last partition unbalanced by swapping a
+// few elements of the part.
+template <class RandomIterator>
+inline void __sort_shuffle_left(RandomIterator first, RandomIterator pivot_pos,
+                                ptrdiff_t size) {
+  if (size >= __sort_insertion_threshold) {
+    nanostl::__sort_iter_swap(first, first + size / 4);
+    nanostl::__sort_iter_swap(pivot_pos - 1, pivot_pos - size / 4);
+    if (size > __sort_ninther_threshold) {
+      nanostl::__sort_iter_swap(first + 1, first + (size / 4 + 1));
+      nanostl::__sort_iter_swap(first + 2, first + (size / 4 + 2));
+      nanostl::__sort_iter_swap(pivot_pos - 2, pivot_pos - (size / 4 + 1));
+      nanostl::__sort_iter_swap(pivot_pos - 3, pivot_pos - (size / 4 + 2));
+    }
+  }
+}
+
+template <class RandomIterator>
+inline void __sort_shuffle_right(RandomIterator pivot_pos, RandomIterator last,
+                                 ptrdiff_t size) {
+  if (size >= __sort_insertion_threshold) {
+    nanostl::__sort_iter_swap(pivot_pos + 1, pivot_pos + (1 + size / 4));
+    nanostl::__sort_iter_swap(last - 1, last - size / 4);
+    if (size > __sort_ninther_threshold) {
+      nanostl::__sort_iter_swap(pivot_pos + 2, pivot_pos + (2 + size / 4));
+      nanostl::__sort_iter_swap(pivot_pos + 3, pivot_pos + (3 + size / 4));
+      nanostl::__sort_iter_swap(last - 2, last - (1 + size / 4));
+      nanostl::__sort_iter_swap(last - 3, last - (2 + size / 4));
+    }
+  }
+}
+
+inline int __sort_log2(ptrdiff_t n) {
+  int log = 0;
+  while (n >>= 1) {
+    ++log;
+  }
+  return log;
+}
+
+// `leftmost` is false when an element not greater than the whole range
+// precedes `first`.
+template <class RandomIterator, class Compare, class Branchless>
+void __pdqsort_loop(RandomIterator first, RandomIterator last, Compare& comp,
+                    int bad_allowed, bool leftmost, Branchless branchless) {
+  while (true) {
+    const ptrdiff_t size = last - first;
+    if (size < __sort_insertion_threshold) {
+      if (leftmost) {
+        nanostl::__insertion_sort(first, last, comp);
+      } else {
+        nanostl::__unguarded_insertion_sort(first, last, comp);
+      }
+      return;
+    }
+
+    nanostl::__sort_choose_pivot(first, last, comp);
+
+    // Many equal elements: the pivot equals the preceding element, so
+    // every element equal to it is already in place.
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      first = nanostl::__partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    const pair<RandomIterator, bool> part =
+        nanostl::__sort_partition(first, last, comp, branchless);
+    const RandomIterator pivot_pos = part.first;
+    const ptrdiff_t l_size = pivot_pos - first;
+    const ptrdiff_t r_size = last - (pivot_pos + 1);
+
+    if ((l_size < size / 8) || (r_size < size / 8)) {
+      if (--bad_allowed == 0) {
+        nanostl::__make_heap(first, size, comp);
+        nanostl::__sort_heap(first, size, comp);
+        return;
+      }
+      nanostl::__sort_shuffle_left(first, pivot_pos, l_size);
+      nanostl::__sort_shuffle_right(pivot_pos, last, r_size);
+    } else if (part.second &&
+               nanostl::__partial_insertion_sort(first, pivot_pos, comp) &&
+               nanostl::__partial_insertion_sort(pivot_pos + 1, last, comp)) {
+      // Nothing was swapped and both halves were nearly sorted.
+      return;
+    }
+
+    // Recurse into the left part, loop on the right one.
+    nanostl::__pdqsort_loop(first, pivot_pos, comp, bad_allowed, leftmost,
+                            branchless);
+    first = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+template <class RandomIterator, class Compare>
+void sort(RandomIterator first, RandomIterator last, Compare comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  if (last - first < 2) return;
+
+  nanostl::__pdqsort_loop(first, last, comp,
+                          nanostl::__sort_log2(last - first), true,
+                          __sort_is_branchless<T, Compare>());
+}
+
+template <class RandomIterator>
+void sort(RandomIterator first, RandomIterator last) {
+  nanostl::sort(first, last,
+                less<typename iterator_traits<RandomIterator>::value_type>());
+}
+
+template <class RandomIterator, class Compare>
+void partial_sort(RandomIterator first, RandomIterator middle,
+                  RandomIterator last, Compare comp) {
+  nanostl::__partial_sort(first, middle, last, comp);
+}
+
+template <class RandomIterator>
+void partial_sort(RandomIterator first, RandomIterator middle,
+                  RandomIterator last) {
+  less<typename iterator_traits<RandomIterator>::value_type> comp;
+  nanostl::__partial_sort(first, middle, last, comp);
+}
+
+// Introselect: quickselect with the pdqsort partitions, falling back to a
+// heap select when partitions keep being unbalanced.
+template <class RandomIterator, class Compare>
+void nth_element(RandomIterator first, RandomIterator nth,
+                 RandomIterator last, Compare comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  if (nth == last) return;
+
+  int bad_allowed = nanostl::__sort_log2(last - first);
+  bool leftmost = true;
+  while (last - first >= __sort_insertion_threshold) {
+    nanostl::__sort_choose_pivot(first, last, comp);
+
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      // [first, pivot_pos] all equal the preceding element.
+      const RandomIterator pivot_pos =
+          nanostl::__partition_left(first, last, comp);
+      if (nth <= pivot_pos) return;
+      first = pivot_pos + 1;
+      continue;
+    }
+
+    const ptrdiff_t size = last - first;
+    const RandomIterator pivot_pos =
+        nanostl::__sort_partition(first, last, comp,
+                                  __sort_is_branchless<T, Compare>())
+            .first;
+    if (nth == pivot_pos) return;
+
+    const ptrdiff_t l_size = pivot_pos - first;
+    const ptrdiff_t r_size = last - (pivot_pos + 1);
+    if ((l_size < size / 8) || (r_size < size / 8)) {
+      if (--bad_allowed == 0) {
+        nanostl::__partial_sort(first, nth + 1, last, comp);
+        return;
+      }
+      nanostl::__sort_shuffle_left(first, pivot_pos, l_size);
+      nanostl::__sort_shuffle_right(pivot_pos, last, r_size);
+    }
+
+    if (nth < pivot_pos) {
+      last = pivot_pos;
+    } else {
+      first = pivot_pos + 1;
+      leftmost = false;
+    }
+  }
+  nanostl::__insertion_sort(first, last, comp);
+}
+
+template <class RandomIterator>
+void nth_element(RandomIterator first, RandomIterator nth,
+                 RandomIterator last) {
+  nanostl::nth_element(
+      first, nth, last,
+      less<typename iterator_traits<RandomIterator>::value_type>());
+}
+
+// Uninitialized storage for the out-of-place sorts. The user constructs
+// the elements and reports how many with __set_size(), so the destructor
+// destroys exactly those.
+template <class T>
+class __temporary_buffer {
+ public:
+  explicit __temporary_buffer(size_t n)
+      : __p_(allocator<T>().allocate(n)), __capacity_(n), __size_(0) {}
+
+  ~__temporary_buffer() {
+    for (size_t i = 0; i < __size_; i++) {
+      __p_[i].~T();
+    }
+    allocator<T>().deallocate(__p_, __capacity_);
+  }
+
+  T* data() { return __p_; }
+
+  void __construct(size_t i, T&& v) {
+    ::new (__placement_tag(), __p_ + i) T(nanostl::move(v));
+  }
+
+  void __set_size(size_t n) { __size_ = n; }
+
+ private:
+  __temporary_buffer(const __temporary_buffer&);
+  __temporary_buffer& operator=(const __temporary_buffer&);
+
+  T* __p_;
+  size_t __capacity_;
+  size_t __size_;
+};
+
+// Stable merge of two sorted ranges, moving the elements to `out`. Ties
+// are taken from the first range.
+template <class InputIterator1, class InputIterator2, class OutputIterator,
+          class Compare>
+OutputIterator __merge_move(InputIterator1 first1, InputIterator1 last1,
+                            InputIterator2 first2, InputIterator2 last2,
+                            OutputIterator out, Compare& comp) {
+  while ((first1 != last1) && (first2 != last2)) {
+    if (comp(*first2, *first1)) {
+      *out = nanostl::move(*first2);
+      ++first2;
+    } else {
+      *out = nanostl::move(*first1);
+      ++first1;
+    }
+    ++out;
+  }
+  for (; first1 != last1; ++first1, ++out) {
+    *out = nanostl::move(*first1);
+  }
+  for (; first2 != last2; ++first2, ++out) {
+    *out = nanostl::move(*first2);
+  }
+  return out;
+}
+
+// Merges neighbouring sorted runs of `width` elements from `src` to `dst`.
+template <class Iterator1, class Iterator2, class Compare>
+void __merge_runs(Iterator1 src, Iterator2 dst, ptrdiff_t n, ptrdiff_t width,
+                  Compare& comp) {
+  for (ptrdiff_t b = 0; b < n; b += 2 * width) {
+    const ptrdiff_t m = (n - b > width) ? (b + width) : n;
+    const ptrdiff_t e = (n - m > width) ? (m + width) : n;
+    nanostl::__merge_move(src + b, src + m, src + m, src + e, dst + b, comp);
+  }
+}
+
+// Runs of this many elements are insertion sorted before merging.
+static const ptrdiff_t __stable_sort_run = 32;
+
+// Bottom-up merge sort. Merge passes alternate between the range and a
+// buffer of the same size.
+template <class RandomIterator, class Compare>
+void stable_sort(RandomIterator first, RandomIterator last, Compare comp) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  const ptrdiff_t n = last - first;
+  if (n <= __stable_sort_run) {
+    nanostl::__insertion_sort(first, last, comp);
+    return;
+  }
+
+  for (ptrdiff_t b = 0; b < n; b += __stable_sort_run) {
+    const ptrdiff_t e = (n - b > __stable_sort_run) ? (b + __stable_sort_run) : n;
+    nanostl::__insertion_sort(first + b, first + e, comp);
+  }
+
+  __temporary_buffer<T> buf(static_cast<size_t>(n));
+  T* tmp = buf.data();
+  for (ptrdiff_t i = 0; i < n; i++) {
+    buf.__construct(static_cast<size_t>(i), nanostl::move(first[i]));
+  }
+  buf.__set_size(static_cast<size_t>(n));
+
+  bool in_buffer = true;
+  for (ptrdiff_t width = __stable_sort_run; width < n; width *= 2) {
+    if (in_buffer) {
+      nanostl::__merge_runs(tmp, first, n, width, comp);
+    } else {
+      nanostl::__merge_runs(first, tmp, n, width, comp);
+    }
+    in_buffer = !in_buffer;
+  }
+
+  if (in_buffer) {
+    for (ptrdiff_t i = 0; i < n; i++) {
+      first[i] = nanostl::move(tmp[i]);
+    }
+  }
+}
+
+template <class RandomIterator>
+void stable_sort(RandomIterator first, RandomIterator last) {
+  nanostl::stable_sort(
+      first, last,
+      less<typename iterator_traits<RandomIterator>::value_type>());
+}
+
+//
+// Radix sort(not a std component). Stable LSD sort with 8 bit digits for
+// integer and floating point keys. One pass computes the histograms of all
+// digits, and digits which are the same for every key are skipped(e.g. the
+// upper bytes of 30 bit Morton codes).
+//
+
+template <size_t N>
+struct __radix_uint;
+template <>
+struct __radix_uint<1> {
+  typedef unsigned char type;
+};
+template <>
+struct __radix_uint<2> {
+  typedef unsigned short type;
+};
+template <>
+struct __radix_uint<4> {
+  typedef unsigned int type;
+};
+template <>
+struct __radix_uint<8> {
+  typedef unsigned long long type;
+};
+
+// Maps a key to an unsigned integer with the same ordering.
+template <class T, bool = is_floating_point<T>::value,
+          bool = is_signed<T>::value>
+struct __radix_key {
+  typedef typename __radix_uint<sizeof(T)>::type type;
+  static type get(T x) { return type(x); }
+};
+
+// Signed integers: flip the sign bit.
+template <class T>
+struct __radix_key<T, false, true> {
+  typedef typename __radix_uint<sizeof(T)>::type type;
+  static type get(T x) {
+    return type(x) ^ type(type(1) << (8 * sizeof(T) - 1));
+  }
+};
+
+// Floating point: flip every bit of negative values, and the sign bit of
+// positive ones. -0.0 sorts before +0.0, NaNs go to the ends by sign.
+template <class T>
+struct __radix_key<T, true, true> {
+  typedef typename __radix_uint<sizeof(T)>::type type;
+  static type get(T x) {
+    union {
+      T f;
+      type u;
+    } bits;
+    bits.f = x;
+    const type sign = type(type(1) << (8 * sizeof(T) - 1));
+    return bits.u ^ ((bits.u & sign) ? type(~type(0)) : sign);
+  }
+};
+
+struct __radix_identity {
+  template <class T>
+  const T& operator()(const T& x) const {
+    return x;
+  }
+};
+
+// Ranges shorter than this are sorted with stable_sort.
+static const ptrdiff_t __radix_sort_min = 256;
+
+// Sorts [first, last) by `key(element)`, which must return an integer or
+// floating point value. Equal keys keep their order.
+template <class RandomIterator, class KeyFunction>
+void radix_sort(RandomIterator first, RandomIterator last, KeyFunction key) {
+  typedef typename iterator_traits<RandomIterator>::value_type T;
+  typedef typename remove_cv<typename remove_reference<decltype(
+      key(*first))>::type>::type K;
+  typedef __radix_key<K> traits;
+  typedef typename traits::type U;
+  const size_t digits = sizeof(U);
+
+  const ptrdiff_t n = last - first;
+  if (n < __radix_sort_min) {
+    nanostl::stable_sort(first, last, [&key](const T& a, const T& b) {
+      return traits::get(key(a)) < traits::get(key(b));
+    });
+    return;
+  }
+
+  size_t counts[digits][256];
+  for (size_t d = 0; d < digits; d++) {
+    for (size_t i = 0; i < 256; i++) {
+      counts[d][i] = 0;
+    }
+  }
+  for (ptrdiff_t i = 0; i < n; i++) {
+    const U k = traits::get(key(first[i]));
+    for (size_t d = 0; d < digits; d++) {
+      counts[d][(k >> (8 * d)) & 0xff]++;
+    }
+  }
+
+  __temporary_buffer<T> buf(static_cast<size_t>(n));
+  T* tmp = buf.data();
+  bool in_buffer = false;
+  bool constructed = false;
+
+  const U k0 = traits::get(key(first[0]));
+  for (size_t d = 0; d < digits; d++) {
+    const unsigned shift = unsigned(8 * d);
+    if (counts[d][(k0 >> shift) & 0xff] == size_t(n)) {
+      continue;
+    }
+
+    // Exclusive prefix sum: bucket start offsets.
+    size_t offset = 0;
+    for (size_t i = 0; i < 256; i++) {
+      const size_t c = counts[d][i];
+      counts[d][i] = offset;
+      offset += c;
+    }
+
+    size_t* pos = counts[d];
+    if (in_buffer) {
+      for (ptrdiff_t i = 0; i < n; i++) {
+        const U k = traits::get(key(tmp[i]));
+        first[ptrdiff_t(pos[(k >> shift) & 0xff]++)] = nanostl::move(tmp[i]);
+      }
+    } else if (constructed) {
+      for (ptrdiff_t i = 0; i < n; i++) {
+        const U k = traits::get(key(first[i]));
+        tmp[pos[(k >> shift) & 0xff]++] = nanostl::move(first[i]);
+      }
+    } else {
+      for (ptrdiff_t i = 0; i < n; i++) {
+        const U k = traits::get(key(first[i]));
+        buf.__construct(pos[(k >> shift) & 0xff]++, nanostl::move(first[i]));
+      }
+      buf.__set_size(static_cast<size_t>(n));
+      constructed = true;
+    }
+    in_buffer = !in_buffer;
+  }
+
+  if (in_buffer) {
+    for (ptrdiff_t i = 0; i < n; i++) {
+      first[i] = nanostl::move(tmp[i]);
+    }
+  }
+}
+
+template <class RandomIterator>
+void radix_sort(RandomIterator first, RandomIterator last) {
+  nanostl::radix_sort(first, last, __radix_identity());
+}
 
 #if defined(NANOSTL_PSTL)
 template <class ExecutionPolicy, class ForwardIterator, class T>
-void fill(ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
-          const T& value) {
-  // TODO: Implement
+__pstl::__enable_if_policy_t<ExecutionPolicy, void> fill(
+    ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+    const T& value) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__is_random_access_iterator<ForwardIterator>::value) {
+    typedef typename iterator_traits<ForwardIterator>::difference_type diff_t;
+    __pstl::__for_chunks<policy>(
+        size_t(last - first), [first, &value](size_t b, size_t e) {
+          ForwardIterator it = first + diff_t(b);
+          __pstl::__loop<policy>(
+              e - b, [it, &value](size_t i) { it[diff_t(i)] = value; });
+        });
+  } else {
+    nanostl::fill(first, last, value);
+  }
+}
+
+//
+// The policy overloads below need random access iterators to split the
+// range. Otherwise they run the serial version on the calling thread.
+// Callables are shared(not copied) by the chunks, so they must be safe to
+// call concurrently under a parallel policy.
+//
+
+template <class ExecutionPolicy, class ForwardIterator, class UnaryFunction>
+__pstl::__enable_if_policy_t<ExecutionPolicy, void> for_each(
+    ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+    UnaryFunction f) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__is_random_access_iterator<ForwardIterator>::value) {
+    typedef typename iterator_traits<ForwardIterator>::difference_type diff_t;
+    __pstl::__for_chunks<policy>(
+        size_t(last - first), [first, &f](size_t b, size_t e) {
+          ForwardIterator it = first + diff_t(b);
+          __pstl::__loop<policy>(e - b,
+                                 [it, &f](size_t i) { f(it[diff_t(i)]); });
+        });
+  } else {
+    nanostl::for_each(first, last, f);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class UnaryOperation>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> transform(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first, UnaryOperation op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value) {
+    typedef typename iterator_traits<ForwardIterator1>::difference_type diff_t;
+    const size_t n = size_t(last - first);
+    __pstl::__for_chunks<policy>(n, [first, d_first, &op](size_t b, size_t e) {
+      ForwardIterator1 in = first + diff_t(b);
+      ForwardIterator2 out = d_first + diff_t(b);
+      __pstl::__loop<policy>(e - b, [in, out, &op](size_t i) {
+        out[diff_t(i)] = op(in[diff_t(i)]);
+      });
+    });
+    return d_first + diff_t(n);
+  } else {
+    return nanostl::transform(first, last, d_first, op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3,
+          class BinaryOperation>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator3> transform(
+    ExecutionPolicy&& exec, ForwardIterator1 first1, ForwardIterator1 last1,
+    ForwardIterator2 first2, ForwardIterator3 d_first, BinaryOperation op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value &&
+                __is_random_access_iterator<ForwardIterator3>::value) {
+    typedef typename iterator_traits<ForwardIterator1>::difference_type diff_t;
+    const size_t n = size_t(last1 - first1);
+    __pstl::__for_chunks<policy>(
+        n, [first1, first2, d_first, &op](size_t b, size_t e) {
+          ForwardIterator1 in1 = first1 + diff_t(b);
+          ForwardIterator2 in2 = first2 + diff_t(b);
+          ForwardIterator3 out = d_first + diff_t(b);
+          __pstl::__loop<policy>(e - b, [in1, in2, out, &op](size_t i) {
+            out[diff_t(i)] = op(in1[diff_t(i)], in2[diff_t(i)]);
+          });
+        });
+    return d_first + diff_t(n);
+  } else {
+    return nanostl::transform(first1, last1, first2, d_first, op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> copy(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value) {
+    typedef typename iterator_traits<ForwardIterator1>::difference_type diff_t;
+    const size_t n = size_t(last - first);
+    __pstl::__for_chunks<policy>(n, [first, d_first](size_t b, size_t e) {
+      ForwardIterator1 in = first + diff_t(b);
+      ForwardIterator2 out = d_first + diff_t(b);
+      __pstl::__loop<policy>(
+          e - b, [in, out](size_t i) { out[diff_t(i)] = in[diff_t(i)]; });
+    });
+    return d_first + diff_t(n);
+  } else {
+    return nanostl::copy(first, last, d_first);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class UnaryPredicate>
+__pstl::__enable_if_policy_t<
+    ExecutionPolicy, typename iterator_traits<ForwardIterator>::difference_type>
+count_if(ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+         UnaryPredicate p) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+  typedef typename iterator_traits<ForwardIterator>::difference_type diff_t;
+
+  if constexpr (__is_random_access_iterator<ForwardIterator>::value) {
+    const __pstl::__chunks chunks =
+        __pstl::__make_chunks<policy>(size_t(last - first));
+    vector<diff_t> counts;
+    counts.resize(chunks.count);
+    __pstl::__for_each_chunk(
+        chunks, [first, &p, &counts](size_t c, size_t b, size_t e) {
+          ForwardIterator it = first + diff_t(b);
+          diff_t n = 0;
+          __pstl::__loop<policy>(
+              e - b, [it, &p, &n](size_t i) { n += p(it[diff_t(i)]) ? 1 : 0; });
+          counts[c] = n;
+        });
+    diff_t n = 0;
+    for (size_t c = 0; c < chunks.count; c++) {
+      n += counts[c];
+    }
+    return n;
+  } else {
+    return nanostl::count_if(first, last, p);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class UnaryPredicate>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator> find_if(
+    ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+    UnaryPredicate p) {
   (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__is_random_access_iterator<ForwardIterator>::value) {
+    typedef typename iterator_traits<ForwardIterator>::difference_type diff_t;
+    const __pstl::__chunks chunks =
+        __pstl::__make_chunks<policy>(size_t(last - first));
+    if (chunks.count <= 1) {
+      return nanostl::find_if(first, last, p);
+    }
+    // Chunks after the first one with a match stop early. Every chunk
+    // before it is scanned to the end, so the match found is the first.
+    __pstl::__shared_min found(int(chunks.count));
+    vector<size_t> pos;
+    pos.resize(chunks.count);
+    __pstl::__for_each_chunk(
+        chunks, [first, &p, &found, &pos](size_t c, size_t b, size_t e) {
+          const int ci = int(c);
+          for (size_t i = b; i < e; i++) {
+            if ((((i - b) & 1023) == 0) && (found.load() < ci)) {
+              return;
+            }
+            if (p(first[diff_t(i)])) {
+              pos[c] = i;
+              found.update(ci);
+              return;
+            }
+          }
+        });
+    const size_t c = size_t(found.load());
+    return (c < chunks.count) ? (first + diff_t(pos[c])) : last;
+  } else {
+    return nanostl::find_if(first, last, p);
+  }
+}
+
+//
+// Parallel sort: every chunk is sorted on the pool, then neighbouring runs
+// are merged in rounds, alternating between the range and a buffer. Each
+// round splits the output into the same chunks and finds where a chunk
+// starts in the two input runs by binary search(merge path), so the last
+// rounds, which merge a few long runs, still use every thread. The merge
+// is stable, so stable_sort only needs stable chunk sorts.
+//
+
+namespace __pstl {
+
+// Number of elements taken from `a` among the first k elements of the
+// stable merge of a[0, na) and b[0, nb).
+template <class _It, class _Compare>
+size_t __merge_path(_It __a, size_t __na, _It __b, size_t __nb, size_t __k,
+                    _Compare &__comp) {
+  typedef typename iterator_traits<_It>::difference_type diff_t;
+  size_t __lo = (__k > __nb) ? (__k - __nb) : 0;
+  size_t __hi = (__k < __na) ? __k : __na;
+  while (__lo < __hi) {
+    const size_t __mid = __lo + (__hi - __lo) / 2;
+    if (!__comp(__b[diff_t(__k - __mid - 1)], __a[diff_t(__mid)])) {
+      __lo = __mid + 1;
+    } else {
+      __hi = __mid;
+    }
+  }
+  return __lo;
+}
+
+// Merges neighbouring sorted runs of `width` elements from `src` to `dst`,
+// the output split into `chunks`. `split` holds one entry per chunk.
+template <class _Src, class _Dst, class _Compare>
+void __merge_round(_Src __src, _Dst __dst, const __chunks &__c, size_t __width,
+                   vector<size_t> &__split, _Compare &__comp) {
+  typedef typename iterator_traits<_Src>::difference_type diff_t;
+  const size_t __n = __c.n;
+  const size_t __pair = 2 * __width;
+
+  // Where every chunk starts in the first run of its pair. All of them are
+  // found before any element is moved out of `src`.
+  __for_each_chunk(__c, [__src, __n, __width, __pair, &__split,
+                         &__comp](size_t __k, size_t __b, size_t) {
+    const size_t __p = __b / __pair * __pair;
+    const size_t __m = (__n - __p > __width) ? (__p + __width) : __n;
+    const size_t __pe = (__n - __m > __width) ? (__m + __width) : __n;
+    __split[__k] = __merge_path(__src + diff_t(__p), __m - __p,
+                                __src + diff_t(__m), __pe - __m, __b - __p,
+                                __comp);
+  });
 
-  fill(first, last, value);
+  __for_each_chunk(__c, [__src, __dst, &__c, __width, __pair, &__split,
+                         &__comp](size_t __k, size_t __b, size_t __e) {
+    // Every pair of runs overlapping the output chunk [b, e).
+    for (size_t __p = __b / __pair * __pair; __p < __e; __p += __pair) {
+      const size_t __m = (__c.n - __p > __width) ? (__p + __width) : __c.n;
+      const size_t __pe = (__c.n - __m > __width) ? (__m + __width) : __c.n;
+      const size_t __k0 = (__b > __p) ? (__b - __p) : 0;
+      const size_t __k1 = ((__e < __pe) ? __e : __pe) - __p;
+      const size_t __i0 = (__b > __p) ? __split[__k] : 0;
+      const size_t __i1 = (__e < __pe) ? __split[__k + 1] : (__m - __p);
+      const _Src __a = __src + diff_t(__p);
+      const _Src __a2 = __src + diff_t(__m);
+      nanostl::__merge_move(__a + diff_t(__i0), __a + diff_t(__i1),
+                            __a2 + diff_t(__k0 - __i0),
+                            __a2 + diff_t(__k1 - __i1),
+                            __dst + diff_t(__p + __k0), __comp);
+    }
+  });
+}
+
+template <class _Pp, bool _Stable, class _RandomIterator, class _Compare>
+void __sort(_RandomIterator __first, _RandomIterator __last,
+            _Compare &__comp) {
+  typedef typename iterator_traits<_RandomIterator>::value_type _Tp;
+  typedef typename iterator_traits<_RandomIterator>::difference_type diff_t;
+  const __chunks __c = __make_chunks<_Pp>(size_t(__last - __first));
+  if (__c.count <= 1) {
+    if constexpr (_Stable) {
+      nanostl::stable_sort(__first, __last, __comp);
+    } else {
+      nanostl::sort(__first, __last, __comp);
+    }
+    return;
   }
+
+  __temporary_buffer<_Tp> __buf(__c.n);
+  _Tp *__tmp = __buf.data();
+  __for_each_chunk(__c, [__first, &__buf, &__comp](size_t, size_t __b,
+                                                   size_t __e) {
+    if constexpr (_Stable) {
+      nanostl::stable_sort(__first + diff_t(__b), __first + diff_t(__e),
+                           __comp);
+    } else {
+      nanostl::sort(__first + diff_t(__b), __first + diff_t(__e), __comp);
+    }
+    for (size_t __i = __b; __i < __e; __i++) {
+      __buf.__construct(__i, nanostl::move(__first[diff_t(__i)]));
+    }
+  });
+  __buf.__set_size(__c.n);
+
+  vector<size_t> __split;
+  __split.resize(__c.count);
+  bool __in_buffer = true;
+  for (size_t __width = __c.grain; __width < __c.n; __width *= 2) {
+    if (__in_buffer) {
+      __merge_round(__tmp, __first, __c, __width, __split, __comp);
+    } else {
+      __merge_round(__first, __tmp, __c, __width, __split, __comp);
+    }
+    __in_buffer = !__in_buffer;
+  }
+
+  if (__in_buffer) {
+    __for_each_chunk(__c, [__first, __tmp](size_t, size_t __b, size_t __e) {
+      for (size_t __i = __b; __i < __e; __i++) {
+        __first[diff_t(__i)] = nanostl::move(__tmp[__i]);
+      }
+    });
+  }
+}
+
+} // namespace __pstl
+
+template <class ExecutionPolicy, class RandomIterator, class Compare>
+__pstl::__enable_if_policy_t<ExecutionPolicy, void> sort(
+    ExecutionPolicy&& exec, RandomIterator first, RandomIterator last,
+    Compare comp) {
+  (void)exec;
+  __pstl::__sort<__pstl::__policy_t<ExecutionPolicy>, false>(first, last,
+                                                             comp);
+}
+
+template <class ExecutionPolicy, class RandomIterator>
+__pstl::__enable_if_policy_t<ExecutionPolicy, void> sort(
+    ExecutionPolicy&& exec, RandomIterator first, RandomIterator last) {
+  nanostl::sort(exec, first, last,
+                less<typename iterator_traits<RandomIterator>::value_type>());
+}
+
+template <class ExecutionPolicy, class RandomIterator, class Compare>
+__pstl::__enable_if_policy_t<ExecutionPolicy, void> stable_sort(
+    ExecutionPolicy&& exec, RandomIterator first, RandomIterator last,
+    Compare comp) {
+  (void)exec;
+  __pstl::__sort<__pstl::__policy_t<ExecutionPolicy>, true>(first, last,
+                                                            comp);
+}
+
+template <class ExecutionPolicy, class RandomIterator>
+__pstl::__enable_if_policy_t<ExecutionPolicy, void> stable_sort(
+    ExecutionPolicy&& exec, RandomIterator first, RandomIterator last) {
+  nanostl::stable_sort(
+      exec, first, last,
+      less<typename iterator_traits<RandomIterator>::value_type>());
+}
 #endif
 
 }  // namespace nanostl
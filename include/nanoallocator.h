@@ -37,6 +37,23 @@ namespace nanostl {
 
 typedef unsigned long long size_type;
 
+// Tag type for placement new. nanostl does not include <new>, and a tagged
+// overload cannot collide with the standard one when user code does.
+struct __placement_tag {};
+
+}  // namespace nanostl
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void* operator new(decltype(sizeof(0)), nanostl::__placement_tag,
+                          void* p) {
+  return p;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void operator delete(void*, nanostl::__placement_tag, void*) {}
+
+namespace nanostl {
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #if __has_warning("-Wzero-as-null-pointer-constant")
@@ -47,6 +64,10 @@ typedef unsigned long long size_type;
 ///
 /// allocator class implementaion without libc function
 ///
+/// `allocate` returns raw storage. Objects are created and destroyed
+/// separately with `construct` and `destroy`, so only the elements which
+/// are actually used are constructed.
+///
 template <typename T>
 class allocator {
  public:
@@ -55,15 +76,28 @@ class allocator {
   typedef const T* const_pointer;
   typedef T& reference;
   typedef const T& const_reference;
+  typedef nanostl::size_type size_type;
+
+  template <class U>
+  struct rebind {
+    typedef allocator<U> other;
+  };
 
   NANOSTL_HOST_AND_DEVICE_QUAL allocator() {}
 
+  template <class U>
+  NANOSTL_HOST_AND_DEVICE_QUAL allocator(const allocator<U>&) {}
+
   NANOSTL_HOST_AND_DEVICE_QUAL T* allocate(size_type n, const void* hint = 0) {
     (void)hint;  // Ignore `hint' for a while.
     if (n < 1) {
       return 0;
     }
 
+    if (n > max_size()) {
+      return 0;
+    }
+
 #ifdef NANOSTL_DEBUG
 #if defined(__CUDACC__)
     printf("allocator::allocate: %u\n", n);
@@ -72,15 +106,120 @@ class allocator {
 #endif
 #endif
 
-    return new T[n];
+    return static_cast<T*>(::operator new(n * sizeof(T)));
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL void deallocate(T* p, size_type n) {
     (void)n;
-    delete[] p;
+    ::operator delete(p);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL size_type max_size() const {
+    return (~size_type(0)) / sizeof(T);
+  }
+
+  template <class U, class... Args>
+  NANOSTL_HOST_AND_DEVICE_QUAL void construct(U* p, Args&&... args) {
+    ::new (__placement_tag(), p) U(static_cast<Args&&>(args)...);
+  }
+
+  template <class U>
+  NANOSTL_HOST_AND_DEVICE_QUAL void destroy(U* p) {
+    p->~U();
+  }
+
+ private:
+};
+
+template <class T, class U>
+NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator==(const allocator<T>&,
+                                                    const allocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator!=(const allocator<T>&,
+                                                    const allocator<U>&) {
+  return false;
+}
+
+///
+/// Uniform interface to allocators. `construct` and `destroy` fall back to
+/// placement new and a destructor call when the allocator does not provide
+/// them.
+///
+template <class Alloc>
+struct allocator_traits {
+  typedef Alloc allocator_type;
+  typedef typename Alloc::value_type value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef nanostl::size_type size_type;
+
+  template <class U>
+  struct rebind_alloc {
+    typedef typename Alloc::template rebind<U>::other other;
+  };
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static pointer allocate(Alloc& a, size_type n) { return a.allocate(n); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void deallocate(Alloc& a, pointer p, size_type n) {
+    a.deallocate(p, n);
   }
 
+  template <class U, class... Args>
+  NANOSTL_HOST_AND_DEVICE_QUAL static void construct(Alloc& a, U* p,
+                                                     Args&&... args) {
+    __construct(0, a, p, static_cast<Args&&>(args)...);
+  }
+
+  template <class U>
+  NANOSTL_HOST_AND_DEVICE_QUAL static void destroy(Alloc& a, U* p) {
+    __destroy(0, a, p);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type max_size(const Alloc& a) { return __max_size(0, a); }
+
  private:
+  // `int` overloads are preferred and drop out by SFINAE when the
+  // allocator lacks the member.
+  template <class A, class U, class... Args>
+  NANOSTL_HOST_AND_DEVICE_QUAL static auto __construct(int, A& a, U* p,
+                                                       Args&&... args)
+      -> decltype(a.construct(p, static_cast<Args&&>(args)...)) {
+    a.construct(p, static_cast<Args&&>(args)...);
+  }
+
+  template <class A, class U, class... Args>
+  NANOSTL_HOST_AND_DEVICE_QUAL static void __construct(long, A&, U* p,
+                                                       Args&&... args) {
+    ::new (__placement_tag(), p) U(static_cast<Args&&>(args)...);
+  }
+
+  template <class A, class U>
+  NANOSTL_HOST_AND_DEVICE_QUAL static auto __destroy(int, A& a, U* p)
+      -> decltype(a.destroy(p)) {
+    a.destroy(p);
+  }
+
+  template <class A, class U>
+  NANOSTL_HOST_AND_DEVICE_QUAL static void __destroy(long, A&, U* p) {
+    p->~U();
+  }
+
+  template <class A>
+  NANOSTL_HOST_AND_DEVICE_QUAL static auto __max_size(int, const A& a)
+      -> decltype(a.max_size()) {
+    return a.max_size();
+  }
+
+  template <class A>
+  NANOSTL_HOST_AND_DEVICE_QUAL static size_type __max_size(long, const A&) {
+    return (~size_type(0)) / sizeof(value_type);
+  }
 };
 
 #ifdef __clang__
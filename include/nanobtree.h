@@ -0,0 +1,1138 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_BTREE_H_
+#define NANOSTL_BTREE_H_
+
+#include "nanoallocator.h"
+#include "nanofunctional.h"  // nanostl::less
+#include "nanotype_traits.h"
+#include "nanoutility.h"  // nanostl::pair
+#include "nanovector.h"
+
+//
+// B+tree based ordered containers: btree_map and btree_set.
+//
+// Each node holds up to kNodeSlots keys in one contiguous array, so a lookup
+// touches a few cache lines per level instead of one node per comparison.
+// Elements live in the leaves, which are linked for iteration.
+//
+// Unlike nanostl::map, insert and erase invalidate all iterators.
+//
+
+namespace nanostl {
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+// Tag for the bulk-load constructors: the input is sorted by the key
+// comparator and contains no duplicate keys.
+struct sorted_unique_t {
+  explicit constexpr sorted_unique_t() {}
+};
+
+constexpr sorted_unique_t sorted_unique = sorted_unique_t();
+
+// Uninitialized storage for N objects of type V.
+template <class V, int N>
+struct __btree_slots {
+  alignas(V) unsigned char buf[sizeof(V) * N];
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  V* ptr() { return reinterpret_cast<V*>(buf); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const V* ptr() const { return reinterpret_cast<const V*>(buf); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  V& operator[](int i) { return ptr()[i]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const V& operator[](int i) const { return ptr()[i]; }
+};
+
+template <class Key, class T, class Compare, class Allocator>
+struct __btree_map_params {
+  typedef Key key_type;
+  typedef nanostl::pair<const Key, T> value_type;
+  typedef value_type& reference;
+  typedef value_type* pointer;
+  typedef Compare key_compare;
+  typedef Allocator allocator_type;
+
+  // Leaves keep a copy of each key next to the value so that the key array
+  // stays contiguous.
+  typedef value_type slot_type;
+  enum { kSeparateValues = 1 };
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static const Key& key(const value_type& v) { return v.first; }
+};
+
+template <class Key, class Compare, class Allocator>
+struct __btree_set_params {
+  typedef Key key_type;
+  typedef Key value_type;
+  typedef const Key& reference;
+  typedef const Key* pointer;
+  typedef Compare key_compare;
+  typedef Allocator allocator_type;
+
+  typedef Key slot_type;
+  enum { kSeparateValues = 0 };
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static const Key& key(const value_type& v) { return v; }
+};
+
+template <class Params>
+class __btree {
+ public:
+  typedef typename Params::key_type key_type;
+  typedef typename Params::value_type value_type;
+  typedef typename Params::reference reference;
+  typedef const value_type& const_reference;
+  typedef typename Params::pointer pointer;
+  typedef const value_type* const_pointer;
+  typedef typename Params::key_compare key_compare;
+  typedef typename Params::allocator_type allocator_type;
+  typedef nanostl::size_type size_type;
+
+  // Aim for 256 bytes of keys per node, with at least 8 and at most 64 slots.
+  enum {
+    kNodeSlots = (256 / sizeof(key_type) < 8)
+                     ? 8
+                     : ((256 / sizeof(key_type) > 64) ? 64
+                                                      : 256 / sizeof(key_type)),
+    kMinSlots = kNodeSlots / 2
+  };
+
+ private:
+  typedef typename Params::slot_type slot_type;
+  typedef integral_constant<bool, Params::kSeparateValues != 0> separate_values;
+
+  struct inner_node;
+
+  struct node {
+    inner_node* parent;
+    int count;  // number of keys
+    bool leaf;
+  };
+
+  struct leaf_node : node {
+    __btree_slots<key_type, kNodeSlots> keys;
+    __btree_slots<slot_type, Params::kSeparateValues ? kNodeSlots : 1> vals;
+    leaf_node* prev;
+    leaf_node* next;
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    leaf_node() : prev(0), next(0) {
+      this->parent = 0;
+      this->count = 0;
+      this->leaf = true;
+    }
+  };
+
+  // ch[i] holds keys less than keys[i]; ch[i + 1] holds keys not less
+  // than keys[i].
+  struct inner_node : node {
+    __btree_slots<key_type, kNodeSlots> keys;
+    node* ch[kNodeSlots + 1];
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    inner_node() {
+      this->parent = 0;
+      this->count = 0;
+      this->leaf = false;
+    }
+  };
+
+  typedef typename nanostl::allocator_traits<allocator_type>::
+      template rebind_alloc<leaf_node>::other leaf_allocator_type;
+  typedef typename nanostl::allocator_traits<allocator_type>::
+      template rebind_alloc<inner_node>::other inner_allocator_type;
+  // Scratch buffers(bulk load) come from the container's allocator too.
+  typedef typename nanostl::allocator_traits<allocator_type>::
+      template rebind_alloc<node*>::other node_ptr_allocator_type;
+  typedef nanostl::vector<node*, node_ptr_allocator_type> node_ptr_vector;
+
+ public:
+  class const_iterator;
+
+  class iterator {
+    friend class __btree;
+    friend class const_iterator;
+
+    const __btree* t;
+    leaf_node* l;
+    int i;
+
+   public:
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator(const __btree* _t = 0, leaf_node* _l = 0, int _i = 0)
+        : t(_t), l(_l), i(_i) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator& operator++() {
+      if (++i == l->count) {
+        l = l->next;
+        i = 0;
+      }
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator operator++(int) {
+      iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    // --end() yields the largest element.
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator& operator--() {
+      if (!l) {
+        l = t->__rightmost_leaf();
+        i = l->count - 1;
+      } else if (i == 0) {
+        l = l->prev;
+        i = l->count - 1;
+      } else {
+        i--;
+      }
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator operator--(int) {
+      iterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    reference operator*() const { return __value(l, i, separate_values()); }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    pointer operator->() const { return &(__value(l, i, separate_values())); }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator==(const iterator& rhs) const {
+      return (l == rhs.l) && (i == rhs.i);
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+  };
+
+  class const_iterator {
+    friend class __btree;
+
+    const __btree* t;
+    const leaf_node* l;
+    int i;
+
+   public:
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator(const __btree* _t = 0, const leaf_node* _l = 0, int _i = 0)
+        : t(_t), l(_l), i(_i) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator(const iterator& it) : t(it.t), l(it.l), i(it.i) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator& operator++() {
+      if (++i == l->count) {
+        l = l->next;
+        i = 0;
+      }
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator& operator--() {
+      if (!l) {
+        l = t->__rightmost_leaf();
+        i = l->count - 1;
+      } else if (i == 0) {
+        l = l->prev;
+        i = l->count - 1;
+      } else {
+        i--;
+      }
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator operator--(int) {
+      const_iterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_reference operator*() const {
+      return __value(const_cast<leaf_node*>(l), i, separate_values());
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_pointer operator->() const { return &(**this); }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator==(const const_iterator& rhs) const {
+      return (l == rhs.l) && (i == rhs.i);
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+  };
+
+  typedef pair<iterator, bool> pair_iterator_bool;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit __btree(const key_compare& comp = key_compare(),
+                   const allocator_type& alloc = allocator_type())
+      : root_(0), size_(0), comp_(comp), alloc_(alloc) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __btree(const __btree& rhs)
+      : root_(0), size_(0), comp_(rhs.comp_), alloc_(rhs.alloc_) {
+    __bulk_load(rhs.begin(), rhs.end());
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __btree(__btree&& rhs)
+      : root_(rhs.root_), size_(rhs.size_), comp_(rhs.comp_),
+        alloc_(rhs.alloc_) {
+    rhs.root_ = 0;
+    rhs.size_ = 0;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  ~__btree() { __free_tree(root_); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  __btree& operator=(const __btree& rhs) {
+    if (this != &rhs) {
+      clear();
+      comp_ = rhs.comp_;
+      __bulk_load(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  allocator_type get_allocator() const { return alloc_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  key_compare key_comp() const { return comp_; }
+
+  // accessors:
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator begin() { return iterator(this, __leftmost_leaf(), 0); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator begin() const {
+    return const_iterator(this, __leftmost_leaf(), 0);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator end() { return iterator(this, 0, 0); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator end() const { return const_iterator(this, 0, 0); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool empty() const { return size_ == 0; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type size() const { return size_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void clear() {
+    __free_tree(root_);
+    root_ = 0;
+    size_ = 0;
+  }
+
+  // insert/erase
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  pair_iterator_bool insert(const value_type& x) {
+    const key_type& key = Params::key(x);
+
+    if (!root_) {
+      root_ = __new_leaf();
+    }
+
+    // Split full nodes on the way down so the parent always has room for
+    // a new separator.
+    if (root_->count == kNodeSlots) {
+      inner_node* r = __new_inner();
+      r->ch[0] = root_;
+      root_->parent = r;
+      root_ = r;
+      __split_child(r, 0);
+    }
+
+    node* n = root_;
+    while (!n->leaf) {
+      inner_node* in = static_cast<inner_node*>(n);
+      int j = __upper(in->keys.ptr(), in->count, key);
+      if (in->ch[j]->count == kNodeSlots) {
+        __split_child(in, j);
+        if (!comp_(key, in->keys[j])) j++;
+      }
+      n = in->ch[j];
+    }
+
+    leaf_node* l = static_cast<leaf_node*>(n);
+    int i = __lower(l->keys.ptr(), l->count, key);
+    if ((i < l->count) && !comp_(key, l->keys[i])) {
+      return make_pair(iterator(this, l, i), false);
+    }
+
+    __leaf_move(l, i + 1, l, i, l->count - i);
+    __leaf_construct(l, i, x, separate_values());
+    l->count++;
+    size_++;
+
+    return make_pair(iterator(this, l, i), true);
+  }
+
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL void insert(InputIterator first,
+                                           InputIterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  // Returns the iterator following the removed element.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(iterator pos) {
+    leaf_node* l = pos.l;
+    int i = pos.i;
+
+    if ((l->count > kMinSlots) || ((l == root_) && (l->count > 1))) {
+      // No rebalancing, so the following element just slides into `i`.
+      __leaf_erase(l, i);
+      size_--;
+      return (i < l->count) ? iterator(this, l, i) : iterator(this, l->next, 0);
+    }
+
+    key_type key(l->keys[i]);
+    erase(key);
+    return lower_bound(key);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(iterator first, iterator last) {
+    if ((first == begin()) && (last == end())) {
+      clear();
+      return end();
+    }
+    // Iterators do not survive rebalancing, so track the end by key.
+    if (last == end()) {
+      while (first != end()) {
+        first = erase(first);
+      }
+      return end();
+    }
+    key_type stop(last.l->keys[last.i]);
+    while (comp_(first.l->keys[first.i], stop)) {
+      first = erase(first);
+    }
+    return first;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type erase(const key_type& key) {
+    if (!root_) return 0;
+    leaf_node* l = __find_leaf(key);
+    int i = __lower(l->keys.ptr(), l->count, key);
+    if ((i == l->count) || comp_(key, l->keys[i])) return 0;
+
+    __leaf_erase(l, i);
+    size_--;
+    __rebalance(l);
+    return 1;
+  }
+
+  // map operations:
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator find(const key_type& key) {
+    const_iterator it = static_cast<const __btree*>(this)->find(key);
+    return iterator(this, const_cast<leaf_node*>(it.l), it.i);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator find(const key_type& key) const {
+    if (!root_) return end();
+    leaf_node* l = __find_leaf(key);
+    int i = __lower(l->keys.ptr(), l->count, key);
+    if ((i == l->count) || comp_(key, l->keys[i])) return end();
+    return const_iterator(this, l, i);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type count(const key_type& key) const {
+    return (find(key) == end()) ? 0 : 1;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator lower_bound(const key_type& key) {
+    const_iterator it = static_cast<const __btree*>(this)->lower_bound(key);
+    return iterator(this, const_cast<leaf_node*>(it.l), it.i);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator lower_bound(const key_type& key) const {
+    if (!root_) return end();
+    leaf_node* l = __find_leaf(key);
+    return __normalize(l, __lower(l->keys.ptr(), l->count, key));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator upper_bound(const key_type& key) {
+    const_iterator it = static_cast<const __btree*>(this)->upper_bound(key);
+    return iterator(this, const_cast<leaf_node*>(it.l), it.i);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator upper_bound(const key_type& key) const {
+    if (!root_) return end();
+    leaf_node* l = __find_leaf(key);
+    return __normalize(l, __upper(l->keys.ptr(), l->count, key));
+  }
+
+ protected:
+  // Build the tree bottom-up from sorted, unique input: fill leaves left to
+  // right, then stack inner levels on top with children spread evenly.
+  // `*this` must be empty.
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL void __bulk_load(InputIterator first,
+                                                InputIterator last) {
+    leaf_node* head = 0;
+    leaf_node* tail = 0;
+    for (; first != last; ++first) {
+      if (!tail || (tail->count == kNodeSlots)) {
+        leaf_node* l = __new_leaf();
+        l->prev = tail;
+        if (tail) {
+          tail->next = l;
+        } else {
+          head = l;
+        }
+        tail = l;
+      }
+      __leaf_construct(tail, tail->count, *first, separate_values());
+      tail->count++;
+      size_++;
+    }
+
+    if (!head) return;
+
+    // Even out the last two leaves so that the tail is not underfull.
+    if ((tail != head) && (tail->count < kMinSlots)) {
+      leaf_node* p = tail->prev;
+      int n = (p->count + tail->count) / 2 - tail->count;
+      __leaf_move(tail, n, tail, 0, tail->count);
+      __leaf_move(tail, 0, p, p->count - n, n);
+      p->count -= n;
+      tail->count += n;
+    }
+
+    node_ptr_vector level((node_ptr_allocator_type(alloc_)));
+    for (leaf_node* l = head; l; l = l->next) {
+      level.push_back(l);
+    }
+
+    while (level.size() > 1) {
+      size_type m = level.size();
+      size_type k = (m + kNodeSlots) / (kNodeSlots + 1);
+      node_ptr_vector up((node_ptr_allocator_type(alloc_)));
+      up.reserve(k);
+
+      size_type idx = 0;
+      for (size_type t = 0; t < k; t++) {
+        int cnt = int(m / k + ((t < (m % k)) ? 1 : 0));
+        inner_node* in = __new_inner();
+        for (int c = 0; c < cnt; c++) {
+          node* child = level[idx + size_type(c)];
+          child->parent = in;
+          in->ch[c] = child;
+          if (c > 0) {
+            ::new (__placement_tag(), in->keys.ptr() + (c - 1))
+                key_type(__min_key(child));
+          }
+        }
+        in->count = cnt - 1;
+        idx += size_type(cnt);
+        up.push_back(in);
+      }
+
+      level.swap(up);
+    }
+
+    root_ = level[0];
+  }
+
+ private:
+  node* root_;
+  size_type size_;
+  key_compare comp_;
+  allocator_type alloc_;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static reference __value(leaf_node* l, int i, true_type) {
+    return l->vals[i];
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static reference __value(leaf_node* l, int i, false_type) {
+    return l->keys[i];
+  }
+
+  // Index of the first key not less than `key`. Branch-free binary search
+  // over the contiguous key array; the compiler turns the select into a
+  // conditional move.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int __lower(const key_type* k, int n, const key_type& key) const {
+    if (n == 0) return 0;
+    const key_type* base = k;
+    while (n > 1) {
+      int half = n >> 1;
+      base = comp_(base[half], key) ? base + half : base;
+      n -= half;
+    }
+    return int(base - k) + (comp_(*base, key) ? 1 : 0);
+  }
+
+  // Index of the first key greater than `key`.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int __upper(const key_type* k, int n, const key_type& key) const {
+    if (n == 0) return 0;
+    const key_type* base = k;
+    while (n > 1) {
+      int half = n >> 1;
+      base = comp_(key, base[half]) ? base : base + half;
+      n -= half;
+    }
+    return int(base - k) + (comp_(key, *base) ? 0 : 1);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  leaf_node* __find_leaf(const key_type& key) const {
+    node* n = root_;
+    while (!n->leaf) {
+      inner_node* in = static_cast<inner_node*>(n);
+      n = in->ch[__upper(in->keys.ptr(), in->count, key)];
+    }
+    return static_cast<leaf_node*>(n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  leaf_node* __leftmost_leaf() const {
+    node* n = root_;
+    if (!n) return 0;
+    while (!n->leaf) {
+      n = static_cast<inner_node*>(n)->ch[0];
+    }
+    return static_cast<leaf_node*>(n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  leaf_node* __rightmost_leaf() const {
+    node* n = root_;
+    if (!n) return 0;
+    while (!n->leaf) {
+      n = static_cast<inner_node*>(n)->ch[n->count];
+    }
+    return static_cast<leaf_node*>(n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static const key_type& __min_key(const node* n) {
+    while (!n->leaf) {
+      n = static_cast<const inner_node*>(n)->ch[0];
+    }
+    return static_cast<const leaf_node*>(n)->keys[0];
+  }
+
+  // Step past the end of a leaf to the head of the next one.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator __normalize(const leaf_node* l, int i) const {
+    if (i < l->count) return const_iterator(this, l, i);
+    return const_iterator(this, l->next, 0);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  leaf_node* __new_leaf() {
+    leaf_allocator_type a(alloc_);
+    leaf_node* l =
+        nanostl::allocator_traits<leaf_allocator_type>::allocate(a, 1);
+    ::new (__placement_tag(), l) leaf_node();
+    return l;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  inner_node* __new_inner() {
+    inner_allocator_type a(alloc_);
+    inner_node* in =
+        nanostl::allocator_traits<inner_allocator_type>::allocate(a, 1);
+    ::new (__placement_tag(), in) inner_node();
+    return in;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __free_leaf(leaf_node* l) {
+    leaf_allocator_type a(alloc_);
+    nanostl::allocator_traits<leaf_allocator_type>::deallocate(a, l, 1);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __free_inner(inner_node* in) {
+    inner_allocator_type a(alloc_);
+    nanostl::allocator_traits<inner_allocator_type>::deallocate(a, in, 1);
+  }
+
+  // Recursion depth is the tree height, which stays in the single digits
+  // even for 10^9 elements.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __free_tree(node* n) {
+    if (!n) return;
+    if (n->leaf) {
+      leaf_node* l = static_cast<leaf_node*>(n);
+      for (int i = 0; i < l->count; i++) {
+        __leaf_destroy(l, i, separate_values());
+      }
+      __free_leaf(l);
+      return;
+    }
+
+    inner_node* in = static_cast<inner_node*>(n);
+    for (int i = 0; i <= in->count; i++) {
+      __free_tree(in->ch[i]);
+    }
+    for (int i = 0; i < in->count; i++) {
+      in->keys[i].~key_type();
+    }
+    __free_inner(in);
+  }
+
+  //
+  // Slot helpers. Storage is raw, so elements are moved with
+  // construct + destroy.
+  //
+
+  template <class V>
+  NANOSTL_HOST_AND_DEVICE_QUAL static void __move_slots(V* dst, V* src,
+                                                        int n) {
+    if (dst > src) {
+      for (int i = n - 1; i >= 0; i--) {
+        ::new (__placement_tag(), dst + i) V(nanostl::move(src[i]));
+        src[i].~V();
+      }
+    } else if (dst < src) {
+      for (int i = 0; i < n; i++) {
+        ::new (__placement_tag(), dst + i) V(nanostl::move(src[i]));
+        src[i].~V();
+      }
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_move(leaf_node* dst, int di, leaf_node* src, int si,
+                          int n) {
+    __move_slots(dst->keys.ptr() + di, src->keys.ptr() + si, n);
+    __leaf_move_values(dst, di, src, si, n, separate_values());
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_move_values(leaf_node* dst, int di, leaf_node* src,
+                                 int si, int n, true_type) {
+    __move_slots(dst->vals.ptr() + di, src->vals.ptr() + si, n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_move_values(leaf_node*, int, leaf_node*, int, int,
+                                 false_type) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_construct(leaf_node* l, int i, const value_type& x,
+                               true_type) {
+    ::new (__placement_tag(), l->keys.ptr() + i) key_type(Params::key(x));
+    ::new (__placement_tag(), l->vals.ptr() + i) value_type(x);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_construct(leaf_node* l, int i, const value_type& x,
+                               false_type) {
+    ::new (__placement_tag(), l->keys.ptr() + i) key_type(x);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_destroy(leaf_node* l, int i, true_type) {
+    l->keys[i].~key_type();
+    l->vals[i].~value_type();
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_destroy(leaf_node* l, int i, false_type) {
+    l->keys[i].~key_type();
+  }
+
+  // Remove slot `i` and close the gap. Does not rebalance.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __leaf_erase(leaf_node* l, int i) {
+    __leaf_destroy(l, i, separate_values());
+    __leaf_move(l, i, l, i + 1, l->count - i - 1);
+    l->count--;
+  }
+
+  // Insert `key` at keys[i] and `child` at ch[i + 1]. `in` must not be full.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __inner_insert(inner_node* in, int i, const key_type& key,
+                             node* child) {
+    __move_slots(in->keys.ptr() + i + 1, in->keys.ptr() + i, in->count - i);
+    ::new (__placement_tag(), in->keys.ptr() + i) key_type(key);
+    for (int j = in->count; j > i; j--) {
+      in->ch[j + 1] = in->ch[j];
+    }
+    in->ch[i + 1] = child;
+    child->parent = in;
+    in->count++;
+  }
+
+  // Remove keys[i] and ch[i + 1].
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __inner_erase(inner_node* in, int i) {
+    in->keys[i].~key_type();
+    __move_slots(in->keys.ptr() + i, in->keys.ptr() + i + 1,
+                 in->count - i - 1);
+    for (int j = i + 1; j < in->count; j++) {
+      in->ch[j] = in->ch[j + 1];
+    }
+    in->count--;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static int __child_index(const inner_node* p, const node* n) {
+    int i = 0;
+    while (p->ch[i] != n) i++;
+    return i;
+  }
+
+  // Split the full child p->ch[i] in two halves. `p` must not be full.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __split_child(inner_node* p, int i) {
+    const int mid = kNodeSlots / 2;
+    node* c = p->ch[i];
+
+    if (c->leaf) {
+      leaf_node* l = static_cast<leaf_node*>(c);
+      leaf_node* r = __new_leaf();
+      __leaf_move(r, 0, l, mid, kNodeSlots - mid);
+      r->count = kNodeSlots - mid;
+      l->count = mid;
+
+      r->next = l->next;
+      if (r->next) r->next->prev = r;
+      l->next = r;
+      r->prev = l;
+
+      __inner_insert(p, i, r->keys[0], r);
+      return;
+    }
+
+    // keys[mid] moves up to the parent.
+    inner_node* l = static_cast<inner_node*>(c);
+    inner_node* r = __new_inner();
+    __move_slots(r->keys.ptr(), l->keys.ptr() + mid + 1,
+                 kNodeSlots - mid - 1);
+    for (int j = 0; j <= kNodeSlots - mid - 1; j++) {
+      r->ch[j] = l->ch[mid + 1 + j];
+      r->ch[j]->parent = r;
+    }
+    r->count = kNodeSlots - mid - 1;
+    l->count = mid;
+
+    __inner_insert(p, i, l->keys[mid], r);
+    l->keys[mid].~key_type();
+  }
+
+  // Merge p->ch[i + 1] into p->ch[i].
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __merge(inner_node* p, int i) {
+    node* a = p->ch[i];
+    node* b = p->ch[i + 1];
+
+    if (a->leaf) {
+      leaf_node* l = static_cast<leaf_node*>(a);
+      leaf_node* r = static_cast<leaf_node*>(b);
+      __leaf_move(l, l->count, r, 0, r->count);
+      l->count += r->count;
+      l->next = r->next;
+      if (l->next) l->next->prev = l;
+      __free_leaf(r);
+    } else {
+      inner_node* l = static_cast<inner_node*>(a);
+      inner_node* r = static_cast<inner_node*>(b);
+      ::new (__placement_tag(), l->keys.ptr() + l->count)
+          key_type(nanostl::move(p->keys[i]));
+      __move_slots(l->keys.ptr() + l->count + 1, r->keys.ptr(), r->count);
+      for (int j = 0; j <= r->count; j++) {
+        l->ch[l->count + 1 + j] = r->ch[j];
+        r->ch[j]->parent = l;
+      }
+      l->count += r->count + 1;
+      __free_inner(r);
+    }
+
+    __inner_erase(p, i);
+  }
+
+  // Move one element from p->ch[i - 1] to the front of p->ch[i].
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __borrow_left(inner_node* p, int i) {
+    node* s = p->ch[i - 1];
+    node* x = p->ch[i];
+
+    if (x->leaf) {
+      leaf_node* l = static_cast<leaf_node*>(s);
+      leaf_node* r = static_cast<leaf_node*>(x);
+      __leaf_move(r, 1, r, 0, r->count);
+      __leaf_move(r, 0, l, l->count - 1, 1);
+      l->count--;
+      r->count++;
+      p->keys[i - 1] = r->keys[0];
+      return;
+    }
+
+    inner_node* l = static_cast<inner_node*>(s);
+    inner_node* r = static_cast<inner_node*>(x);
+    __move_slots(r->keys.ptr() + 1, r->keys.ptr(), r->count);
+    ::new (__placement_tag(), r->keys.ptr())
+        key_type(nanostl::move(p->keys[i - 1]));
+    for (int j = r->count + 1; j > 0; j--) {
+      r->ch[j] = r->ch[j - 1];
+    }
+    r->ch[0] = l->ch[l->count];
+    r->ch[0]->parent = r;
+    r->count++;
+
+    p->keys[i - 1] = nanostl::move(l->keys[l->count - 1]);
+    l->keys[l->count - 1].~key_type();
+    l->count--;
+  }
+
+  // Move one element from p->ch[i + 1] to the back of p->ch[i].
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __borrow_right(inner_node* p, int i) {
+    node* x = p->ch[i];
+    node* s = p->ch[i + 1];
+
+    if (x->leaf) {
+      leaf_node* l = static_cast<leaf_node*>(x);
+      leaf_node* r = static_cast<leaf_node*>(s);
+      __leaf_move(l, l->count, r, 0, 1);
+      __leaf_move(r, 0, r, 1, r->count - 1);
+      l->count++;
+      r->count--;
+      p->keys[i] = r->keys[0];
+      return;
+    }
+
+    inner_node* l = static_cast<inner_node*>(x);
+    inner_node* r = static_cast<inner_node*>(s);
+    ::new (__placement_tag(), l->keys.ptr() + l->count)
+        key_type(nanostl::move(p->keys[i]));
+    l->ch[l->count + 1] = r->ch[0];
+    l->ch[l->count + 1]->parent = l;
+    l->count++;
+
+    p->keys[i] = nanostl::move(r->keys[0]);
+    r->keys[0].~key_type();
+    __move_slots(r->keys.ptr(), r->keys.ptr() + 1, r->count - 1);
+    for (int j = 0; j < r->count; j++) {
+      r->ch[j] = r->ch[j + 1];
+    }
+    r->count--;
+  }
+
+  // Restore the minimum fill of `n` after an erase, walking up while merges
+  // leave the parent underfull.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __rebalance(node* n) {
+    for (;;) {
+      if (n == root_) {
+        if (n->leaf) {
+          if (n->count == 0) {
+            __free_leaf(static_cast<leaf_node*>(n));
+            root_ = 0;
+          }
+        } else if (n->count == 0) {
+          inner_node* in = static_cast<inner_node*>(n);
+          root_ = in->ch[0];
+          root_->parent = 0;
+          __free_inner(in);
+        }
+        return;
+      }
+
+      if (n->count >= kMinSlots) return;
+
+      inner_node* p = n->parent;
+      int i = __child_index(p, n);
+      // Inner nodes also pull the separator down when merging.
+      int extra = n->leaf ? 0 : 1;
+
+      if (i > 0) {
+        if (p->ch[i - 1]->count + n->count + extra <= kNodeSlots) {
+          __merge(p, i - 1);
+          n = p;
+          continue;
+        }
+        __borrow_left(p, i);
+        return;
+      }
+
+      if (p->ch[1]->count + n->count + extra <= kNodeSlots) {
+        __merge(p, 0);
+        n = p;
+        continue;
+      }
+      __borrow_right(p, 0);
+      return;
+    }
+  }
+};
+
+template <class Key, class T, class Compare = nanostl::less<Key>,
+          class Allocator = nanostl::allocator<nanostl::pair<const Key, T> > >
+class btree_map
+    : public __btree<__btree_map_params<Key, T, Compare, Allocator> > {
+  typedef __btree<__btree_map_params<Key, T, Compare, Allocator> > base;
+
+ public:
+  typedef T mapped_type;
+  typedef typename base::key_type key_type;
+  typedef typename base::value_type value_type;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  btree_map() {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit btree_map(const Compare& comp, const Allocator& alloc = Allocator())
+      : base(comp, alloc) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit btree_map(const Allocator& alloc) : base(Compare(), alloc) {}
+
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL btree_map(InputIterator first,
+                                         InputIterator last,
+                                         const Compare& comp = Compare(),
+                                         const Allocator& alloc = Allocator())
+      : base(comp, alloc) {
+    this->insert(first, last);
+  }
+
+  // Bulk load in O(n) from input that is sorted and free of duplicates.
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL btree_map(sorted_unique_t, InputIterator first,
+                                         InputIterator last,
+                                         const Compare& comp = Compare(),
+                                         const Allocator& alloc = Allocator())
+      : base(comp, alloc) {
+    this->__bulk_load(first, last);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  T& operator[](const key_type& k) {
+    typename base::iterator it = this->find(k);
+    if (it == this->end()) {
+      it = this->insert(value_type(k, T())).first;
+    }
+    return it->second;
+  }
+};
+
+template <class Key, class Compare = nanostl::less<Key>,
+          class Allocator = nanostl::allocator<Key> >
+class btree_set : public __btree<__btree_set_params<Key, Compare, Allocator> > {
+  typedef __btree<__btree_set_params<Key, Compare, Allocator> > base;
+
+ public:
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  btree_set() {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit btree_set(const Compare& comp, const Allocator& alloc = Allocator())
+      : base(comp, alloc) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit btree_set(const Allocator& alloc) : base(Compare(), alloc) {}
+
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL btree_set(InputIterator first,
+                                         InputIterator last,
+                                         const Compare& comp = Compare(),
+                                         const Allocator& alloc = Allocator())
+      : base(comp, alloc) {
+    this->insert(first, last);
+  }
+
+  // Bulk load in O(n) from input that is sorted and free of duplicates.
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL btree_set(sorted_unique_t, InputIterator first,
+                                         InputIterator last,
+                                         const Compare& comp = Compare(),
+                                         const Allocator& alloc = Allocator())
+      : base(comp, alloc) {
+    this->__bulk_load(first, last);
+  }
+};
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_BTREE_H_
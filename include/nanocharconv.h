@@ -0,0 +1,696 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_CHARCONV_H_
+#define NANOSTL_CHARCONV_H_
+
+#include "__nanostrutil.h"
+#include "fast_float/fast_float.h"
+#include "nanocommon.h"
+#include "nanocstdint.h"
+#include "nanocstring.h"
+#include "nanosystem_error.h"
+
+namespace nanostl {
+
+struct to_chars_result {
+  char *ptr;
+  errc ec;
+};
+
+struct from_chars_result {
+  const char *ptr;
+  errc ec;
+};
+
+enum class chars_format {
+  scientific = 0x1,
+  fixed = 0x2,
+  hex = 0x4,
+  general = fixed | scientific
+};
+
+//
+// Integer formatting. Base 10 writes two digits per step from
+// ryu::DIGIT_TABLE, straight into the destination(the length is counted up
+// front). No allocation, no null terminator.
+//
+
+// Number of decimal digits in `v`(1 for 0).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline int __decimal_length(uint64_t v) {
+  int n = 1;
+  for (;;) {
+    if (v < 10) return n;
+    if (v < 100) return n + 1;
+    if (v < 1000) return n + 2;
+    if (v < 10000) return n + 3;
+    v /= 10000;
+    n += 4;
+  }
+}
+
+// Writes `v` as exactly `len` digits ending at `end`.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void __write_digits32(char *end, uint32_t v, int len) {
+  char *p = end;
+  while (len >= 2) {
+    const uint32_t c = (v % 100) << 1;
+    v /= 100;
+    p -= 2;
+    nanostl::memcpy(p, ryu::DIGIT_TABLE + c, 2);
+    len -= 2;
+  }
+  if (len) {
+    *--p = char('0' + v);
+  }
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void __write_digits64(char *end, uint64_t v, int len) {
+  // 8 digits per 64-bit division, then 32-bit arithmetic.
+  while (v > 0xffffffffull) {
+    __write_digits32(end, uint32_t(v % 100000000), 8);
+    v /= 100000000;
+    end -= 8;
+    len -= 8;
+  }
+  __write_digits32(end, uint32_t(v), len);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result __to_chars_unsigned(char *first, char *last, uint64_t v,
+                                           bool negative, int base) {
+  const int sign = negative ? 1 : 0;
+  if (base == 10) {
+    const int len = __decimal_length(v);
+    if (last - first < len + sign) {
+      to_chars_result r = {last, errc::value_too_large};
+      return r;
+    }
+    if (negative) {
+      *first++ = '-';
+    }
+    __write_digits64(first + len, v, len);
+    to_chars_result r = {first + len, errc()};
+    return r;
+  }
+
+  // Other bases: count, then fill from the end.
+  int len = 1;
+  for (uint64_t t = v / uint64_t(base); t; t /= uint64_t(base)) {
+    len++;
+  }
+  if (last - first < len + sign) {
+    to_chars_result r = {last, errc::value_too_large};
+    return r;
+  }
+  if (negative) {
+    *first++ = '-';
+  }
+  char *p = first + len;
+  do {
+    const unsigned d = unsigned(v % uint64_t(base));
+    v /= uint64_t(base);
+    *--p = char((d < 10) ? ('0' + d) : ('a' + d - 10));
+  } while (v);
+  to_chars_result r = {first + len, errc()};
+  return r;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result __to_chars_signed(char *first, char *last, int64_t v,
+                                         int base) {
+  // Negate in unsigned arithmetic so the minimum value does not overflow.
+  const uint64_t u = (v < 0) ? (uint64_t(0) - uint64_t(v)) : uint64_t(v);
+  return __to_chars_unsigned(first, last, u, v < 0, base);
+}
+
+// `base` must be in [2, 36].
+#define NANOSTL_TO_CHARS_SIGNED(__type)                                     \
+  NANOSTL_HOST_AND_DEVICE_QUAL                                              \
+  inline to_chars_result to_chars(char *first, char *last, __type value,    \
+                                  int base = 10) {                          \
+    return __to_chars_signed(first, last, int64_t(value), base);            \
+  }
+
+NANOSTL_TO_CHARS_SIGNED(char)
+NANOSTL_TO_CHARS_SIGNED(signed char)
+NANOSTL_TO_CHARS_SIGNED(short)
+NANOSTL_TO_CHARS_SIGNED(int)
+NANOSTL_TO_CHARS_SIGNED(long)
+NANOSTL_TO_CHARS_SIGNED(long long)
+
+#undef NANOSTL_TO_CHARS_SIGNED
+
+#define NANOSTL_TO_CHARS_UNSIGNED(__type)                                   \
+  NANOSTL_HOST_AND_DEVICE_QUAL                                              \
+  inline to_chars_result to_chars(char *first, char *last, __type value,    \
+                                  int base = 10) {                          \
+    return __to_chars_unsigned(first, last, uint64_t(value), false, base);  \
+  }
+
+NANOSTL_TO_CHARS_UNSIGNED(unsigned char)
+NANOSTL_TO_CHARS_UNSIGNED(unsigned short)
+NANOSTL_TO_CHARS_UNSIGNED(unsigned int)
+NANOSTL_TO_CHARS_UNSIGNED(unsigned long)
+NANOSTL_TO_CHARS_UNSIGNED(unsigned long long)
+
+#undef NANOSTL_TO_CHARS_UNSIGNED
+
+// to_chars(bool) is deleted in the standard.
+to_chars_result to_chars(char *, char *, bool, int = 10) = delete;
+
+//
+// Integer parsing. As in the standard: an optional '-'(signed types only)
+// followed by digits in `base`, no whitespace, '+' or "0x" prefix. A value
+// that does not fit reports errc::result_out_of_range(all digits are
+// consumed) and leaves `value` unchanged.
+//
+
+// Value of the digit `c`, or 36 if it is not one.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline unsigned __digit_value(char c) {
+  if ((c >= '0') && (c <= '9')) return unsigned(c - '0');
+  if ((c >= 'a') && (c <= 'z')) return unsigned(c - 'a' + 10);
+  if ((c >= 'A') && (c <= 'Z')) return unsigned(c - 'A' + 10);
+  return 36;
+}
+
+// Parses the digits at `first` as a magnitude no greater than `max`.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline from_chars_result __from_chars_unsigned(const char *first,
+                                               const char *last, uint64_t max,
+                                               uint64_t &value, int base) {
+  const uint64_t b = uint64_t(base);
+  const uint64_t limit = max / b;
+  uint64_t v = 0;
+  bool overflow = false;
+  const char *p = first;
+  for (; p != last; ++p) {
+    const unsigned d = __digit_value(*p);
+    if (d >= unsigned(base)) {
+      break;
+    }
+    if ((v > limit) || (d > max - v * b)) {
+      overflow = true;
+    } else {
+      v = v * b + d;
+    }
+  }
+  from_chars_result r = {p, errc()};
+  if (p == first) {
+    r.ec = errc::invalid_argument;
+  } else if (overflow) {
+    r.ec = errc::result_out_of_range;
+  } else {
+    value = v;
+  }
+  return r;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline from_chars_result __from_chars_signed(const char *first,
+                                             const char *last, int64_t min,
+                                             int64_t max, int64_t &value,
+                                             int base) {
+  const bool negative = (first != last) && (*first == '-');
+  const uint64_t limit =
+      negative ? (uint64_t(0) - uint64_t(min)) : uint64_t(max);
+  uint64_t u;
+  from_chars_result r =
+      __from_chars_unsigned(first + (negative ? 1 : 0), last, limit, u, base);
+  if (r.ec == errc::invalid_argument) {
+    r.ptr = first;
+  } else if (r.ec == errc()) {
+    value = negative ? int64_t(uint64_t(0) - u) : int64_t(u);
+  }
+  return r;
+}
+
+// `base` must be in [2, 36].
+#define NANOSTL_FROM_CHARS_SIGNED(__type, __min, __max)                      \
+  NANOSTL_HOST_AND_DEVICE_QUAL                                               \
+  inline from_chars_result from_chars(const char *first, const char *last,   \
+                                      __type &value, int base = 10) {        \
+    int64_t v;                                                               \
+    from_chars_result r =                                                    \
+        __from_chars_signed(first, last, __min, __max, v, base);             \
+    if (r.ec == errc()) {                                                    \
+      value = static_cast<__type>(v);                                                   \
+    }                                                                        \
+    return r;                                                                \
+  }
+
+NANOSTL_FROM_CHARS_SIGNED(char, (char(-1) < 0) ? -128 : 0,
+                          (char(-1) < 0) ? 127 : 255)
+NANOSTL_FROM_CHARS_SIGNED(signed char, -128, 127)
+NANOSTL_FROM_CHARS_SIGNED(short, -32768, 32767)
+NANOSTL_FROM_CHARS_SIGNED(int, -2147483647 - 1, 2147483647)
+NANOSTL_FROM_CHARS_SIGNED(long,
+                          (sizeof(long) == 8) ? (-9223372036854775807ll - 1)
+                                              : (-2147483647ll - 1),
+                          (sizeof(long) == 8) ? 9223372036854775807ll
+                                              : 2147483647ll)
+NANOSTL_FROM_CHARS_SIGNED(long long, -9223372036854775807ll - 1,
+                          9223372036854775807ll)
+
+#undef NANOSTL_FROM_CHARS_SIGNED
+
+#define NANOSTL_FROM_CHARS_UNSIGNED(__type)                                  \
+  NANOSTL_HOST_AND_DEVICE_QUAL                                               \
+  inline from_chars_result from_chars(const char *first, const char *last,   \
+                                      __type &value, int base = 10) {        \
+    uint64_t v;                                                              \
+    from_chars_result r =                                                    \
+        __from_chars_unsigned(first, last, uint64_t(static_cast<__type>(-1)), v, base);   \
+    if (r.ec == errc()) {                                                    \
+      value = static_cast<__type>(v);                                                   \
+    }                                                                        \
+    return r;                                                                \
+  }
+
+NANOSTL_FROM_CHARS_UNSIGNED(unsigned char)
+NANOSTL_FROM_CHARS_UNSIGNED(unsigned short)
+NANOSTL_FROM_CHARS_UNSIGNED(unsigned int)
+NANOSTL_FROM_CHARS_UNSIGNED(unsigned long)
+NANOSTL_FROM_CHARS_UNSIGNED(unsigned long long)
+
+#undef NANOSTL_FROM_CHARS_UNSIGNED
+
+//
+// Floating point formatting. Digits are the shortest that parse back to the
+// same value(Ryu's f2d/d2d), laid out in the requested style:
+//
+//   to_chars(first, last, v)                   fixed or scientific,
+//                                              whichever is shorter
+//   to_chars(..., v, chars_format::fixed)      123.45, 0.001, 1e+21 written
+//                                              out in full
+//   to_chars(..., v, chars_format::scientific) 1.2345e+02
+//   to_chars(..., v, chars_format::general)    scientific below 1e-4 and
+//                                              from 1e6 up(as printf("%g"))
+//   to_chars(..., v, chars_format::hex)        1.8p+1(no "0x" prefix)
+//
+// Precision overloads are not provided.
+//
+
+template <class T>
+struct __float_layout;
+
+template <>
+struct __float_layout<float> {
+  static const int mantissa_bits = 23;
+  static const int exponent_bits = 8;
+  static const int bias = 127;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static uint64_t bits(float v) { return ryu::float_to_bits(v); }
+
+  // value = mantissa * 10^exponent
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void shortest(uint64_t m, uint32_t e, uint64_t *mantissa,
+                       int32_t *exponent) {
+    ryu::floating_decimal_32 d = ryu::f2d(uint32_t(m), e);
+    *mantissa = d.mantissa;
+    *exponent = d.exponent;
+  }
+};
+
+template <>
+struct __float_layout<double> {
+  static const int mantissa_bits = 52;
+  static const int exponent_bits = 11;
+  static const int bias = 1023;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static uint64_t bits(double v) { return ryu::double_to_bits(v); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void shortest(uint64_t m, uint32_t e, uint64_t *mantissa,
+                       int32_t *exponent) {
+    ryu::floating_decimal_64 d = ryu::d2d(m, e);
+    *mantissa = d.mantissa;
+    *exponent = d.exponent;
+  }
+};
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result __to_chars_copy(char *first, char *last, const char *s,
+                                       int n) {
+  if (last - first < n) {
+    to_chars_result r = {last, errc::value_too_large};
+    return r;
+  }
+  nanostl::memcpy(first, s, size_t(n));
+  to_chars_result r = {first + n, errc()};
+  return r;
+}
+
+// Writes the exponent of scientific notation: sign and at least 2 digits.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *__write_exponent10(char *p, int32_t x) {
+  *p++ = (x < 0) ? '-' : '+';
+  uint32_t u = uint32_t((x < 0) ? -x : x);
+  if (u >= 100) {
+    *p++ = char('0' + u / 100);
+    u %= 100;
+  }
+  nanostl::memcpy(p, ryu::DIGIT_TABLE + 2 * u, 2);
+  return p + 2;
+}
+
+// Writes the integer `mant` * 2^`shift`(shift may be negative when the low
+// bits are zero) in full. Returns the digit count. `buf` needs 310 chars
+// for double.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline int __write_exact_integer(char *buf, uint64_t mant, int32_t shift) {
+  if (shift <= 0) {
+    mant >>= -shift;
+    shift = 0;
+  }
+  if ((shift == 0) || ((shift < 64) && ((mant >> (64 - shift)) == 0))) {
+    const uint64_t v = mant << shift;
+    const int len = __decimal_length(v);
+    __write_digits64(buf + len, v, len);
+    return len;
+  }
+
+  // Base 1e9 limbs, least significant first. 2^1024 < 1e9^35.
+  uint32_t limb[36];
+  int n = 0;
+  while (mant) {
+    limb[n++] = uint32_t(mant % 1000000000);
+    mant /= 1000000000;
+  }
+  while (shift > 0) {
+    const int s = (shift < 29) ? shift : 29;
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+      const uint64_t t = (uint64_t(limb[i]) << s) + carry;
+      limb[i] = uint32_t(t % 1000000000);
+      carry = t / 1000000000;
+    }
+    if (carry) {
+      limb[n++] = uint32_t(carry);
+    }
+    shift -= s;
+  }
+
+  const int top = __decimal_length(limb[n - 1]);
+  const int len = top + 9 * (n - 1);
+  __write_digits32(buf + top, limb[n - 1], top);
+  for (int i = n - 2, pos = top + 9; i >= 0; i--, pos += 9) {
+    __write_digits32(buf + pos, limb[i], 9);
+  }
+  return len;
+}
+
+// Lays out `negative`, digits `m`(no trailing zeros) and decimal exponent
+// `e`(value = m * 10^e). `bin_mant` * 2^`bin_exp` is the exact value, used
+// when fixed notation prints an integer in full: the standard wants the
+// closest of the equally short representations.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result __format_decimal(char *first, char *last,
+                                        bool negative, uint64_t m, int32_t e,
+                                        uint64_t bin_mant, int32_t bin_exp,
+                                        chars_format fmt, bool plain) {
+  const int olen = __decimal_length(m);
+  const int32_t x = e + olen - 1;  // exponent in scientific notation
+
+  const int32_t ax = (x < 0) ? -x : x;
+  const int32_t sci_len =
+      olen + ((olen > 1) ? 1 : 0) + 2 + ((ax >= 100) ? 3 : 2);
+  int32_t fixed_len;
+  if (e > 0) {
+    fixed_len = olen + e;  // exact digits may be one shorter, see below
+  } else if (x >= 0) {
+    fixed_len = olen + ((e < 0) ? 1 : 0);  // point among the digits
+  } else {
+    fixed_len = 2 + (-x - 1) + olen;  // "0.", zeros, digits
+  }
+
+  char exact[320];
+  int exact_len = 0;
+  if ((e > 0) && (!plain || (fixed_len - 1 <= sci_len))) {
+    exact_len = __write_exact_integer(exact, bin_mant, bin_exp);
+    fixed_len = exact_len;
+  }
+
+  bool sci;
+  if (plain) {
+    sci = sci_len < fixed_len;
+  } else if (fmt == chars_format::scientific) {
+    sci = true;
+  } else if (fmt == chars_format::fixed) {
+    sci = false;
+  } else {
+    // printf("%g") with the default precision of 6.
+    sci = (x < -4) || (x >= 6);
+  }
+
+  const int32_t len = (sci ? sci_len : fixed_len) + (negative ? 1 : 0);
+  if (last - first < len) {
+    to_chars_result r = {last, errc::value_too_large};
+    return r;
+  }
+
+  char *p = first;
+  if (negative) {
+    *p++ = '-';
+  }
+
+  if (sci) {
+    // Write the digits one slot to the right, then pull the first one out
+    // in front of the point.
+    __write_digits64(p + 1 + olen, m, olen);
+    p[0] = p[1];
+    if (olen > 1) {
+      p[1] = '.';
+      p += olen + 1;
+    } else {
+      p += 1;
+    }
+    *p++ = 'e';
+    p = __write_exponent10(p, x);
+  } else if (e > 0) {
+    nanostl::memcpy(p, exact, size_t(exact_len));
+    p += exact_len;
+  } else if (e == 0) {
+    __write_digits64(p + olen, m, olen);
+    p += olen;
+  } else if (x >= 0) {
+    __write_digits64(p + 1 + olen, m, olen);
+    nanostl::memmove(p, p + 1, size_t(x + 1));
+    p[x + 1] = '.';
+    p += olen + 1;
+  } else {
+    p[0] = '0';
+    p[1] = '.';
+    nanostl::memset(p + 2, '0', size_t(-x - 1));
+    p += 2 + (-x - 1);
+    __write_digits64(p + olen, m, olen);
+    p += olen;
+  }
+
+  to_chars_result r = {p, errc()};
+  return r;
+}
+
+template <class T>
+NANOSTL_HOST_AND_DEVICE_QUAL inline to_chars_result __to_chars_hex(
+    char *first, char *last, bool negative, uint64_t m, uint32_t e) {
+  typedef __float_layout<T> L;
+  const int nibbles = (L::mantissa_bits + 3) / 4;
+  char buf[32];
+  char *p = buf;
+  if (negative) {
+    *p++ = '-';
+  }
+
+  int32_t x;
+  if ((e == 0) && (m == 0)) {
+    *p++ = '0';
+    x = 0;
+  } else {
+    *p++ = (e == 0) ? '0' : '1';
+    x = ((e == 0) ? 1 : int32_t(e)) - L::bias;
+    m <<= (nibbles * 4 - L::mantissa_bits);  // align to whole hex digits
+    int n = nibbles;
+    while ((n > 0) && ((m & 0xf) == 0)) {
+      m >>= 4;
+      n--;
+    }
+    if (n > 0) {
+      *p++ = '.';
+      for (int i = n - 1; i >= 0; i--) {
+        const unsigned d = unsigned(m >> (4 * i)) & 0xf;
+        *p++ = char((d < 10) ? ('0' + d) : ('a' + d - 10));
+      }
+    }
+  }
+  *p++ = 'p';
+  *p++ = (x < 0) ? '-' : '+';
+  p = __to_chars_unsigned(p, buf + sizeof(buf),
+                          uint64_t((x < 0) ? -x : x), false, 10)
+          .ptr;
+  return __to_chars_copy(first, last, buf, int(p - buf));
+}
+
+template <class T>
+NANOSTL_HOST_AND_DEVICE_QUAL inline to_chars_result __to_chars_float(
+    char *first, char *last, T value, chars_format fmt, bool plain) {
+  typedef __float_layout<T> L;
+  const uint64_t bits = L::bits(value);
+  const bool negative =
+      ((bits >> (L::mantissa_bits + L::exponent_bits)) & 1) != 0;
+  const uint64_t m = bits & ((uint64_t(1) << L::mantissa_bits) - 1);
+  const uint32_t e =
+      uint32_t(bits >> L::mantissa_bits) & ((1u << L::exponent_bits) - 1);
+
+  if (e == ((1u << L::exponent_bits) - 1)) {
+    if (m) {
+      return negative ? __to_chars_copy(first, last, "-nan", 4)
+                      : __to_chars_copy(first, last, "nan", 3);
+    }
+    return negative ? __to_chars_copy(first, last, "-inf", 4)
+                    : __to_chars_copy(first, last, "inf", 3);
+  }
+
+  if (!plain && (fmt == chars_format::hex)) {
+    return __to_chars_hex<T>(first, last, negative, m, e);
+  }
+
+  if ((e == 0) && (m == 0)) {
+    if (!plain && (fmt == chars_format::scientific)) {
+      return negative ? __to_chars_copy(first, last, "-0e+00", 6)
+                      : __to_chars_copy(first, last, "0e+00", 5);
+    }
+    return negative ? __to_chars_copy(first, last, "-0", 2)
+                    : __to_chars_copy(first, last, "0", 1);
+  }
+
+  uint64_t digits;
+  int32_t exponent;
+  L::shortest(m, e, &digits, &exponent);
+  const uint64_t bin_mant = e ? (m | (uint64_t(1) << L::mantissa_bits)) : m;
+  const int32_t bin_exp = (e ? int32_t(e) : 1) - L::bias - L::mantissa_bits;
+  return __format_decimal(first, last, negative, digits, exponent, bin_mant,
+                          bin_exp, fmt, plain);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result to_chars(char *first, char *last, float value) {
+  return __to_chars_float(first, last, value, chars_format::general, true);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result to_chars(char *first, char *last, double value) {
+  return __to_chars_float(first, last, value, chars_format::general, true);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result to_chars(char *first, char *last, float value,
+                                chars_format fmt) {
+  return __to_chars_float(first, last, value, fmt, false);
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline to_chars_result to_chars(char *first, char *last, double value,
+                                chars_format fmt) {
+  return __to_chars_float(first, last, value, fmt, false);
+}
+
+//
+// Floating point parsing through fast_float(Eisel-Lemire, with a big
+// integer fallback for the rare hard cases). Host only.
+//
+// As in the standard: no leading whitespace or '+', "inf"/"nan" accepted,
+// and a value that overflows or underflows to zero reports
+// errc::result_out_of_range and leaves `value` unchanged.
+// chars_format::hex is not supported(errc::invalid_argument).
+//
+
+// True if the mantissa part of a matched number has a nonzero digit.
+inline bool __has_nonzero_digit(const char *first, const char *last) {
+  for (; first != last; ++first) {
+    if ((*first == 'e') || (*first == 'E')) {
+      break;
+    }
+    if ((*first >= '1') && (*first <= '9')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T>
+inline from_chars_result __from_chars_float(const char *first,
+                                            const char *last, T &value,
+                                            chars_format fmt) {
+  from_chars_result r = {first, errc::invalid_argument};
+  fast_float::chars_format ff;
+  if (fmt == chars_format::fixed) {
+    ff = fast_float::chars_format::fixed;
+  } else if (fmt == chars_format::scientific) {
+    ff = fast_float::chars_format::scientific;
+  } else if (fmt == chars_format::general) {
+    ff = fast_float::chars_format::general;
+  } else {
+    return r;
+  }
+
+  T v;
+  fast_float::from_chars_result fr = fast_float::from_chars(first, last, v, ff);
+  r.ptr = fr.ptr;
+  r.ec = fr.ec;
+  if (r.ec != errc()) {
+    return r;
+  }
+
+  const char *digits = (*first == '-') ? first + 1 : first;
+  const bool is_inf = (v == v) && (v - v != v - v);
+  if ((is_inf && (*digits != 'i') && (*digits != 'I')) ||
+      ((v == T(0)) && __has_nonzero_digit(digits, fr.ptr))) {
+    r.ec = errc::result_out_of_range;
+    return r;
+  }
+  value = v;
+  return r;
+}
+
+inline from_chars_result from_chars(const char *first, const char *last,
+                                    float &value,
+                                    chars_format fmt = chars_format::general) {
+  return __from_chars_float(first, last, value, fmt);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last,
+                                    double &value,
+                                    chars_format fmt = chars_format::general) {
+  return __from_chars_float(first, last, value, fmt);
+}
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_CHARCONV_H_
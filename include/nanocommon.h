@@ -48,6 +48,18 @@
 #endif
 
 
+// Put before a loop whose iterations are independent, so the compiler may
+// vectorize it without proving that itself(unsequenced execution policies).
+#if defined(__clang__)
+#define NANOSTL_PRAGMA_SIMD _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define NANOSTL_PRAGMA_SIMD _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define NANOSTL_PRAGMA_SIMD __pragma(loop(ivdep))
+#else
+#define NANOSTL_PRAGMA_SIMD
+#endif
+
 // TODO(LTE): Implement
 #ifndef _NANOSTL_TEMPLATE_VIS
 #define _NANOSTL_TEMPLATE_VIS
@@ -25,24 +25,788 @@
 #ifndef NANOSTL_CSTRING_H_
 #define NANOSTL_CSTRING_H_
 
+//
+// <cstring> without libc.
+//
+// mem* functions work on 8 byte words, with 16 byte SSE2/NEON blocks on top
+// (see __string_search.h). On x86 GCC/Clang builds, inputs over 32 bytes go
+// through AVX2 kernels when the CPU supports them(checked once at runtime);
+// building with -mavx2 selects them statically. Define
+// NANOSTL_CSTRING_NO_DISPATCH to stay on the SSE2 kernels.
+//
+// str* functions find the terminating null with has-zero-byte word tricks.
+// They read whole aligned words that may extend past the null, but never
+// across a page boundary(as optimized libc implementations do), so they are
+// excluded from AddressSanitizer instrumentation.
+//
+// CUDA device code uses plain byte loops.
+//
+
+// Intrinsic headers must not see the `nullptr` macro from __nullptr, which
+// is already defined when another nanostl header includes this one.
+#if !defined(__CUDACC__) && !defined(NANOSTL_STRING_SEARCH_PORTABLE) && \
+    (defined(__GNUC__) || defined(__clang__)) &&                       \
+    (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#if defined(__AVX2__)
+#define NANOSTL_CSTRING_AVX2
+#define NANOSTL_CSTRING_TARGET_AVX2
+#elif !defined(NANOSTL_CSTRING_NO_DISPATCH)
+#define NANOSTL_CSTRING_AVX2
+#define NANOSTL_CSTRING_AVX2_DISPATCH
+#define NANOSTL_CSTRING_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#if defined(NANOSTL_CSTRING_AVX2)
+#pragma push_macro("nullptr")
+#undef nullptr
+#include <immintrin.h>
+#pragma pop_macro("nullptr")
+#endif
+#endif
+
+#include "__bits.h"
+#include "__string_search.h"
 #include "nanocommon.h"
+#include "nanocstdint.h"
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 8))
+#define NANOSTL_NO_SANITIZE_ADDRESS __attribute__((no_sanitize("address")))
+#elif defined(__GNUC__)
+#define NANOSTL_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define NANOSTL_NO_SANITIZE_ADDRESS
+#endif
 
 namespace nanostl {
 
-// Naiive implementation of memcpy
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+#if !defined(__CUDA_ARCH__)
+
+//
+// Unaligned word access.
+//
+#if defined(__GNUC__) || defined(__clang__)
+typedef uint64_t __attribute__((__may_alias__, __aligned__(1))) __cstring_u64;
+typedef uint32_t __attribute__((__may_alias__, __aligned__(1))) __cstring_u32;
+typedef uint16_t __attribute__((__may_alias__, __aligned__(1))) __cstring_u16;
+#else
+typedef uint64_t __cstring_u64;
+typedef uint32_t __cstring_u32;
+typedef uint16_t __cstring_u16;
+#endif
+
+inline uint64_t __cstring_load64(const unsigned char *p) {
+  return *reinterpret_cast<const __cstring_u64 *>(p);
+}
+
+inline uint32_t __cstring_load32(const unsigned char *p) {
+  return *reinterpret_cast<const __cstring_u32 *>(p);
+}
+
+inline uint16_t __cstring_load16(const unsigned char *p) {
+  return *reinterpret_cast<const __cstring_u16 *>(p);
+}
+
+inline void __cstring_store64(unsigned char *p, uint64_t v) {
+  *reinterpret_cast<__cstring_u64 *>(p) = v;
+}
+
+inline void __cstring_store32(unsigned char *p, uint32_t v) {
+  *reinterpret_cast<__cstring_u32 *>(p) = v;
+}
+
+inline void __cstring_store16(unsigned char *p, uint16_t v) {
+  *reinterpret_cast<__cstring_u16 *>(p) = v;
+}
+
+// Loads that may read past the end of the object, but not past the end of
+// its page(the callers guarantee that).
+NANOSTL_NO_SANITIZE_ADDRESS
+inline uint64_t __cstring_peek64(const unsigned char *p) {
+  return *reinterpret_cast<const __cstring_u64 *>(p);
+}
+
+#if defined(NANOSTL_STRING_SEARCH_SSE2)
+NANOSTL_NO_SANITIZE_ADDRESS
+inline __m128i __cstring_peek_block(const unsigned char *p) {
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+}
+#elif defined(NANOSTL_STRING_SEARCH_NEON)
+NANOSTL_NO_SANITIZE_ADDRESS
+inline uint8x16_t __cstring_peek_block(const unsigned char *p) {
+  return vld1q_u8(p);
+}
+#endif
+
+// Byte offset of the first flagged byte in a word read with a native load.
+// `mask` has the high bit set in flagged bytes only.
+inline size_t __cstring_first_byte(uint64_t mask) {
+#if defined(NANOSTL_BIG_ENDIAN)
+  return size_t(__clz64(mask) >> 3);
+#else
+  return size_t(__ctz64(mask) >> 3);
+#endif
+}
+
+inline uint64_t __cstring_nonzero_bytes(uint64_t x) {
+  return ~__search_zero_bytes(x) & 0x8080808080808080ull;
+}
+
+// True if [p, p + n) stays within one 4 KB page.
+inline bool __cstring_same_page(const void *p, size_t n) {
+  return (reinterpret_cast<uintptr_t>(p) & 4095) <= (4096 - n);
+}
+
+//
+// Copies. Every kernel loads a block before storing over it and walks
+// backwards when the destination overlaps the tail of the source, so
+// memcpy and memmove share them.
+//
+
+// n <= 32.
+inline void __cstring_move_small(unsigned char *d, const unsigned char *s,
+                                 size_t n) {
+  if (n >= 16) {
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+    typedef __search_block B;
+    B::vec a = B::load(s);
+    B::vec b = B::load(s + n - 16);
+    B::store(d, a);
+    B::store(d + n - 16, b);
+#else
+    uint64_t a = __cstring_load64(s);
+    uint64_t b = __cstring_load64(s + 8);
+    uint64_t c = __cstring_load64(s + n - 16);
+    uint64_t e = __cstring_load64(s + n - 8);
+    __cstring_store64(d, a);
+    __cstring_store64(d + 8, b);
+    __cstring_store64(d + n - 16, c);
+    __cstring_store64(d + n - 8, e);
+#endif
+  } else if (n >= 8) {
+    uint64_t a = __cstring_load64(s);
+    uint64_t b = __cstring_load64(s + n - 8);
+    __cstring_store64(d, a);
+    __cstring_store64(d + n - 8, b);
+  } else if (n >= 4) {
+    uint32_t a = __cstring_load32(s);
+    uint32_t b = __cstring_load32(s + n - 4);
+    __cstring_store32(d, a);
+    __cstring_store32(d + n - 4, b);
+  } else if (n >= 2) {
+    uint16_t a = __cstring_load16(s);
+    uint16_t b = __cstring_load16(s + n - 2);
+    __cstring_store16(d, a);
+    __cstring_store16(d + n - 2, b);
+  } else if (n == 1) {
+    d[0] = s[0];
+  }
+}
+
+// n > 32. Full blocks, then one block aligned to the end(loaded up front)
+// covers the remainder.
+inline void __cstring_move_large(unsigned char *d, const unsigned char *s,
+                                 size_t n) {
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  const size_t W = 16;
+  typedef B::vec word;
+#define NANOSTL_CSTRING_LOAD(p) B::load(p)
+#define NANOSTL_CSTRING_STORE(p, v) B::store(p, v)
+#else
+  const size_t W = 8;
+  typedef uint64_t word;
+#define NANOSTL_CSTRING_LOAD(p) __cstring_load64(p)
+#define NANOSTL_CSTRING_STORE(p, v) __cstring_store64(p, v)
+#endif
+  if ((d <= s) || (d >= s + n)) {
+    word tail = NANOSTL_CSTRING_LOAD(s + n - W);
+    for (size_t i = 0; i + W < n; i += W) {
+      NANOSTL_CSTRING_STORE(d + i, NANOSTL_CSTRING_LOAD(s + i));
+    }
+    NANOSTL_CSTRING_STORE(d + n - W, tail);
+  } else {
+    word head = NANOSTL_CSTRING_LOAD(s);
+    for (size_t i = n; i > W; i -= W) {
+      NANOSTL_CSTRING_STORE(d + i - W, NANOSTL_CSTRING_LOAD(s + i - W));
+    }
+    NANOSTL_CSTRING_STORE(d, head);
+  }
+#undef NANOSTL_CSTRING_LOAD
+#undef NANOSTL_CSTRING_STORE
+}
+
+// n <= 32.
+inline void __cstring_set_small(unsigned char *d, unsigned char c, size_t n) {
+  uint64_t v = __search_splat(c);
+  if (n >= 16) {
+    __cstring_store64(d, v);
+    __cstring_store64(d + 8, v);
+    __cstring_store64(d + n - 16, v);
+    __cstring_store64(d + n - 8, v);
+  } else if (n >= 8) {
+    __cstring_store64(d, v);
+    __cstring_store64(d + n - 8, v);
+  } else if (n >= 4) {
+    __cstring_store32(d, uint32_t(v));
+    __cstring_store32(d + n - 4, uint32_t(v));
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      d[i] = c;
+    }
+  }
+}
+
+// n > 32.
+inline void __cstring_set_large(unsigned char *d, unsigned char c, size_t n) {
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  B::vec v = B::splat(c);
+  for (size_t i = 0; i + 16 < n; i += 16) {
+    B::store(d + i, v);
+  }
+  B::store(d + n - 16, v);
+#else
+  uint64_t v = __search_splat(c);
+  for (size_t i = 0; i + 8 < n; i += 8) {
+    __cstring_store64(d + i, v);
+  }
+  __cstring_store64(d + n - 8, v);
+#endif
+}
+
+#if defined(NANOSTL_CSTRING_AVX2)
+
+//
+// AVX2 kernels(32 byte blocks) for inputs over 32 bytes.
+//
+NANOSTL_CSTRING_TARGET_AVX2
+inline void __cstring_move_avx2(unsigned char *d, const unsigned char *s,
+                                size_t n) {
+  typedef __m256i V;
+#define NANOSTL_CSTRING_LOAD(p) _mm256_loadu_si256(reinterpret_cast<const V *>(p))
+#define NANOSTL_CSTRING_STORE(p, v) \
+  _mm256_storeu_si256(reinterpret_cast<V *>(p), v)
+  if (n <= 64) {
+    V a = NANOSTL_CSTRING_LOAD(s);
+    V b = NANOSTL_CSTRING_LOAD(s + n - 32);
+    NANOSTL_CSTRING_STORE(d, a);
+    NANOSTL_CSTRING_STORE(d + n - 32, b);
+  } else if ((d <= s) || (d >= s + n)) {
+    V tail = NANOSTL_CSTRING_LOAD(s + n - 32);
+    for (size_t i = 0; i + 32 < n; i += 32) {
+      NANOSTL_CSTRING_STORE(d + i, NANOSTL_CSTRING_LOAD(s + i));
+    }
+    NANOSTL_CSTRING_STORE(d + n - 32, tail);
+  } else {
+    V head = NANOSTL_CSTRING_LOAD(s);
+    for (size_t i = n; i > 32; i -= 32) {
+      NANOSTL_CSTRING_STORE(d + i - 32, NANOSTL_CSTRING_LOAD(s + i - 32));
+    }
+    NANOSTL_CSTRING_STORE(d, head);
+  }
+#undef NANOSTL_CSTRING_LOAD
+#undef NANOSTL_CSTRING_STORE
+}
+
+NANOSTL_CSTRING_TARGET_AVX2
+inline void __cstring_set_avx2(unsigned char *d, unsigned char c, size_t n) {
+  __m256i v = _mm256_set1_epi8(char(c));
+  for (size_t i = 0; i + 32 < n; i += 32) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + i), v);
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + n - 32), v);
+}
+
+NANOSTL_CSTRING_TARGET_AVX2
+inline size_t __cstring_memchr_avx2(const unsigned char *p, size_t n,
+                                    unsigned char c) {
+  __m256i v = _mm256_set1_epi8(char(c));
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+    unsigned m = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v)));
+    if (m) {
+      return i + size_t(__ctz64(m));
+    }
+  }
+  if (i < n) {
+    size_t j = n - 32;
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + j));
+    unsigned m = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v)));
+    m >>= (i - j);
+    if (m) {
+      return i + size_t(__ctz64(m));
+    }
+  }
+  return __search_npos;
+}
+
+NANOSTL_CSTRING_TARGET_AVX2
+inline int __cstring_memcmp_avx2(const unsigned char *a,
+                                 const unsigned char *b, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    unsigned ne = ~unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (ne) {
+      size_t k = i + size_t(__ctz64(ne));
+      return (a[k] < b[k]) ? -1 : 1;
+    }
+  }
+  return __search_memcmp(a + i, b + i, n - i);
+}
+
+#endif  // NANOSTL_CSTRING_AVX2
+
+#if defined(NANOSTL_CSTRING_AVX2_DISPATCH)
+
+// CPU feature level, detected on first use. Accessed with relaxed atomics;
+// concurrent first calls store the same value.
+template <class T>
+struct __cstring_cpu {
+  static int avx2;  // 0: unknown, 1: no, 2: yes
+};
+
+template <class T>
+int __cstring_cpu<T>::avx2 = 0;
+
+inline bool __cstring_has_avx2() {
+  int level = __atomic_load_n(&__cstring_cpu<void>::avx2, __ATOMIC_RELAXED);
+  if (level == 0) {
+    __builtin_cpu_init();
+    level = __builtin_cpu_supports("avx2") ? 2 : 1;
+    __atomic_store_n(&__cstring_cpu<void>::avx2, level, __ATOMIC_RELAXED);
+  }
+  return level == 2;
+}
+
+#elif defined(NANOSTL_CSTRING_AVX2)
+
+inline bool __cstring_has_avx2() { return true; }
+
+#endif
+
+inline void __cstring_move(unsigned char *d, const unsigned char *s,
+                           size_t n) {
+  if (n <= 32) {
+    __cstring_move_small(d, s, n);
+    return;
+  }
+#if defined(NANOSTL_CSTRING_AVX2)
+  if (__cstring_has_avx2()) {
+    __cstring_move_avx2(d, s, n);
+    return;
+  }
+#endif
+  __cstring_move_large(d, s, n);
+}
+
+inline void __cstring_set(unsigned char *d, unsigned char c, size_t n) {
+  if (n <= 32) {
+    __cstring_set_small(d, c, n);
+    return;
+  }
+#if defined(NANOSTL_CSTRING_AVX2)
+  if (__cstring_has_avx2()) {
+    __cstring_set_avx2(d, c, n);
+    return;
+  }
+#endif
+  __cstring_set_large(d, c, n);
+}
+
+inline size_t __cstring_memchr(const unsigned char *p, size_t n,
+                               unsigned char c) {
+#if defined(NANOSTL_CSTRING_AVX2)
+  if ((n > 32) && __cstring_has_avx2()) {
+    return __cstring_memchr_avx2(p, n, c);
+  }
+#endif
+  return __search_memchr(p, n, c);
+}
+
+inline int __cstring_memcmp(const unsigned char *a, const unsigned char *b,
+                            size_t n) {
+#if defined(NANOSTL_CSTRING_AVX2)
+  if ((n > 32) && __cstring_has_avx2()) {
+    return __cstring_memcmp_avx2(a, b, n);
+  }
+#endif
+  return __search_memcmp(a, b, n);
+}
+
+//
+// Null terminator scans. Blocks are read from aligned addresses, which
+// never cross a page.
+//
+
+// Length of `s`, looking at no more than `max` chars.
+NANOSTL_NO_SANITIZE_ADDRESS
+inline size_t __cstring_strnlen(const unsigned char *s, size_t max) {
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  const B::vec zero = B::splat(0);
+  size_t mis = size_t(reinterpret_cast<uintptr_t>(s) & 15);
+  const unsigned char *a = s - mis;
+  // Drop the bytes before `s` from the first block.
+  uint64_t m = B::mask(B::eq(__cstring_peek_block(a), zero)) >> (mis << B::kShift);
+  size_t n = 0;
+  if (m) {
+    n = size_t(__ctz64(m) >> B::kShift);
+  } else {
+    for (a += 16;; a += 16) {
+      if (size_t(a - s) >= max) {
+        return max;
+      }
+      m = B::mask(B::eq(__cstring_peek_block(a), zero));
+      if (m) {
+        n = size_t(a - s) + size_t(__ctz64(m) >> B::kShift);
+        break;
+      }
+    }
+  }
+  return (n < max) ? n : max;
+#else
+  size_t n = 0;
+  while ((reinterpret_cast<uintptr_t>(s + n) & 7) && (n < max)) {
+    if (s[n] == 0) {
+      return n;
+    }
+    n++;
+  }
+  for (; n < max; n += 8) {
+    uint64_t z = __search_zero_bytes(__cstring_peek64(s + n));
+    if (z) {
+      n += __cstring_first_byte(z);
+      break;
+    }
+  }
+  return (n < max) ? n : max;
+#endif
+}
+
+// First `c` or null in `s`. Returns a pointer to whichever comes first.
+NANOSTL_NO_SANITIZE_ADDRESS
+inline const unsigned char *__cstring_chr_or_null(const unsigned char *s,
+                                                  unsigned char c) {
+#if defined(NANOSTL_STRING_SEARCH_BLOCK)
+  typedef __search_block B;
+  const B::vec zero = B::splat(0);
+  const B::vec vc = B::splat(c);
+  size_t mis = size_t(reinterpret_cast<uintptr_t>(s) & 15);
+  const unsigned char *a = s - mis;
+  B::vec x = __cstring_peek_block(a);
+  uint64_t m = B::mask(B::vor(B::eq(x, zero), B::eq(x, vc))) >>
+               (mis << B::kShift);
+  if (m) {
+    return s + (__ctz64(m) >> B::kShift);
+  }
+  for (a += 16;; a += 16) {
+    x = __cstring_peek_block(a);
+    m = B::mask(B::vor(B::eq(x, zero), B::eq(x, vc)));
+    if (m) {
+      return a + (__ctz64(m) >> B::kShift);
+    }
+  }
+#else
+  while (reinterpret_cast<uintptr_t>(s) & 7) {
+    if ((*s == c) || (*s == 0)) {
+      return s;
+    }
+    s++;
+  }
+  const uint64_t vc = __search_splat(c);
+  for (;; s += 8) {
+    uint64_t w = __cstring_peek64(s);
+    uint64_t z = __search_zero_bytes(w) | __search_zero_bytes(w ^ vc);
+    if (z) {
+      return s + __cstring_first_byte(z);
+    }
+  }
+#endif
+}
+
+// strncmp, comparing 8 bytes at a time while neither read crosses a page.
+NANOSTL_NO_SANITIZE_ADDRESS
+inline int __cstring_strncmp(const unsigned char *a, const unsigned char *b,
+                             size_t n) {
+  size_t i = 0;
+  while (i < n) {
+    if ((n - i >= 8) && __cstring_same_page(a + i, 8) &&
+        __cstring_same_page(b + i, 8)) {
+      uint64_t wa = __cstring_peek64(a + i);
+      uint64_t wb = __cstring_peek64(b + i);
+      uint64_t stop = __cstring_nonzero_bytes(wa ^ wb) | __search_zero_bytes(wa);
+      if (stop == 0) {
+        i += 8;
+        continue;
+      }
+      i += __cstring_first_byte(stop);
+      return int(a[i]) - int(b[i]);
+    }
+    if ((a[i] != b[i]) || (a[i] == 0)) {
+      return int(a[i]) - int(b[i]);
+    }
+    i++;
+  }
+  return 0;
+}
+
+#endif  // !__CUDA_ARCH__
+
+//
+// Public functions.
+//
+
 NANOSTL_HOST_AND_DEVICE_QUAL
-inline void *memcpy(void *dest, const void *src, unsigned long long num)
-{
-  unsigned char *d_ptr = reinterpret_cast<unsigned char *>(dest);
-  const unsigned char *s_ptr = reinterpret_cast<const unsigned char *>(src);
+inline void *memmove(void *dest, const void *src, size_t count) {
+  unsigned char *d = static_cast<unsigned char *>(dest);
+  const unsigned char *s = static_cast<const unsigned char *>(src);
+#if defined(__CUDA_ARCH__)
+  if (d < s) {
+    for (size_t i = 0; i < count; i++) {
+      d[i] = s[i];
+    }
+  } else if (d > s) {
+    for (size_t i = count; i > 0; i--) {
+      d[i - 1] = s[i - 1];
+    }
+  }
+#else
+  __cstring_move(d, s, count);
+#endif
+  return dest;
+}
 
-  for (unsigned long long i = 0; i < num; i++) {
-    d_ptr[i] = s_ptr[i];
+// Also safe for overlapping ranges(same kernels as memmove).
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void *memcpy(void *dest, const void *src, size_t count) {
+#if defined(__CUDA_ARCH__)
+  unsigned char *d = static_cast<unsigned char *>(dest);
+  const unsigned char *s = static_cast<const unsigned char *>(src);
+  for (size_t i = 0; i < count; i++) {
+    d[i] = s[i];
   }
+  return dest;
+#else
+  return memmove(dest, src, count);
+#endif
+}
 
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void *memset(void *dest, int ch, size_t count) {
+  unsigned char *d = static_cast<unsigned char *>(dest);
+#if defined(__CUDA_ARCH__)
+  for (size_t i = 0; i < count; i++) {
+    d[i] = static_cast<unsigned char>(ch);
+  }
+#else
+  __cstring_set(d, static_cast<unsigned char>(ch), count);
+#endif
   return dest;
 }
 
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline int memcmp(const void *lhs, const void *rhs, size_t count) {
+  const unsigned char *a = static_cast<const unsigned char *>(lhs);
+  const unsigned char *b = static_cast<const unsigned char *>(rhs);
+#if defined(__CUDA_ARCH__)
+  return __search_memcmp(a, b, count);
+#else
+  return __cstring_memcmp(a, b, count);
+#endif
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline const void *memchr(const void *ptr, int ch, size_t count) {
+  const unsigned char *p = static_cast<const unsigned char *>(ptr);
+  unsigned char c = static_cast<unsigned char>(ch);
+#if defined(__CUDA_ARCH__)
+  size_t i = __search_memchr(p, count, c);
+#else
+  size_t i = __cstring_memchr(p, count, c);
+#endif
+  return (i == __search_npos) ? 0 : p + i;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline void *memchr(void *ptr, int ch, size_t count) {
+  return const_cast<void *>(
+      memchr(static_cast<const void *>(ptr), ch, count));
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t strlen(const char *str) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(str);
+#if defined(__CUDA_ARCH__)
+  size_t n = 0;
+  while (s[n]) {
+    n++;
+  }
+  return n;
+#else
+  return __cstring_strnlen(s, ~size_t(0));
+#endif
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline int strncmp(const char *lhs, const char *rhs, size_t count) {
+  const unsigned char *a = reinterpret_cast<const unsigned char *>(lhs);
+  const unsigned char *b = reinterpret_cast<const unsigned char *>(rhs);
+#if defined(__CUDA_ARCH__)
+  for (size_t i = 0; i < count; i++) {
+    if ((a[i] != b[i]) || (a[i] == 0)) {
+      return int(a[i]) - int(b[i]);
+    }
+  }
+  return 0;
+#else
+  return __cstring_strncmp(a, b, count);
+#endif
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline int strcmp(const char *lhs, const char *rhs) {
+  return strncmp(lhs, rhs, ~size_t(0));
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline const char *strchr(const char *str, int ch) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(str);
+  unsigned char c = static_cast<unsigned char>(ch);
+#if defined(__CUDA_ARCH__)
+  while ((*s != c) && (*s != 0)) {
+    s++;
+  }
+#else
+  s = __cstring_chr_or_null(s, c);
+#endif
+  return (*s == c) ? reinterpret_cast<const char *>(s) : 0;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strchr(char *str, int ch) {
+  return const_cast<char *>(strchr(static_cast<const char *>(str), ch));
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline const char *strrchr(const char *str, int ch) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(str);
+  // Search the null too, so strrchr(s, 0) finds it.
+  size_t i = __search_memrchr(s, strlen(str) + 1, static_cast<unsigned char>(ch));
+  return (i == __search_npos) ? 0 : str + i;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strrchr(char *str, int ch) {
+  return const_cast<char *>(strrchr(static_cast<const char *>(str), ch));
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline const char *strstr(const char *str, const char *substr) {
+  size_t i = __search_find(reinterpret_cast<const unsigned char *>(str),
+                           strlen(str),
+                           reinterpret_cast<const unsigned char *>(substr),
+                           strlen(substr));
+  return (i == __search_npos) ? 0 : str + i;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strstr(char *str, const char *substr) {
+  return const_cast<char *>(strstr(static_cast<const char *>(str), substr));
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t strspn(const char *dest, const char *src) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+  __search_byteset set(s, strlen(src));
+  size_t i = 0;
+  while (dest[i] && set.has(static_cast<unsigned char>(dest[i]))) {
+    i++;
+  }
+  return i;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline size_t strcspn(const char *dest, const char *src) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+  __search_byteset set(s, strlen(src));
+  size_t i = 0;
+  while (dest[i] && !set.has(static_cast<unsigned char>(dest[i]))) {
+    i++;
+  }
+  return i;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline const char *strpbrk(const char *dest, const char *breakset) {
+  const char *p = dest + strcspn(dest, breakset);
+  return *p ? p : 0;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strpbrk(char *dest, const char *breakset) {
+  return const_cast<char *>(
+      strpbrk(static_cast<const char *>(dest), breakset));
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strcpy(char *dest, const char *src) {
+  memcpy(dest, src, strlen(src) + 1);
+  return dest;
+}
+
+// Copies at most `count` chars and pads with nulls up to `count`.
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strncpy(char *dest, const char *src, size_t count) {
+#if defined(__CUDA_ARCH__)
+  size_t n = 0;
+  while ((n < count) && src[n]) {
+    n++;
+  }
+#else
+  size_t n = __cstring_strnlen(reinterpret_cast<const unsigned char *>(src),
+                               count);
+#endif
+  memcpy(dest, src, n);
+  memset(dest + n, 0, count - n);
+  return dest;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strcat(char *dest, const char *src) {
+  strcpy(dest + strlen(dest), src);
+  return dest;
+}
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+inline char *strncat(char *dest, const char *src, size_t count) {
+  char *end = dest + strlen(dest);
+#if defined(__CUDA_ARCH__)
+  size_t n = 0;
+  while ((n < count) && src[n]) {
+    n++;
+  }
+#else
+  size_t n = __cstring_strnlen(reinterpret_cast<const unsigned char *>(src),
+                               count);
+#endif
+  memcpy(end, src, n);
+  end[n] = '\0';
+  return dest;
+}
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
 }  // namespace nanostl
 
 #endif  // NANOSTL_CSTRING_H_
@@ -25,11 +25,78 @@
 #ifndef NANOSTL_EXECUTION_H_
 #define NANOSTL_EXECUTION_H_
 
+#include "nanocommon.h"
+
+#if !defined(NANOSTL_NO_THREAD)
+#include "nanothread_pool.h"
+#endif
+
+//
+// Backend of the parallel algorithms. Declared regardless of NANOSTL_PSTL,
+// so libnanostl(src/nanoalgorithm.cc) can be built without C++17.
+//
+namespace nanostl {
+namespace __pstl {
+
+#if !defined(NANOSTL_NO_THREAD)
+// Shared by all parallel algorithms. Started on first use.
+thread_pool &__default_pool();
+
+// Smallest chunk index reported so far, shared by the chunks of one call
+// (find_if skips chunks after a match). libs_thread atomics.
+class __shared_min {
+ public:
+  explicit __shared_min(int __v);
+  int load();
+  void update(int __v);
+
+ private:
+  // Same layout as libs_thread's thread_atomic_int_t.
+  union {
+    void *__align_;
+    long __i_;
+  } __v_;
+};
+#else
+class __shared_min {
+ public:
+  explicit __shared_min(int __v) : __v_(__v) {}
+  int load() { return __v_; }
+  void update(int __v) {
+    if (__v < __v_) {
+      __v_ = __v;
+    }
+  }
+
+ private:
+  int __v_;
+};
+#endif
+
+} // namespace __pstl
+} // namespace nanostl
+
 #if defined(NANOSTL_PSTL)
 
+#include "nanoiterator.h"
+#include "nanotype_traits.h"
+
 namespace nanostl {
 namespace execution {
 
+//
+// Parallel policies split the range into chunks run on a process-wide
+// thread_pool(link with libnanostl). Unsequenced policies mark the inner
+// loop with NANOSTL_PRAGMA_SIMD. Parallel execution needs random access
+// iterators and falls back to the calling thread otherwise, or when
+// NANOSTL_NO_THREAD is defined.
+//
+
+class sequenced_policy
+{
+  public:
+};
+
 class parallel_policy
 {
   public:
@@ -40,10 +107,130 @@ class parallel_unsequenced_policy
   public:
 };
 
+class unsequenced_policy
+{
+  public:
+};
+
+inline constexpr sequenced_policy seq{};
 inline constexpr parallel_policy par{};
-inline constexpr parallel_policy par_unseq{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+inline constexpr unsequenced_policy unseq{};
 
 } // namespace execution
+
+template <class _Tp> struct is_execution_policy : public false_type {};
+template <> struct is_execution_policy<execution::sequenced_policy> : public true_type {};
+template <> struct is_execution_policy<execution::parallel_policy> : public true_type {};
+template <> struct is_execution_policy<execution::parallel_unsequenced_policy> : public true_type {};
+template <> struct is_execution_policy<execution::unsequenced_policy> : public true_type {};
+
+template <class _Tp>
+inline constexpr bool is_execution_policy_v = is_execution_policy<_Tp>::value;
+
+namespace __pstl {
+
+template <class _Pp>
+using __policy_t = typename remove_cv<typename remove_reference<_Pp>::type>::type;
+
+// Return type `_Rp` of an algorithm overload taking policy `_Pp`. Keeps the
+// overloads out of the way of the serial ones with the same arity.
+template <class _Pp, class _Rp>
+using __enable_if_policy_t =
+    typename enable_if<is_execution_policy<__policy_t<_Pp> >::value, _Rp>::type;
+
+template <class _Pp> struct __is_parallel : public false_type {};
+template <> struct __is_parallel<execution::parallel_policy> : public true_type {};
+template <> struct __is_parallel<execution::parallel_unsequenced_policy> : public true_type {};
+
+template <class _Pp> struct __is_unsequenced : public false_type {};
+template <> struct __is_unsequenced<execution::unsequenced_policy> : public true_type {};
+template <> struct __is_unsequenced<execution::parallel_unsequenced_policy> : public true_type {};
+
+// Ranges shorter than this are not worth waking the pool for, and chunks
+// are never made smaller.
+constexpr size_t __min_chunk_size = 4096;
+
+// Fixed partition of [0, n) into `count` chunks of `grain` elements(the
+// last one may be shorter). Algorithms that combine per-chunk results rely
+// on the boundaries not depending on scheduling.
+struct __chunks {
+  size_t n;
+  size_t grain;
+  size_t count;
+
+  size_t begin(size_t __c) const { return __c * grain; }
+  size_t end(size_t __c) const {
+    return (n - begin(__c) > grain) ? (begin(__c) + grain) : n;
+  }
+};
+
+// One chunk unless the policy is parallel and the range is large.
+template <class _Pp>
+inline __chunks __make_chunks(size_t __n) {
+  __chunks __c;
+  __c.n = __n;
+  __c.grain = __n;
+  __c.count = (__n > 0) ? 1 : 0;
+#if !defined(NANOSTL_NO_THREAD)
+  if constexpr (__is_parallel<_Pp>::value) {
+    if (__n >= 2 * __min_chunk_size) {
+      // About 8 chunks per thread(the caller works too) for load balance.
+      const size_t __threads = size_t(__default_pool().size()) + 1;
+      __c.grain = __n / (8 * __threads);
+      if (__c.grain < __min_chunk_size) {
+        __c.grain = __min_chunk_size;
+      }
+      __c.count = (__n + __c.grain - 1) / __c.grain;
+    }
+  }
+#endif
+  return __c;
+}
+
+// Calls `f(c, begin, end)` for every chunk c, on the pool when there is
+// more than one.
+template <class _Fp>
+inline void __for_each_chunk(const __chunks &__c, _Fp &&__f) {
+#if !defined(NANOSTL_NO_THREAD)
+  if (__c.count > 1) {
+    __default_pool().parallel_for(
+        0, __c.count,
+        [&__c, &__f](size_t __k) { __f(__k, __c.begin(__k), __c.end(__k)); },
+        1);
+    return;
+  }
+#endif
+  if (__c.count == 1) {
+    __f(size_t(0), size_t(0), __c.n);
+  }
+}
+
+// Calls `f(begin, end)` over chunks covering [0, n). With a parallel
+// policy the chunks run on the pool, otherwise `f(0, n)` runs inline.
+template <class _Pp, class _Fp>
+inline void __for_chunks(size_t __n, _Fp &&__f) {
+  __for_each_chunk(__make_chunks<_Pp>(__n),
+                   [&__f](size_t, size_t __b, size_t __e) { __f(__b, __e); });
+}
+
+// Calls `f(i)` for i in [0, n), as a SIMD loop for unsequenced policies.
+template <class _Pp, class _Fp>
+inline void __loop(size_t __n, _Fp &&__f) {
+  if constexpr (__is_unsequenced<_Pp>::value) {
+    NANOSTL_PRAGMA_SIMD
+    for (size_t __i = 0; __i < __n; ++__i) {
+      __f(__i);
+    }
+  } else {
+    for (size_t __i = 0; __i < __n; ++__i) {
+      __f(__i);
+    }
+  }
+}
+
+} // namespace __pstl
+
 } // namespace nanostl
 
 #endif // NANOSTL_PSTL
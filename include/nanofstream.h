@@ -0,0 +1,379 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_FSTREAM_H_
+#define NANOSTL_FSTREAM_H_
+
+#include "nanoios.h"
+#include "nanoiosfwd.h"
+#include "nanoostream.h"
+#include "nanostreambuf.h"
+#include "nanostring.h"
+#include "__nullptr"
+
+#ifndef NANOSTL_NO_IO
+
+#include <stdio.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <errno.h>
+
+// Default size of the output buffer of basic_filebuf(in characters).
+#ifndef NANOSTL_FILEBUF_BUFFER_SIZE
+#define NANOSTL_FILEBUF_BUFFER_SIZE 8192
+#endif
+
+namespace nanostl {
+
+//
+// Output-only file buffer. The sink is either a FILE*(opened by open() or
+// attached) or a file descriptor(attached). Writes are collected in the put
+// area and drained on overflow, sync() and close(); a write that does not
+// fit in the buffer is passed to the sink directly instead of being copied.
+//
+// setbuf(s, n) controls buffering: a caller buffer when `s` is given,
+// an owned buffer of `n` characters when `s` is nullptr(nanostl extension),
+// and unbuffered output when both are 0.
+//
+template <class _CharT, class _Traits>
+class basic_filebuf
+    : public basic_streambuf<_CharT, _Traits>
+{
+public:
+    typedef _CharT                           char_type;
+    typedef _Traits                          traits_type;
+    typedef typename traits_type::int_type   int_type;
+    typedef typename traits_type::pos_type   pos_type;
+    typedef typename traits_type::off_type   off_type;
+
+    basic_filebuf()
+        : __file_(nullptr), __fd_(-1), __owns_file_(false),
+          __buf_(nullptr), __buf_size_(NANOSTL_FILEBUF_BUFFER_SIZE),
+          __owns_buf_(false) {}
+
+    virtual ~basic_filebuf()
+    {
+        close();
+        __release_buffer();
+    }
+
+    inline bool is_open() const {return __file_ != nullptr || __fd_ >= 0;}
+
+    // Opens `__s` for output. Input modes are not supported.
+    basic_filebuf* open(const char* __s, ios_base::openmode __mode);
+    basic_filebuf* open(const string& __s, ios_base::openmode __mode)
+        {return open(__s.c_str(), __mode);}
+
+    // Writes to an already open FILE* or file descriptor. close() flushes
+    // but does not close them.
+    basic_filebuf* attach(FILE* __fp);
+    basic_filebuf* attach(int __fd);
+
+    basic_filebuf* close();
+
+protected:
+    virtual basic_streambuf<char_type, traits_type>* setbuf(char_type* __s, streamsize __n);
+    virtual int sync();
+    virtual int_type overflow(int_type __c = traits_type::eof());
+    virtual streamsize xsputn(const char_type* __s, streamsize __n);
+
+private:
+    basic_filebuf(const basic_filebuf&);
+    basic_filebuf& operator=(const basic_filebuf&);
+
+    bool __write(const char_type* __s, size_t __n);
+    bool __drain();
+    void __release_buffer();
+
+    FILE* __file_;
+    int __fd_;
+    bool __owns_file_;
+    char_type* __buf_;
+    size_t __buf_size_;
+    bool __owns_buf_;
+};
+
+template <class _CharT, class _Traits>
+basic_filebuf<_CharT, _Traits>*
+basic_filebuf<_CharT, _Traits>::open(const char* __s, ios_base::openmode __mode)
+{
+    if (is_open())
+        return nullptr;
+
+    const char* __mdstr;
+    switch (__mode & ~(ios_base::ate | ios_base::binary))
+    {
+    case ios_base::out:
+    case ios_base::out | ios_base::trunc:
+        __mdstr = (__mode & ios_base::binary) ? "wb" : "w";
+        break;
+    case ios_base::app:
+    case ios_base::out | ios_base::app:
+        __mdstr = (__mode & ios_base::binary) ? "ab" : "a";
+        break;
+    default:
+        return nullptr;
+    }
+
+    __file_ = fopen(__s, __mdstr);
+    if (!__file_)
+        return nullptr;
+    __owns_file_ = true;
+    return this;
+}
+
+template <class _CharT, class _Traits>
+basic_filebuf<_CharT, _Traits>*
+basic_filebuf<_CharT, _Traits>::attach(FILE* __fp)
+{
+    if (is_open() || !__fp)
+        return nullptr;
+    __file_ = __fp;
+    __owns_file_ = false;
+    return this;
+}
+
+template <class _CharT, class _Traits>
+basic_filebuf<_CharT, _Traits>*
+basic_filebuf<_CharT, _Traits>::attach(int __fd)
+{
+    if (is_open() || (__fd < 0))
+        return nullptr;
+    __fd_ = __fd;
+    return this;
+}
+
+template <class _CharT, class _Traits>
+basic_filebuf<_CharT, _Traits>*
+basic_filebuf<_CharT, _Traits>::close()
+{
+    if (!is_open())
+        return nullptr;
+
+    basic_filebuf* __r = this;
+    if (sync() == -1)
+        __r = nullptr;
+    if (__file_ && __owns_file_ && (fclose(__file_) != 0))
+        __r = nullptr;
+    __file_ = nullptr;
+    __fd_ = -1;
+    __owns_file_ = false;
+    this->setp(nullptr, nullptr);
+    return __r;
+}
+
+template <class _CharT, class _Traits>
+basic_streambuf<_CharT, _Traits>*
+basic_filebuf<_CharT, _Traits>::setbuf(char_type* __s, streamsize __n)
+{
+    if (!__drain())
+        return nullptr;
+    __release_buffer();
+    if (__s && (__n > 0))
+    {
+        __buf_ = __s;
+        __buf_size_ = static_cast<size_t>(__n);
+        this->setp(__buf_, __buf_ + __buf_size_);
+    }
+    else
+    {
+        // Allocated on the first write.
+        __buf_size_ = (__n > 0) ? static_cast<size_t>(__n) : 0;
+        this->setp(nullptr, nullptr);
+    }
+    return this;
+}
+
+template <class _CharT, class _Traits>
+int
+basic_filebuf<_CharT, _Traits>::sync()
+{
+    if (!is_open())
+        return 0;
+    if (!__drain())
+        return -1;
+    if (__file_ && (fflush(__file_) != 0))
+        return -1;
+    return 0;
+}
+
+template <class _CharT, class _Traits>
+typename basic_filebuf<_CharT, _Traits>::int_type
+basic_filebuf<_CharT, _Traits>::overflow(int_type __c)
+{
+    if (!is_open() || !__drain())
+        return traits_type::eof();
+
+    // close() drops the put area but keeps the buffer for a reopen.
+    if (!this->pbase() && __buf_size_)
+    {
+        if (!__buf_)
+        {
+            __buf_ = new char_type[__buf_size_];
+            __owns_buf_ = true;
+        }
+        this->setp(__buf_, __buf_ + __buf_size_);
+    }
+
+    if (traits_type::eq_int_type(__c, traits_type::eof()))
+        return traits_type::not_eof(__c);
+
+    char_type __ch = traits_type::to_char_type(__c);
+    if (this->pptr() == this->epptr())
+    {
+        // Unbuffered.
+        if (!__write(&__ch, 1))
+            return traits_type::eof();
+    }
+    else
+    {
+        *this->pptr() = __ch;
+        this->pbump(1);
+    }
+    return __c;
+}
+
+template <class _CharT, class _Traits>
+streamsize
+basic_filebuf<_CharT, _Traits>::xsputn(const char_type* __s, streamsize __n)
+{
+    // Only called when [__s, __s + __n) does not fit in the put area.
+    if (static_cast<size_t>(__n) < __buf_size_)
+        return basic_streambuf<char_type, traits_type>::xsputn(__s, __n);
+
+    if (!is_open() || !__drain() || !__write(__s, static_cast<size_t>(__n)))
+        return 0;
+    return __n;
+}
+
+template <class _CharT, class _Traits>
+bool
+basic_filebuf<_CharT, _Traits>::__write(const char_type* __s, size_t __n)
+{
+    if (__file_)
+        return fwrite(__s, sizeof(char_type), __n, __file_) == __n;
+
+    const char* __p = reinterpret_cast<const char*>(__s);
+    size_t __len = __n * sizeof(char_type);
+    while (__len > 0)
+    {
+#if defined(_WIN32)
+        int __chunk = (__len > 0x40000000u) ? 0x40000000 : static_cast<int>(__len);
+        int __k = _write(__fd_, __p, static_cast<unsigned int>(__chunk));
+#else
+        ssize_t __k = ::write(__fd_, __p, __len);
+#endif
+        if (__k < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        __p += __k;
+        __len -= static_cast<size_t>(__k);
+    }
+    return true;
+}
+
+// Writes out the pending put area.
+template <class _CharT, class _Traits>
+bool
+basic_filebuf<_CharT, _Traits>::__drain()
+{
+    if (this->pbase() == this->pptr())
+        return true;
+    bool __ok = __write(this->pbase(), static_cast<size_t>(this->pptr() - this->pbase()));
+    this->setp(this->pbase(), this->epptr());
+    return __ok;
+}
+
+template <class _CharT, class _Traits>
+void
+basic_filebuf<_CharT, _Traits>::__release_buffer()
+{
+    if (__owns_buf_)
+        delete [] __buf_;
+    __buf_ = nullptr;
+    __owns_buf_ = false;
+}
+
+template <class _CharT, class _Traits>
+class basic_ofstream
+    : public basic_ostream<_CharT, _Traits>
+{
+public:
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+
+    basic_ofstream() {this->init(&__sb_);}
+
+    explicit basic_ofstream(const char* __s, ios_base::openmode __mode = ios_base::out)
+    {
+        this->init(&__sb_);
+        open(__s, __mode);
+    }
+
+    explicit basic_ofstream(const string& __s, ios_base::openmode __mode = ios_base::out)
+    {
+        this->init(&__sb_);
+        open(__s, __mode);
+    }
+
+    inline basic_filebuf<char_type, traits_type>* rdbuf() const
+        {return const_cast<basic_filebuf<char_type, traits_type>*>(&__sb_);}
+
+    inline bool is_open() const {return __sb_.is_open();}
+
+    void open(const char* __s, ios_base::openmode __mode = ios_base::out)
+    {
+        if (__sb_.open(__s, __mode | ios_base::out))
+            this->clear();
+        else
+            this->setstate(ios_base::failbit);
+    }
+
+    void open(const string& __s, ios_base::openmode __mode = ios_base::out)
+        {open(__s.c_str(), __mode);}
+
+    void close()
+    {
+        if (__sb_.close() == nullptr)
+            this->setstate(ios_base::failbit);
+    }
+
+private:
+    basic_filebuf<char_type, traits_type> __sb_;
+};
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_NO_IO
+
+#endif  // NANOSTL_FSTREAM_H_
@@ -31,6 +31,8 @@
 
 #include "__hashfunc.h"
 #include "__nullptr"
+#include "nanotype_traits.h"
+#include "nanoutility.h"
 
 namespace nanostl {
 
@@ -43,10 +45,70 @@ struct less {
   }
 };
 
+// equal_to
 
+template<class T = void>
+struct equal_to {
+  bool operator()(const T& lhs, const T& rhs) const {
+    return lhs == rhs;
+  }
+};
+
+// Transparent comparison, for heterogeneous lookup in hash containers.
+template<>
+struct equal_to<void> {
+  typedef void is_transparent;
+
+  template<class T, class U>
+  bool operator()(const T& lhs, const U& rhs) const {
+    return lhs == rhs;
+  }
+};
+
+
+// plus
+
+template<class T = void>
+struct plus {
+  T operator()(const T& lhs, const T& rhs) const {
+    return lhs + rhs;
+  }
+};
+
+template<>
+struct plus<void> {
+  typedef void is_transparent;
+
+  template<class T, class U>
+  auto operator()(T&& lhs, U&& rhs) const -> decltype(nanostl::forward<T>(lhs) + nanostl::forward<U>(rhs)) {
+    return nanostl::forward<T>(lhs) + nanostl::forward<U>(rhs);
+  }
+};
+
+// multiplies
+
+template<class T = void>
+struct multiplies {
+  T operator()(const T& lhs, const T& rhs) const {
+    return lhs * rhs;
+  }
+};
+
+template<>
+struct multiplies<void> {
+  typedef void is_transparent;
+
+  template<class T, class U>
+  auto operator()(T&& lhs, U&& rhs) const -> decltype(nanostl::forward<T>(lhs) * nanostl::forward<U>(rhs)) {
+    return nanostl::forward<T>(lhs) * nanostl::forward<U>(rhs);
+  }
+};
 
 // from libc++ =======
 
+// Hashes defining `__is_avalanching` already mix every input bit into every
+// output bit, so the hash tables use them as is. Other(user) hashers get an
+// extra mixing step.
 template< class Key > struct hash;
 //template<> struct hash<int>;
 //template<> struct hash<unsigned int>;
@@ -54,67 +116,78 @@ template< class Key > struct hash;
 template <>
 struct hash<bool>
 {
-    size_t operator()(bool __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(bool __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<signed char>
 {
-    size_t operator()(signed char __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(signed char __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<unsigned char>
 {
-    size_t operator()(unsigned char __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(unsigned char __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<signed short>
 {
-    size_t operator()(signed short __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(signed short __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<unsigned short>
 {
-    size_t operator()(unsigned short __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(unsigned short __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<int>
 {
-    size_t operator()(int __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(int __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<unsigned int>
 {
-    size_t operator()(unsigned int __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(unsigned int __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<long>
 {
-    size_t operator()(long __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(long __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<unsigned long>
 {
-    size_t operator()(unsigned long __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(unsigned long __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<long long>
 {
-    size_t operator()(long long __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(long long __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <>
 struct hash<unsigned long long>
 {
-    size_t operator()(unsigned long long __v) const noexcept {return static_cast<size_t>(__v);}
+    typedef void __is_avalanching;
+    size_t operator()(unsigned long long __v) const noexcept {return static_cast<size_t>(__hash_mix64(static_cast<uint64_t>(__v)));}
 };
 
 template <class _Tp, size_t = sizeof(_Tp) / sizeof(size_t)>
@@ -123,6 +196,7 @@ struct __scalar_hash;
 template <class _Tp>
 struct __scalar_hash<_Tp, 0>
 {
+    typedef void __is_avalanching;
     size_t operator()(_Tp __v) const noexcept
     {
         union
@@ -132,13 +206,14 @@ struct __scalar_hash<_Tp, 0>
         } __u;
         __u.__a = 0;
         __u.__t = __v;
-        return __u.__a;
+        return static_cast<size_t>(__hash_mix64(__u.__a));
     }
 };
 
 template <class _Tp>
 struct __scalar_hash<_Tp, 1>
 {
+    typedef void __is_avalanching;
     size_t operator()(_Tp __v) const noexcept
     {
         union
@@ -148,7 +223,7 @@ struct __scalar_hash<_Tp, 1>
         } __u;
         __u.__a = 0;
         __u.__t = __v;
-        return __u.__a;
+        return static_cast<size_t>(__hash_mix64(__u.__a));
     }
 };
 
@@ -182,6 +257,17 @@ struct hash<nullptr_t>
     size_t operator()(nullptr_t) const noexcept {return 662607004ull;}
 };
 
+template <class _Tp>
+struct hash<_Tp*>
+{
+    typedef void __is_avalanching;
+    size_t operator()(_Tp* __v) const noexcept
+    {
+        return static_cast<size_t>(
+            __hash_mix64(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(__v))));
+    }
+};
+
 // TODO: long double
 
 // ===================
@@ -28,12 +28,42 @@
 #include "nanoiosfwd.h"
 #include "nanotype_traits.h"
 #include "__string"
+#include "__nullptr"
 
 namespace nanostl {
 
 // ptrdiff_t is implementation dependent, but usually `long int`(int64 for 64bit system)
 typedef long int streamsize;
 
+// Stream position. nanostl has no multibyte conversion state, so this is
+// just an offset.
+template <class _State>
+class fpos
+{
+    streamoff __off_;
+public:
+    fpos(streamoff __off = streamoff()) : __off_(__off) {}
+
+    operator streamoff() const {return __off_;}
+
+    fpos& operator+=(streamoff __off) {__off_ += __off; return *this;}
+    fpos  operator+ (streamoff __off) const {fpos __t(*this); __t += __off; return __t;}
+    fpos& operator-=(streamoff __off) {__off_ -= __off; return *this;}
+    fpos  operator- (streamoff __off) const {fpos __t(*this); __t -= __off; return __t;}
+};
+
+template <class _State>
+inline streamoff operator-(const fpos<_State>& __x, const fpos<_State>& __y)
+    {return streamoff(__x) - streamoff(__y);}
+
+template <class _State>
+inline bool operator==(const fpos<_State>& __x, const fpos<_State>& __y)
+    {return streamoff(__x) == streamoff(__y);}
+
+template <class _State>
+inline bool operator!=(const fpos<_State>& __x, const fpos<_State>& __y)
+    {return streamoff(__x) != streamoff(__y);}
+
 class ios_base {
  public:
   typedef unsigned int fmtflags;
@@ -75,24 +105,95 @@ class ios_base {
   class Init;
 
   // destructor
-  virtual ~ios_base();
+  virtual ~ios_base() {}
 
+  // 27.5.2.2 fmtflags state:
+  inline fmtflags flags() const {return __fmtflags_;}
+  inline fmtflags flags(fmtflags __fmtfl)
+  {
+    fmtflags __r = __fmtflags_;
+    __fmtflags_ = __fmtfl;
+    return __r;
+  }
+  inline fmtflags setf(fmtflags __fmtfl)
+  {
+    fmtflags __r = __fmtflags_;
+    __fmtflags_ |= __fmtfl;
+    return __r;
+  }
+  inline fmtflags setf(fmtflags __fmtfl, fmtflags __mask)
+  {
+    fmtflags __r = __fmtflags_;
+    __fmtflags_ = (__fmtflags_ & ~__mask) | (__fmtfl & __mask);
+    return __r;
+  }
+  inline void unsetf(fmtflags __mask) {__fmtflags_ &= ~__mask;}
 
-  inline bool good() const;
-  inline bool eof() const;
-  inline bool fail() const;
-  inline bool bad() const;
+  // Floating point output is shortest round trip(to_chars), so precision
+  // is stored but not used for formatting yet.
+  inline streamsize precision() const {return __precision_;}
+  inline streamsize precision(streamsize __prec)
+  {
+    streamsize __r = __precision_;
+    __precision_ = __prec;
+    return __r;
+  }
 
+  inline streamsize width() const {return __width_;}
+  inline streamsize width(streamsize __wide)
+  {
+    streamsize __r = __width_;
+    __width_ = __wide;
+    return __r;
+  }
 
+  inline iostate rdstate() const {return __rdstate_;}
+  // badbit is always set while there is no stream buffer.
+  inline void clear(iostate __state = goodbit)
+  {
+    __rdstate_ = __rdbuf_ ? __state : (__state | badbit);
+  }
+  inline void setstate(iostate __state) {clear(__rdstate_ | __state);}
+
+  inline bool good() const {return __rdstate_ == 0;}
+  inline bool eof() const {return (__rdstate_ & eofbit) != 0;}
+  inline bool fail() const {return (__rdstate_ & (failbit | badbit)) != 0;}
+  inline bool bad() const {return (__rdstate_ & badbit) != 0;}
 
 private:
     ios_base(const ios_base&) = delete;
     ios_base& operator=(const ios_base&) = delete;
 
 protected:
+    // Members are set by init().
     ios_base() {
                }
 
+    void init(void* __sb)
+    {
+        __rdbuf_ = __sb;
+        __rdstate_ = __rdbuf_ ? goodbit : badbit;
+        __fmtflags_ = skipws | dec;
+        __precision_ = 6;
+        __width_ = 0;
+    }
+
+    // Copies the format flags and the stream state, not the buffer.
+    void __copy_state(const ios_base& __rhs)
+    {
+        __fmtflags_ = __rhs.__fmtflags_;
+        __precision_ = __rhs.__precision_;
+        __width_ = __rhs.__width_;
+        __rdstate_ = __rhs.__rdstate_;
+    }
+
+    void* __rdbuf_;
+
+private:
+    fmtflags __fmtflags_;
+    streamsize __precision_;
+    streamsize __width_;
+    iostate __rdstate_;
 };
 
 // Based on libcxx ----------------------------
@@ -107,7 +208,7 @@ public:
     typedef _Traits traits_type;
 
     typedef typename traits_type::int_type int_type;
-    //typedef typename traits_type::pos_type pos_type; // TODO
+    typedef typename traits_type::pos_type pos_type;
     typedef typename traits_type::off_type off_type;
 
     static_assert((is_same<_CharT, typename traits_type::char_type>::value),
@@ -117,14 +218,61 @@ public:
     explicit operator bool() const {return !fail();}
 
     inline bool operator!() const    {return  fail();}
-    //inline iostate rdstate() const   {return ios_base::rdstate();}
-    //inline void clear(iostate __state = goodbit) {ios_base::clear(__state);}
-    //inline void setstate(iostate __state) {ios_base::setstate(__state);}
+    inline iostate rdstate() const   {return ios_base::rdstate();}
+    inline void clear(iostate __state = goodbit) {ios_base::clear(__state);}
+    inline void setstate(iostate __state) {ios_base::setstate(__state);}
     inline bool good() const {return ios_base::good();}
     inline bool eof() const  {return ios_base::eof();}
     inline bool fail() const {return ios_base::fail();}
     inline bool bad() const  {return ios_base::bad();}
 
+    explicit basic_ios(basic_streambuf<char_type, traits_type>* __sb) {init(__sb);}
+    virtual ~basic_ios() {}
+
+    inline basic_streambuf<char_type, traits_type>* rdbuf() const
+        {return static_cast<basic_streambuf<char_type, traits_type>*>(__rdbuf_);}
+    inline basic_streambuf<char_type, traits_type>* rdbuf(basic_streambuf<char_type, traits_type>* __sb)
+    {
+        basic_streambuf<char_type, traits_type>* __r = rdbuf();
+        __rdbuf_ = __sb;
+        clear();
+        return __r;
+    }
+
+    inline char_type fill() const {return __fill_;}
+    inline char_type fill(char_type __ch)
+    {
+        char_type __r = __fill_;
+        __fill_ = __ch;
+        return __r;
+    }
+
+    inline char_type widen(char __c) const {return char_type(__c);}
+
+protected:
+    basic_ios() {}
+
+    void init(basic_streambuf<char_type, traits_type>* __sb)
+    {
+        ios_base::init(__sb);
+        __fill_ = widen(' ');
+    }
+
+    // Takes over the state of __rhs, leaving rdbuf() null(the derived
+    // stream sets its own buffer with set_rdbuf()).
+    void move(basic_ios& __rhs)
+    {
+        ios_base::__copy_state(__rhs);
+        __fill_ = __rhs.__fill_;
+        __rdbuf_ = nullptr;
+    }
+
+    // Unlike rdbuf(__sb), keeps the stream state.
+    inline void set_rdbuf(basic_streambuf<char_type, traits_type>* __sb)
+        {__rdbuf_ = __sb;}
+
+private:
+    char_type __fill_;
 };
 
 class ios_base::Init
@@ -134,6 +282,24 @@ public:
     ~Init();
 };
 
+// 27.5.6 ios_base manipulators:
+
+inline ios_base& boolalpha(ios_base& __str) {__str.setf(ios_base::boolalpha); return __str;}
+inline ios_base& noboolalpha(ios_base& __str) {__str.unsetf(ios_base::boolalpha); return __str;}
+inline ios_base& unitbuf(ios_base& __str) {__str.setf(ios_base::unitbuf); return __str;}
+inline ios_base& nounitbuf(ios_base& __str) {__str.unsetf(ios_base::unitbuf); return __str;}
+
+inline ios_base& left(ios_base& __str) {__str.setf(ios_base::left, ios_base::adjustfield); return __str;}
+inline ios_base& right(ios_base& __str) {__str.setf(ios_base::right, ios_base::adjustfield); return __str;}
+
+inline ios_base& dec(ios_base& __str) {__str.setf(ios_base::dec, ios_base::basefield); return __str;}
+inline ios_base& hex(ios_base& __str) {__str.setf(ios_base::hex, ios_base::basefield); return __str;}
+inline ios_base& oct(ios_base& __str) {__str.setf(ios_base::oct, ios_base::basefield); return __str;}
+
+inline ios_base& fixed(ios_base& __str) {__str.setf(ios_base::fixed, ios_base::floatfield); return __str;}
+inline ios_base& scientific(ios_base& __str) {__str.setf(ios_base::scientific, ios_base::floatfield); return __str;}
+inline ios_base& hexfloat(ios_base& __str) {__str.setf(ios_base::fixed | ios_base::scientific, ios_base::floatfield); return __str;}
+inline ios_base& defaultfloat(ios_base& __str) {__str.unsetf(ios_base::floatfield); return __str;}
 
 }  // namespace nanostl
 
@@ -40,13 +40,50 @@ struct char_traits<char32_t>;
 template <>
 struct char_traits<wchar_t>;
 
+template <class _Tp>
+class allocator;
+
+template <class _CharT, class _Traits = char_traits<_CharT> >
+class basic_ios;
+
 template <class charT, class traits = char_traits<charT> >
 class basic_streambuf;
 template <class _CharT, class _Traits = char_traits<_CharT> >
+class basic_istream;
+template <class _CharT, class _Traits = char_traits<_CharT> >
 class basic_ostream;
+template <class _CharT, class _Traits = char_traits<_CharT> >
+class basic_iostream;
+
+template <class _CharT, class _Traits = char_traits<_CharT>,
+          class _Allocator = allocator<_CharT> >
+class basic_stringbuf;
+template <class _CharT, class _Traits = char_traits<_CharT>,
+          class _Allocator = allocator<_CharT> >
+class basic_istringstream;
+template <class _CharT, class _Traits = char_traits<_CharT>,
+          class _Allocator = allocator<_CharT> >
+class basic_ostringstream;
+template <class _CharT, class _Traits = char_traits<_CharT>,
+          class _Allocator = allocator<_CharT> >
+class basic_stringstream;
+
+template <class _CharT, class _Traits = char_traits<_CharT> >
+class basic_filebuf;
+template <class _CharT, class _Traits = char_traits<_CharT> >
+class basic_ofstream;
 
+typedef basic_ios<char> ios;
 typedef basic_streambuf<char> streambuf;
+typedef basic_istream<char> istream;
 typedef basic_ostream<char> ostream;
+typedef basic_iostream<char> iostream;
+typedef basic_stringbuf<char> stringbuf;
+typedef basic_istringstream<char> istringstream;
+typedef basic_ostringstream<char> ostringstream;
+typedef basic_stringstream<char> stringstream;
+typedef basic_filebuf<char> filebuf;
+typedef basic_ofstream<char> ofstream;
 
 template <class _State>             class fpos;
 
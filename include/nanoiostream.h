@@ -25,176 +25,21 @@
 #ifndef NANOSTL_IOSTREAM_H_
 #define NANOSTL_IOSTREAM_H_
 
-#ifdef NANOSTL_DEBUG
-#include <stdio.h>
-#endif
-
 #include "nanoiosfwd.h"
 #include "nanoios.h"
+#include "nanoostream.h"
+#include "nanofstream.h"
 #include "nanosstream.h"
 #include "__nullptr"
 
 namespace nanostl {
 
-// Based on libcxx ----------------------
-
-template <class _CharT, class _Traits>
-class basic_ostream
-    : virtual public basic_ios<_CharT, _Traits>
-{
-public:
-    // types (inherited from basic_ios (27.5.4)):
-    typedef _CharT                         char_type;
-    typedef _Traits                        traits_type;
-    typedef typename traits_type::int_type int_type;
-    typedef typename traits_type::pos_type pos_type;
-    typedef typename traits_type::off_type off_type;
-
-
-    basic_ostream& operator<<(bool __n);
-    basic_ostream& operator<<(short __n);
-    basic_ostream& operator<<(unsigned short __n);
-    basic_ostream& operator<<(int __n);
-    basic_ostream& operator<<(unsigned int __n);
-    //basic_ostream& operator<<(long __n);
-    //basic_ostream& operator<<(unsigned long __n);
-    basic_ostream& operator<<(long long __n);
-    basic_ostream& operator<<(unsigned long long __n);
-    basic_ostream& operator<<(float __f);
-    basic_ostream& operator<<(double __f);
-    basic_ostream& operator<<(long double __f);
-    basic_ostream& operator<<(const void* __p);
-
-    basic_ostream& operator<<(basic_streambuf<char_type, traits_type>* __sb);
-
-    inline
-    basic_ostream& operator<<(nullptr_t)
-    { return *this << "nullptr"; }
-
-    // 27.7.2.7 Unformatted output:
-    basic_ostream& put(char_type __c);
-    basic_ostream& write(const char_type* __s, streamsize __n);
-    basic_ostream& flush();
-
-protected:
-    // TODO: Uncomment
-    //basic_ostream() {}
-
-private:
-    // FIXME
-    stringstream _ss;
-
-};
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(bool __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(short __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(unsigned short __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(int __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(unsigned int __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(long long __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(unsigned long long __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(float __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template <class _CharT, class _Traits>
-basic_ostream<_CharT, _Traits>&
-basic_ostream<_CharT, _Traits>::operator<<(double __n)
-{
-
-  _ss << nanostl::to_string(__n);
-
-  return *this;
-}
-
-template<>
-basic_ostream<char, nanostl::char_traits<char>>&
-basic_ostream<char, nanostl::char_traits<char>>::operator<<(const void *__n)
-{
-  // FIXME: Assume const char *
-  string str = nanostl::string(static_cast<const char *>(__n));
-  _ss << str;
-
-#ifdef NANOSTL_DEBUG
-  printf("n : %s\n", str.c_str());
-  printf("string: %s\n", _ss.str().c_str());
-#endif
-  return *this;
-}
-
-
-// --------------------------------------
-
 // Need to link with iostream.cc
+//
+// cout and cerr write to stdout/stderr through their own filebuf, so text
+// printed with printf() only interleaves at flush points(like
+// sync_with_stdio(false)). cout is flushed by endl, flush() and at exit;
+// cerr is unit-buffered.
 extern ostream cout;
 extern ostream cerr;
 
@@ -208,39 +53,16 @@ extern ostream cerr;
 
 #ifdef NANOSTL_IOSTREAM_IMPLEMENTATION
 
-#ifndef NANOSTL_NO_IO
-#include <stdio.h>
-#endif
-
 namespace nanostl {
 
 #ifndef NANOSTL_NO_IO
 
-#if __has_feature(cxx_alignas)
-#define _ALIGNAS_TYPE(x) alignas(x)
-#define _ALIGNAS(x) alignas(x)
-#else
-#error TODO
-#define _ALIGNAS_TYPE(x) __attribute__((__aligned__(_LIBCPP_ALIGNOF(x))))
-#define _ALIGNAS(x) __attribute__((__aligned__(x)))
-#endif
-
-ios_base::~ios_base() {
-  // TODO
-}
-
-template<>
-ostream& ostream::flush() {
-  printf("%s", _ss.str().c_str());
-
-  _ss.clear();
-
-  return (*this);
-}
-
+// Constructed in this order before main().
+static filebuf __cout_buf;
+static filebuf __cerr_buf;
 
-//_ALIGNAS_TYPE (ostream) char cout[sizeof(ostream)];
-ostream cout; // fixme
+ostream cout(__cout_buf.attach(stdout));
+ostream cerr(__cerr_buf.attach(stderr));
 
 // from libcxx
 class DoIOSInit {
@@ -252,32 +74,12 @@ class DoIOSInit {
 DoIOSInit::DoIOSInit() {
   // force_locale_initialization();
 
-#ifndef _LIBCPP_HAS_NO_STDOUT
-  // ostream* cout_ptr = ::new(cout) ostream(::new(__cout)
-  // __stdoutbuf<char>(stdout, &mb_cout));
-#endif
-  // ostream* cerr_ptr = ::new(cerr) ostream(::new(__cerr)
-  // __stdoutbuf<char>(stderr, &mb_cerr));
-  //                    ::new(clog) ostream(cerr_ptr->rdbuf());
-
-  //_VSTD::unitbuf(*cerr_ptr);
-#ifndef _LIBCPP_HAS_NO_STDOUT
-  // cerr_ptr->tie(cout_ptr);
-#endif
+  nanostl::unitbuf(cerr);
 }
 
 DoIOSInit::~DoIOSInit(){
-#ifndef _LIBCPP_HAS_NO_STDOUT
-// ostream* cout_ptr = reinterpret_cast<ostream*>(cout);
-// wostream* wcout_ptr = reinterpret_cast<wostream*>(wcout);
-// cout_ptr->flush();
-// wcout_ptr->flush();
-#endif
-
-    // ostream* clog_ptr = reinterpret_cast<ostream*>(clog);
-    // wostream* wclog_ptr = reinterpret_cast<wostream*>(wclog);
-    // clog_ptr->flush();
-    // wclog_ptr->flush();
+  cout.flush();
+  cerr.flush();
 }
 
 ios_base::Init::Init() {
@@ -286,16 +88,10 @@ ios_base::Init::Init() {
 
 ios_base::Init::~Init() {}
 
-// compiler specific way
-//__attribute__ ((__visibility__("hidden"))) ios_base::Init __start_std_streams
-//__attribute__((init_priority(101)));
-
 // Invoke Init() before main()
 ios_base::Init __start_std_streams;
 
-#else
-#error TODO
-#endif
+#endif  // NANOSTL_NO_IO
 
 }
 #endif
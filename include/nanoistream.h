@@ -0,0 +1,1027 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_ISTREAM_H_
+#define NANOSTL_ISTREAM_H_
+
+#include "nanocharconv.h"
+#include "nanoios.h"
+#include "nanoiosfwd.h"
+#include "nanolimits.h"
+#include "nanoostream.h"
+#include "nanostreambuf.h"
+#include "nanostring.h"
+#include "__nullptr"
+
+namespace nanostl {
+
+// Based on libcxx ----------------------
+//
+// Numbers are parsed with from_chars straight from the get area when they
+// end inside it, otherwise the chars that can belong to the number are
+// first copied into a local buffer(never a temporary string). Integers
+// honour dec/hex/oct(without a "0x" prefix) and accept a leading '+'; an
+// out of range integer saturates. An out of range floating point value
+// sets failbit and leaves the value unchanged, a malformed number stores 0.
+// Floating point input is decimal only(no hexfloat).
+//
+template <class _CharT, class _Traits>
+class basic_istream
+    : virtual public basic_ios<_CharT, _Traits>
+{
+    streamsize __gc_;
+public:
+    // types (inherited from basic_ios (27.5.4)):
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+
+    // 27.7.1.1.1 Constructor/destructor:
+    explicit basic_istream(basic_streambuf<char_type, traits_type>* __sb)
+        : __gc_(0) { this->init(__sb); }
+    virtual ~basic_istream() {}
+
+    // 27.7.1.1.3 Prefix/suffix:
+    class sentry;
+
+    // 27.7.1.2 Formatted input:
+    inline basic_istream& operator>>(basic_istream& (*__pf)(basic_istream&))
+        { return __pf(*this); }
+
+    inline basic_istream& operator>>(basic_ios<char_type, traits_type>&
+                                     (*__pf)(basic_ios<char_type, traits_type>&))
+        { __pf(*this); return *this; }
+
+    inline basic_istream& operator>>(ios_base& (*__pf)(ios_base&))
+        { __pf(*this); return *this; }
+
+    basic_istream& operator>>(bool& __n);
+    basic_istream& operator>>(short& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(unsigned short& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(int& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(unsigned int& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(long& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(unsigned long& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(long long& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(unsigned long long& __n) { return __get_integer(__n); }
+    basic_istream& operator>>(float& __f) { return __get_float(__f); }
+    basic_istream& operator>>(double& __f) { return __get_float(__f); }
+    // Parsed with double precision.
+    basic_istream& operator>>(long double& __f)
+    {
+        double __d = static_cast<double>(__f);
+        __get_float(__d);
+        __f = __d;
+        return *this;
+    }
+
+    // 27.7.1.3 Unformatted input:
+    inline streamsize gcount() const { return __gc_; }
+    int_type get();
+
+    inline basic_istream& get(char_type& __c)
+    {
+        int_type __ch = get();
+        if (!traits_type::eq_int_type(__ch, traits_type::eof()))
+            __c = traits_type::to_char_type(__ch);
+        return *this;
+    }
+
+    inline basic_istream& get(char_type* __s, streamsize __n)
+        { return get(__s, __n, this->widen('\n')); }
+    basic_istream& get(char_type* __s, streamsize __n, char_type __dlm);
+
+    inline basic_istream& getline(char_type* __s, streamsize __n)
+        { return getline(__s, __n, this->widen('\n')); }
+    basic_istream& getline(char_type* __s, streamsize __n, char_type __dlm);
+
+    basic_istream& ignore(streamsize __n = 1, int_type __dlm = traits_type::eof());
+    int_type peek();
+    basic_istream& read(char_type* __s, streamsize __n);
+    streamsize readsome(char_type* __s, streamsize __n);
+
+    basic_istream& putback(char_type __c);
+    basic_istream& unget();
+    int sync();
+
+    pos_type tellg();
+    basic_istream& seekg(pos_type __pos);
+    basic_istream& seekg(off_type __off, ios_base::seekdir __dir);
+
+    // ' ' and '\t' to '\r', as isspace() in the "C" locale.
+    static inline bool __is_space(int_type __c)
+    {
+        return (__c == int_type(' ')) ||
+               ((__c >= int_type('\t')) && (__c <= int_type('\r')));
+    }
+
+    // Clears __str and appends chars up to the next space, at most width()
+    // of them when it is positive. Used by operator>>(basic_string&).
+    template <class _Allocator>
+    basic_istream& __get_word(basic_string<char_type, _Allocator>& __str);
+
+    // Clears __str and appends chars up to(and consumes) the next __dlm.
+    // Used by getline(basic_istream&, basic_string&).
+    template <class _Allocator>
+    basic_istream& __get_line(basic_string<char_type, _Allocator>& __str,
+                              char_type __dlm);
+
+protected:
+    basic_istream() : __gc_(0) {}  // the most derived class calls init()
+    // Takes the format and state of __rhs; the most derived class sets
+    // the buffer.
+    basic_istream(basic_istream&& __rhs) : __gc_(__rhs.__gc_)
+    {
+        this->move(__rhs);
+        __rhs.__gc_ = 0;
+    }
+
+private:
+    template <class _Tp>
+    basic_istream& __get_integer(_Tp& __n);
+    template <class _Tp>
+    basic_istream& __get_float(_Tp& __n);
+
+    // Reads a number with `__num`(see __istream_integer_format). Parses in
+    // place when the number ends inside the get area, otherwise scans it
+    // into a local buffer of _Size chars. A longer number is still consumed
+    // in full and fails(an integer saturates, like std::num_get).
+    template <size_t _Size, class _Number>
+    basic_istream& __get_number(_Number& __num);
+
+    // Runs __scan(first, last) over the get area, refilling it as needed,
+    // until __scan returns a position before `last`. __scan consumes
+    // [first, returned position). Returns false at end of file.
+    template <class _Scan>
+    bool __scan_chars(_Scan& __scan);
+};
+
+template <class _CharT, class _Traits>
+class basic_istream<_CharT, _Traits>::sentry
+{
+    bool __ok_;
+
+    sentry(const sentry&) = delete;
+    sentry& operator=(const sentry&) = delete;
+
+public:
+    // Skips leading whitespace unless __noskipws or !(flags() & skipws).
+    explicit sentry(basic_istream<_CharT, _Traits>& __is, bool __noskipws = false);
+    ~sentry() {}
+
+    explicit operator bool() const { return __ok_; }
+};
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>::sentry::sentry(basic_istream<_CharT, _Traits>& __is,
+                                               bool __noskipws)
+    : __ok_(false)
+{
+    if (!__is.good())
+    {
+        __is.setstate(ios_base::failbit);
+        return;
+    }
+    if (!__noskipws && (__is.flags() & ios_base::skipws))
+    {
+        basic_streambuf<_CharT, _Traits>* __sb = __is.rdbuf();
+        for (;;)
+        {
+            int_type __c = __sb->sgetc();
+            if (_Traits::eq_int_type(__c, _Traits::eof()))
+            {
+                __is.setstate(ios_base::failbit | ios_base::eofbit);
+                break;
+            }
+            if (!basic_istream::__is_space(__c))
+                break;
+            __sb->sbumpc();
+        }
+    }
+    __ok_ = __is.good();
+}
+
+template <class _CharT, class _Traits>
+template <class _Scan>
+bool
+basic_istream<_CharT, _Traits>::__scan_chars(_Scan& __scan)
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    for (;;)
+    {
+        if (__sb->__ninp_ == __sb->__einp_)
+        {
+            int_type __c = __sb->sgetc();
+            if (traits_type::eq_int_type(__c, traits_type::eof()))
+                return false;
+            if (__sb->__ninp_ == __sb->__einp_)
+            {
+                // Unbuffered: one char at a time.
+                char_type __ch = traits_type::to_char_type(__c);
+                if (__scan(&__ch, &__ch + 1) != &__ch + 1)
+                    return true;
+                __sb->sbumpc();
+                continue;
+            }
+        }
+        char_type* __last = __sb->__einp_;
+        char_type* __p = __scan(__sb->__ninp_, __last);
+        __sb->__ninp_ = __p;
+        if (__p != __last)
+            return true;
+    }
+}
+
+template <class _CharT, class _Traits>
+template <size_t _Size, class _Number>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::__get_number(_Number& __num)
+{
+    sentry __s(*this);
+    if (!__s)
+        return *this;
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (is_same<char_type, char>::value)
+    {
+        // A number that runs to the end of the get area may continue after
+        // a refill, so that case goes through the scanner.
+        const char* __first = reinterpret_cast<const char*>(__sb->__ninp_);
+        const char* __last = reinterpret_cast<const char*>(__sb->__einp_);
+        from_chars_result __r = __num(__first, __last);
+        if ((__r.ec == errc()) && (__r.ptr != __last))
+        {
+            __sb->__ninp_ += __r.ptr - __first;
+            return *this;
+        }
+    }
+
+    char __buf[_Size];
+    size_t __n = 0;
+    bool __full = false;
+    ios_base::iostate __state = ios_base::goodbit;
+    for (;;)
+    {
+        int_type __c = __sb->sgetc();
+        if (traits_type::eq_int_type(__c, traits_type::eof()))
+        {
+            __state |= ios_base::eofbit;
+            break;
+        }
+        // Only the basic character set can be part of a number.
+        const char_type __ch = traits_type::to_char_type(__c);
+        const char __nc = ((__ch > char_type(0)) && (__ch < char_type(0x7f)))
+                              ? static_cast<char>(__ch) : '\0';
+        if (!__num.__accepts(__nc))
+            break;
+        if (__num.__keep)
+        {
+            if (__n == _Size)
+                __full = true;
+            else
+                __buf[__n++] = __nc;
+        }
+        __sb->sbumpc();
+    }
+    if (!__num.__parse(__buf, __buf + __n) || __full)
+        __state |= ios_base::failbit;
+    this->setstate(__state);
+    return *this;
+}
+
+// Parses an integer in `__base`. __accepts() tells the scanner which chars
+// can extend the number read so far, and __keep whether the accepted char
+// has to be stored. Leading zeros past the first are dropped, so the digits
+// that fill the scan buffer are significant and always out of range.
+template <class _Tp>
+struct __istream_integer_format
+{
+    _Tp& __value;
+    int __base;
+    bool __empty;
+    bool __keep;
+    bool __digits;  // a digit seen
+    bool __zeros;   // only zeros seen so far, at least one
+
+    __istream_integer_format(_Tp& __v, int __b)
+        : __value(__v), __base(__b), __empty(true), __keep(true), __digits(false),
+          __zeros(false) {}
+
+    from_chars_result operator()(const char* __first, const char* __last) const
+    {
+        return from_chars(__first, __last, __value, __base);
+    }
+
+    bool __accepts(char __c)
+    {
+        const bool __sign = __empty && ((__c == '-') || (__c == '+'));
+        __empty = false;
+        if (__sign)
+            return true;
+        if (__digit_value(__c) >= unsigned(__base))
+            return false;
+        __keep = !(__zeros && (__c == '0'));
+        __zeros = (__c == '0') && (__zeros || !__digits);
+        __digits = true;
+        return true;
+    }
+
+    // Parses the scanned chars, which must all be used. Like strtoull(), a
+    // '-' on an unsigned type negates the value.
+    bool __parse(const char* __first, const char* __last)
+    {
+        bool __negate = false;
+        if ((__first != __last) && (*__first == '+'))
+            ++__first;
+        else if (!is_signed<_Tp>::value && (__first != __last) && (*__first == '-'))
+        {
+            ++__first;
+            __negate = true;
+        }
+        from_chars_result __r = from_chars(__first, __last, __value, __base);
+        if (__r.ec == errc::result_out_of_range)
+        {
+            __value = (is_signed<_Tp>::value && (*__first == '-'))
+                          ? numeric_limits<_Tp>::min()
+                          : numeric_limits<_Tp>::max();
+            return false;
+        }
+        if ((__r.ec != errc()) || (__r.ptr != __last))
+        {
+            __value = 0;
+            return false;
+        }
+        if (__negate)
+            __value = static_cast<_Tp>(_Tp(0) - __value);
+        return true;
+    }
+};
+
+template <class _CharT, class _Traits>
+template <class _Tp>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::__get_integer(_Tp& __n)
+{
+    const ios_base::fmtflags __basefield = this->flags() & ios_base::basefield;
+    __istream_integer_format<_Tp> __num(
+        __n, (__basefield == ios_base::hex) ? 16 : (__basefield == ios_base::oct) ? 8 : 10);
+    // 64 bit in binary would be 64 digits and a sign; octal needs 23.
+    return __get_number<32>(__num);
+}
+
+// Parses a decimal floating point number: [sign] digits [. digits]
+// [e [sign] digits], or a case-insensitive "inf"/"infinity"/"nan".
+// Scanning stops at the first character that cannot continue the number,
+// so a failed extraction only consumes a prefix of one(e.g. "-" of "-foo",
+// nothing of "abc"). As with std::num_get, a dangling exponent("1e",
+// "1e+") is consumed and the extraction fails with the value set to 0, a
+// value too large for _Tp fails with +-max(), and one too small reads as
+// +-0 without failing.
+template <class _Tp>
+struct __istream_float_format
+{
+    static const bool __keep = true;  // every accepted char is stored
+
+    _Tp& __value;
+    int __n;        // chars accepted
+    bool __alpha;   // inf/nan
+    bool __inf;     // still a prefix of "infinity"
+    bool __nan;     // still a prefix of "nan"
+    int __word;     // index of the first inf/nan char
+    bool __digits;  // a digit seen(before the exponent)
+    bool __dot;
+    bool __exp;
+    char __prev;
+
+    explicit __istream_float_format(_Tp& __v)
+        : __value(__v), __n(0), __alpha(false), __inf(false), __nan(false),
+          __word(0), __digits(false), __dot(false), __exp(false), __prev('\0') {}
+
+    from_chars_result operator()(const char* __first, const char* __last) const
+    {
+        from_chars_result __r = from_chars(__first, __last, __value);
+        // from_chars stops before an incomplete exponent; leave that to the
+        // scanner, which fails like std does.
+        if ((__r.ec == errc()) && (__r.ptr != __last) &&
+            ((*__r.ptr == 'e') || (*__r.ptr == 'E')))
+            __r.ec = errc::invalid_argument;
+        return __r;
+    }
+
+    static char __lower(char __c)
+    {
+        return ((__c >= 'A') && (__c <= 'Z')) ? char(__c - 'A' + 'a') : __c;
+    }
+
+    // Whether __c continues "inf", "infinity" or "nan" at index __k.
+    bool __continues_word(char __c, int __k)
+    {
+        __c = __lower(__c);
+        __inf = __inf && (__k < 8) && (__c == "infinity"[__k]);
+        __nan = __nan && (__k < 3) && (__c == "nan"[__k]);
+        return __inf || __nan;
+    }
+
+    bool __accepts(char __c)
+    {
+        bool __ok = false;
+        const bool __at_start = (__n == 0) || ((__n == 1) && ((__prev == '-') || (__prev == '+')));
+        if (__alpha)
+            __ok = __continues_word(__c, __n - __word);
+        else if ((__c >= '0') && (__c <= '9'))
+        {
+            __digits = __digits || !__exp;
+            __ok = true;
+        }
+        else if (__c == '.')
+            __ok = !__dot && !__exp;
+        else if ((__c == 'e') || (__c == 'E'))
+            __ok = __digits && !__exp;
+        else if ((__c == '-') || (__c == '+'))
+            __ok = (__n == 0) || (__prev == 'e') || (__prev == 'E');
+        else if (__at_start && ((__lower(__c) == 'i') || (__lower(__c) == 'n')))
+        {
+            __inf = __nan = true;
+            __word = __n;
+            __ok = __alpha = __continues_word(__c, 0);
+        }
+
+        if (__ok)
+        {
+            __dot = __dot || (__c == '.');
+            __exp = __exp || (!__alpha && ((__c == 'e') || (__c == 'E')));
+            __prev = __c;
+            ++__n;
+        }
+        return __ok;
+    }
+
+    // Whether an out of range number is too large rather than too small:
+    // the first nonzero digit, shifted by the exponent, lies left of the point.
+    static bool __too_large(const char* __first, const char* __last)
+    {
+        long __order = 0;
+        bool __dot = false;
+        for (; (__first != __last) && (*__first != 'e') && (*__first != 'E'); ++__first)
+        {
+            if (*__first == '.')
+                __dot = true;
+            else if ((*__first >= '1') && (*__first <= '9'))
+                break;
+            else if (__dot && (*__first == '0'))
+                --__order;
+        }
+        for (; (__first != __last) && (*__first != 'e') && (*__first != 'E'); ++__first)
+        {
+            __dot = __dot || (*__first == '.');
+            if (!__dot)
+                ++__order;
+        }
+        if (__first == __last)
+            return __order > 0;
+        ++__first;
+        const bool __neg = (*__first == '-');
+        if ((*__first == '-') || (*__first == '+'))
+            ++__first;
+        long __exp = 0;
+        for (; (__first != __last) && (__exp < 100000); ++__first)
+            __exp = __exp * 10 + (*__first - '0');
+        return (__neg ? __order - __exp : __order + __exp) > 0;
+    }
+
+    bool __parse(const char* __first, const char* __last)
+    {
+        if ((__first != __last) && (*__first == '+'))
+            ++__first;
+        from_chars_result __r = from_chars(__first, __last, __value);
+        if (__r.ec == errc::result_out_of_range)
+        {
+            const bool __neg = (*__first == '-');
+            if (__too_large(__neg ? __first + 1 : __first, __last))
+            {
+                __value = __neg ? -numeric_limits<_Tp>::max() : numeric_limits<_Tp>::max();
+                return false;
+            }
+            __value = __neg ? -_Tp(0) : _Tp(0);
+            return true;
+        }
+        if ((__r.ec != errc()) || (__r.ptr != __last))
+        {
+            __value = 0;
+            return false;
+        }
+        return true;
+    }
+};
+
+template <class _CharT, class _Traits>
+template <class _Tp>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::__get_float(_Tp& __n)
+{
+    __istream_float_format<_Tp> __num(__n);
+    // Enough for any round trip representation with some leading zeros.
+    return __get_number<512>(__num);
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::operator>>(bool& __n)
+{
+    if (!(this->flags() & ios_base::boolalpha))
+    {
+        long __v = 0;
+        __get_integer(__v);
+        __n = (__v != 0);
+        if ((__v != 0) && (__v != 1))
+            this->setstate(ios_base::failbit);
+        return *this;
+    }
+
+    sentry __s(*this);
+    if (!__s)
+        return *this;
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    static const char __true[] = "true";
+    static const char __false[] = "false";
+    const int_type __c = __sb->sgetc();
+    const bool __value = traits_type::eq_int_type(__c, traits_type::to_int_type(this->widen('t')));
+    const char* __word = __value ? __true : __false;
+    ios_base::iostate __state = ios_base::goodbit;
+    for (; *__word; ++__word)
+    {
+        int_type __ch = __sb->sgetc();
+        if (traits_type::eq_int_type(__ch, traits_type::eof()))
+        {
+            __state |= ios_base::eofbit | ios_base::failbit;
+            break;
+        }
+        if (!traits_type::eq(traits_type::to_char_type(__ch), this->widen(*__word)))
+        {
+            __state |= ios_base::failbit;
+            break;
+        }
+        __sb->sbumpc();
+    }
+    __n = (__state & ios_base::failbit) ? false : __value;
+    this->setstate(__state);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+typename basic_istream<_CharT, _Traits>::int_type
+basic_istream<_CharT, _Traits>::get()
+{
+    __gc_ = 0;
+    int_type __r = traits_type::eof();
+    sentry __s(*this, true);
+    if (__s)
+    {
+        __r = this->rdbuf()->sbumpc();
+        if (traits_type::eq_int_type(__r, traits_type::eof()))
+            this->setstate(ios_base::failbit | ios_base::eofbit);
+        else
+            __gc_ = 1;
+    }
+    return __r;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::get(char_type* __s, streamsize __n, char_type __dlm)
+{
+    __gc_ = 0;
+    sentry __sen(*this, true);
+    if (__sen && (__n > 0))
+    {
+        ios_base::iostate __state = ios_base::goodbit;
+        basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+        while (__gc_ < __n - 1)
+        {
+            int_type __c = __sb->sgetc();
+            if (traits_type::eq_int_type(__c, traits_type::eof()))
+            {
+                __state |= ios_base::eofbit;
+                break;
+            }
+            char_type __ch = traits_type::to_char_type(__c);
+            if (traits_type::eq(__ch, __dlm))
+                break;
+            *__s++ = __ch;
+            ++__gc_;
+            __sb->sbumpc();
+        }
+        if (__gc_ == 0)
+            __state |= ios_base::failbit;
+        this->setstate(__state);
+    }
+    if (__n > 0)
+        *__s = char_type();
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::getline(char_type* __s, streamsize __n, char_type __dlm)
+{
+    __gc_ = 0;
+    sentry __sen(*this, true);
+    if (__sen)
+    {
+        ios_base::iostate __state = ios_base::goodbit;
+        basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+        for (;;)
+        {
+            int_type __c = __sb->sgetc();
+            if (traits_type::eq_int_type(__c, traits_type::eof()))
+            {
+                __state |= ios_base::eofbit;
+                break;
+            }
+            char_type __ch = traits_type::to_char_type(__c);
+            if (traits_type::eq(__ch, __dlm))
+            {
+                __sb->sbumpc();
+                ++__gc_;
+                break;
+            }
+            if (__gc_ >= __n - 1)
+            {
+                __state |= ios_base::failbit;
+                break;
+            }
+            *__s++ = __ch;
+            __sb->sbumpc();
+            ++__gc_;
+        }
+        if (__gc_ == 0)
+            __state |= ios_base::failbit;
+        this->setstate(__state);
+    }
+    if (__n > 0)
+        *__s = char_type();
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::ignore(streamsize __n, int_type __dlm)
+{
+    __gc_ = 0;
+    sentry __sen(*this, true);
+    if (__sen)
+    {
+        basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+        const bool __unlimited = (__n == numeric_limits<streamsize>::max());
+        while (__unlimited || (__gc_ < __n))
+        {
+            int_type __c = __sb->sbumpc();
+            if (traits_type::eq_int_type(__c, traits_type::eof()))
+            {
+                this->setstate(ios_base::eofbit);
+                break;
+            }
+            ++__gc_;
+            if (traits_type::eq_int_type(__c, __dlm))
+                break;
+        }
+    }
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+typename basic_istream<_CharT, _Traits>::int_type
+basic_istream<_CharT, _Traits>::peek()
+{
+    __gc_ = 0;
+    int_type __r = traits_type::eof();
+    sentry __sen(*this, true);
+    if (__sen)
+    {
+        __r = this->rdbuf()->sgetc();
+        if (traits_type::eq_int_type(__r, traits_type::eof()))
+            this->setstate(ios_base::eofbit);
+    }
+    return __r;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::read(char_type* __s, streamsize __n)
+{
+    __gc_ = 0;
+    sentry __sen(*this, true);
+    if (__sen)
+    {
+        __gc_ = this->rdbuf()->sgetn(__s, __n);
+        if (__gc_ != __n)
+            this->setstate(ios_base::failbit | ios_base::eofbit);
+    }
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+streamsize
+basic_istream<_CharT, _Traits>::readsome(char_type* __s, streamsize __n)
+{
+    __gc_ = 0;
+    sentry __sen(*this, true);
+    if (__sen)
+    {
+        streamsize __c = this->rdbuf()->in_avail();
+        if (__c == -1)
+            this->setstate(ios_base::eofbit);
+        else if (__c > 0)
+            __gc_ = this->rdbuf()->sgetn(__s, (__c < __n) ? __c : __n);
+    }
+    return __gc_;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::putback(char_type __c)
+{
+    __gc_ = 0;
+    this->clear(this->rdstate() & ~ios_base::eofbit);
+    sentry __sen(*this, true);
+    if (__sen &&
+        traits_type::eq_int_type(this->rdbuf()->sputbackc(__c), traits_type::eof()))
+        this->setstate(ios_base::badbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::unget()
+{
+    __gc_ = 0;
+    this->clear(this->rdstate() & ~ios_base::eofbit);
+    sentry __sen(*this, true);
+    if (__sen &&
+        traits_type::eq_int_type(this->rdbuf()->sungetc(), traits_type::eof()))
+        this->setstate(ios_base::badbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+int
+basic_istream<_CharT, _Traits>::sync()
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (__sb == nullptr)
+        return -1;
+    if (__sb->pubsync() == -1)
+    {
+        this->setstate(ios_base::badbit);
+        return -1;
+    }
+    return 0;
+}
+
+template <class _CharT, class _Traits>
+typename basic_istream<_CharT, _Traits>::pos_type
+basic_istream<_CharT, _Traits>::tellg()
+{
+    if (this->fail())
+        return pos_type(off_type(-1));
+    return this->rdbuf()->pubseekoff(0, ios_base::cur, ios_base::in);
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::seekg(pos_type __pos)
+{
+    this->clear(this->rdstate() & ~ios_base::eofbit);
+    if (!this->fail() &&
+        (this->rdbuf()->pubseekpos(__pos, ios_base::in) == pos_type(off_type(-1))))
+        this->setstate(ios_base::failbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::seekg(off_type __off, ios_base::seekdir __dir)
+{
+    this->clear(this->rdstate() & ~ios_base::eofbit);
+    if (!this->fail() &&
+        (this->rdbuf()->pubseekoff(__off, __dir, ios_base::in) == pos_type(off_type(-1))))
+        this->setstate(ios_base::failbit);
+    return *this;
+}
+
+// Appends to a string the chars before the first one __stop() accepts.
+template <class _CharT, class _Traits, class _Allocator, class _Stop>
+struct __istream_append_until
+{
+    basic_string<_CharT, _Allocator>& __str;
+    _Stop __stop;
+    streamsize __max;  // chars left to take
+
+    _CharT* operator()(_CharT* __first, _CharT* __last)
+    {
+        _CharT* __p = __first;
+        if (__last - __first > __max)
+            __last = __first + __max;
+        while ((__p != __last) && !__stop(*__p))
+            ++__p;
+        __str.append(__first, __p);
+        __max -= __p - __first;
+        return __p;
+    }
+};
+
+template <class _CharT, class _Traits>
+struct __istream_is_space
+{
+    bool operator()(_CharT __c) const
+        { return basic_istream<_CharT, _Traits>::__is_space(_Traits::to_int_type(__c)); }
+};
+
+template <class _CharT, class _Traits>
+struct __istream_is_char
+{
+    _CharT __dlm;
+    bool operator()(_CharT __c) const { return _Traits::eq(__c, __dlm); }
+};
+
+template <class _CharT, class _Traits>
+template <class _Allocator>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::__get_word(basic_string<char_type, _Allocator>& __str)
+{
+    sentry __sen(*this);
+    if (!__sen)
+        return *this;
+    __str.clear();
+    __istream_append_until<char_type, traits_type, _Allocator,
+                           __istream_is_space<char_type, traits_type> >
+        __scan = {__str, __istream_is_space<char_type, traits_type>(),
+                  (this->width() > 0) ? this->width()
+                                      : numeric_limits<streamsize>::max()};
+    ios_base::iostate __state = ios_base::goodbit;
+    if (!__scan_chars(__scan))
+        __state |= ios_base::eofbit;
+    if (__str.empty())
+        __state |= ios_base::failbit;
+    this->width(0);
+    this->setstate(__state);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+template <class _Allocator>
+basic_istream<_CharT, _Traits>&
+basic_istream<_CharT, _Traits>::__get_line(basic_string<char_type, _Allocator>& __str,
+                                           char_type __dlm)
+{
+    sentry __sen(*this, true);
+    if (!__sen)
+        return *this;
+    __str.clear();
+    __istream_is_char<char_type, traits_type> __stop = {__dlm};
+    __istream_append_until<char_type, traits_type, _Allocator,
+                           __istream_is_char<char_type, traits_type> >
+        __scan = {__str, __stop, numeric_limits<streamsize>::max()};
+    ios_base::iostate __state = ios_base::goodbit;
+    if (__scan_chars(__scan))
+        this->rdbuf()->sbumpc();  // the delimiter
+    else if (__str.empty())
+        __state |= ios_base::eofbit | ios_base::failbit;
+    else
+        __state |= ios_base::eofbit;
+    this->setstate(__state);
+    return *this;
+}
+
+// 27.7.1.2.3 Character extraction templates:
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+operator>>(basic_istream<_CharT, _Traits>& __is, _CharT& __c)
+{
+    typename basic_istream<_CharT, _Traits>::sentry __sen(__is);
+    if (__sen)
+    {
+        typename _Traits::int_type __i = __is.rdbuf()->sbumpc();
+        if (_Traits::eq_int_type(__i, _Traits::eof()))
+            __is.setstate(ios_base::eofbit | ios_base::failbit);
+        else
+            __c = _Traits::to_char_type(__i);
+    }
+    return __is;
+}
+
+template <class _Traits>
+inline basic_istream<char, _Traits>&
+operator>>(basic_istream<char, _Traits>& __is, unsigned char& __c)
+{
+    return __is >> reinterpret_cast<char&>(__c);
+}
+
+template <class _Traits>
+inline basic_istream<char, _Traits>&
+operator>>(basic_istream<char, _Traits>& __is, signed char& __c)
+{
+    return __is >> reinterpret_cast<char&>(__c);
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+inline basic_istream<_CharT, _Traits>&
+operator>>(basic_istream<_CharT, _Traits>& __is,
+           basic_string<_CharT, _Allocator>& __str)
+{
+    return __is.__get_word(__str);
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+inline basic_istream<_CharT, _Traits>&
+getline(basic_istream<_CharT, _Traits>& __is,
+        basic_string<_CharT, _Allocator>& __str, _CharT __dlm)
+{
+    return __is.__get_line(__str, __dlm);
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+inline basic_istream<_CharT, _Traits>&
+getline(basic_istream<_CharT, _Traits>& __is,
+        basic_string<_CharT, _Allocator>& __str)
+{
+    return __is.__get_line(__str, __is.widen('\n'));
+}
+
+// 27.7.1.4 Standard basic_istream manipulators:
+
+template <class _CharT, class _Traits>
+basic_istream<_CharT, _Traits>&
+ws(basic_istream<_CharT, _Traits>& __is)
+{
+    typename basic_istream<_CharT, _Traits>::sentry __sen(__is, true);
+    if (__sen)
+    {
+        basic_streambuf<_CharT, _Traits>* __sb = __is.rdbuf();
+        for (;;)
+        {
+            typename _Traits::int_type __c = __sb->sgetc();
+            if (_Traits::eq_int_type(__c, _Traits::eof()))
+            {
+                __is.setstate(ios_base::eofbit);
+                break;
+            }
+            if (!basic_istream<_CharT, _Traits>::__is_space(__c))
+                break;
+            __sb->sbumpc();
+        }
+    }
+    return __is;
+}
+
+// 27.7.1.5 Class template basic_iostream:
+
+template <class _CharT, class _Traits>
+class basic_iostream
+    : public basic_istream<_CharT, _Traits>,
+      public basic_ostream<_CharT, _Traits>
+{
+public:
+    // types:
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+
+    // constructor/destructor
+    explicit basic_iostream(basic_streambuf<char_type, traits_type>* __sb)
+        : basic_istream<_CharT, _Traits>(__sb) {}
+    virtual ~basic_iostream() {}
+
+protected:
+    basic_iostream(basic_iostream&& __rhs)
+        : basic_istream<_CharT, _Traits>(static_cast<basic_istream<_CharT, _Traits>&&>(__rhs)) {}
+};
+
+} // namespace nanostl
+
+#endif // NANOSTL_ISTREAM_H_
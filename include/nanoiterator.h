@@ -25,6 +25,8 @@
 #ifndef NANOSTL_ITERATOR_H_
 #define NANOSTL_ITERATOR_H_
 
+#include "nanotype_traits.h"
+
 namespace nanostl {
 
 #ifdef __clang__
@@ -80,6 +82,19 @@ struct iterator_traits<const T*>
 };
 
 
+// Algorithms which split or index a range check these, with a serial
+// fallback for other iterators.
+template <class It>
+struct __is_random_access_iterator
+    : public is_base_of<random_access_iterator_tag,
+                        typename iterator_traits<It>::iterator_category> {};
+
+template <class It1, class It2>
+struct __both_random_access
+    : public integral_constant<bool,
+                               __is_random_access_iterator<It1>::value &&
+                                   __is_random_access_iterator<It2>::value> {};
+
 template <class InputIterator>
 typename iterator_traits<InputIterator>::difference_type
 distance(InputIterator first, InputIterator last)
@@ -118,6 +118,34 @@ struct numeric_limits<unsigned int> {
   static const int digits10 = 9;
 };
 
+// 64 bit on LP64, 32 bit on LLP64(Windows).
+template <>
+struct numeric_limits<long> {
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static inline long min(void) {
+    return (sizeof(long) == 8) ? long(-0x7FFFFFFFFFFFFFFFLL - 1LL)
+                               : long(-2147483647L - 1L);
+  }
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static inline long max(void) {
+    return (sizeof(long) == 8) ? long(0x7FFFFFFFFFFFFFFFLL) : long(2147483647L);
+  }
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static inline long epsilon(void) { return 0; }
+  static const int digits10 = (sizeof(long) == 8) ? 18 : 9;
+};
+
+template <>
+struct numeric_limits<unsigned long> {
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static inline unsigned long min(void) { return 0; }
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static inline unsigned long max(void) { return ~0UL; }
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static inline unsigned long epsilon(void) { return 0; }
+  static const int digits10 = (sizeof(long) == 8) ? 19 : 9;
+};
+
 // assume int64_t
 template <>
 struct numeric_limits<long long> {
@@ -25,6 +25,10 @@
 #ifndef NANOSTL_MAP_H_
 #define NANOSTL_MAP_H_
 
+#include "nanoallocator.h"
+#include "nanofunctional.h"  // nanostl::less
+#include "nanomemory_resource.h"  // nanostl::node_pool
+#include "nanotype_traits.h"
 #include "nanoutility.h"  // nanostl::pair
 #include "nanovector.h"
 
@@ -55,41 +59,75 @@ static inline priority_type priority_rand() {
   return y = y ^ (y << 5);
 }
 
-// TODO(LTE): Support Comparator and Allocator.
-template <class Key, class T>
+template <class Key, class T, class Compare = nanostl::less<Key>,
+          class Allocator = nanostl::allocator<nanostl::pair<const Key, T> > >
 class map {
  public:
   typedef Key key_type;
+  typedef T mapped_type;
   typedef nanostl::pair<const Key, T> value_type;
+  typedef Compare key_compare;
+  typedef Allocator allocator_type;
   typedef value_type& reference;
   typedef const value_type& const_reference;
   typedef value_type* pointer;
   typedef const value_type* const_pointer;
+  typedef nanostl::size_type size_type;
 
   struct Node {
     value_type val;
     priority_type pri;
     Node* ch[2];  // left, right
-    Node(value_type v) : val(v), pri(priority_rand()) { ch[0] = ch[1] = 0; }
-    inline Key key() { return val.first; }
-    inline T mapped() { return val.second; }
+    Node* parent;
+    Node(const value_type& v) : val(v), pri(priority_rand()), parent(0) {
+      ch[0] = ch[1] = 0;
+    }
+    inline const Key& key() const { return val.first; }
+    inline T& mapped() { return val.second; }
   };
 
+  class const_iterator;
+
+  // Bidirectional iterator. Nodes are linked to their parent, so ++/-- walk
+  // the tree directly and a full traversal is O(n).
   class iterator {
-    map<Key, T>* mp;
+    friend class map;
+    friend class const_iterator;
+
+    const map* mp;
     Node* p;
 
    public:
     NANOSTL_HOST_AND_DEVICE_QUAL
-    iterator(map<Key, T>* _mp = 0, Node* _p = 0) : mp(_mp), p(_p) {}
+    iterator(const map* _mp = 0, Node* _p = 0) : mp(_mp), p(_p) {}
 
     NANOSTL_HOST_AND_DEVICE_QUAL
     iterator& operator++() {
-      // O(log n)
-      p = mp->__upper_bound(mp->root, p->val.first);
+      p = __next(p);
+      return *this;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator operator++(int) {
+      iterator tmp(*this);
+      p = __next(p);
+      return tmp;
+    }
+
+    // --end() yields the largest element.
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator& operator--() {
+      p = p ? __prev(p) : __rightmost(mp->root);
       return *this;
     }
 
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    iterator operator--(int) {
+      iterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
     NANOSTL_HOST_AND_DEVICE_QUAL
     reference operator*() const { return p->val; }
 
@@ -97,45 +135,141 @@ class map {
     pointer operator->() const { return &(p->val); }
 
     NANOSTL_HOST_AND_DEVICE_QUAL
-    bool operator==(const iterator& rhs) const {
-      if (rhs.isEnd() && this->isEnd()) return true;
-      return *rhs == this->p->val;
+    bool operator==(const iterator& rhs) const { return p == rhs.p; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator!=(const iterator& rhs) const { return p != rhs.p; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool isEnd() const { return p == 0; }
+  };
+
+  class const_iterator {
+    friend class map;
+
+    const map* mp;
+    const Node* p;
+
+   public:
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator(const map* _mp = 0, const Node* _p = 0) : mp(_mp), p(_p) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator(const iterator& it) : mp(it.mp), p(it.p) {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator& operator++() {
+      p = __next(const_cast<Node*>(p));
+      return *this;
     }
 
     NANOSTL_HOST_AND_DEVICE_QUAL
-    bool operator!=(const iterator& rhs) const {
-      if (rhs.isEnd() && this->isEnd())
-        return false;
-      else if (rhs.isEnd() || this->isEnd())
-        return true;
-      return *rhs != this->p->val;
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator& operator--() {
+      p = p ? __prev(const_cast<Node*>(p)) : __rightmost(mp->root);
+      return *this;
     }
 
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_iterator operator--(int) {
+      const_iterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_reference operator*() const { return p->val; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    const_pointer operator->() const { return &(p->val); }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator==(const const_iterator& rhs) const { return p == rhs.p; }
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    bool operator!=(const const_iterator& rhs) const { return p != rhs.p; }
+
     NANOSTL_HOST_AND_DEVICE_QUAL
     bool isEnd() const { return p == 0; }
   };
 
-  typedef const iterator const_iterator;
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  map() : root(0), size_(0) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit map(const Compare& comp, const Allocator& alloc = Allocator())
+      : root(0), size_(0), comp_(comp), pool_(node_allocator_type(alloc)) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit map(const Allocator& alloc)
+      : root(0), size_(0), pool_(node_allocator_type(alloc)) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  map(const map& rhs)
+      : root(0),
+        size_(0),
+        comp_(rhs.comp_),
+        pool_(rhs.pool_.get_allocator()) {
+    __copy(rhs);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  map& operator=(const map& rhs) {
+    if (this != &rhs) {
+      clear();
+      comp_ = rhs.comp_;
+      __copy(rhs);
+    }
+    return *this;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  allocator_type get_allocator() const {
+    return allocator_type(pool_.get_allocator());
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  map() { root = 0; }
+  key_compare key_comp() const { return comp_; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  ~map() { __delete(root); }
+  ~map() { __destroy_values(root); }
 
   // accessors:
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  iterator begin() { return iterator(this, root); }
+  iterator begin() { return iterator(this, __leftmost(root)); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator begin() const {
+    return const_iterator(this, __leftmost(root));
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   iterator end() { return iterator(this, 0); }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  const_iterator end() const { return iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, 0); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool empty() const { return size_ == 0; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  bool empty() const { return !root; }
+  size_type size() const { return size_; }
+
+  // Destroys all elements and hands every node chunk back to the allocator.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void clear() {
+    __destroy_values(root);
+    pool_.release();
+    root = 0;
+    size_ = 0;
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   T& operator[](const key_type& k) {
@@ -147,24 +281,63 @@ class map {
   typedef pair<iterator, bool> pair_iterator_bool;
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  pair_iterator_bool insert(const value_type& x) {
-    pair<Node*, pair_iterator_bool> p = __insert(root, x);
-    root = p.first;
-    return p.second;
+  pair_iterator_bool insert(const value_type& x) { return __insert(x); }
+
+  // Returns the iterator following the removed element.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(iterator pos) {
+    Node* next = __next(pos.p);
+    __erase(pos.p);
+    return iterator(this, next);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(iterator first, iterator last) {
+    while (first != last) {
+      first = erase(first);
+    }
+    return last;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type erase(const key_type& key) {
+    Node* t = __find(key);
+    if (!t) return 0;
+    __erase(t);
+    return 1;
   }
 
   // map operations:
 
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator find(const key_type& key) { return iterator(this, __find(key)); }
+
   NANOSTL_HOST_AND_DEVICE_QUAL
   const_iterator find(const key_type& key) const {
-    Node* t = __find(root, key);
-    return (!t) ? this->end() : iterator(this, t);
+    return const_iterator(this, __find(key));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type count(const key_type& key) const { return __find(key) ? 1 : 0; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator lower_bound(const key_type& key) {
+    return iterator(this, __lower_bound(key));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator lower_bound(const key_type& key) const {
+    return const_iterator(this, __lower_bound(key));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator upper_bound(const key_type& key) {
+    return iterator(this, __upper_bound(key));
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   const_iterator upper_bound(const key_type& key) const {
-    Node* t = __upper_bound(root, key);
-    return (!t) ? this->end() : iterator(this, t);
+    return const_iterator(this, __upper_bound(key));
   }
 
   // debug:
@@ -176,57 +349,246 @@ class map {
   }
 
  private:
+  typedef typename nanostl::allocator_traits<Allocator>::template rebind_alloc<
+      Node>::other node_allocator_type;
+
   Node* root;
+  size_type size_;
+  Compare comp_;
+  nanostl::node_pool<Node, node_allocator_type> pool_;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool __equal(const key_type& a, const key_type& b) const {
+    return !comp_(a, b) && !comp_(b, a);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  Node* __new_node(const value_type& x) {
+    Node* n = pool_.allocate();
+    ::new (__placement_tag(), n) Node(x);
+    return n;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __free_node(Node* n) {
+    n->~Node();
+    pool_.deallocate(n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static Node* __leftmost(Node* t) {
+    if (t) {
+      while (t->ch[0]) t = t->ch[0];
+    }
+    return t;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static Node* __rightmost(Node* t) {
+    if (t) {
+      while (t->ch[1]) t = t->ch[1];
+    }
+    return t;
+  }
+
+  // In-order successor/predecessor. Amortized O(1) over a traversal.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static Node* __next(Node* t) {
+    if (t->ch[1]) return __leftmost(t->ch[1]);
+    Node* p = t->parent;
+    while (p && (t == p->ch[1])) {
+      t = p;
+      p = p->parent;
+    }
+    return p;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static Node* __prev(Node* t) {
+    if (t->ch[0]) return __rightmost(t->ch[0]);
+    Node* p = t->parent;
+    while (p && (t == p->ch[0])) {
+      t = p;
+      p = p->parent;
+    }
+    return p;
+  }
 
   // b: the direction of rotation
   NANOSTL_HOST_AND_DEVICE_QUAL
   Node* __rotate(Node* t, int b) {
     Node* s = t->ch[1 - b];
     t->ch[1 - b] = s->ch[b];
+    if (s->ch[b]) s->ch[b]->parent = t;
+
+    s->parent = t->parent;
+    if (!t->parent) {
+      root = s;
+    } else {
+      t->parent->ch[t->parent->ch[1] == t] = s;
+    }
+
     s->ch[b] = t;
+    t->parent = s;
     return s;  // return the upper node after the rotation
   }
 
-  // {pointer to the root node of the subtree, {iterator to inserted/found
-  // value, inserted or not}}
+  // Insert as a leaf, then rotate up until the heap order on `pri` holds.
   NANOSTL_HOST_AND_DEVICE_QUAL
-  pair<Node*, pair_iterator_bool> __insert(Node* t, const value_type& x) {
-    if (!t) {
-      Node* n = new Node(x);
-      return make_pair(n, make_pair(iterator(this, n), true));
+  pair_iterator_bool __insert(const value_type& x) {
+    const Key& key = x.first;
+
+    Node* parent = 0;
+    Node* t = root;
+    int b = 0;
+    while (t) {
+      if (comp_(key, t->key())) {
+        b = 0;
+      } else if (comp_(t->key(), key)) {
+        b = 1;
+      } else {
+        return make_pair(iterator(this, t), false);
+      }
+      parent = t;
+      t = t->ch[b];
+    }
+
+    Node* n = __new_node(x);
+    n->parent = parent;
+    size_++;
+    if (!parent) {
+      root = n;
+    } else {
+      parent->ch[b] = n;
+    }
+
+    while (n->parent && (n->parent->pri > n->pri)) {
+      Node* p = n->parent;
+      __rotate(p, 1 - (p->ch[1] == n));
+    }
+
+    return make_pair(iterator(this, n), true);
+  }
+
+  // Rotate `t` down until it has at most one child, then splice it out.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __erase(Node* t) {
+    while (t->ch[0] && t->ch[1]) {
+      // Lift the child with the higher priority (smaller `pri`).
+      int b = (t->ch[0]->pri < t->ch[1]->pri) ? 1 : 0;
+      __rotate(t, b);
     }
-    Key key = x.first;
-    if (key == t->key()) {
-      return make_pair(t, make_pair(iterator(this, t), false));
+
+    Node* c = t->ch[0] ? t->ch[0] : t->ch[1];
+    if (c) c->parent = t->parent;
+    if (!t->parent) {
+      root = c;
+    } else {
+      t->parent->ch[t->parent->ch[1] == t] = c;
     }
-    int b = key > t->key();
-    pair<Node*, pair_iterator_bool> p = __insert(t->ch[b], x);
-    t->ch[b] = p.first;
-    if (t->pri > t->ch[b]->pri) t = __rotate(t, 1 - b);
-    return make_pair(t, p.second);
+
+    __free_node(t);
+    size_--;
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  Node* __find(Node* t, const key_type& key) const {
-    return (!t || key == t->key()) ? t : __find(t->ch[key > t->key()], key);
+  Node* __find(const key_type& key) const {
+    Node* t = root;
+    while (t) {
+      if (comp_(key, t->key())) {
+        t = t->ch[0];
+      } else if (comp_(t->key(), key)) {
+        t = t->ch[1];
+      } else {
+        return t;
+      }
+    }
+    return 0;
   }
 
+  // First node whose key is not less than `key`.
   NANOSTL_HOST_AND_DEVICE_QUAL
-  Node* __upper_bound(Node* t, const key_type& key) const {
-    if (!t) return 0;
-    if (key < t->key()) {
-      Node* s = __upper_bound(t->ch[0], key);
-      return s ? s : t;
+  Node* __lower_bound(const key_type& key) const {
+    Node* t = root;
+    Node* ret = 0;
+    while (t) {
+      if (!comp_(t->key(), key)) {
+        ret = t;
+        t = t->ch[0];
+      } else {
+        t = t->ch[1];
+      }
+    }
+    return ret;
+  }
+
+  // First node whose key is greater than `key`.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  Node* __upper_bound(const key_type& key) const {
+    Node* t = root;
+    Node* ret = 0;
+    while (t) {
+      if (comp_(key, t->key())) {
+        ret = t;
+        t = t->ch[0];
+      } else {
+        t = t->ch[1];
+      }
+    }
+    return ret;
+  }
+
+  // Run destructors only; node storage goes back with pool_.release().
+  // Post-order walk that unlinks each leaf from its parent as it goes.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __destroy_values(Node* t) {
+    if (is_trivially_destructible<value_type>::value) return;
+    while (t) {
+      if (t->ch[0]) {
+        t = t->ch[0];
+      } else if (t->ch[1]) {
+        t = t->ch[1];
+      } else {
+        Node* p = t->parent;
+        if (p) p->ch[p->ch[1] == t] = 0;
+        t->~Node();
+        t = p;
+      }
+    }
+  }
+
+  // Clone the shape and priorities of `rhs` in a pre-order walk, so no
+  // rebalancing is needed. `*this` must be empty.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __copy(const map& rhs) {
+    const Node* s = rhs.root;
+    if (!s) return;
+
+    root = __clone_node(s, 0);
+    Node* d = root;
+    while (s) {
+      if (s->ch[0] && !d->ch[0]) {
+        d->ch[0] = __clone_node(s->ch[0], d);
+        s = s->ch[0];
+        d = d->ch[0];
+      } else if (s->ch[1] && !d->ch[1]) {
+        d->ch[1] = __clone_node(s->ch[1], d);
+        s = s->ch[1];
+        d = d->ch[1];
+      } else {
+        s = (s == rhs.root) ? 0 : s->parent;
+        d = d->parent;
+      }
     }
-    return __upper_bound(t->ch[1], key);
+    size_ = rhs.size_;
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  void __delete(Node* t) {
-    if (!t) return;
-    __delete(t->ch[0]);
-    __delete(t->ch[1]);
-    delete t;
+  Node* __clone_node(const Node* s, Node* parent) {
+    Node* n = __new_node(s->val);
+    n->pri = s->pri;
+    n->parent = parent;
+    return n;
   }
 
 #ifdef NANOSTL_DEBUG
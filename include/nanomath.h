@@ -25,7 +25,7 @@
 #ifndef NANOSTL_MATH_H_
 #define NANOSTL_MATH_H_
 
-#include "nanoalgorithm.h"
+#include "__minmax.h"
 #include "nanocommon.h"
 #include "nanolimits.h"
 
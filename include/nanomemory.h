@@ -11,6 +11,7 @@
 #include "nanotype_traits.h"
 #include "nanocommon.h"
 #include "nanofunctional.h"
+#include "nanoutility.h"
 
 #include "__nullptr"
 
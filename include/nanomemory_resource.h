@@ -0,0 +1,443 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2021 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_MEMORY_RESOURCE_H_
+#define NANOSTL_MEMORY_RESOURCE_H_
+
+#include "nanoallocator.h"
+#include "nanocommon.h"
+#include "nanocstdint.h"
+
+//
+// Monotonic (bump pointer) arena and an allocator adaptor for it.
+// Similar to std::pmr::monotonic_buffer_resource, but without virtual
+// dispatch so that it can also be used in device code.
+//
+// Also provides a fixed-size node pool used by node based containers.
+//
+
+namespace nanostl {
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+///
+/// Hands out memory by bumping a pointer. Individual deallocation is a
+/// no-op; all memory is reclaimed at once with `reset()` or `release()`.
+///
+/// Memory comes from an optional user supplied buffer first, then from
+/// blocks obtained with ::operator new. Blocks are kept over `reset()` so a
+/// per-frame arena stops allocating once it has reached its peak size.
+///
+/// Not thread safe.
+///
+class monotonic_arena {
+ public:
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit monotonic_arena(size_type initial_block_size = 4096)
+      : buffer_(0),
+        buffer_size_(0),
+        head_(0),
+        current_(0),
+        cur_(0),
+        end_(0),
+        next_block_size_(initial_block_size < size_type(kMinBlockSize)
+                             ? size_type(kMinBlockSize)
+                             : initial_block_size),
+        allocated_(0) {}
+
+  // Use `buffer` (not owned) before falling back to heap blocks.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  monotonic_arena(void* buffer, size_type buffer_size)
+      : buffer_(static_cast<unsigned char*>(buffer)),
+        buffer_size_(buffer_size),
+        head_(0),
+        current_(0),
+        cur_(buffer_),
+        end_(buffer_ + buffer_size),
+        next_block_size_(buffer_size < size_type(kMinBlockSize)
+                             ? size_type(kMinBlockSize)
+                             : buffer_size),
+        allocated_(0) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  ~monotonic_arena() { release(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void* allocate(size_type bytes, size_type alignment = kDefaultAlignment) {
+    unsigned char* p = cur_ ? __align_up(cur_, alignment) : 0;
+    if (!p || (p > end_) || (size_type(end_ - p) < bytes)) {
+      p = __next_block(bytes, alignment);
+      if (!p) {
+        return 0;
+      }
+    }
+
+    cur_ = p + bytes;
+    allocated_ += bytes;
+    return p;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void deallocate(void* p, size_type bytes,
+                  size_type alignment = kDefaultAlignment) {
+    // Memory is reclaimed by reset()/release().
+    (void)p;
+    (void)bytes;
+    (void)alignment;
+  }
+
+  // Make all memory available again. Heap blocks are retained for reuse.
+  // Objects living in the arena must not be used after this.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void reset() {
+    allocated_ = 0;
+    current_ = 0;
+    if (buffer_) {
+      cur_ = buffer_;
+      end_ = buffer_ + buffer_size_;
+    } else if (head_) {
+      current_ = head_;
+      cur_ = __block_begin(head_);
+      end_ = __block_end(head_);
+    } else {
+      cur_ = end_ = 0;
+    }
+  }
+
+  // Return all heap blocks to the system.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void release() {
+    __block* b = head_;
+    while (b) {
+      __block* next = b->next;
+      ::operator delete(b);
+      b = next;
+    }
+    head_ = 0;
+    reset();
+  }
+
+  // Bytes handed out since construction or the last reset().
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type bytes_allocated() const { return allocated_; }
+
+ private:
+  enum { kMinBlockSize = 256, kDefaultAlignment = 16 };
+
+  struct __block {
+    __block* next;
+    size_type size;  // usable bytes after the header
+  };
+
+  monotonic_arena(const monotonic_arena&);
+  monotonic_arena& operator=(const monotonic_arena&);
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static unsigned char* __align_up(unsigned char* p, size_type alignment) {
+    uintptr_t v = reinterpret_cast<uintptr_t>(p);
+    v = (v + (alignment - 1)) & ~uintptr_t(alignment - 1);
+    return reinterpret_cast<unsigned char*>(v);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static unsigned char* __block_begin(__block* b) {
+    return reinterpret_cast<unsigned char*>(b) + sizeof(__block);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static unsigned char* __block_end(__block* b) {
+    return __block_begin(b) + b->size;
+  }
+
+  // Move to the next retained block which fits the request, or append a
+  // new one after the current block.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  unsigned char* __next_block(size_type bytes, size_type alignment) {
+    size_type need = bytes + alignment;
+
+    __block* b = current_ ? current_->next : head_;
+    while (b) {
+      if (b->size >= need) {
+        current_ = b;
+        cur_ = __block_begin(b);
+        end_ = __block_end(b);
+        return __align_up(cur_, alignment);
+      }
+      b = b->next;
+    }
+
+    size_type size = next_block_size_;
+    while (size < need) {
+      size *= 2;
+    }
+
+    void* mem = ::operator new(sizeof(__block) + size);
+    if (!mem) {
+      return 0;
+    }
+
+    b = static_cast<__block*>(mem);
+    b->size = size;
+    if (current_) {
+      b->next = current_->next;
+      current_->next = b;
+    } else {
+      b->next = head_;
+      head_ = b;
+    }
+
+    next_block_size_ = size * 2;
+
+    current_ = b;
+    cur_ = __block_begin(b);
+    end_ = __block_end(b);
+    return __align_up(cur_, alignment);
+  }
+
+  unsigned char* buffer_;
+  size_type buffer_size_;
+
+  __block* head_;     // heap blocks in the order they are consumed
+  __block* current_;  // block `cur_` points into, or null for `buffer_`
+  unsigned char* cur_;
+  unsigned char* end_;
+
+  size_type next_block_size_;
+  size_type allocated_;
+};
+
+///
+/// Allocator which draws from a monotonic_arena. Usable with vector,
+/// valarray, basic_string and map. Copies share the arena.
+///
+template <class T>
+class arena_allocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef nanostl::size_type size_type;
+
+  template <class U>
+  struct rebind {
+    typedef arena_allocator<U> other;
+  };
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  arena_allocator(monotonic_arena* arena) : arena_(arena) {}
+
+  template <class U>
+  NANOSTL_HOST_AND_DEVICE_QUAL arena_allocator(const arena_allocator<U>& rhs)
+      : arena_(rhs.arena()) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  T* allocate(size_type n, const void* hint = 0) {
+    (void)hint;
+    if (n < 1) {
+      return 0;
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void deallocate(T* p, size_type n) {
+    arena_->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  monotonic_arena* arena() const { return arena_; }
+
+ private:
+  monotonic_arena* arena_;
+};
+
+template <class T, class U>
+NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator==(
+    const arena_allocator<T>& a, const arena_allocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <class T, class U>
+NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator!=(
+    const arena_allocator<T>& a, const arena_allocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+///
+/// Fixed-size object pool. Storage is carved out of cache line aligned
+/// chunks obtained from `Allocator`, and freed slots are kept on a free list
+/// for reuse. `release()` returns every chunk at once without visiting the
+/// individual objects.
+///
+/// The pool only manages storage; objects are constructed and destroyed by
+/// the caller. Not copyable, not thread safe.
+///
+template <class T, class Allocator = nanostl::allocator<T> >
+class node_pool {
+ public:
+  typedef T value_type;
+  typedef nanostl::size_type size_type;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit node_pool(const Allocator& alloc = Allocator())
+      : alloc_(alloc),
+        chunks_(0),
+        free_(0),
+        cur_(0),
+        end_(0),
+        next_chunk_nodes_(kMinChunkNodes) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  ~node_pool() { release(); }
+
+  // Storage for one T.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  T* allocate() {
+    if (free_) {
+      __slot* s = free_;
+      free_ = s->next;
+      return reinterpret_cast<T*>(s);
+    }
+
+    if (cur_ == end_) {
+      if (!__new_chunk()) {
+        return 0;
+      }
+    }
+
+    T* p = reinterpret_cast<T*>(cur_);
+    cur_ += kSlotSize;
+    return p;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void deallocate(T* p) {
+    if (!p) {
+      return;
+    }
+    __slot* s = reinterpret_cast<__slot*>(p);
+    s->next = free_;
+    free_ = s;
+  }
+
+  // Free all chunks. Objects still in the pool are not destroyed.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void release() {
+    __chunk* c = chunks_;
+    while (c) {
+      __chunk* next = c->next;
+      byte_traits::deallocate(alloc_, c->raw, c->raw_size);
+      c = next;
+    }
+    chunks_ = 0;
+    free_ = 0;
+    cur_ = end_ = 0;
+    next_chunk_nodes_ = kMinChunkNodes;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  Allocator get_allocator() const { return Allocator(alloc_); }
+
+ private:
+  typedef typename nanostl::allocator_traits<Allocator>::template rebind_alloc<
+      unsigned char>::other byte_allocator_type;
+  typedef nanostl::allocator_traits<byte_allocator_type> byte_traits;
+
+  union __slot {
+    __slot* next;
+    unsigned char storage[sizeof(T)];
+  };
+
+  // Lives at the start of each chunk, before the first slot.
+  struct __chunk {
+    __chunk* next;
+    unsigned char* raw;
+    size_type raw_size;
+  };
+
+  enum {
+    kCacheLineSize = 64,
+    kAlign = alignof(T) > alignof(__slot*) ? alignof(T) : alignof(__slot*),
+    kSlotSize = ((sizeof(__slot) + kAlign - 1) / kAlign) * kAlign,
+    kHeaderSize = ((sizeof(__chunk) + kCacheLineSize - 1) / kCacheLineSize) *
+                  kCacheLineSize,
+    kMinChunkNodes = 32,
+    kMaxChunkBytes = 64 * 1024
+  };
+
+  node_pool(const node_pool&);
+  node_pool& operator=(const node_pool&);
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool __new_chunk() {
+    size_type nodes = next_chunk_nodes_;
+    size_type raw_size = kHeaderSize + nodes * kSlotSize + kCacheLineSize;
+
+    unsigned char* raw = byte_traits::allocate(alloc_, raw_size);
+    if (!raw) {
+      return false;
+    }
+
+    uintptr_t v = reinterpret_cast<uintptr_t>(raw);
+    v = (v + (kCacheLineSize - 1)) & ~uintptr_t(kCacheLineSize - 1);
+    unsigned char* base = reinterpret_cast<unsigned char*>(v);
+
+    __chunk* c = reinterpret_cast<__chunk*>(base);
+    c->next = chunks_;
+    c->raw = raw;
+    c->raw_size = raw_size;
+    chunks_ = c;
+
+    cur_ = base + kHeaderSize;
+    end_ = cur_ + nodes * kSlotSize;
+
+    if ((nodes * 2) * kSlotSize <= size_type(kMaxChunkBytes)) {
+      next_chunk_nodes_ = nodes * 2;
+    }
+
+    return true;
+  }
+
+  byte_allocator_type alloc_;
+  __chunk* chunks_;
+  __slot* free_;
+  unsigned char* cur_;  // next never-used slot in the newest chunk
+  unsigned char* end_;
+  size_type next_chunk_nodes_;
+};
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_MEMORY_RESOURCE_H_
@@ -0,0 +1,482 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_NUMERIC_H_
+#define NANOSTL_NUMERIC_H_
+
+#include "nanocommon.h"
+#include "nanofunctional.h"
+#include "nanoiterator.h"
+#include "nanotype_traits.h"
+
+#if defined(NANOSTL_PSTL)
+#include "nanoexecution.h"
+#include "nanovector.h"
+#endif
+
+namespace nanostl {
+
+//
+// reduce and transform_reduce may group and reorder the operations. For
+// random access iterators and arithmetic accumulators they keep 8
+// independent partial sums, which the compiler can hold in SIMD registers.
+// Floating point results may therefore differ from a left-to-right sum in
+// the last bits.
+//
+
+// Folds `get(0..n-1)` into `init`.
+template <class T, class BinaryOp, class Get>
+inline T __reduce_n(size_t n, T init, BinaryOp& op, Get& get, false_type) {
+  for (size_t i = 0; i < n; i++) {
+    init = op(init, get(i));
+  }
+  return init;
+}
+
+template <class T, class BinaryOp, class Get>
+inline T __reduce_n(size_t n, T init, BinaryOp& op, Get& get, true_type) {
+  const size_t lanes = 8;
+  if (n < 2 * lanes) {
+    return __reduce_n(n, init, op, get, false_type());
+  }
+  T acc[lanes];
+  for (size_t k = 0; k < lanes; k++) {
+    acc[k] = get(k);
+  }
+  const size_t blocks = n / lanes;
+  for (size_t j = 1; j < blocks; j++) {
+    for (size_t k = 0; k < lanes; k++) {
+      acc[k] = op(acc[k], get(j * lanes + k));
+    }
+  }
+  for (size_t i = blocks * lanes; i < n; i++) {
+    init = op(init, get(i));
+  }
+  // Pairwise, to keep rounding errors of the lanes balanced.
+  for (size_t w = lanes / 2; w > 0; w /= 2) {
+    for (size_t k = 0; k < w; k++) {
+      acc[k] = op(acc[k], acc[k + w]);
+    }
+  }
+  return op(init, acc[0]);
+}
+
+template <class T, class BinaryOp, class Get>
+inline T __reduce_n(size_t n, T init, BinaryOp& op, Get& get) {
+  return __reduce_n(n, init, op, get,
+                    integral_constant<bool, is_arithmetic<T>::value>());
+}
+
+template <class InputIterator, class T, class BinaryOp>
+inline T __reduce_range(InputIterator first, InputIterator last, T init,
+                        BinaryOp& op, random_access_iterator_tag) {
+  typedef typename iterator_traits<InputIterator>::difference_type diff_t;
+  auto get = [first](size_t i) -> decltype(first[0]) {
+    return first[diff_t(i)];
+  };
+  return __reduce_n(size_t(last - first), init, op, get);
+}
+
+template <class InputIterator, class T, class BinaryOp, class Tag>
+inline T __reduce_range(InputIterator first, InputIterator last, T init,
+                        BinaryOp& op, Tag) {
+  for (; first != last; ++first) {
+    init = op(init, *first);
+  }
+  return init;
+}
+
+template <class InputIterator, class T, class BinaryOp>
+T reduce(InputIterator first, InputIterator last, T init, BinaryOp op) {
+  return __reduce_range(
+      first, last, init, op,
+      typename iterator_traits<InputIterator>::iterator_category());
+}
+
+template <class InputIterator, class T>
+T reduce(InputIterator first, InputIterator last, T init) {
+  return nanostl::reduce(first, last, init, plus<>());
+}
+
+template <class InputIterator>
+typename iterator_traits<InputIterator>::value_type reduce(
+    InputIterator first, InputIterator last) {
+  return nanostl::reduce(first, last,
+                typename iterator_traits<InputIterator>::value_type());
+}
+
+template <class InputIterator1, class InputIterator2, class T,
+          class BinaryReductionOp, class BinaryTransformOp>
+inline T __transform_reduce_range(InputIterator1 first1, InputIterator1 last1,
+                                  InputIterator2 first2, T init,
+                                  BinaryReductionOp& reduce_op,
+                                  BinaryTransformOp& transform_op, true_type) {
+  typedef typename iterator_traits<InputIterator1>::difference_type diff_t;
+  auto get = [first1, first2, &transform_op](size_t i) {
+    return transform_op(first1[diff_t(i)], first2[diff_t(i)]);
+  };
+  return __reduce_n(size_t(last1 - first1), init, reduce_op, get);
+}
+
+template <class InputIterator1, class InputIterator2, class T,
+          class BinaryReductionOp, class BinaryTransformOp>
+inline T __transform_reduce_range(InputIterator1 first1, InputIterator1 last1,
+                                  InputIterator2 first2, T init,
+                                  BinaryReductionOp& reduce_op,
+                                  BinaryTransformOp& transform_op, false_type) {
+  for (; first1 != last1; ++first1, ++first2) {
+    init = reduce_op(init, transform_op(*first1, *first2));
+  }
+  return init;
+}
+
+template <class InputIterator1, class InputIterator2, class T,
+          class BinaryReductionOp, class BinaryTransformOp>
+T transform_reduce(InputIterator1 first1, InputIterator1 last1,
+                   InputIterator2 first2, T init, BinaryReductionOp reduce_op,
+                   BinaryTransformOp transform_op) {
+  return __transform_reduce_range(
+      first1, last1, first2, init, reduce_op, transform_op,
+      __both_random_access<InputIterator1, InputIterator2>());
+}
+
+template <class InputIterator1, class InputIterator2, class T>
+T transform_reduce(InputIterator1 first1, InputIterator1 last1,
+                   InputIterator2 first2, T init) {
+  return nanostl::transform_reduce(first1, last1, first2, init, plus<>(),
+                          multiplies<>());
+}
+
+template <class InputIterator, class T, class BinaryReductionOp,
+          class UnaryTransformOp>
+T transform_reduce(InputIterator first, InputIterator last, T init,
+                   BinaryReductionOp reduce_op, UnaryTransformOp transform_op) {
+  // Second range is the first one again, ignored by the transform.
+  auto op = [&transform_op](decltype(*first) x, decltype(*first)) {
+    return transform_op(x);
+  };
+  return __transform_reduce_range(
+      first, last, first, init, reduce_op, op,
+      __both_random_access<InputIterator, InputIterator>());
+}
+
+//
+// Scans. `d_first` may equal `first`(in place).
+//
+
+template <class InputIterator, class OutputIterator, class BinaryOp, class T>
+OutputIterator inclusive_scan(InputIterator first, InputIterator last,
+                              OutputIterator d_first, BinaryOp op, T init) {
+  for (; first != last; ++first, ++d_first) {
+    init = op(init, *first);
+    *d_first = init;
+  }
+  return d_first;
+}
+
+template <class InputIterator, class OutputIterator, class BinaryOp>
+OutputIterator inclusive_scan(InputIterator first, InputIterator last,
+                              OutputIterator d_first, BinaryOp op) {
+  if (first == last) {
+    return d_first;
+  }
+  typename iterator_traits<InputIterator>::value_type acc = *first;
+  *d_first = acc;
+  ++first;
+  ++d_first;
+  return nanostl::inclusive_scan(first, last, d_first, op, acc);
+}
+
+template <class InputIterator, class OutputIterator>
+OutputIterator inclusive_scan(InputIterator first, InputIterator last,
+                              OutputIterator d_first) {
+  return nanostl::inclusive_scan(first, last, d_first, plus<>());
+}
+
+template <class InputIterator, class OutputIterator, class T, class BinaryOp>
+OutputIterator exclusive_scan(InputIterator first, InputIterator last,
+                              OutputIterator d_first, T init, BinaryOp op) {
+  for (; first != last; ++first, ++d_first) {
+    T v = op(init, *first);  // read before writing(in place)
+    *d_first = init;
+    init = v;
+  }
+  return d_first;
+}
+
+template <class InputIterator, class OutputIterator, class T>
+OutputIterator exclusive_scan(InputIterator first, InputIterator last,
+                              OutputIterator d_first, T init) {
+  return nanostl::exclusive_scan(first, last, d_first, init, plus<>());
+}
+
+#if defined(NANOSTL_PSTL)
+
+//
+// Parallel overloads: the range is split into fixed chunks, each reduced
+// on the pool, and the partial results are combined in chunk order. Scans
+// take two passes(chunk sums, then each chunk scanned from its offset), so
+// their operator only needs to be associative. Without random access
+// iterators they run serially. Accumulators must be default constructible.
+//
+
+namespace __pstl {
+
+// Reduces `get(0..n-1)` into `init`. `get` is called concurrently.
+template <class Policy, class T, class BinaryOp, class Get>
+T __reduce(size_t n, T init, BinaryOp& op, Get& get) {
+  const __chunks chunks = __make_chunks<Policy>(n);
+  if (chunks.count <= 1) {
+    return __reduce_n(n, init, op, get);
+  }
+  vector<T> partial;
+  partial.resize(chunks.count);
+  __for_each_chunk(chunks, [&op, &get, &partial](size_t c, size_t b, size_t e) {
+    // No identity value for the chunk: start from its first element.
+    auto rest = [&get, b](size_t i) { return get(b + 1 + i); };
+    partial[c] = __reduce_n(e - b - 1, T(get(b)), op, rest);
+  });
+  for (size_t c = 0; c < chunks.count; c++) {
+    init = op(init, partial[c]);
+  }
+  return init;
+}
+
+template <class Policy, class InputIterator, class OutputIterator, class T,
+          class BinaryOp>
+OutputIterator __scan(InputIterator first, InputIterator last,
+                      OutputIterator d_first, BinaryOp& op, T init,
+                      bool has_init, bool inclusive) {
+  typedef typename iterator_traits<InputIterator>::difference_type diff_t;
+  const size_t n = size_t(last - first);
+  const __chunks chunks = __make_chunks<Policy>(n);
+  if (chunks.count <= 1) {
+    if (!inclusive) {
+      return nanostl::exclusive_scan(first, last, d_first, init, op);
+    }
+    return has_init ? nanostl::inclusive_scan(first, last, d_first, op, init)
+                    : nanostl::inclusive_scan(first, last, d_first, op);
+  }
+
+  // Pass 1: sum of every chunk but the last, in order(no commuting).
+  vector<T> carry;
+  carry.resize(chunks.count);
+  __for_each_chunk(chunks, [&](size_t c, size_t b, size_t e) {
+    if (c + 1 == chunks.count) {
+      return;
+    }
+    InputIterator in = first + diff_t(b + 1);
+    auto get = [in](size_t i) { return in[diff_t(i)]; };
+    carry[c] =
+        __reduce_n(e - b - 1, T(first[diff_t(b)]), op, get, false_type());
+  });
+
+  // Turn chunk sums into the value carried into each chunk.
+  T acc = init;
+  for (size_t c = 0; c < chunks.count; c++) {
+    T sum = carry[c];
+    carry[c] = acc;
+    acc = (has_init || (c > 0)) ? T(op(acc, sum)) : sum;
+  }
+
+  // Pass 2.
+  __for_each_chunk(chunks, [&](size_t c, size_t b, size_t e) {
+    InputIterator in = first + diff_t(b);
+    OutputIterator out = d_first + diff_t(b);
+    if (!inclusive) {
+      nanostl::exclusive_scan(in, in + diff_t(e - b), out, carry[c], op);
+    } else if ((c == 0) && !has_init) {
+      nanostl::inclusive_scan(in, in + diff_t(e - b), out, op);
+    } else {
+      nanostl::inclusive_scan(in, in + diff_t(e - b), out, op, carry[c]);
+    }
+  });
+  return d_first + diff_t(n);
+}
+
+} // namespace __pstl
+
+template <class ExecutionPolicy, class ForwardIterator, class T,
+          class BinaryOp>
+__pstl::__enable_if_policy_t<ExecutionPolicy, T> reduce(
+    ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+    T init, BinaryOp op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__is_random_access_iterator<ForwardIterator>::value) {
+    typedef typename iterator_traits<ForwardIterator>::difference_type diff_t;
+    auto get = [first](size_t i) -> decltype(first[0]) {
+      return first[diff_t(i)];
+    };
+    return __pstl::__reduce<policy>(size_t(last - first), init, op, get);
+  } else {
+    return nanostl::reduce(first, last, init, op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T>
+__pstl::__enable_if_policy_t<ExecutionPolicy, T> reduce(
+    ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+    T init) {
+  return nanostl::reduce(nanostl::forward<ExecutionPolicy>(exec), first, last,
+                         init, plus<>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator>
+__pstl::__enable_if_policy_t<
+    ExecutionPolicy, typename iterator_traits<ForwardIterator>::value_type>
+reduce(ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last) {
+  return nanostl::reduce(nanostl::forward<ExecutionPolicy>(exec), first, last,
+                         typename iterator_traits<ForwardIterator>::value_type(),
+                         plus<>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class T, class BinaryReductionOp,
+          class BinaryTransformOp>
+__pstl::__enable_if_policy_t<ExecutionPolicy, T> transform_reduce(
+    ExecutionPolicy&& exec, ForwardIterator1 first1, ForwardIterator1 last1,
+    ForwardIterator2 first2, T init, BinaryReductionOp reduce_op,
+    BinaryTransformOp transform_op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value) {
+    typedef typename iterator_traits<ForwardIterator1>::difference_type diff_t;
+    auto get = [first1, first2, &transform_op](size_t i) {
+      return transform_op(first1[diff_t(i)], first2[diff_t(i)]);
+    };
+    return __pstl::__reduce<policy>(size_t(last1 - first1), init, reduce_op,
+                                    get);
+  } else {
+    return nanostl::transform_reduce(first1, last1, first2, init, reduce_op,
+                            transform_op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class T>
+__pstl::__enable_if_policy_t<ExecutionPolicy, T> transform_reduce(
+    ExecutionPolicy&& exec, ForwardIterator1 first1, ForwardIterator1 last1,
+    ForwardIterator2 first2, T init) {
+  return nanostl::transform_reduce(nanostl::forward<ExecutionPolicy>(exec),
+                                   first1, last1, first2, init, plus<>(),
+                                   multiplies<>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T,
+          class BinaryReductionOp, class UnaryTransformOp>
+__pstl::__enable_if_policy_t<ExecutionPolicy, T> transform_reduce(
+    ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+    T init, BinaryReductionOp reduce_op, UnaryTransformOp transform_op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__is_random_access_iterator<ForwardIterator>::value) {
+    typedef typename iterator_traits<ForwardIterator>::difference_type diff_t;
+    auto get = [first, &transform_op](size_t i) {
+      return transform_op(first[diff_t(i)]);
+    };
+    return __pstl::__reduce<policy>(size_t(last - first), init, reduce_op,
+                                    get);
+  } else {
+    return nanostl::transform_reduce(first, last, init, reduce_op,
+                                     transform_op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class BinaryOp, class T>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> inclusive_scan(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first, BinaryOp op, T init) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value) {
+    return __pstl::__scan<policy>(first, last, d_first, op, init, true, true);
+  } else {
+    return nanostl::inclusive_scan(first, last, d_first, op, init);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class BinaryOp>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> inclusive_scan(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first, BinaryOp op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+  typedef typename iterator_traits<ForwardIterator1>::value_type T;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value) {
+    return __pstl::__scan<policy>(first, last, d_first, op, T(), false, true);
+  } else {
+    return nanostl::inclusive_scan(first, last, d_first, op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> inclusive_scan(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first) {
+  return nanostl::inclusive_scan(nanostl::forward<ExecutionPolicy>(exec), first,
+                                 last, d_first, plus<>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class T, class BinaryOp>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> exclusive_scan(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first, T init, BinaryOp op) {
+  (void)exec;
+  typedef __pstl::__policy_t<ExecutionPolicy> policy;
+
+  if constexpr (__both_random_access<ForwardIterator1,
+                                    ForwardIterator2>::value) {
+    return __pstl::__scan<policy>(first, last, d_first, op, init, true, false);
+  } else {
+    return nanostl::exclusive_scan(first, last, d_first, init, op);
+  }
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class T>
+__pstl::__enable_if_policy_t<ExecutionPolicy, ForwardIterator2> exclusive_scan(
+    ExecutionPolicy&& exec, ForwardIterator1 first, ForwardIterator1 last,
+    ForwardIterator2 d_first, T init) {
+  return nanostl::exclusive_scan(nanostl::forward<ExecutionPolicy>(exec), first,
+                                 last, d_first, init, plus<>());
+}
+
+#endif // NANOSTL_PSTL
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_NUMERIC_H_
@@ -0,0 +1,528 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_OSTREAM_H_
+#define NANOSTL_OSTREAM_H_
+
+#include "nanocharconv.h"
+#include "nanoios.h"
+#include "nanoiosfwd.h"
+#include "nanostreambuf.h"
+#include "nanostring.h"
+#include "nanostring_view.h"
+#include "__nullptr"
+
+namespace nanostl {
+
+// Based on libcxx ----------------------
+//
+// Output goes straight to the stream buffer: write()/put() copy into its
+// put area and numbers are formatted with to_chars, in place when the put
+// area has room. Supported format flags are boolalpha, dec/hex/oct,
+// fixed/scientific/hexfloat(shortest round trip, precision() is ignored),
+// left/right with width()/fill(), and unitbuf.
+//
+template <class _CharT, class _Traits>
+class basic_ostream
+    : virtual public basic_ios<_CharT, _Traits>
+{
+public:
+    // types (inherited from basic_ios (27.5.4)):
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+
+    // 27.7.2.2 Constructor/destructor:
+    explicit basic_ostream(basic_streambuf<char_type, traits_type>* __sb)
+        { this->init(__sb); }
+    virtual ~basic_ostream() {}
+
+    // 27.7.2.6 Formatted output:
+    inline basic_ostream& operator<<(basic_ostream& (*__pf)(basic_ostream&))
+        { return __pf(*this); }
+
+    inline basic_ostream& operator<<(basic_ios<char_type, traits_type>&
+                                     (*__pf)(basic_ios<char_type, traits_type>&))
+        { __pf(*this); return *this; }
+
+    inline basic_ostream& operator<<(ios_base& (*__pf)(ios_base&))
+        { __pf(*this); return *this; }
+
+    basic_ostream& operator<<(bool __n);
+    basic_ostream& operator<<(short __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(unsigned short __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(int __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(unsigned int __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(long __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(unsigned long __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(long long __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(unsigned long long __n) { return __put_integer(__n); }
+    basic_ostream& operator<<(float __f) { return __put_float(__f); }
+    basic_ostream& operator<<(double __f) { return __put_float(__f); }
+    // Printed with double precision.
+    basic_ostream& operator<<(long double __f) { return __put_float(static_cast<double>(__f)); }
+    basic_ostream& operator<<(const void* __p);
+
+    basic_ostream& operator<<(basic_streambuf<char_type, traits_type>* __sb);
+
+    inline
+    basic_ostream& operator<<(nullptr_t)
+    { return *this << "nullptr"; }
+
+    // 27.7.2.7 Unformatted output:
+    basic_ostream& put(char_type __c);
+    basic_ostream& write(const char_type* __s, streamsize __n);
+    basic_ostream& flush();
+
+    // 27.7.2.5 Seeks:
+    pos_type tellp();
+    basic_ostream& seekp(pos_type __pos);
+    basic_ostream& seekp(off_type __off, ios_base::seekdir __dir);
+
+    // Writes [__s, __s + __n) padded to width() with fill(), then resets
+    // width() to 0. Used by all formatted output.
+    basic_ostream& __put_padded(const char_type* __s, streamsize __n);
+
+protected:
+    basic_ostream() {}  // the most derived class calls init()
+    // Takes the format and state of __rhs; the most derived class sets
+    // the buffer.
+    basic_ostream(basic_ostream&& __rhs) { this->move(__rhs); }
+
+private:
+    template <class _Tp>
+    basic_ostream& __put_integer(_Tp __n);
+    template <class _Tp>
+    basic_ostream& __put_float(_Tp __f);
+
+    // Formats with `__fmt(first, last)` directly into the put area when it
+    // has room and no padding is needed, otherwise into a local buffer of
+    // _Size chars.
+    template <size_t _Size, class _Format>
+    basic_ostream& __put_chars(_Format __fmt);
+
+    inline void __after_output()
+    {
+        if (this->flags() & ios_base::unitbuf)
+            flush();
+    }
+};
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::__put_padded(const char_type* __s, streamsize __n)
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (!__sb || this->fail())
+    {
+        this->setstate(ios_base::badbit);
+        return *this;
+    }
+
+    const streamsize __wide = this->width();
+    const streamsize __pad = (__wide > __n) ? (__wide - __n) : 0;
+    const bool __left = (this->flags() & ios_base::adjustfield) == ios_base::left;
+    bool __ok = true;
+    if (__pad && !__left)
+    {
+        for (streamsize __i = 0; __ok && (__i < __pad); ++__i)
+            __ok = !traits_type::eq_int_type(__sb->sputc(this->fill()), traits_type::eof());
+    }
+    __ok = __ok && (__sb->sputn(__s, __n) == __n);
+    if (__pad && __left)
+    {
+        for (streamsize __i = 0; __ok && (__i < __pad); ++__i)
+            __ok = !traits_type::eq_int_type(__sb->sputc(this->fill()), traits_type::eof());
+    }
+    this->width(0);
+    if (!__ok)
+        this->setstate(ios_base::badbit);
+    __after_output();
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+template <size_t _Size, class _Format>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::__put_chars(_Format __fmt)
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (is_same<char_type, char>::value && __sb && !this->fail() && (this->width() == 0))
+    {
+        char* __first = reinterpret_cast<char*>(__sb->__nout_);
+        char* __last = reinterpret_cast<char*>(__sb->__eout_);
+        to_chars_result __r = __fmt(__first, __last);
+        if (__r.ec == errc())
+        {
+            __sb->__nout_ = reinterpret_cast<char_type*>(__r.ptr);
+            __after_output();
+            return *this;
+        }
+    }
+
+    char __buf[_Size];
+    to_chars_result __r = __fmt(__buf, __buf + _Size);
+    char_type __wbuf[_Size];
+    const streamsize __n = static_cast<streamsize>(__r.ptr - __buf);
+    for (streamsize __i = 0; __i < __n; ++__i)
+        __wbuf[__i] = this->widen(__buf[__i]);
+    return __put_padded(__wbuf, __n);
+}
+
+template <class _Tp>
+struct __ostream_integer_format
+{
+    _Tp __value;
+    int __base;
+
+    to_chars_result operator()(char* __first, char* __last) const
+    {
+        if ((__base != 10) && is_signed<_Tp>::value)
+        {
+            // hex/oct print the two's complement bits, like printf("%x").
+            unsigned long long __u = static_cast<unsigned long long>(__value);
+            if (sizeof(_Tp) < sizeof(__u))
+                __u &= (1ull << (8 * (sizeof(_Tp) % sizeof(__u)))) - 1;
+            return to_chars(__first, __last, __u, __base);
+        }
+        return to_chars(__first, __last, __value, __base);
+    }
+};
+
+template <class _CharT, class _Traits>
+template <class _Tp>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::__put_integer(_Tp __n)
+{
+    const ios_base::fmtflags __basefield = this->flags() & ios_base::basefield;
+    __ostream_integer_format<_Tp> __fmt;
+    __fmt.__value = __n;
+    __fmt.__base = (__basefield == ios_base::hex) ? 16 : (__basefield == ios_base::oct) ? 8 : 10;
+    // 64 bit in octal: 22 digits and a sign.
+    return __put_chars<24>(__fmt);
+}
+
+template <class _Tp>
+struct __ostream_float_format
+{
+    _Tp __value;
+    ios_base::fmtflags __floatfield;
+
+    to_chars_result operator()(char* __first, char* __last) const
+    {
+        if (__floatfield == ios_base::fixed)
+            return to_chars(__first, __last, __value, chars_format::fixed);
+        if (__floatfield == ios_base::scientific)
+            return to_chars(__first, __last, __value, chars_format::scientific);
+        if ((__floatfield == (ios_base::fixed | ios_base::scientific)) &&
+            (__value - __value == 0))
+        {
+            // to_chars omits the "0x" prefix(inf/nan have none).
+            char* __p = __first;
+            if (__negative(__value))
+            {
+                if (__p == __last)
+                    return __too_large(__last);
+                *__p++ = '-';
+            }
+            if ((__last - __p) < 2)
+                return __too_large(__last);
+            *__p++ = '0';
+            *__p++ = 'x';
+            return to_chars(__p, __last, __value_abs(__value), chars_format::hex);
+        }
+        return to_chars(__first, __last, __value);
+    }
+
+    // Sign bit, so -0.0 prints as "-0x0p+0".
+    static bool __negative(_Tp __v)
+    {
+        typedef __float_layout<_Tp> __layout;
+        return (__layout::bits(__v) >> (__layout::mantissa_bits + __layout::exponent_bits)) & 1;
+    }
+
+    static _Tp __value_abs(_Tp __v) { return __negative(__v) ? -__v : __v; }
+
+    static to_chars_result __too_large(char* __last)
+    {
+        to_chars_result __r = {__last, errc::value_too_large};
+        return __r;
+    }
+};
+
+template <class _CharT, class _Traits>
+template <class _Tp>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::__put_float(_Tp __f)
+{
+    __ostream_float_format<_Tp> __fmt;
+    __fmt.__value = __f;
+    __fmt.__floatfield = this->flags() & ios_base::floatfield;
+    // Longest fixed double is denorm_min: "0." and 324 digits, plus a sign.
+    return __put_chars<336>(__fmt);
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::operator<<(bool __n)
+{
+    if (this->flags() & ios_base::boolalpha)
+    {
+        static const char_type __true[] = {'t', 'r', 'u', 'e'};
+        static const char_type __false[] = {'f', 'a', 'l', 's', 'e'};
+        return __n ? __put_padded(__true, 4) : __put_padded(__false, 5);
+    }
+    return __put_integer(static_cast<int>(__n));
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::operator<<(const void* __p)
+{
+    // "0x" and 16 hex digits, like printf("%p").
+    char_type __buf[2 + 2 * sizeof(void*)];
+    uintptr_t __v = reinterpret_cast<uintptr_t>(__p);
+    if (__v == 0)
+    {
+        __buf[0] = this->widen('0');
+        return __put_padded(__buf, 1);
+    }
+    char __digits[2 * sizeof(void*)];
+    to_chars_result __r = to_chars(__digits, __digits + sizeof(__digits), __v, 16);
+    streamsize __n = 0;
+    __buf[__n++] = this->widen('0');
+    __buf[__n++] = this->widen('x');
+    for (char* __d = __digits; __d != __r.ptr; ++__d)
+        __buf[__n++] = this->widen(*__d);
+    return __put_padded(__buf, __n);
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::operator<<(basic_streambuf<char_type, traits_type>* __sb)
+{
+    basic_streambuf<char_type, traits_type>* __out = this->rdbuf();
+    if (!__sb || !__out || this->fail())
+    {
+        this->setstate(ios_base::badbit);
+        return *this;
+    }
+
+    // Copies chunk-wise through a local buffer until __sb runs dry.
+    char_type __buf[256];
+    streamsize __total = 0;
+    for (;;)
+    {
+        streamsize __n = __sb->sgetn(__buf, 256);
+        if (__n <= 0)
+            break;
+        if (__out->sputn(__buf, __n) != __n)
+        {
+            this->setstate(ios_base::badbit);
+            break;
+        }
+        __total += __n;
+        if (__n < 256)
+            break;
+    }
+    if (__total == 0)
+        this->setstate(ios_base::failbit);
+    __after_output();
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::put(char_type __c)
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (!__sb || this->fail() ||
+        traits_type::eq_int_type(__sb->sputc(__c), traits_type::eof()))
+        this->setstate(ios_base::badbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::write(const char_type* __s, streamsize __n)
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (!__sb || this->fail() || (__sb->sputn(__s, __n) != __n))
+        this->setstate(ios_base::badbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::flush()
+{
+    basic_streambuf<char_type, traits_type>* __sb = this->rdbuf();
+    if (__sb && (__sb->pubsync() == -1))
+        this->setstate(ios_base::badbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+typename basic_ostream<_CharT, _Traits>::pos_type
+basic_ostream<_CharT, _Traits>::tellp()
+{
+    if (this->fail())
+        return pos_type(off_type(-1));
+    return this->rdbuf()->pubseekoff(0, ios_base::cur, ios_base::out);
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::seekp(pos_type __pos)
+{
+    if (!this->fail() &&
+        (this->rdbuf()->pubseekpos(__pos, ios_base::out) == pos_type(off_type(-1))))
+        this->setstate(ios_base::failbit);
+    return *this;
+}
+
+template <class _CharT, class _Traits>
+basic_ostream<_CharT, _Traits>&
+basic_ostream<_CharT, _Traits>::seekp(off_type __off, ios_base::seekdir __dir)
+{
+    if (!this->fail() &&
+        (this->rdbuf()->pubseekoff(__off, __dir, ios_base::out) == pos_type(off_type(-1))))
+        this->setstate(ios_base::failbit);
+    return *this;
+}
+
+// 27.7.2.6.4 Character inserter templates:
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+operator<<(basic_ostream<_CharT, _Traits>& __os, _CharT __c)
+{
+    return __os.__put_padded(&__c, 1);
+}
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+operator<<(basic_ostream<_CharT, _Traits>& __os, char __cn)
+{
+    _CharT __c = __os.widen(__cn);
+    return __os.__put_padded(&__c, 1);
+}
+
+template <class _Traits>
+inline basic_ostream<char, _Traits>&
+operator<<(basic_ostream<char, _Traits>& __os, char __c)
+{
+    return __os.__put_padded(&__c, 1);
+}
+
+template <class _Traits>
+inline basic_ostream<char, _Traits>&
+operator<<(basic_ostream<char, _Traits>& __os, signed char __c)
+{
+    return __os << static_cast<char>(__c);
+}
+
+template <class _Traits>
+inline basic_ostream<char, _Traits>&
+operator<<(basic_ostream<char, _Traits>& __os, unsigned char __c)
+{
+    return __os << static_cast<char>(__c);
+}
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+operator<<(basic_ostream<_CharT, _Traits>& __os, const _CharT* __str)
+{
+    return __os.__put_padded(__str, static_cast<streamsize>(_Traits::length(__str)));
+}
+
+template <class _Traits>
+inline basic_ostream<char, _Traits>&
+operator<<(basic_ostream<char, _Traits>& __os, const char* __str)
+{
+    return __os.__put_padded(__str, static_cast<streamsize>(_Traits::length(__str)));
+}
+
+template <class _Traits>
+inline basic_ostream<char, _Traits>&
+operator<<(basic_ostream<char, _Traits>& __os, const signed char* __str)
+{
+    return __os << reinterpret_cast<const char*>(__str);
+}
+
+template <class _Traits>
+inline basic_ostream<char, _Traits>&
+operator<<(basic_ostream<char, _Traits>& __os, const unsigned char* __str)
+{
+    return __os << reinterpret_cast<const char*>(__str);
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+inline basic_ostream<_CharT, _Traits>&
+operator<<(basic_ostream<_CharT, _Traits>& __os,
+           const basic_string<_CharT, _Allocator>& __str)
+{
+    return __os.__put_padded(__str.data(), static_cast<streamsize>(__str.size()));
+}
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+operator<<(basic_ostream<_CharT, _Traits>& __os,
+           basic_string_view<_CharT> __sv)
+{
+    return __os.__put_padded(__sv.data(), static_cast<streamsize>(__sv.size()));
+}
+
+// 27.7.2.8 Standard basic_ostream manipulators:
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+endl(basic_ostream<_CharT, _Traits>& __os)
+{
+    __os.put(__os.widen('\n'));
+    __os.flush();
+    return __os;
+}
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+ends(basic_ostream<_CharT, _Traits>& __os)
+{
+    __os.put(_CharT());
+    return __os;
+}
+
+template <class _CharT, class _Traits>
+inline basic_ostream<_CharT, _Traits>&
+flush(basic_ostream<_CharT, _Traits>& __os)
+{
+    __os.flush();
+    return __os;
+}
+
+} // namespace nanostl
+
+#endif // NANOSTL_OSTREAM_H_
@@ -0,0 +1,387 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_PARSE_H_
+#define NANOSTL_PARSE_H_
+
+//
+// Batch parsing of delimited float/double arrays(OBJ, CSV, ASCII PLY ...).
+//
+//   nanostl::vector<float> v;
+//   nanostl::parse_floats_result r = nanostl::parse_floats(p, p + n, v);
+//   if (r.ec != nanostl::errc()) {
+//     // r.ptr points to the offending token, r.count values were parsed.
+//   }
+//
+// Values are parsed in place with from_chars(fast_float), no temporary
+// strings. Separator runs are skipped 16 bytes at a time with SSE2/NEON.
+//
+// Setting `num_threads` > 1 splits large inputs at separators and parses
+// the chunks in parallel. This uses nanostl::thread, so it is only compiled
+// in when NANOSTL_PARSE_USE_THREAD is defined(link with libnanostl), and
+// `num_threads` is ignored otherwise.
+//
+
+#include "__string_search.h"
+#include "nanocharconv.h"
+#include "nanocommon.h"
+#include "nanocstring.h"
+#include "nanosystem_error.h"
+#include "nanovector.h"
+
+#if defined(NANOSTL_PARSE_USE_THREAD) && !defined(NANOSTL_NO_THREAD)
+#define NANOSTL_PARSE_THREADED
+#endif
+
+#if defined(NANOSTL_PARSE_THREADED)
+#include "nanothread.h"
+#endif
+
+namespace nanostl {
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+struct parse_floats_options {
+  // Separator bytes. Any run of them separates two values; leading and
+  // trailing runs are ignored. Up to 8 bytes take the SIMD path.
+  const char *delimiters;
+
+  chars_format format;
+
+  // Inputs of at least `min_chunk_size` bytes are split into up to
+  // `num_threads` chunks parsed in parallel.
+  unsigned num_threads;
+  size_t min_chunk_size;
+
+  parse_floats_options()
+      : delimiters(" \t\r\n,"),
+        format(chars_format::general),
+        num_threads(1),
+        min_chunk_size(size_t(1) << 20) {}
+};
+
+struct parse_floats_result {
+  // Number of values stored.
+  size_t count;
+
+  // `last` on success. Otherwise the start of the token that failed to
+  // parse or did not fit.
+  const char *ptr;
+
+  // errc() on success, invalid_argument for a malformed token,
+  // result_out_of_range for a value outside the type's range, and
+  // value_too_large when the output span is full.
+  errc ec;
+};
+
+struct __parse_delimiters {
+  const unsigned char *s;
+  size_t n;
+  __search_byteset set;
+
+  explicit __parse_delimiters(const char *d)
+      : s(reinterpret_cast<const unsigned char *>(d)),
+        n(strlen(d)),
+        set(s, n) {}
+
+  bool has(char c) const { return set.has(static_cast<unsigned char>(c)); }
+
+  const char *skip(const char *p, const char *last) const {
+    // Most runs are a single separator; stay scalar for those and scan
+    // long runs(indentation, blank lines) block-wise.
+    for (int i = 0; i < 4; i++, p++) {
+      if ((p == last) || !has(*p)) {
+        return p;
+      }
+    }
+    const size_t k =
+        __search_find_of(reinterpret_cast<const unsigned char *>(p),
+                         size_t(last - p), s, n, /* in */ false);
+    return (k == __search_npos) ? last : p + k;
+  }
+};
+
+template <class T>
+struct __parse_span_sink {
+  T *out;
+  size_t capacity;
+  size_t count;
+
+  bool push(T v) {
+    if (count == capacity) {
+      return false;
+    }
+    out[count++] = v;
+    return true;
+  }
+};
+
+template <class T>
+struct __parse_vector_sink {
+  vector<T> *out;
+  size_t count;
+
+  bool push(T v) {
+    out->push_back(v);
+    count++;
+    return true;
+  }
+};
+
+template <class T, class Sink>
+inline parse_floats_result __parse_floats(const char *first, const char *last,
+                                          Sink &sink,
+                                          const __parse_delimiters &delims,
+                                          chars_format fmt) {
+  parse_floats_result r = {0, last, errc()};
+  const char *p = delims.skip(first, last);
+  while (p != last) {
+    T v = T();
+    from_chars_result fr = from_chars(p, last, v, fmt);
+    if ((fr.ec == errc()) && (fr.ptr != last) && !delims.has(*fr.ptr)) {
+      fr.ec = errc::invalid_argument;  // e.g. "1.5x"
+    }
+    if (fr.ec != errc()) {
+      r.ptr = p;
+      r.ec = fr.ec;
+      break;
+    }
+    if (!sink.push(v)) {
+      r.ptr = p;
+      r.ec = errc::value_too_large;
+      break;
+    }
+    p = delims.skip(fr.ptr, last);
+  }
+  r.count = sink.count;
+  return r;
+}
+
+#if defined(NANOSTL_PARSE_THREADED)
+
+template <class T>
+struct __parse_chunk {
+  const char *first;
+  const char *last;
+  const __parse_delimiters *delims;
+  chars_format fmt;
+  vector<T> values;
+  parse_floats_result result;
+
+  void run() {
+    __parse_vector_sink<T> sink = {&values, 0};
+    result = __parse_floats<T>(first, last, sink, *delims, fmt);
+  }
+
+  static void __run(__parse_chunk *c) { c->run(); }
+};
+
+// Splits [first, last) at separators into up to `n` chunks and parses them
+// in parallel. Chunk 0 runs on the calling thread.
+template <class T>
+inline void __parse_chunks(const char *first, const char *last,
+                           const __parse_delimiters &delims, chars_format fmt,
+                           vector<__parse_chunk<T> > &chunks, unsigned n) {
+  chunks.resize(n);
+  const size_t size = size_t(last - first);
+  const char *begin = first;
+  for (unsigned i = 0; i < n; i++) {
+    const char *end = last;
+    if (i + 1 < n) {
+      end = first + size / n * (i + 1);
+      if (end < begin) {
+        end = begin;
+      }
+      while ((end != last) && !delims.has(*end)) {
+        end++;
+      }
+    }
+    chunks[i].first = begin;
+    chunks[i].last = end;
+    chunks[i].delims = &delims;
+    chunks[i].fmt = fmt;
+    begin = end;
+  }
+
+  vector<thread> threads;
+  threads.reserve(n - 1);
+  for (unsigned i = 1; i < n; i++) {
+    threads.emplace_back(&__parse_chunk<T>::__run, &chunks[i]);
+  }
+  chunks[0].run();
+  for (unsigned i = 1; i < n; i++) {
+    if (threads[i - 1].joinable()) {
+      threads[i - 1].join();
+    } else {
+      chunks[i].run();  // could not start a thread
+    }
+  }
+}
+
+#endif  // NANOSTL_PARSE_THREADED
+
+inline unsigned __parse_num_chunks(const char *first, const char *last,
+                                   const parse_floats_options &options) {
+#if defined(NANOSTL_PARSE_THREADED)
+  if ((options.num_threads > 1) &&
+      (size_t(last - first) >= options.min_chunk_size)) {
+    return options.num_threads;
+  }
+#else
+  (void)first;
+  (void)last;
+  (void)options;
+#endif
+  return 1;
+}
+
+template <class T>
+inline parse_floats_result __parse_floats_span(
+    const char *first, const char *last, T *out, size_t capacity,
+    const parse_floats_options &options) {
+  const __parse_delimiters delims(options.delimiters);
+  const unsigned n = __parse_num_chunks(first, last, options);
+  if (n <= 1) {
+    __parse_span_sink<T> sink = {out, capacity, 0};
+    return __parse_floats<T>(first, last, sink, delims, options.format);
+  }
+
+#if defined(NANOSTL_PARSE_THREADED)
+  vector<__parse_chunk<T> > chunks;
+  __parse_chunks<T>(first, last, delims, options.format, chunks, n);
+
+  parse_floats_result r = {0, last, errc()};
+  for (unsigned i = 0; i < n; i++) {
+    const __parse_chunk<T> &c = chunks[i];
+    const size_t k = c.values.size();
+    if (k > capacity - r.count) {
+      // Does not fit: re-parse this chunk into the remaining space to find
+      // the token where the output runs full.
+      __parse_span_sink<T> sink = {out + r.count, capacity - r.count, 0};
+      parse_floats_result t =
+          __parse_floats<T>(c.first, c.last, sink, delims, options.format);
+      r.count += t.count;
+      r.ptr = t.ptr;
+      r.ec = t.ec;
+      return r;
+    }
+    if (k) {
+      nanostl::memcpy(out + r.count, &chunks[i].values[0], k * sizeof(T));
+    }
+    r.count += k;
+    if (c.result.ec != errc()) {
+      r.ptr = c.result.ptr;
+      r.ec = c.result.ec;
+      return r;
+    }
+  }
+  return r;
+#else
+  return parse_floats_result();
+#endif
+}
+
+template <class T>
+inline parse_floats_result __parse_floats_vector(
+    const char *first, const char *last, vector<T> &out,
+    const parse_floats_options &options) {
+  const __parse_delimiters delims(options.delimiters);
+  const unsigned n = __parse_num_chunks(first, last, options);
+  if (n <= 1) {
+    __parse_vector_sink<T> sink = {&out, 0};
+    return __parse_floats<T>(first, last, sink, delims, options.format);
+  }
+
+#if defined(NANOSTL_PARSE_THREADED)
+  vector<__parse_chunk<T> > chunks;
+  __parse_chunks<T>(first, last, delims, options.format, chunks, n);
+
+  size_t total = 0;
+  unsigned used = 0;
+  while (used < n) {
+    total += chunks[used].values.size();
+    if (chunks[used++].result.ec != errc()) {
+      break;
+    }
+  }
+
+  const size_t base = out.size();
+  out.resize(base + total);
+  parse_floats_result r = {total, last, errc()};
+  size_t pos = base;
+  for (unsigned i = 0; i < used; i++) {
+    const size_t k = chunks[i].values.size();
+    if (k) {
+      nanostl::memcpy(&out[pos], &chunks[i].values[0], k * sizeof(T));
+    }
+    pos += k;
+    if (chunks[i].result.ec != errc()) {
+      r.ptr = chunks[i].result.ptr;
+      r.ec = chunks[i].result.ec;
+    }
+  }
+  return r;
+#else
+  return parse_floats_result();
+#endif
+}
+
+// Parses [first, last) into out[0, capacity).
+inline parse_floats_result parse_floats(
+    const char *first, const char *last, float *out, size_t capacity,
+    const parse_floats_options &options = parse_floats_options()) {
+  return __parse_floats_span(first, last, out, capacity, options);
+}
+
+inline parse_floats_result parse_floats(
+    const char *first, const char *last, double *out, size_t capacity,
+    const parse_floats_options &options = parse_floats_options()) {
+  return __parse_floats_span(first, last, out, capacity, options);
+}
+
+// Parses [first, last), appending to `out`.
+inline parse_floats_result parse_floats(
+    const char *first, const char *last, vector<float> &out,
+    const parse_floats_options &options = parse_floats_options()) {
+  return __parse_floats_vector(first, last, out, options);
+}
+
+inline parse_floats_result parse_floats(
+    const char *first, const char *last, vector<double> &out,
+    const parse_floats_options &options = parse_floats_options()) {
+  return __parse_floats_vector(first, last, out, options);
+}
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_PARSE_H_
@@ -26,66 +26,534 @@
 #define NANOSTL_SSTREAM_H_
 
 #include "nanoios.h"
+#include "nanoiosfwd.h"
+#include "nanoistream.h"
+#include "nanoostream.h"
 #include "nanostreambuf.h"
 #include "nanostring.h"
-#include "nanocstdint.h"
+#include "nanostring_view.h"
+#include "nanoutility.h"
+#include "__nullptr"
 
 namespace nanostl {
 
-// Work in progress.
-// TODO(LTE): Implement
-// TODO(LTE): Inherit ostream
-#if 1
-class stringstream
+// Based on libcxx ----------------------
+//
+// The characters live in a basic_string whose whole capacity is exposed as
+// the put area, so sputc()/sputn() and in place number formatting write
+// straight into it. A full area grows geometrically(at least doubling).
+// The end of the written data is tracked separately(__hm_), so the
+// string's own size is only meaningful for str(), which copies, or
+// `nanostl::move(buf).str()`, which hands the buffer over without a copy.
+// reserve() is an extension that preallocates the put area.
+//
+template <class _CharT, class _Traits, class _Allocator>
+class basic_stringbuf
+    : public basic_streambuf<_CharT, _Traits>
 {
-  typedef unsigned long long size_type;
+public:
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+    typedef _Allocator                     allocator_type;
 
-  public:
-    NANOSTL_HOST_AND_DEVICE_QUAL
-    stringstream& operator=(const stringstream&) = delete; // disable copy
+    typedef basic_string<char_type, allocator_type> string_type;
+    typedef typename string_type::size_type size_type;
 
-    NANOSTL_HOST_AND_DEVICE_QUAL
-    stringstream& operator=(stringstream&& other) {
-      str_ = other.str_;
-      other.str_ = string();
+    // 27.8.1.1 Constructors:
+    explicit basic_stringbuf(ios_base::openmode __wch = ios_base::in | ios_base::out)
+        : __hm_(nullptr), __mode_(__wch)
+        { __init_buf_ptrs(); }
 
-      return (*this);
+    explicit basic_stringbuf(const string_type& __s,
+                             ios_base::openmode __wch = ios_base::in | ios_base::out)
+        : __str_(__s), __hm_(nullptr), __mode_(__wch)
+        { __init_buf_ptrs(); }
+
+    explicit basic_stringbuf(string_type&& __s,
+                             ios_base::openmode __wch = ios_base::in | ios_base::out)
+        : __str_(nanostl::move(__s)), __hm_(nullptr), __mode_(__wch)
+        { __init_buf_ptrs(); }
+
+    basic_stringbuf(basic_stringbuf&& __rhs) : __hm_(nullptr), __mode_(__rhs.__mode_)
+        { __move_from(__rhs); }
+
+    // 27.8.1.2 Assign and swap:
+    basic_stringbuf& operator=(basic_stringbuf&& __rhs)
+    {
+        if (this != &__rhs)
+        {
+            __mode_ = __rhs.__mode_;
+            __move_from(__rhs);
+        }
+        return *this;
+    }
+
+    // 27.8.1.3 Get and set:
+    string_type str() const &
+    {
+        const char_type* __p = __str_.data();
+        return string_type(__p, __p + __length());
+    }
+
+    // Hands the buffer over without copying and leaves this buffer empty.
+    string_type str() &&
+    {
+        __str_.__resize_default_init(__length());
+        string_type __r(nanostl::move(__str_));
+        __str_.clear();
+        __init_buf_ptrs();
+        return __r;
+    }
+
+    void str(const string_type& __s)
+    {
+        __str_ = __s;
+        __init_buf_ptrs();
+    }
+
+    void str(string_type&& __s)
+    {
+        __str_ = nanostl::move(__s);
+        __init_buf_ptrs();
+    }
+
+    basic_string_view<char_type> view() const
+        { return basic_string_view<char_type>(__str_.data(), __length()); }
+
+    // Makes room for at least `__n` characters in total without growing.
+    void reserve(size_type __n)
+    {
+        if ((__mode_ & ios_base::out) && (__n > size_type(this->epptr() - this->pbase())))
+            __grow(__n);
+    }
+
+protected:
+    // 27.8.1.4 Overridden virtual functions:
+    virtual int_type underflow();
+    virtual int_type pbackfail(int_type __c = traits_type::eof());
+    virtual int_type overflow(int_type __c = traits_type::eof());
+    virtual streamsize xsputn(const char_type* __s, streamsize __n);
+    virtual pos_type seekoff(off_type __off, ios_base::seekdir __way,
+                             ios_base::openmode __wch = ios_base::in | ios_base::out);
+    virtual pos_type seekpos(pos_type __sp,
+                             ios_base::openmode __wch = ios_base::in | ios_base::out)
+        { return seekoff(__sp, ios_base::beg, __wch); }
+
+private:
+    string_type __str_;
+    mutable char_type* __hm_;  // end of the written characters
+    ios_base::openmode __mode_;
+
+    basic_stringbuf(const basic_stringbuf&) = delete;
+    basic_stringbuf& operator=(const basic_stringbuf&) = delete;
+
+    inline char_type* __base() const { return const_cast<char_type*>(__str_.data()); }
+
+    // Number of characters in the buffer.
+    size_type __length() const
+    {
+        if (__mode_ & ios_base::out)
+        {
+            if (__hm_ < this->pptr())
+                __hm_ = this->pptr();
+            return size_type(__hm_ - __base());
+        }
+        if (__mode_ & ios_base::in)
+            return size_type(this->egptr() - this->eback());
+        return 0;
+    }
+
+    // Sets up the areas over __str_, which holds exactly the characters.
+    void __init_buf_ptrs();
+    // Regrows the put area to at least `__n` characters, keeping positions.
+    void __grow(size_type __n);
+    void __move_from(basic_stringbuf& __rhs);
+};
+
+template <class _CharT, class _Traits, class _Allocator>
+void
+basic_stringbuf<_CharT, _Traits, _Allocator>::__init_buf_ptrs()
+{
+    const size_type __sz = __str_.size();
+    if (__mode_ & ios_base::out)
+        __str_.__resize_default_init(__str_.capacity());
+    char_type* __p = __base();
+    __hm_ = __p + __sz;
+    if (__mode_ & ios_base::in)
+        this->setg(__p, __p, __hm_);
+    else
+        this->setg(nullptr, nullptr, nullptr);
+    if (__mode_ & ios_base::out)
+    {
+        this->setp(__p, __p + __str_.size());
+        if (__mode_ & (ios_base::app | ios_base::ate))
+            this->__pbump(static_cast<streamsize>(__sz));
+    }
+    else
+        this->setp(nullptr, nullptr);
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+void
+basic_stringbuf<_CharT, _Traits, _Allocator>::__grow(size_type __n)
+{
+    char_type* __old = __base();
+    const off_type __nout = this->pptr() - __old;
+    const off_type __ninp = (__mode_ & ios_base::in) ? (this->gptr() - __old) : 0;
+    if (__hm_ < this->pptr())
+        __hm_ = this->pptr();
+    const off_type __hm = __hm_ - __old;
+
+    const size_type __cap = 2 * __str_.capacity();
+    __str_.reserve((__n < __cap) ? __cap : __n);
+    __str_.__resize_default_init(__str_.capacity());
+
+    char_type* __p = __base();
+    this->setp(__p, __p + __str_.size());
+    this->__pbump(__nout);
+    __hm_ = __p + __hm;
+    if (__mode_ & ios_base::in)
+        this->setg(__p, __p + __ninp, __hm_);
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+void
+basic_stringbuf<_CharT, _Traits, _Allocator>::__move_from(basic_stringbuf& __rhs)
+{
+    // The characters may move(short strings are stored inline), so
+    // positions are carried over as offsets.
+    char_type* __q = __rhs.__base();
+    const bool __in = __rhs.eback() != nullptr;
+    const bool __out = __rhs.pbase() != nullptr;
+    const off_type __ninp = __in ? (__rhs.gptr() - __q) : 0;
+    const off_type __einp = __in ? (__rhs.egptr() - __q) : 0;
+    const off_type __nout = __out ? (__rhs.pptr() - __q) : 0;
+    const off_type __eout = __out ? (__rhs.epptr() - __q) : 0;
+    const off_type __hm = __rhs.__hm_ - __q;
+
+    __str_ = nanostl::move(__rhs.__str_);
+    char_type* __p = __base();
+    if (__in)
+        this->setg(__p, __p + __ninp, __p + __einp);
+    else
+        this->setg(nullptr, nullptr, nullptr);
+    if (__out)
+    {
+        this->setp(__p, __p + __eout);
+        this->__pbump(__nout);
+    }
+    else
+        this->setp(nullptr, nullptr);
+    __hm_ = __p + __hm;
+
+    __rhs.__str_.clear();
+    __rhs.__init_buf_ptrs();
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+typename basic_stringbuf<_CharT, _Traits, _Allocator>::int_type
+basic_stringbuf<_CharT, _Traits, _Allocator>::underflow()
+{
+    if (__hm_ < this->pptr())
+        __hm_ = this->pptr();
+    if (__mode_ & ios_base::in)
+    {
+        if (this->egptr() < __hm_)
+            this->setg(this->eback(), this->gptr(), __hm_);
+        if (this->gptr() < this->egptr())
+            return traits_type::to_int_type(*this->gptr());
+    }
+    return traits_type::eof();
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+typename basic_stringbuf<_CharT, _Traits, _Allocator>::int_type
+basic_stringbuf<_CharT, _Traits, _Allocator>::pbackfail(int_type __c)
+{
+    if (__hm_ < this->pptr())
+        __hm_ = this->pptr();
+    if (this->eback() < this->gptr())
+    {
+        if (traits_type::eq_int_type(__c, traits_type::eof()))
+        {
+            this->setg(this->eback(), this->gptr() - 1, __hm_);
+            return traits_type::not_eof(__c);
+        }
+        if ((__mode_ & ios_base::out) ||
+            traits_type::eq(traits_type::to_char_type(__c), this->gptr()[-1]))
+        {
+            this->setg(this->eback(), this->gptr() - 1, __hm_);
+            *this->gptr() = traits_type::to_char_type(__c);
+            return __c;
+        }
     }
+    return traits_type::eof();
+}
 
-    NANOSTL_HOST_AND_DEVICE_QUAL
-    stringstream() {}
+template <class _CharT, class _Traits, class _Allocator>
+typename basic_stringbuf<_CharT, _Traits, _Allocator>::int_type
+basic_stringbuf<_CharT, _Traits, _Allocator>::overflow(int_type __c)
+{
+    if (traits_type::eq_int_type(__c, traits_type::eof()))
+        return traits_type::not_eof(__c);
+    if (!(__mode_ & ios_base::out))
+        return traits_type::eof();
+    if (this->pptr() == this->epptr())
+        __grow(size_type(this->epptr() - this->pbase()) + 1);
+    *this->pptr() = traits_type::to_char_type(__c);
+    this->pbump(1);
+    return __c;
+}
 
-    NANOSTL_HOST_AND_DEVICE_QUAL
-    ~stringstream() {}
+template <class _CharT, class _Traits, class _Allocator>
+streamsize
+basic_stringbuf<_CharT, _Traits, _Allocator>::xsputn(const char_type* __s, streamsize __n)
+{
+    if (!(__mode_ & ios_base::out) || (__n <= 0))
+        return 0;
+    // One regrow for the whole write instead of one overflow() per char.
+    const size_type __used = size_type(this->pptr() - this->pbase());
+    if (size_type(__n) > size_type(this->epptr() - this->pptr()))
+        __grow(__used + size_type(__n));
+    traits_type::copy(this->pptr(), __s, static_cast<size_t>(__n));
+    this->__pbump(__n);
+    return __n;
+}
+
+template <class _CharT, class _Traits, class _Allocator>
+typename basic_stringbuf<_CharT, _Traits, _Allocator>::pos_type
+basic_stringbuf<_CharT, _Traits, _Allocator>::seekoff(off_type __off,
+                                                      ios_base::seekdir __way,
+                                                      ios_base::openmode __wch)
+{
+    if (__hm_ < this->pptr())
+        __hm_ = this->pptr();
+    if ((__wch & (ios_base::in | ios_base::out)) == 0)
+        return pos_type(-1);
+    if (((__wch & (ios_base::in | ios_base::out)) == (ios_base::in | ios_base::out)) &&
+        (__way == ios_base::cur))
+        return pos_type(-1);
+    if (((__wch & ios_base::in) && !(__mode_ & ios_base::in)) ||
+        ((__wch & ios_base::out) && !(__mode_ & ios_base::out)))
+        return pos_type(-1);
 
-    // FIXME(LTE): Signature is different from STL spec. take the reference. drop const
-    NANOSTL_HOST_AND_DEVICE_QUAL
-    string &str() {
-      return str_;
+    char_type* __p = __base();
+    const off_type __hm = __hm_ - __p;
+    off_type __noff;
+    switch (__way)
+    {
+    case ios_base::beg:
+        __noff = 0;
+        break;
+    case ios_base::cur:
+        if (__wch & ios_base::in)
+            __noff = this->gptr() - this->eback();
+        else
+            __noff = this->pptr() - this->pbase();
+        break;
+    case ios_base::end:
+        __noff = __hm;
+        break;
+    default:
+        return pos_type(-1);
     }
+    __noff += __off;
+    if ((__noff < 0) || (__hm < __noff))
+        return pos_type(-1);
+    if (__wch & ios_base::in)
+        this->setg(__p, __p + __noff, __hm_);
+    if (__wch & ios_base::out)
+    {
+        this->setp(__p, this->epptr());
+        this->__pbump(__noff);
+    }
+    return pos_type(__noff);
+}
+
+// 27.8.2 Class template basic_istringstream:
+
+template <class _CharT, class _Traits, class _Allocator>
+class basic_istringstream
+    : public basic_istream<_CharT, _Traits>
+{
+public:
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+    typedef _Allocator                     allocator_type;
+
+    typedef basic_string<char_type, allocator_type> string_type;
 
-    // TODO(LTE): Use stringbuf or streambuf
-    NANOSTL_HOST_AND_DEVICE_QUAL
-    stringstream& operator<<(const nanostl::string &s) {
+private:
+    basic_stringbuf<char_type, traits_type, allocator_type> __sb_;
 
-      str_ += s;
-      return (*this);
+public:
+    // 27.8.2.1 Constructors:
+    explicit basic_istringstream(ios_base::openmode __wch = ios_base::in)
+        : basic_istream<_CharT, _Traits>(&__sb_), __sb_(__wch | ios_base::in) {}
+
+    explicit basic_istringstream(const string_type& __s,
+                                 ios_base::openmode __wch = ios_base::in)
+        : basic_istream<_CharT, _Traits>(&__sb_), __sb_(__s, __wch | ios_base::in) {}
+
+    explicit basic_istringstream(string_type&& __s,
+                                 ios_base::openmode __wch = ios_base::in)
+        : basic_istream<_CharT, _Traits>(&__sb_),
+          __sb_(nanostl::move(__s), __wch | ios_base::in) {}
+
+    basic_istringstream(basic_istringstream&& __rhs)
+        : basic_istream<_CharT, _Traits>(static_cast<basic_istream<_CharT, _Traits>&&>(__rhs)),
+          __sb_(nanostl::move(__rhs.__sb_))
+        { this->set_rdbuf(&__sb_); }
+
+    // 27.8.2.2 Assign and swap:
+    basic_istringstream& operator=(basic_istringstream&& __rhs)
+    {
+        __sb_ = nanostl::move(__rhs.__sb_);
+        this->move(__rhs);
+        this->set_rdbuf(&__sb_);
+        return *this;
     }
 
-    // TODO(LTE): Inherit ios
-    void clear() {
-      str_ = string();
+    // 27.8.2.3 Members:
+    basic_stringbuf<char_type, traits_type, allocator_type>* rdbuf() const
+    {
+        return const_cast<basic_stringbuf<char_type, traits_type, allocator_type>*>(&__sb_);
     }
+    string_type str() const & { return __sb_.str(); }
+    string_type str() && { return nanostl::move(__sb_).str(); }
+    void str(const string_type& __s) { __sb_.str(__s); }
+    void str(string_type&& __s) { __sb_.str(nanostl::move(__s)); }
+    basic_string_view<char_type> view() const { return __sb_.view(); }
+};
+
+// 27.8.3 Class template basic_ostringstream:
+
+template <class _CharT, class _Traits, class _Allocator>
+class basic_ostringstream
+    : public basic_ostream<_CharT, _Traits>
+{
+public:
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+    typedef _Allocator                     allocator_type;
+
+    typedef basic_string<char_type, allocator_type> string_type;
+    typedef typename string_type::size_type size_type;
+
+private:
+    basic_stringbuf<char_type, traits_type, allocator_type> __sb_;
 
- private:
+public:
+    // 27.8.3.1 Constructors:
+    explicit basic_ostringstream(ios_base::openmode __wch = ios_base::out)
+        : basic_ostream<_CharT, _Traits>(&__sb_), __sb_(__wch | ios_base::out) {}
 
-  NANOSTL_HOST_AND_DEVICE_QUAL
-  size_type size() const { return str_.size(); }
+    explicit basic_ostringstream(const string_type& __s,
+                                 ios_base::openmode __wch = ios_base::out)
+        : basic_ostream<_CharT, _Traits>(&__sb_), __sb_(__s, __wch | ios_base::out) {}
 
- private:
-  nanostl::string str_;
+    explicit basic_ostringstream(string_type&& __s,
+                                 ios_base::openmode __wch = ios_base::out)
+        : basic_ostream<_CharT, _Traits>(&__sb_),
+          __sb_(nanostl::move(__s), __wch | ios_base::out) {}
+
+    basic_ostringstream(basic_ostringstream&& __rhs)
+        : basic_ostream<_CharT, _Traits>(static_cast<basic_ostream<_CharT, _Traits>&&>(__rhs)),
+          __sb_(nanostl::move(__rhs.__sb_))
+        { this->set_rdbuf(&__sb_); }
+
+    // 27.8.3.2 Assign and swap:
+    basic_ostringstream& operator=(basic_ostringstream&& __rhs)
+    {
+        __sb_ = nanostl::move(__rhs.__sb_);
+        this->move(__rhs);
+        this->set_rdbuf(&__sb_);
+        return *this;
+    }
+
+    // 27.8.3.3 Members:
+    basic_stringbuf<char_type, traits_type, allocator_type>* rdbuf() const
+    {
+        return const_cast<basic_stringbuf<char_type, traits_type, allocator_type>*>(&__sb_);
+    }
+    string_type str() const & { return __sb_.str(); }
+    string_type str() && { return nanostl::move(__sb_).str(); }
+    void str(const string_type& __s) { __sb_.str(__s); }
+    void str(string_type&& __s) { __sb_.str(nanostl::move(__s)); }
+    basic_string_view<char_type> view() const { return __sb_.view(); }
+    // Extension: see basic_stringbuf::reserve().
+    void reserve(size_type __n) { __sb_.reserve(__n); }
+};
+
+// 27.8.4 Class template basic_stringstream:
+
+template <class _CharT, class _Traits, class _Allocator>
+class basic_stringstream
+    : public basic_iostream<_CharT, _Traits>
+{
+public:
+    typedef _CharT                         char_type;
+    typedef _Traits                        traits_type;
+    typedef typename traits_type::int_type int_type;
+    typedef typename traits_type::pos_type pos_type;
+    typedef typename traits_type::off_type off_type;
+    typedef _Allocator                     allocator_type;
+
+    typedef basic_string<char_type, allocator_type> string_type;
+    typedef typename string_type::size_type size_type;
+
+private:
+    basic_stringbuf<char_type, traits_type, allocator_type> __sb_;
+
+public:
+    // 27.8.5.1 Constructors:
+    explicit basic_stringstream(ios_base::openmode __wch = ios_base::in | ios_base::out)
+        : basic_iostream<_CharT, _Traits>(&__sb_), __sb_(__wch) {}
+
+    explicit basic_stringstream(const string_type& __s,
+                                ios_base::openmode __wch = ios_base::in | ios_base::out)
+        : basic_iostream<_CharT, _Traits>(&__sb_), __sb_(__s, __wch) {}
+
+    explicit basic_stringstream(string_type&& __s,
+                                ios_base::openmode __wch = ios_base::in | ios_base::out)
+        : basic_iostream<_CharT, _Traits>(&__sb_), __sb_(nanostl::move(__s), __wch) {}
+
+    basic_stringstream(basic_stringstream&& __rhs)
+        : basic_iostream<_CharT, _Traits>(static_cast<basic_iostream<_CharT, _Traits>&&>(__rhs)),
+          __sb_(nanostl::move(__rhs.__sb_))
+        { this->set_rdbuf(&__sb_); }
+
+    // 27.8.5.2 Assign and swap:
+    basic_stringstream& operator=(basic_stringstream&& __rhs)
+    {
+        __sb_ = nanostl::move(__rhs.__sb_);
+        this->move(__rhs);
+        this->set_rdbuf(&__sb_);
+        return *this;
+    }
+
+    // 27.8.5.3 Members:
+    basic_stringbuf<char_type, traits_type, allocator_type>* rdbuf() const
+    {
+        return const_cast<basic_stringbuf<char_type, traits_type, allocator_type>*>(&__sb_);
+    }
+    string_type str() const & { return __sb_.str(); }
+    string_type str() && { return nanostl::move(__sb_).str(); }
+    void str(const string_type& __s) { __sb_.str(__s); }
+    void str(string_type&& __s) { __sb_.str(nanostl::move(__s)); }
+    basic_string_view<char_type> view() const { return __sb_.view(); }
+    // Extension: see basic_stringbuf::reserve().
+    void reserve(size_type __n) { __sb_.reserve(__n); }
 };
-#endif
 
 }  // namespace nanostl
 
@@ -25,12 +25,21 @@
 #ifndef NANOSTL_STREAMBUF_H_
 #define NANOSTL_STREAMBUF_H_
 
-#include "nanostring.h"
-#include "nanotype_traits.h"
+#include "nanoios.h"
 #include "nanoiosfwd.h"
+#include "nanotype_traits.h"
+#include "__nullptr"
 
 namespace nanostl {
 
+// Based on libcxx ----------------------
+//
+// The put area is [pbase(), epptr()) with the next free slot at pptr().
+// sputc() and sputn() store straight into it while there is room and only
+// call the virtual overflow()/xsputn() when it is full, so derived buffers
+// only implement how a full area is drained(and, for input, how the get
+// area [eback(), egptr()) is refilled by underflow()).
+//
 template <class _CharT, class _Traits>
 class basic_streambuf {
  public:
@@ -44,18 +53,236 @@ class basic_streambuf {
   static_assert((is_same<_CharT, typename traits_type::char_type>::value),
                 "traits_type::char_type must be the same type as CharT");
 
-  virtual ~basic_streambuf();
+  virtual ~basic_streambuf() {}
+
+  // 27.6.2.2.2 buffer and positioning:
+  inline basic_streambuf* pubsetbuf(char_type* __s, streamsize __n) {
+    return setbuf(__s, __n);
+  }
+
+  inline pos_type pubseekoff(off_type __off, ios_base::seekdir __way,
+                             ios_base::openmode __which = ios_base::in |
+                                                          ios_base::out) {
+    return seekoff(__off, __way, __which);
+  }
+
+  inline pos_type pubseekpos(pos_type __sp,
+                             ios_base::openmode __which = ios_base::in |
+                                                          ios_base::out) {
+    return seekpos(__sp, __which);
+  }
+
+  inline int pubsync() { return sync(); }
+
+  // Get and put areas:
+  // 27.6.2.2.3 Get area:
+  inline streamsize in_avail() {
+    if (__ninp_ < __einp_) return static_cast<streamsize>(__einp_ - __ninp_);
+    return showmanyc();
+  }
+
+  inline int_type snextc() {
+    if (sbumpc() == traits_type::eof()) return traits_type::eof();
+    return sgetc();
+  }
+
+  inline int_type sbumpc() {
+    if (__ninp_ == __einp_) return uflow();
+    return traits_type::to_int_type(*__ninp_++);
+  }
+
+  inline int_type sgetc() {
+    if (__ninp_ == __einp_) return underflow();
+    return traits_type::to_int_type(*__ninp_);
+  }
+
+  inline streamsize sgetn(char_type* __s, streamsize __n) {
+    return xsgetn(__s, __n);
+  }
+
+  // 27.6.2.2.4 Putback:
+  inline int_type sputbackc(char_type __c) {
+    if (__binp_ == __ninp_ || !traits_type::eq(__c, __ninp_[-1]))
+      return pbackfail(traits_type::to_int_type(__c));
+    return traits_type::to_int_type(*--__ninp_);
+  }
+
+  inline int_type sungetc() {
+    if (__binp_ == __ninp_) return pbackfail();
+    return traits_type::to_int_type(*--__ninp_);
+  }
+
+  // 27.6.2.2.5 Put area:
+  inline int_type sputc(char_type __c) {
+    if (__nout_ == __eout_) return overflow(traits_type::to_int_type(__c));
+    *__nout_++ = __c;
+    return traits_type::to_int_type(__c);
+  }
+
+  // Copies into the put area when `__n` characters fit, otherwise leaves it
+  // to xsputn()(which may bypass the buffer for large writes).
+  inline streamsize sputn(const char_type* __s, streamsize __n) {
+    if (__n <= __eout_ - __nout_) {
+      traits_type::copy(__nout_, __s, static_cast<size_t>(__n));
+      __nout_ += __n;
+      return __n;
+    }
+    return xsputn(__s, __n);
+  }
 
  protected:
-  basic_streambuf();
-  basic_streambuf(const basic_streambuf& __rhs);
-  basic_streambuf& operator=(const basic_streambuf& __rhs);
-  void swap(basic_streambuf& __rhs);
-};
+  basic_streambuf()
+      : __binp_(nullptr),
+        __ninp_(nullptr),
+        __einp_(nullptr),
+        __bout_(nullptr),
+        __nout_(nullptr),
+        __eout_(nullptr) {}
+
+  basic_streambuf(const basic_streambuf& __sb)
+      : __binp_(__sb.__binp_),
+        __ninp_(__sb.__ninp_),
+        __einp_(__sb.__einp_),
+        __bout_(__sb.__bout_),
+        __nout_(__sb.__nout_),
+        __eout_(__sb.__eout_) {}
+
+  basic_streambuf& operator=(const basic_streambuf& __sb) {
+    __binp_ = __sb.__binp_;
+    __ninp_ = __sb.__ninp_;
+    __einp_ = __sb.__einp_;
+    __bout_ = __sb.__bout_;
+    __nout_ = __sb.__nout_;
+    __eout_ = __sb.__eout_;
+    return *this;
+  }
 
-//extern template class basic_streambuf<char>;
+  void swap(basic_streambuf& __sb) {
+    basic_streambuf __t(__sb);
+    __sb = *this;
+    *this = __t;
+  }
 
-//typedef basic_streambuf<char> streambuf;
+  // 27.6.2.3.2 Get area:
+  inline char_type* eback() const { return __binp_; }
+  inline char_type* gptr() const { return __ninp_; }
+  inline char_type* egptr() const { return __einp_; }
+  inline void gbump(int __n) { __ninp_ += __n; }
+
+  inline void setg(char_type* __gbeg, char_type* __gnext, char_type* __gend) {
+    __binp_ = __gbeg;
+    __ninp_ = __gnext;
+    __einp_ = __gend;
+  }
+
+  // 27.6.2.3.3 Put area:
+  inline char_type* pbase() const { return __bout_; }
+  inline char_type* pptr() const { return __nout_; }
+  inline char_type* epptr() const { return __eout_; }
+  inline void pbump(int __n) { __nout_ += __n; }
+  // pbump() for offsets that may not fit in an int.
+  inline void __pbump(streamsize __n) { __nout_ += __n; }
+
+  inline void setp(char_type* __pbeg, char_type* __pend) {
+    __bout_ = __nout_ = __pbeg;
+    __eout_ = __pend;
+  }
+
+  // 27.6.2.4 virtual functions:
+  // 27.6.2.4.2 Buffer management and positioning:
+  virtual basic_streambuf* setbuf(char_type*, streamsize) { return this; }
+
+  virtual pos_type seekoff(off_type, ios_base::seekdir,
+                           ios_base::openmode = ios_base::in | ios_base::out) {
+    return pos_type(off_type(-1));
+  }
+
+  virtual pos_type seekpos(pos_type,
+                           ios_base::openmode = ios_base::in | ios_base::out) {
+    return pos_type(off_type(-1));
+  }
+
+  virtual int sync() { return 0; }
+
+  // 27.6.2.4.3 Get area:
+  virtual streamsize showmanyc() { return 0; }
+
+  virtual streamsize xsgetn(char_type* __s, streamsize __n) {
+    const int_type __eof = traits_type::eof();
+    int_type __c;
+    streamsize __i = 0;
+    while (__i < __n) {
+      if (__ninp_ < __einp_) {
+        const streamsize __len =
+            (__einp_ - __ninp_ < __n - __i) ? __einp_ - __ninp_ : __n - __i;
+        traits_type::copy(__s, __ninp_, static_cast<size_t>(__len));
+        __s += __len;
+        __i += __len;
+        __ninp_ += __len;
+      } else if ((__c = uflow()) != __eof) {
+        *__s = traits_type::to_char_type(__c);
+        ++__s;
+        ++__i;
+      } else {
+        break;
+      }
+    }
+    return __i;
+  }
+
+  virtual int_type underflow() { return traits_type::eof(); }
+
+  virtual int_type uflow() {
+    if (underflow() == traits_type::eof()) return traits_type::eof();
+    return traits_type::to_int_type(*__ninp_++);
+  }
+
+  // 27.6.2.4.4 Putback:
+  virtual int_type pbackfail(int_type = traits_type::eof()) {
+    return traits_type::eof();
+  }
+
+  // 27.6.2.4.5 Put area:
+  virtual streamsize xsputn(const char_type* __s, streamsize __n) {
+    const int_type __eof = traits_type::eof();
+    streamsize __i = 0;
+    while (__i < __n) {
+      if (__nout_ < __eout_) {
+        const streamsize __len =
+            (__eout_ - __nout_ < __n - __i) ? __eout_ - __nout_ : __n - __i;
+        traits_type::copy(__nout_, __s, static_cast<size_t>(__len));
+        __s += __len;
+        __i += __len;
+        __nout_ += __len;
+      } else if (overflow(traits_type::to_int_type(*__s)) != __eof) {
+        ++__s;
+        ++__i;
+      } else {
+        break;
+      }
+    }
+    return __i;
+  }
+
+  virtual int_type overflow(int_type = traits_type::eof()) {
+    return traits_type::eof();
+  }
+
+ private:
+  // basic_ostream formats numbers directly into the put area and
+  // basic_istream parses them straight from the get area.
+  template <class, class>
+  friend class basic_ostream;
+  template <class, class>
+  friend class basic_istream;
+
+  char_type* __binp_;
+  char_type* __ninp_;
+  char_type* __einp_;
+  char_type* __bout_;
+  char_type* __nout_;
+  char_type* __eout_;
+};
 
 }  // namespace nanostl
 
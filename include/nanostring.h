@@ -26,10 +26,16 @@
 #define NANOSTL_STRING_H_
 
 #include "__nanostrutil.h"
+#include "nanoiterator.h"
 #include "nanolimits.h"
 #include "nanovector.h"
 #include "nanoutility.h"
 #include "nanoiosfwd.h"
+#include "nanofunctional.h"
+#include "nanostring_view.h"
+#include "nanocharconv.h"
+#include "nanoexpected.h"
+#include "nanosystem_error.h"
 
 #ifdef NANOSTL_DEBUG
 #if !defined(__CUDACC__)
@@ -38,17 +44,24 @@
 #endif
 
 //
-// Simple alternative implementation of std::string
-// Implement `string' as `vector<char>`
-// TODO(LTE): Support traits and allocator.
+// Alternative implementation of std::string.
+//
+// Short strings are stored inline(small string optimization): up to 22 chars
+// for `char` on 64-bit targets, so `sizeof(string) == 24` and short strings
+// never allocate. Longer strings live in a heap buffer with an explicit
+// capacity. Both layouts keep the size, so size() is O(1), and both keep a
+// terminating null after the last char.
+//
+// TODO(LTE): Support traits.
 //
 
 namespace nanostl {
 
-template <class charT>
+template <class charT, class Allocator = nanostl::allocator<charT> >
 class basic_string {
  public:
   typedef unsigned long long size_type;
+  typedef Allocator allocator_type;
 
   typedef charT value_type;
   typedef charT &reference;
@@ -58,108 +71,453 @@ class basic_string {
   typedef pointer iterator;
   typedef const_pointer const_iterator;
 
+  static const size_type npos = ~size_type(0);
+
+ private:
+  typedef nanostl::allocator_traits<Allocator> alloc_traits;
+
+  // Heap layout. `cap_` holds the capacity together with the long flag.
+  struct __long {
+    size_type cap_;
+    size_type size_;
+    charT *data_;
+  };
+
+  // Inline layout. `size_` overlaps the first byte of __long::cap_, which
+  // is where the long flag lives.
+  enum {
+    __min_cap = (sizeof(__long) - 1) / sizeof(charT) > 2
+                    ? (sizeof(__long) - 1) / sizeof(charT)
+                    : 2
+  };
+
+  struct __short {
+    unsigned char size_;
+    charT data_[__min_cap];
+  };
+
+  // Bit 0 of the first byte on little endian(the low bit of cap_), bit 7 on
+  // big endian(the high bit of cap_).
+#if defined(NANOSTL_BIG_ENDIAN)
+  static const unsigned char __short_flag = 0x80;
+  static const size_type __long_flag = ~(~size_type(0) >> 1);
+#else
+  static const unsigned char __short_flag = 0x01;
+  static const size_type __long_flag = 0x1ull;
+#endif
+
+  // Allocator as an empty base, so the default allocator adds no space.
+  struct __rep : public Allocator {
+    union {
+      __long l;
+      __short s;
+    };
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    __rep() : Allocator() {}
+
+    NANOSTL_HOST_AND_DEVICE_QUAL
+    explicit __rep(const Allocator &a) : Allocator(a) {}
+  };
+
+ public:
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string() { __zero(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit basic_string(const allocator_type &alloc) : r_(alloc) { __zero(); }
+
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string() {
-    data_.resize(1);
-    data_[0] = '\0';
+  basic_string(const basic_string &s) : r_(s.__alloc()) {
+    __init(s.data(), s.size());
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string(const basic_string &s) { data_ = s.data_; }
+  basic_string(basic_string &&s) : r_(nanostl::move(s.__alloc())) {
+    r_.l = s.r_.l;
+    s.__zero();
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string(const charT *s) {
-    data_.clear();
-    while (s && (*s) != '\0') {
-      data_.push_back(*s);
-      s++;
-    }
-    data_.push_back('\0');
+  basic_string(const charT *s) { __init(s, __length(s)); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string(const charT *s, const allocator_type &alloc) : r_(alloc) {
+    __init(s, __length(s));
+  }
+
+  // Templated like std, so string(p, 0) picks the (pointer, count) overload.
+  template <class InputIt, class = typename nanostl::enable_if<
+                               !nanostl::is_integral<InputIt>::value>::type>
+  NANOSTL_HOST_AND_DEVICE_QUAL basic_string(InputIt first, InputIt last) {
+    __init_range(first, last, __is_random_access_iterator<InputIt>());
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string(const charT *first, const charT *last) {
-    const char *s = first;
-    while (s && (s <= last)) {
-      data_.push_back(*s);
-      s++;
-    }
+  basic_string(const charT *s, size_type count) { __init(s, count); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit basic_string(basic_string_view<charT> v) {
+    __init(v.data(), v.size());
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string(const charT *s, size_type count) {
+  basic_string(size_type count, charT c) {
+    charT *p = __init_storage(count);
     for (size_type i = 0; i < count; i++) {
-      data_.push_back(s[i]);
+      p[i] = c;
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  ~basic_string() {
+    if (__is_long()) {
+      alloc_traits::deallocate(__alloc(), r_.l.data_, __long_cap() + 1);
     }
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  bool empty() const { return data_.size() == 0; }
+  allocator_type get_allocator() const { return __alloc(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool empty() const { return size() == 0; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   size_type size() const {
-    // -1 for '\0'
-    return data_.size() - 1;
+    return __is_long() ? r_.l.size_ : __short_size();
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  size_type length() const {
-    // -1 for '\0'
-    return data_.size() - 1;
+  size_type length() const { return size(); }
+
+  // Number of chars that fit without reallocation(excluding the null).
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type capacity() const {
+    return __is_long() ? __long_cap() : size_type(__min_cap - 1);
   }
 
+  // Preallocate storage for at least `n` chars. Never shrinks.
   NANOSTL_HOST_AND_DEVICE_QUAL
-  void clear() { data_.clear();
-    data_.resize(1);
-    data_[0] = '\0';
+  void reserve(size_type n) {
+    if (n > capacity()) {
+      __reallocate(__recommend(n));
+    }
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  const charT *c_str() const { return &data_.at(0); }
+  void shrink_to_fit() {
+    if (!__is_long()) {
+      return;
+    }
+    size_type sz = size();
+    if (sz < size_type(__min_cap)) {
+      // Back to the inline layout.
+      charT *p = r_.l.data_;
+      size_type cap = __long_cap();
+      __set_short_size(sz);
+      __copy(r_.s.data_, p, sz + 1);
+      alloc_traits::deallocate(__alloc(), p, cap + 1);
+    } else if (__recommend(sz) < __long_cap()) {
+      __reallocate(__recommend(sz));
+    }
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  char &at(size_type pos) { return data_[pos]; }
+  void clear() { __set_size(0); }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  const charT &at(size_type pos) const { return data_[pos]; }
+  void push_back(charT c) {
+    size_type sz = size();
+    if (sz == capacity()) {
+      __grow(sz + 1);
+    }
+    data()[sz] = c;
+    __set_size(sz + 1);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void pop_back() { __set_size(size() - 1); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void resize(size_type n, charT c = charT()) {
+    size_type sz = size();
+    if (n > sz) {
+      append(n - sz, c);
+    } else {
+      __set_size(n);
+    }
+  }
+
+  // resize() without filling: chars past the old size are left
+  // uninitialized for the caller to write(stringbuf uses the whole
+  // capacity as its put area).
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __resize_default_init(size_type n) {
+    if (n > capacity()) {
+      __reallocate(__recommend(n));
+    }
+    __set_size(n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &append(const basic_string &s) {
+    __append(s.data(), s.size());
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &append(const charT *s, size_type n) {
+    __append(s, n);
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &append(const charT *s) {
+    __append(s, __length(s));
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &append(size_type n, charT c) {
+    charT *p = __open_gap(size(), 0, n);
+    for (size_type i = 0; i < n; i++) {
+      p[i] = c;
+    }
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &append(basic_string_view<charT> v) {
+    __append(v.data(), v.size());
+    return (*this);
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  char &operator[](size_type pos) { return data_[pos]; }
+  basic_string &append(const charT *first, const charT *last) {
+    __append(first, size_type(last - first));
+    return (*this);
+  }
 
+  //
+  // insert() and replace() take char positions; a `pos` past the end is
+  // clamped to size()(nanostl does not throw out_of_range).
+  //
   NANOSTL_HOST_AND_DEVICE_QUAL
-  const charT &operator[](size_type pos) const { return data_[pos]; }
+  basic_string &insert(size_type pos, const basic_string &s) {
+    __replace(pos, 0, s.data(), s.size());
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &insert(size_type pos, const charT *s, size_type n) {
+    __replace(pos, 0, s, n);
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &insert(size_type pos, const charT *s) {
+    __replace(pos, 0, s, __length(s));
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &insert(size_type pos, size_type n, charT c) {
+    size_type sz = size();
+    charT *p = __open_gap(pos < sz ? pos : sz, 0, n);
+    for (size_type i = 0; i < n; i++) {
+      p[i] = c;
+    }
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator insert(const_iterator it, charT c) {
+    size_type pos = size_type(it - begin());
+    charT *p = __open_gap(pos, 0, 1);
+    *p = c;
+    return p;
+  }
+
+  // Replaces [pos, pos + count) with `s`. `count` may run past the end.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &replace(size_type pos, size_type count, const basic_string &s) {
+    __replace(pos, count, s.data(), s.size());
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &replace(size_type pos, size_type count, const charT *s,
+                        size_type n) {
+    __replace(pos, count, s, n);
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &replace(size_type pos, size_type count, const charT *s) {
+    __replace(pos, count, s, __length(s));
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT *c_str() const { return data(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT *data() const { return __is_long() ? r_.l.data_ : r_.s.data_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  charT *data() { return __is_long() ? r_.l.data_ : r_.s.data_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  operator basic_string_view<charT>() const {
+    return basic_string_view<charT>(data(), size());
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator begin() { return data(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator begin() const { return data(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator end() { return data() + size(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator end() const { return data() + size(); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  charT &at(size_type pos) { return data()[pos]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT &at(size_type pos) const { return data()[pos]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  charT &operator[](size_type pos) { return data()[pos]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT &operator[](size_type pos) const { return data()[pos]; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   int compare(const basic_string &str) const {
-    return compare_(&data_[0], &str[0]);
+    return __compare(data(), size(), str.data(), str.size());
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int compare(const charT *s) const {
+    return __compare(data(), size(), s, __length(s));
+  }
+
+  //
+  // Searches, shared with basic_string_view. String and C string arguments
+  // convert to a view.
+  //
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find(basic_string_view<charT> v, size_type pos = 0) const {
+    return __view().find(v, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find(charT c, size_type pos = 0) const {
+    return __view().find(c, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type rfind(basic_string_view<charT> v, size_type pos = npos) const {
+    return __view().rfind(v, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type rfind(charT c, size_type pos = npos) const {
+    return __view().rfind(c, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_first_of(basic_string_view<charT> v,
+                          size_type pos = 0) const {
+    return __view().find_first_of(v, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_first_not_of(basic_string_view<charT> v,
+                              size_type pos = 0) const {
+    return __view().find_first_not_of(v, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_last_of(basic_string_view<charT> v,
+                         size_type pos = npos) const {
+    return __view().find_last_of(v, pos);
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  int compare(const charT *s) const { return compare_(&data_[0], s); }
+  bool starts_with(basic_string_view<charT> v) const {
+    return __view().starts_with(v);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool ends_with(basic_string_view<charT> v) const {
+    return __view().ends_with(v);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  iterator erase(iterator pos) {
+    size_type n = size();
+    size_type i = size_type(pos - begin());
+    charT *p = data();
+    // Shift the tail, null included.
+    __move(p + i, p + i + 1, n - i);
+    __set_size_only(n - 1);
+    return p + i;
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  iterator erase(iterator pos) { return data_.erase(pos); }
+  basic_string &operator+=(const basic_string &s) { return append(s); }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string operator+(const basic_string &s) const;
+  basic_string &operator+=(const charT *s) { return append(s); }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  basic_string &operator+=(const basic_string &s);
+  basic_string &operator+=(charT c) {
+    push_back(c);
+    return (*this);
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   basic_string &operator=(const basic_string &s) {
-    this->data_ = s.data_;
+    if (this != &s) {
+      __assign(s.data(), s.size());
+    }
     return (*this);
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  bool operator==(const basic_string &str) const { return compare(str) == 0; }
+  basic_string &operator=(basic_string &&s) {
+    if (this != &s) {
+      if (__is_long()) {
+        alloc_traits::deallocate(__alloc(), r_.l.data_, __long_cap() + 1);
+      }
+      __alloc() = nanostl::move(s.__alloc());
+      r_.l = s.r_.l;
+      s.__zero();
+    }
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string &operator=(const charT *s) {
+    __assign(s, __length(s));
+    return (*this);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool operator==(const basic_string &str) const {
+    return (size() == str.size()) && (compare(str) == 0);
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   bool operator==(const charT *s) const { return compare(s) == 0; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  bool operator!=(const basic_string &str) const { return compare(str) != 0; }
+  bool operator!=(const basic_string &str) const { return !(*this == str); }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   bool operator!=(const charT *s) const { return compare(s) != 0; }
@@ -177,196 +535,478 @@ class basic_string {
   bool operator>(const charT *s) const { return compare(s) > 0; }
 
  private:
-  nanostl::vector<charT> data_;
-
-  inline int compare_(const charT *p, const charT *q) const {
-    while (*p && (*p == *q)) {
-      p++;
-      q++;
-    }
+  __rep r_;
 
-    return *reinterpret_cast<const unsigned char *>(p) -
-           *reinterpret_cast<const unsigned char *>(q);
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string_view<charT> __view() const {
+    return basic_string_view<charT>(data(), size());
   }
-};
 
-template <class charT>
-basic_string<charT> basic_string<charT>::operator+(
-    const basic_string<charT> &s) const {
-  basic_string<charT> result(*this);
-  result += s;
-  return result;
-}
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  Allocator &__alloc() { return r_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const Allocator &__alloc() const { return r_; }
 
-template <class charT>
-basic_string<charT> &basic_string<charT>::operator+=(
-    const basic_string<charT> &s) {
-  // remove '\0'
-  if (data_.size() < 1) {
-    // this should not be happen
-  } else {
-    data_.pop_back();
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool __is_long() const {
+    // Read the flag byte through unsigned char, which may alias either
+    // layout.
+    return (*reinterpret_cast<const unsigned char *>(&r_.s) & __short_flag) !=
+           0;
   }
 
-  const_iterator first = s.data_.begin();
-  const_iterator last = s.data_.end(); // this contains `\0`
+#if defined(NANOSTL_BIG_ENDIAN)
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __short_size() const { return r_.s.size_; }
 
-  for (; first != last; ++first) {
-#ifdef NANOSTL_DEBUG
-    printf("first = %c\n", *first);
-#endif
-    data_.push_back(*first);
-  }
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_short_size(size_type n) { r_.s.size_ = (unsigned char)(n); }
 
-#ifdef NANOSTL_DEBUG
-  printf("data_ = %s\n", &data_.at(0));
-#endif
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __long_cap() const { return r_.l.cap_ & ~__long_flag; }
 
-  return (*this);
-}
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_long_cap(size_type cap) { r_.l.cap_ = cap | __long_flag; }
+#else
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __short_size() const { return r_.s.size_ >> 1; }
 
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_short_size(size_type n) { r_.s.size_ = (unsigned char)(n << 1); }
 
-typedef basic_string<char> string;
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type __long_cap() const { return r_.l.cap_ >> 1; }
 
-// stream
-ostream &operator<<(ostream &os, const string &s)
-{
-  os << s;
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_long_cap(size_type cap) { r_.l.cap_ = (cap << 1) | __long_flag; }
+#endif
 
-  return os;
-}
+  // Empty inline string.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __zero() {
+    __set_short_size(0);
+    r_.s.data_[0] = charT(0);
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(int value);
+  // Updates the size only; the caller writes the null.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_size_only(size_type n) {
+    if (__is_long()) {
+      r_.l.size_ = n;
+    } else {
+      __set_short_size(n);
+    }
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(unsigned int value);
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __set_size(size_type n) {
+    __set_size_only(n);
+    data()[n] = charT(0);
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(int64_t value);
+  // Capacity to allocate for `n` chars: heap blocks are rounded to 16 bytes.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type __recommend(size_type n) {
+    const size_type g = (sizeof(charT) < 16) ? 16 / sizeof(charT) : 1;
+    return ((n + 1 + g - 1) & ~(g - 1)) - 1;
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(uint64_t value);
+  // Sets up storage for `n` chars on a freshly constructed object, writes
+  // the null and returns the buffer for the caller to fill.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  charT *__init_storage(size_type n) {
+    charT *p;
+    if (n < size_type(__min_cap)) {
+      __set_short_size(n);
+      p = r_.s.data_;
+    } else {
+      size_type cap = __recommend(n);
+      p = alloc_traits::allocate(__alloc(), cap + 1);
+      r_.l.data_ = p;
+      r_.l.size_ = n;
+      __set_long_cap(cap);
+    }
+    p[n] = charT(0);
+    return p;
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(float value);
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __init(const charT *s, size_type n) {
+    __copy(__init_storage(n), s, n);
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(double value);
+  template <class It>
+  NANOSTL_HOST_AND_DEVICE_QUAL void __init_range(It first, It last,
+                                                 true_type) {
+    charT *p = __init_storage(size_type(last - first));
+    for (; first != last; ++first, ++p) {
+      *p = *first;
+    }
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-float stof(const nanostl::string &str, nanostl::size_t *idx = nullptr);
+  template <class It>
+  NANOSTL_HOST_AND_DEVICE_QUAL void __init_range(It first, It last,
+                                                 false_type) {
+    __zero();
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-float stod(const nanostl::string &str, nanostl::size_t *idx = nullptr);
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __assign(const charT *s, size_type n) {
+    if (n > capacity()) {
+      __grow_discard(n);
+    }
+    charT *p = data();
+    __move(p, s, n);
+    __set_size(n);
+  }
 
-#if defined(NANOSTL_IMPLEMENTATION)
-#ifndef NANOSTL_STRING_IMPLEMENTATION
-#define NANOSTL_STRING_IMPLEMENTATION
-#endif
-#endif
+  // Moves the contents to a heap buffer of capacity `cap`(>= size()).
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __reallocate(size_type cap) {
+    size_type sz = size();
+    charT *p = alloc_traits::allocate(__alloc(), cap + 1);
+    __copy(p, data(), sz + 1);
+    if (__is_long()) {
+      alloc_traits::deallocate(__alloc(), r_.l.data_, __long_cap() + 1);
+    }
+    r_.l.data_ = p;
+    r_.l.size_ = sz;
+    __set_long_cap(cap);
+  }
 
-#if defined(NANOSTL_STRING_IMPLEMENTATION)
+  // Geometric growth, so a sequence of appends is amortized O(n).
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type __next_cap(size_type old_cap, size_type n) {
+    return __recommend((n < 2 * old_cap) ? 2 * old_cap : n);
+  }
 
-#include "fast_float/fast_float.h"
+  // Reallocates to hold at least `n` chars, keeping the contents.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __grow(size_type n) { __reallocate(__next_cap(capacity(), n)); }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(int value) {
-  // naiive implementation of base-10 int to ascii
-  // based on https://www.techiedelight.com/implement-itoa-function-in-c/
-
-  auto myreverse = [](char *buf, int i, int j) {
-    while (i < j) {
-      char tmp = buf[j];
-      buf[j] = buf[i];
-      buf[i] = tmp;
-      i++;
-      j--;
-
-      //swap(buf[i++], buf[j--]);
+  // Replaces the `n1` chars at `pos` with a gap of `n2` uninitialized chars
+  // and returns it. `pos` and `n1` must be within the string. Reallocates at
+  // most once, copying prefix and suffix straight to their final place.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  charT *__open_gap(size_type pos, size_type n1, size_type n2) {
+    size_type sz = size();
+    size_type tail = sz - pos - n1;
+    size_type new_sz = sz - n1 + n2;
+    size_type old_cap = capacity();
+
+    if (new_sz <= old_cap) {
+      charT *p = data();
+      __move(p + pos + n2, p + pos + n1, tail);
+      __set_size(new_sz);
+      return p + pos;
     }
-  };
 
-  char buffer[numeric_limits<int>::digits10 + 2];  // +2 for sign and null
+    size_type cap = __next_cap(old_cap, new_sz);
+    charT *old = data();
+    charT *p = alloc_traits::allocate(__alloc(), cap + 1);
+    __copy(p, old, pos);
+    __copy(p + pos + n2, old + pos + n1, tail);
+    p[new_sz] = charT(0);
+    if (__is_long()) {
+      alloc_traits::deallocate(__alloc(), old, old_cap + 1);
+    }
+    r_.l.data_ = p;
+    r_.l.size_ = new_sz;
+    __set_long_cap(cap);
+    return p + pos;
+  }
 
-  int n = (value < 0) ? -value : value;  // abs
-  int i = 0;
-  int base = 10;
-  while (n) {
-    int r = n % base;
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __replace(size_type pos, size_type n1, const charT *s, size_type n2) {
+    size_type sz = size();
+    if (pos > sz) {
+      pos = sz;
+    }
+    if (n1 > sz - pos) {
+      n1 = sz - pos;
+    }
 
-    if (r >= 10) {
-      buffer[i++] = 'A' + (r - 10);  //
-    } else {
-      buffer[i++] = '0' + r;
+    const charT *p = data();
+    bool alias = (s >= p) && (s <= p + sz);
+    if (alias) {
+      if (n2 > n1) {
+        // Opening the gap would move or free the source.
+        basic_string tmp(__alloc());
+        tmp.__init(s, n2);
+        __replace(pos, n1, tmp.data(), n2);
+        return;
+      }
+      // Shrinking in place: write the replacement first, the tail after
+      // it is untouched until then.
+      charT *q = data();
+      __move(q + pos, s, n2);
+      __move(q + pos + n2, q + pos + n1, sz - pos - n1);
+      __set_size(sz - n1 + n2);
+      return;
+    }
+
+    __copy(__open_gap(pos, n1, n2), s, n2);
+  }
+
+  // Like __grow, but the old contents are not needed.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __grow_discard(size_type n) {
+    size_type cap = __recommend(n);
+    charT *p = alloc_traits::allocate(__alloc(), cap + 1);
+    if (__is_long()) {
+      alloc_traits::deallocate(__alloc(), r_.l.data_, __long_cap() + 1);
     }
+    r_.l.data_ = p;
+    r_.l.size_ = 0;
+    __set_long_cap(cap);
+    p[0] = charT(0);
+  }
 
-    n = n / base;
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __append(const charT *s, size_type n) {
+    size_type sz = size();
+    if (sz + n > capacity()) {
+      // `s` may point into this string; __grow keeps the contents but frees
+      // the old buffer, so remember the offset.
+      const charT *first = data();
+      bool inside = (s >= first) && (s <= first + sz);
+      size_type off = size_type(s - first);
+      __grow(sz + n);
+      if (inside) {
+        s = data() + off;
+      }
+    }
+    charT *p = data();
+    __copy(p + sz, s, n);
+    __set_size(sz + n);
   }
 
-  if (i == 0) {
-    buffer[i++] = '0';
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type __length(const charT *s) { return __cstr_length(s); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __copy(charT *d, const charT *s, size_type n) {
+    nanostl::memcpy(d, s, n * sizeof(charT));
   }
 
-  if ((value < 0) && (base == 10)) {
-    buffer[i++] = '-';
+  // Overlap-safe copy.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static void __move(charT *d, const charT *s, size_type n) {
+    nanostl::memmove(d, s, n * sizeof(charT));
+  }
+
+  // Lexicographic, 1-byte chars compared as unsigned.
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static int __compare(const charT *p, size_type pn, const charT *q,
+                       size_type qn) {
+    return basic_string_view<charT>(p, pn).compare(
+        basic_string_view<charT>(q, qn));
   }
+};
 
-  buffer[i] = '\0';
+//
+// Concatenation. Lvalue operands build the result with one allocation of
+// the final size; an rvalue operand is appended to(or inserted into) in
+// place, so a chain `a + b + c + d` reuses the first temporary's buffer and
+// grows it geometrically instead of copying at each step.
+//
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    const basic_string<charT, Allocator> &a,
+    const basic_string<charT, Allocator> &b) {
+  basic_string<charT, Allocator> result(a.get_allocator());
+  result.reserve(a.size() + b.size());
+  result.append(a);
+  result.append(b);
+  return result;
+}
 
-  myreverse(buffer, 0, i - 1);
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    const basic_string<charT, Allocator> &a, const charT *b) {
+  basic_string<charT, Allocator> result(a.get_allocator());
+  result.reserve(a.size() + __cstr_length(b));
+  result.append(a);
+  result.append(b);
+  return result;
+}
 
-  return string(buffer);
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    const charT *a, const basic_string<charT, Allocator> &b) {
+  basic_string<charT, Allocator> result(b.get_allocator());
+  result.reserve(__cstr_length(a) + b.size());
+  result.append(a);
+  result.append(b);
+  return result;
 }
 
-NANOSTL_HOST_AND_DEVICE_QUAL
-string to_string(int64_t value) {
-  // naiive implementation of base-10 int to ascii
-  // based on https://www.techiedelight.com/implement-itoa-function-in-c/
-
-  auto myreverse = [](char *buf, int i, int j) {
-    while (i < j) {
-      char tmp = buf[j];
-      buf[j] = buf[i];
-      buf[i] = tmp;
-      i++;
-      j--;
-      //swap(buf[i++], buf[j--]);
-    }
-  };
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    const basic_string<charT, Allocator> &a, charT c) {
+  basic_string<charT, Allocator> result(a.get_allocator());
+  result.reserve(a.size() + 1);
+  result.append(a);
+  result.push_back(c);
+  return result;
+}
 
-  char buffer[numeric_limits<int64_t>::digits10 + 2];  // +2 for sign and null
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    basic_string<charT, Allocator> &&a,
+    const basic_string<charT, Allocator> &b) {
+  return nanostl::move(a.append(b));
+}
 
-  int n = (value < 0) ? -value : value;  // abs
-  int i = 0;
-  int base = 10;
-  while (n) {
-    int r = n % base;
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    const basic_string<charT, Allocator> &a,
+    basic_string<charT, Allocator> &&b) {
+  return nanostl::move(b.insert(0, a));
+}
 
-    if (r >= 10) {
-      buffer[i++] = 'A' + (r - 10);  //
-    } else {
-      buffer[i++] = '0' + r;
-    }
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    basic_string<charT, Allocator> &&a, basic_string<charT, Allocator> &&b) {
+  // Append into whichever buffer already has room.
+  if ((b.size() > a.capacity() - a.size()) &&
+      (b.capacity() >= a.size() + b.size())) {
+    return nanostl::move(b.insert(0, a));
+  }
+  return nanostl::move(a.append(b));
+}
+
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    basic_string<charT, Allocator> &&a, const charT *b) {
+  return nanostl::move(a.append(b));
+}
+
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    const charT *a, basic_string<charT, Allocator> &&b) {
+  return nanostl::move(b.insert(0, a));
+}
+
+template <class charT, class Allocator>
+NANOSTL_HOST_AND_DEVICE_QUAL basic_string<charT, Allocator> operator+(
+    basic_string<charT, Allocator> &&a, charT c) {
+  a.push_back(c);
+  return nanostl::move(a);
+}
+
+
+typedef basic_string<char> string;
+
+// Hashes the character bytes(without the terminating null), so a string and
+// its c_str() hash equal; hash is transparent for lookup by `const charT *`.
+template <class charT, class Allocator>
+struct hash<basic_string<charT, Allocator> > {
+  typedef void is_transparent;
+  typedef void __is_avalanching;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_t operator()(const basic_string<charT, Allocator> &s) const {
+    return __hash_bytes(s.c_str(), s.size() * sizeof(charT));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_t operator()(const charT *s) const {
+    return __hash_bytes(s, __cstr_length(s) * sizeof(charT));
+  }
+};
 
-    n = n / base;
+// operator<<(ostream&, const string&) is in nanoostream.h
+
+// Integers format through to_chars. 20 chars at most, so the result never
+// leaves the short(inline) representation.
+#define NANOSTL_TO_STRING_INTEGER(__type)                               \
+  NANOSTL_HOST_AND_DEVICE_QUAL                                          \
+  inline string to_string(__type value) {                               \
+    char buf[24];                                                       \
+    to_chars_result r = to_chars(buf, buf + sizeof(buf), value);        \
+    return string(buf, r.ptr);                                          \
   }
 
-  if (i == 0) {
-    buffer[i++] = '0';
+NANOSTL_TO_STRING_INTEGER(int)
+NANOSTL_TO_STRING_INTEGER(unsigned int)
+NANOSTL_TO_STRING_INTEGER(long)
+NANOSTL_TO_STRING_INTEGER(unsigned long)
+NANOSTL_TO_STRING_INTEGER(long long)
+NANOSTL_TO_STRING_INTEGER(unsigned long long)
+
+#undef NANOSTL_TO_STRING_INTEGER
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+string to_string(float value);
+
+NANOSTL_HOST_AND_DEVICE_QUAL
+string to_string(double value);
+
+// Parses a float/double at the start of `str` after skipping leading white
+// space(an explicit '+' is accepted, as with strtod). On success `*idx`
+// is set to the number of characters consumed. Hex floats are not
+// supported. Uses from_chars(fast_float) directly on the string's buffer.
+//
+// errc::invalid_argument when no number could be parsed,
+// errc::result_out_of_range when the value does not fit in `T`.
+template <class T>
+inline expected<T, errc> __sto_float(const string &str, size_t *idx) {
+  const char *first = str.data();
+  const char *last = first + str.size();
+  const char *p = first;
+  while ((p != last) && ((*p == ' ') || ((*p >= '\t') && (*p <= '\r')))) {
+    p++;
+  }
+  if ((p != last) && (*p == '+') && ((last - p) > 1) && (p[1] != '-')) {
+    p++;
   }
 
-  if ((value < 0) && (base == 10)) {
-    buffer[i++] = '-';
+  T value;
+  from_chars_result r = from_chars(p, last, value);
+  if (r.ec != errc()) {
+    return nonstd::make_unexpected(r.ec);
   }
+  if (idx) {
+    (*idx) = size_t(r.ptr - first);
+  }
+  return value;
+}
 
-  buffer[i] = '\0';
+inline expected<float, errc> try_stof(const string &str,
+                                      size_t *idx = nullptr) {
+  return __sto_float<float>(str, idx);
+}
 
-  myreverse(buffer, 0, i - 1);
+inline expected<double, errc> try_stod(const string &str,
+                                       size_t *idx = nullptr) {
+  return __sto_float<double>(str, idx);
+}
 
-  return string(buffer);
+// Same as try_stof/try_stod, but returns (signaling) NaN on error since
+// nanostl does not throw. `*idx` is left untouched on error.
+inline float stof(const string &str, size_t *idx = nullptr) {
+  expected<float, errc> r = __sto_float<float>(str, idx);
+  return r ? *r : numeric_limits<float>::signaling_NaN();
 }
 
+inline double stod(const string &str, size_t *idx = nullptr) {
+  expected<double, errc> r = __sto_float<double>(str, idx);
+  return r ? *r : numeric_limits<double>::signaling_NaN();
+}
+
+#if defined(NANOSTL_IMPLEMENTATION)
+#ifndef NANOSTL_STRING_IMPLEMENTATION
+#define NANOSTL_STRING_IMPLEMENTATION
+#endif
+#endif
+
+#if defined(NANOSTL_STRING_IMPLEMENTATION)
+
 // TODO: Move implementation to .cc and remove `static`
 NANOSTL_HOST_AND_DEVICE_QUAL
 string to_string(float value) {
@@ -384,36 +1024,6 @@ string to_string(double value) {
   return string(buf);
 }
 
-#if 0
-NANOSTL_HOST_AND_DEVICE_QUAL
-float stof(const nanostl::string &str, nanostl::size_t *idx) {
-  (void)idx;  // TODO(LTE):
-  float value;
-  ryu::RyuStatus ret = ryu::s2f_n(str.c_str(), str.size(), &value);
-
-  if (ret != ryu::RYU_SUCCESS) {
-    // TODO(LTE): Report an error
-    return nanostl::numeric_limits<float>::signaling_NaN();
-  }
-
-  return value;
-}
-#else
-#endif
-
-NANOSTL_HOST_AND_DEVICE_QUAL
-float stod(const nanostl::string &str, nanostl::size_t *idx) {
-  (void)idx;  // TODO(LTE):
-  double value;
-  ryu::RyuStatus ret = ryu::s2d_n(str.c_str(), str.size(), &value);
-
-  if (ret != ryu::RYU_SUCCESS) {
-    // TODO(LTE): Report an error
-    return nanostl::numeric_limits<double>::signaling_NaN();
-  }
-
-  return value;
-}
 #endif
 
 }  // namespace nanostl
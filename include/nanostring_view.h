@@ -0,0 +1,449 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_STRING_VIEW_H_
+#define NANOSTL_STRING_VIEW_H_
+
+#include "__string_search.h"
+#include "nanocommon.h"
+#include "nanocstring.h"
+#include "nanofunctional.h"
+#include "nanotype_traits.h"
+
+//
+// Non-owning reference to a char sequence(std::basic_string_view).
+//
+// Searches on 1-byte chars go through the SSE2/NEON/word-at-a-time routines
+// in __string_search.h; wider char types use plain loops.
+//
+
+namespace nanostl {
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#if __has_warning("-Wzero-as-null-pointer-constant")
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#endif
+#endif
+
+// Length of a null-terminated string; a null pointer counts as empty.
+template <class charT>
+NANOSTL_HOST_AND_DEVICE_QUAL inline unsigned long long __cstr_length(
+    const charT *s) {
+  unsigned long long n = 0;
+  if (s) {
+    while (s[n] != charT(0)) {
+      n++;
+    }
+  }
+  return n;
+}
+
+// Char sequence operations used by basic_string_view and basic_string.
+// Positions are relative to `p`; __search_npos means not found.
+template <class charT, bool = (sizeof(charT) == 1)>
+struct __char_ops {
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static int compare(const charT *a, const charT *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      if (a[i] != b[i]) {
+        return (a[i] < b[i]) ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t find(const charT *p, size_t n, charT c) {
+    for (size_t i = 0; i < n; i++) {
+      if (p[i] == c) {
+        return i;
+      }
+    }
+    return __search_npos;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t rfind(const charT *p, size_t n, charT c) {
+    for (size_t i = n; i > 0; i--) {
+      if (p[i - 1] == c) {
+        return i - 1;
+      }
+    }
+    return __search_npos;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t find(const charT *p, size_t n, const charT *s, size_t m) {
+    if (m > n) {
+      return __search_npos;
+    }
+    for (size_t i = 0; i + m <= n; i++) {
+      if (compare(p + i, s, m) == 0) {
+        return i;
+      }
+    }
+    return __search_npos;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t rfind(const charT *p, size_t n, const charT *s, size_t m) {
+    if (m > n) {
+      return __search_npos;
+    }
+    for (size_t i = n - m + 1; i > 0; i--) {
+      if (compare(p + i - 1, s, m) == 0) {
+        return i - 1;
+      }
+    }
+    return __search_npos;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t find_of(const charT *p, size_t n, const charT *s, size_t m,
+                        bool in) {
+    for (size_t i = 0; i < n; i++) {
+      if ((find(s, m, p[i]) != __search_npos) == in) {
+        return i;
+      }
+    }
+    return __search_npos;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t rfind_of(const charT *p, size_t n, const charT *s, size_t m,
+                         bool in) {
+    for (size_t i = n; i > 0; i--) {
+      if ((find(s, m, p[i - 1]) != __search_npos) == in) {
+        return i - 1;
+      }
+    }
+    return __search_npos;
+  }
+};
+
+template <class charT>
+struct __char_ops<charT, true> {
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static const unsigned char *u(const charT *p) {
+    return reinterpret_cast<const unsigned char *>(p);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static int compare(const charT *a, const charT *b, size_t n) {
+    return nanostl::memcmp(a, b, n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t find(const charT *p, size_t n, charT c) {
+    const void *q = nanostl::memchr(p, static_cast<unsigned char>(c), n);
+    return q ? size_t(static_cast<const charT *>(q) - p) : __search_npos;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t rfind(const charT *p, size_t n, charT c) {
+    return __search_memrchr(u(p), n, static_cast<unsigned char>(c));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t find(const charT *p, size_t n, const charT *s, size_t m) {
+    return __search_find(u(p), n, u(s), m);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t rfind(const charT *p, size_t n, const charT *s, size_t m) {
+    return __search_rfind(u(p), n, u(s), m);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t find_of(const charT *p, size_t n, const charT *s, size_t m,
+                        bool in) {
+    return __search_find_of(u(p), n, u(s), m, in);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_t rfind_of(const charT *p, size_t n, const charT *s, size_t m,
+                         bool in) {
+    return __search_rfind_of(u(p), n, u(s), m, in);
+  }
+};
+
+template <class charT>
+class basic_string_view {
+ public:
+  typedef unsigned long long size_type;
+  typedef charT value_type;
+  typedef const charT *pointer;
+  typedef const charT *const_pointer;
+  typedef const charT &reference;
+  typedef const charT &const_reference;
+  typedef const charT *iterator;
+  typedef const charT *const_iterator;
+
+  static const size_type npos = ~size_type(0);
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string_view() : data_(0), size_(0) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string_view(const charT *s) : data_(s), size_(__cstr_length(s)) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string_view(const charT *s, size_type count)
+      : data_(s), size_(count) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator begin() const { return data_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const_iterator end() const { return data_ + size_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT &operator[](size_type pos) const { return data_[pos]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT &at(size_type pos) const { return data_[pos]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT &front() const { return data_[0]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT &back() const { return data_[size_ - 1]; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  const charT *data() const { return data_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type size() const { return size_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type length() const { return size_; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool empty() const { return size_ == 0; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void remove_prefix(size_type n) {
+    data_ += n;
+    size_ -= n;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void remove_suffix(size_type n) { size_ -= n; }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void swap(basic_string_view &v) {
+    const charT *d = data_;
+    data_ = v.data_;
+    v.data_ = d;
+    size_type n = size_;
+    size_ = v.size_;
+    v.size_ = n;
+  }
+
+  // `pos` past the end is clamped to size()(nanostl does not throw).
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  basic_string_view substr(size_type pos = 0, size_type count = npos) const {
+    if (pos > size_) {
+      pos = size_;
+    }
+    size_type n = size_ - pos;
+    return basic_string_view(data_ + pos, (count < n) ? count : n);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int compare(basic_string_view v) const {
+    size_type n = (size_ < v.size_) ? size_ : v.size_;
+    int r = ops::compare(data_, v.data_, n);
+    if (r != 0) {
+      return r;
+    }
+    return (size_ < v.size_) ? -1 : ((size_ > v.size_) ? 1 : 0);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  int compare(size_type pos, size_type count, basic_string_view v) const {
+    return substr(pos, count).compare(v);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool starts_with(basic_string_view v) const {
+    return (size_ >= v.size_) && (ops::compare(data_, v.data_, v.size_) == 0);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool starts_with(charT c) const { return (size_ > 0) && (data_[0] == c); }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool ends_with(basic_string_view v) const {
+    return (size_ >= v.size_) &&
+           (ops::compare(data_ + size_ - v.size_, v.data_, v.size_) == 0);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  bool ends_with(charT c) const {
+    return (size_ > 0) && (data_[size_ - 1] == c);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find(basic_string_view v, size_type pos = 0) const {
+    if (pos > size_) {
+      return npos;
+    }
+    return __offset(pos, ops::find(data_ + pos, size_ - pos, v.data_, v.size_));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find(charT c, size_type pos = 0) const {
+    if (pos >= size_) {
+      return npos;
+    }
+    return __offset(pos, ops::find(data_ + pos, size_ - pos, c));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type rfind(basic_string_view v, size_type pos = npos) const {
+    if (v.size_ > size_) {
+      return npos;
+    }
+    // The match may start at `pos` at most.
+    size_type last = size_ - v.size_;
+    size_type n = ((pos < last) ? pos : last) + v.size_;
+    return ops::rfind(data_, n, v.data_, v.size_);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type rfind(charT c, size_type pos = npos) const {
+    if (size_ == 0) {
+      return npos;
+    }
+    size_type n = (pos < size_) ? pos + 1 : size_;
+    return ops::rfind(data_, n, c);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_first_of(basic_string_view v, size_type pos = 0) const {
+    if (pos >= size_) {
+      return npos;
+    }
+    return __offset(pos,
+                    ops::find_of(data_ + pos, size_ - pos, v.data_, v.size_,
+                                 true));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_first_of(charT c, size_type pos = 0) const {
+    return find(c, pos);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_first_not_of(basic_string_view v, size_type pos = 0) const {
+    if (pos >= size_) {
+      return npos;
+    }
+    return __offset(pos,
+                    ops::find_of(data_ + pos, size_ - pos, v.data_, v.size_,
+                                 false));
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_last_of(basic_string_view v, size_type pos = npos) const {
+    if (size_ == 0) {
+      return npos;
+    }
+    size_type n = (pos < size_) ? pos + 1 : size_;
+    return ops::rfind_of(data_, n, v.data_, v.size_, true);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_type find_last_not_of(basic_string_view v, size_type pos = npos) const {
+    if (size_ == 0) {
+      return npos;
+    }
+    size_type n = (pos < size_) ? pos + 1 : size_;
+    return ops::rfind_of(data_, n, v.data_, v.size_, false);
+  }
+
+ private:
+  typedef __char_ops<charT> ops;
+
+  const charT *data_;
+  size_type size_;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  static size_type __offset(size_type pos, size_t r) {
+    return (r == __search_npos) ? npos : pos + r;
+  }
+};
+
+typedef basic_string_view<char> string_view;
+
+//
+// Comparisons. The __identity overloads let one side convert implicitly
+// (from basic_string or a C string) while the other deduces charT.
+//
+#define NANOSTL_STRING_VIEW_COMPARE(op, expr)                              \
+  template <class charT>                                                   \
+  NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator op(                    \
+      basic_string_view<charT> a, basic_string_view<charT> b) {            \
+    return expr;                                                           \
+  }                                                                        \
+  template <class charT>                                                   \
+  NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator op(                    \
+      basic_string_view<charT> a,                                          \
+      typename __identity<basic_string_view<charT> >::type b) {            \
+    return expr;                                                           \
+  }                                                                        \
+  template <class charT>                                                   \
+  NANOSTL_HOST_AND_DEVICE_QUAL inline bool operator op(                    \
+      typename __identity<basic_string_view<charT> >::type a,              \
+      basic_string_view<charT> b) {                                        \
+    return expr;                                                           \
+  }
+
+NANOSTL_STRING_VIEW_COMPARE(==, (a.size() == b.size()) && (a.compare(b) == 0))
+NANOSTL_STRING_VIEW_COMPARE(!=, (a.size() != b.size()) || (a.compare(b) != 0))
+NANOSTL_STRING_VIEW_COMPARE(<, a.compare(b) < 0)
+NANOSTL_STRING_VIEW_COMPARE(>, a.compare(b) > 0)
+NANOSTL_STRING_VIEW_COMPARE(<=, a.compare(b) <= 0)
+NANOSTL_STRING_VIEW_COMPARE(>=, a.compare(b) >= 0)
+
+#undef NANOSTL_STRING_VIEW_COMPARE
+
+template <class charT>
+struct hash<basic_string_view<charT> > {
+  typedef void __is_avalanching;
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  size_t operator()(basic_string_view<charT> v) const {
+    return __hash_bytes(v.data(), v.size() * sizeof(charT));
+  }
+};
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_STRING_VIEW_H_
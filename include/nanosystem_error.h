@@ -30,12 +30,14 @@
 //#include "nanostring.h"
 //#include "nanocstdint.h"
 
-#include "errno.h"
+#include <errno.h>
 
 namespace nanostl {
 
 enum class errc {
   invalid_argument = EINVAL,
+  result_out_of_range = ERANGE,
+  value_too_large = EOVERFLOW,
 };
 
 } // namespace nsnostl
@@ -0,0 +1,187 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_TASK_SCHEDULER_H_
+#define NANOSTL_TASK_SCHEDULER_H_
+
+#if !defined(NANOSTL_NO_THREAD)
+
+#include "nanocommon.h"
+#include "nanothread.h"
+#include "nanoutility.h"
+
+namespace nanostl {
+
+//
+// Work-stealing scheduler for fork/join parallelism(recursive builds,
+// divide and conquer sorts). Not a std component. Link with
+// libnanostl(src/nanotask_scheduler.cc).
+//
+// Each worker owns a Chase-Lev deque: it pushes and pops spawned tasks at
+// the bottom(LIFO, cache friendly) while idle workers steal from the top of
+// a random victim(FIFO, the largest pieces of work). Tasks spawned from a
+// thread outside the scheduler go to a shared injection queue. Workers
+// that find nothing park on a signal instead of spinning.
+//
+//   task_scheduler sched;                    // hardware_concurrency() workers
+//   task_group g(sched);
+//   g.spawn([&] { build(left); });
+//   build(right);
+//   g.sync();                                // helps until both are done
+//
+//   sched.parallel_invoke([&] { sort(a); }, [&] { sort(b); });
+//
+class task_scheduler;
+
+//
+// A set of spawned tasks that can be waited on. sync() executes pending
+// tasks(its own or stolen ones) while waiting, so it can be called from
+// inside a task and nest to any depth. A thread outside the scheduler that
+// runs out of tasks to help with parks until the group is done. The
+// destructor syncs.
+//
+class task_group {
+ public:
+  explicit task_group(task_scheduler &__s);
+  ~task_group();
+
+  task_group(const task_group &) = delete;
+  task_group &operator=(const task_group &) = delete;
+
+  // Runs `f(args...)` asynchronously. The callable and the arguments are
+  // decay-copied.
+  template <class _Fp, class... _Args>
+  void spawn(_Fp &&__f, _Args &&... __args) {
+    __spawn(new __task_group_call<_Fp, _Args...>(
+        this, nanostl::forward<_Fp>(__f), nanostl::forward<_Args>(__args)...));
+  }
+
+  // Waits until every task spawned in this group(including tasks spawned
+  // by those tasks into the same group) has finished.
+  void sync();
+
+ private:
+  // _Gp = tuple<Callable, Args...> run by __thread_call, then reports
+  // completion to the group.
+  template <class _Fp, class... _Args>
+  struct __task_group_call
+      : public __thread_call<tuple<typename decay<_Fp>::type,
+                                   typename decay<_Args>::type...> > {
+    typedef __thread_call<
+        tuple<typename decay<_Fp>::type, typename decay<_Args>::type...> >
+        __base;
+
+    task_group *__group_;
+
+    template <class... _Up>
+    explicit __task_group_call(task_group *__g, _Up &&... __u)
+        : __base(nanostl::forward<_Up>(__u)...),
+          __group_(__g) {}
+
+    virtual void __execute() {
+      task_group *__g = __group_;
+      this->__invoke(tao::seq::make_index_sequence<
+                     tao::tuple_size<typename __base::__tuple_type>::value>());
+      delete this;
+      __g->__finish();
+    }
+  };
+
+  void __spawn(__thread_task *__task);
+  void __finish();
+
+  task_scheduler *__sched_;
+
+  // Number of unfinished tasks, plus a flag bit set while sync() is parked.
+  // Same layout as libs_thread's thread_atomic_int_t.
+  union {
+    void *__align_;
+    long __i_;
+  } __pending_;
+
+  // Signal(on the parked thread's stack) raised by the last __finish().
+  void *__waiter_;
+};
+
+class task_scheduler {
+ public:
+  // `num_threads` == 0 uses hardware_concurrency()(at least 1).
+  explicit task_scheduler(unsigned num_threads = 0);
+
+  // Runs the tasks still pending, then stops the workers.
+  ~task_scheduler();
+
+  task_scheduler(const task_scheduler &) = delete;
+  task_scheduler &operator=(const task_scheduler &) = delete;
+
+  // Number of workers actually started. With no workers, spawned tasks run
+  // when the spawning thread syncs.
+  unsigned size() const __NANOSTL_NOEXCEPT;
+
+  // Runs all callables, possibly in parallel, and returns when all have
+  // finished. The first one runs on the calling thread.
+  template <class _F0, class... _Fs>
+  void parallel_invoke(_F0 &&__f0, _Fs &&... __fs) {
+    task_group __g(*this);
+    __spawn_each(__g, nanostl::forward<_Fs>(__fs)...);
+    __f0();
+    __g.sync();
+  }
+
+ private:
+  friend class task_group;
+
+  static void __spawn_each(task_group &) {}
+
+  template <class _Fp, class... _Fs>
+  static void __spawn_each(task_group &__g, _Fp &&__f, _Fs &&... __fs) {
+    __g.spawn(nanostl::forward<_Fp>(__f));
+    __spawn_each(__g, nanostl::forward<_Fs>(__fs)...);
+  }
+
+  // Queues `__task` on the calling worker's deque, or on the injection
+  // queue from other threads(takes ownership).
+  void __push(__thread_task *__task);
+
+  // Runs one pending task if there is any. Returns false otherwise.
+  bool __try_run_one();
+
+  // True when called from one of this scheduler's workers.
+  bool __on_worker() const;
+
+  // opeque pointer(src/nanotask_scheduler.cc)
+  void *__impl_;
+};
+
+template <class _F0, class... _Fs>
+inline void parallel_invoke(task_scheduler &__s, _F0 &&__f0, _Fs &&... __fs) {
+  __s.parallel_invoke(nanostl::forward<_F0>(__f0),
+                      nanostl::forward<_Fs>(__fs)...);
+}
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_NO_THREAD
+
+#endif  // NANOSTL_TASK_SCHEDULER_H_
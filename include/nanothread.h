@@ -31,179 +31,92 @@
 #include "nanochrono.h"
 #include "nanotuple.h"
 #include "nanomemory.h"
-
-// forward decl(from libs_thread)
-typedef void* thread_tls_t;
-extern void* thread_tls_get( thread_tls_t tls );
-extern thread_tls_t thread_tls_create( void );
-extern void thread_tls_set(thread_tls_t tls, void *value);
+#include "nanoutility.h"
+#include "__nullptr"
 
 namespace nanostl {
 
-namespace {
-
-//===--------------------------- thread -----------------------------------===//
 //
-// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
-// See https://llvm.org/LICENSE.txt for license information.
-// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Threads are created with libs_thread(src/libs_thread.h), so link with
+// libnanostl(src/nanothread.cc).
+//
+// The callable and decayed copies of its arguments are moved to the heap
+// and invoked on the new thread as `f(args...)`(pointers to members are
+// not supported). Unlike std::thread, destroying or assigning to a
+// joinable thread joins it instead of calling terminate().
 //
-//===----------------------------------------------------------------------===//
-
-template <class _Tp> class __thread_specific_ptr;
-class /*_LIBCPP_TYPE_VIS*/ __thread_struct;
-class /*_LIBCPP_HIDDEN*/ __thread_struct_imp;
-class __assoc_sub_state;
-
-//TODO: func_vis
-/*_LIBCPP_FUNC_VIS*/ __thread_specific_ptr<__thread_struct>& __thread_local_data();
-
-
-class /*_LIBCPP_TYPE_VIS*/ __thread_struct
-{
-    __thread_struct_imp* __p_;
 
-public:
-    __thread_struct();
-    ~__thread_struct();
-    __thread_struct(const __thread_struct&) = default;
-    __thread_struct& operator=(const __thread_struct&) = default;
+// Work item for thread and thread_pool. __execute() runs it and then
+// releases whatever it owns(heap allocated calls delete themselves).
+struct __thread_task {
+  __thread_task *__next_;  // thread_pool queue link
 
-    // TODO
-    //void notify_all_at_thread_exit(condition_variable*, mutex*);
-    void __make_ready_at_thread_exit(__assoc_sub_state*);
+  __thread_task() : __next_(nullptr) {}
+  virtual ~__thread_task() {}
+  virtual void __execute() = 0;
 };
 
-template <class _Tp>
-class __thread_specific_ptr
-{
-    thread_tls_t __key_;
-
-     // Only __thread_local_data() may construct a __thread_specific_ptr
-     // and only with _Tp == __thread_struct.
-    static_assert((is_same<_Tp, __thread_struct>::value), "");
-    __thread_specific_ptr();
-    friend /*_LIBCPP_FUNC_VIS*/ __thread_specific_ptr<__thread_struct>& __thread_local_data();
+// _Gp = tuple<Callable, Args...>
+template <class _Gp>
+struct __thread_call : public __thread_task {
+  typedef _Gp __tuple_type;
 
-    __thread_specific_ptr(const __thread_specific_ptr&);
-    __thread_specific_ptr& operator=(const __thread_specific_ptr&);
+  _Gp __g_;
 
-    /*_LIBCPP_HIDDEN*/ static void /*_LIBCPP_TLS_DESTRUCTOR_CC*/ __at_thread_exit(void*);
+  template <class... _Up>
+  explicit __thread_call(_Up &&... __u) : __g_(nanostl::forward<_Up>(__u)...) {}
 
-public:
-    typedef _Tp* pointer;
-
-    ~__thread_specific_ptr();
-
-    _LIBCPP_INLINE_VISIBILITY
-    pointer get() const {return static_cast<_Tp*>(thread_tls_get(__key_));}
-    _LIBCPP_INLINE_VISIBILITY
-    pointer operator*() const {return *get();}
-    _LIBCPP_INLINE_VISIBILITY
-    pointer operator->() const {return get();}
-    void set_pointer(pointer __p);
-};
-
-
-template <class _Tp>
-void /*_LIBCPP_TLS_DESTRUCTOR_CC*/
-__thread_specific_ptr<_Tp>::__at_thread_exit(void* __p)
-{
-    delete static_cast<pointer>(__p);
-}
-
-template <class _Tp>
-__thread_specific_ptr<_Tp>::__thread_specific_ptr()
-{
-  //int __ec =
-  //    __libcpp_tls_create(&__key_, &__thread_specific_ptr::__at_thread_exit);
-  //if (__ec)
-  //  __throw_system_error(__ec, "__thread_specific_ptr construction failed");
-
-  // TODO: at_thread_exit handler
-  __key_ = thread_tls_create();
-  if (__key_ == nullptr) {
-    // TODO: throw
+  virtual void __execute() {
+    __invoke(tao::seq::make_index_sequence<tao::tuple_size<_Gp>::value>());
+    delete this;
   }
-}
-
-template <class _Tp>
-__thread_specific_ptr<_Tp>::~__thread_specific_ptr()
-{
-    // __thread_specific_ptr is only created with a static storage duration
-    // so this destructor is only invoked during program termination. Invoking
-    // pthread_key_delete(__key_) may prevent other threads from deleting their
-    // thread local data. For this reason we leak the key.
-}
-
-template <class _Tp>
-void
-__thread_specific_ptr<_Tp>::set_pointer(pointer __p)
-{
-    _LIBCPP_ASSERT(get() == nullptr,
-                   "Attempting to overwrite thread local data");
-    thread_tls_set(__key_, __p);
-}
 
+  template <size_t _Fn, size_t... _Is>
+  void __invoke(tao::seq::index_sequence<_Fn, _Is...>) {
+    nanostl::move(tao::get<_Fn>(__g_))(nanostl::move(tao::get<_Is>(__g_))...);
+  }
+};
 
-template <class _Fp>
-/*_LIBCPP_INLINE_VISIBILITY*/
-void* __thread_proxy(void* __vp)
-{
-    // _Fp = tuple< unique_ptr<__thread_struct>, Functor, Args...>
-    unique_ptr<_Fp> __p(static_cast<_Fp*>(__vp));
-    __thread_local_data().set_pointer(tao::get<0>(*__p.get()).release());
-    //typedef typename __make_tuple_indices<tao::tuple_size<_Fp>::value, 2>::type _Index;
-    //typedef typename tao::seq::make_integer_sequence<typename tao::tuple_size<_Fp>::value, 2>::type _Index;
-    //_VSTD::__thread_execute(*__p.get(), _Index());
-    //_VSTD::__thread_execute(*__p.get(), tao::seq::make_integer_sequence<tao::tuple_size<_Fp>::value, 2>());
-    return nullptr;
+template <class _Fp, class... _Args>
+inline __thread_task *__make_thread_call(_Fp &&__f, _Args &&... __args) {
+  typedef tuple<typename decay<_Fp>::type, typename decay<_Args>::type...> _Gp;
+  return new __thread_call<_Gp>(
+      nanostl::__decay_copy(nanostl::forward<_Fp>(__f)),
+      nanostl::__decay_copy(nanostl::forward<_Args>(__args))...);
 }
 
-
-//===----------------------------------------------------------------------===//
-
-} // namespace
-
 class thread {
 
  public:
 
   class id {
    public:
-    id() __NANOSTL_NOEXCEPT;
-
-    //bool operator==(thread::id x, thread::id y) noexcept;
-    //bool operator!=(thread::id x, thread::id y) noexcept;
-    //bool operator<(thread::id x, thread::id y) noexcept;
-    //bool operator<=(thread::id x, thread::id y) noexcept;
-    //bool operator>(thread::id x, thread::id y) noexcept;
-    //bool operator>=(thread::id x, thread::id y) noexcept;
+    id() __NANOSTL_NOEXCEPT : __id_(nullptr) {}
 
-    //template<class CharT, class Traits>
-    //std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& out, thread::id id);
+    friend bool operator==(id __x, id __y) __NANOSTL_NOEXCEPT { return __x.__id_ == __y.__id_; }
+    friend bool operator!=(id __x, id __y) __NANOSTL_NOEXCEPT { return __x.__id_ != __y.__id_; }
+    friend bool operator<(id __x, id __y) __NANOSTL_NOEXCEPT { return __x.__id_ < __y.__id_; }
+    friend bool operator<=(id __x, id __y) __NANOSTL_NOEXCEPT { return !(__y < __x); }
+    friend bool operator>(id __x, id __y) __NANOSTL_NOEXCEPT { return __y < __x; }
+    friend bool operator>=(id __x, id __y) __NANOSTL_NOEXCEPT { return !(__x < __y); }
 
-    template <class T> struct hash;
-    //template <> struct hash<thread::id>; // TODO
+    // posix: pthread_t, windows: thread id
+    void *__native() const { return __id_; }
+    explicit id(void *__id) : __id_(__id) {}
 
+   private:
+    void *__id_;
   };
 
   thread() __NANOSTL_NOEXCEPT;
 
+  // The thread is not joinable if it could not be started.
   template <class _Fp, class ..._Args>
-  explicit thread(_Fp&& __f, _Args&&... __args) {
-    typedef unique_ptr<__thread_struct> _TSPtr;
-    _TSPtr __tsp(new __thread_struct);
-    typedef tuple<_TSPtr, typename decay<_Fp>::type, typename decay<_Args>::type...> _Gp;
-
-    unique_ptr<_Gp> __p(
-            new _Gp(nanostl::move(__tsp),
-                    nanostl::__decay_copy(nanostl::forward<_Fp>(__f)),
-                    nanostl::__decay_copy(nanostl::forward<_Args>(__args))...));
-
+  explicit thread(_Fp&& __f, _Args&&... __args) : thread_handle_(nullptr) {
+    __start(__make_thread_call(nanostl::forward<_Fp>(__f),
+                               nanostl::forward<_Args>(__args)...));
   }
 
-
   ~thread();
 
   thread(const thread&) = delete;
@@ -229,13 +142,22 @@ class thread {
   static unsigned hardware_concurrency() __NANOSTL_NOEXCEPT;
 
  private:
+  // Starts a thread running `__task`(which it takes ownership of).
+  void __start(__thread_task *__task);
+
   // opeque pointer
   void *thread_handle_{nullptr};
 };
 
+inline void swap(thread &__x, thread &__y) __NANOSTL_NOEXCEPT { __x.swap(__y); }
+
 namespace this_thread
 {
 
+thread::id get_id() __NANOSTL_NOEXCEPT;
+
+void yield() __NANOSTL_NOEXCEPT;
+
 void sleep_for(const chrono::nanoseconds &ns);
 
 } // namespace this_thread
@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_THREAD_POOL_H_
+#define NANOSTL_THREAD_POOL_H_
+
+#if !defined(NANOSTL_NO_THREAD)
+
+#include "nanocommon.h"
+#include "nanothread.h"
+#include "nanoutility.h"
+
+namespace nanostl {
+
+//
+// Fixed set of persistent worker threads fed from one FIFO queue, so batch
+// jobs pay for thread creation once instead of per task. Not a std
+// component. Link with libnanostl(src/nanothread.cc).
+//
+//   thread_pool pool;                      // hardware_concurrency() workers
+//   pool.submit(f, args...);               // runs f(args...) on a worker
+//   pool.wait();                           // until every task has finished
+//   pool.parallel_for(0, n, [&](size_t i) { ... });
+//   pool.parallel_for_range(0, n, [&](size_t b, size_t e) { ... });
+//
+// Tasks still queued at destruction are run before the workers exit.
+// wait() must not be called from inside a task(it would wait for itself).
+//
+class thread_pool {
+ public:
+  // `num_threads` == 0 uses hardware_concurrency()(at least 1).
+  explicit thread_pool(unsigned num_threads = 0);
+  ~thread_pool();
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  // Number of workers actually started. With no workers, submit() runs the
+  // task on the calling thread.
+  unsigned size() const __NANOSTL_NOEXCEPT;
+
+  // Queues `f(args...)`. The callable and the arguments are decay-copied.
+  template <class _Fp, class... _Args>
+  void submit(_Fp &&__f, _Args &&... __args) {
+    __push(__make_thread_call(nanostl::forward<_Fp>(__f),
+                              nanostl::forward<_Args>(__args)...));
+  }
+
+  // Blocks until all submitted tasks have finished.
+  void wait();
+
+  // Calls `f(i)` for every i in [first, last). The range is cut into chunks
+  // of `grain` indices(0 picks about 8 chunks per thread) which the calling
+  // thread and up to size() workers take in turn; returns when all are
+  // done. Safe to call from inside a task.
+  template <class _Fp>
+  void parallel_for(size_t __first, size_t __last, _Fp &&__f,
+                    size_t __grain = 0) {
+    typedef typename remove_reference<_Fp>::type _Body;
+    __parallel_for(__first, __last, __grain, &__parallel_for_chunk<_Body>,
+                   const_cast<void *>(static_cast<const volatile void *>(&__f)));
+  }
+
+  // Same as parallel_for, but calls `f(begin, end)` once per chunk, so the
+  // body can keep a tight inner loop.
+  template <class _Fp>
+  void parallel_for_range(size_t __first, size_t __last, _Fp &&__f,
+                          size_t __grain = 0) {
+    typedef typename remove_reference<_Fp>::type _Body;
+    __parallel_for(__first, __last, __grain,
+                   &__parallel_for_range_chunk<_Body>,
+                   const_cast<void *>(static_cast<const volatile void *>(&__f)));
+  }
+
+ private:
+  template <class _Body>
+  static void __parallel_for_chunk(void *__body, size_t __begin, size_t __end) {
+    _Body &__f = *static_cast<_Body *>(__body);
+    for (size_t __i = __begin; __i < __end; ++__i) {
+      __f(__i);
+    }
+  }
+
+  template <class _Body>
+  static void __parallel_for_range_chunk(void *__body, size_t __begin,
+                                         size_t __end) {
+    (*static_cast<_Body *>(__body))(__begin, __end);
+  }
+
+  // Queues `__task`(takes ownership).
+  void __push(__thread_task *__task);
+
+  void __parallel_for(size_t __first, size_t __last, size_t __grain,
+                      void (*__chunk)(void *, size_t, size_t), void *__body);
+
+  // opeque pointer(src/nanothread.cc)
+  void *__impl_;
+};
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_NO_THREAD
+
+#endif  // NANOSTL_THREAD_POOL_H_
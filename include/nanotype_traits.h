@@ -309,6 +309,11 @@ template <class _Tp> struct _NANOSTL_TEMPLATE_VIS is_abstract
 template <class _Tp> struct _NANOSTL_TEMPLATE_VIS __libcpp_is_final
     : public integral_constant<bool, __is_final(_Tp)> {};
 
+// is_base_of
+
+template <class _Bp, class _Dp> struct _NANOSTL_TEMPLATE_VIS is_base_of
+    : public integral_constant<bool, __is_base_of(_Bp, _Dp)> {};
+
 //#if _LIBCPP_STD_VER > 11
 template <class _Tp> struct _NANOSTL_TEMPLATE_VIS
 is_final : public integral_constant<bool, __is_final(_Tp)> {};
@@ -1273,6 +1278,30 @@ template <class _Tp> struct _NANOSTL_TEMPLATE_VIS is_trivially_move_constructibl
     : public is_trivially_constructible<_Tp, typename add_rvalue_reference<_Tp>::type>
     {};
 
+// is_trivially_copyable
+
+template <class _Tp> struct _NANOSTL_TEMPLATE_VIS is_trivially_copyable
+    : public integral_constant<bool, __is_trivially_copyable(_Tp)>
+    {};
+
+// is_trivially_destructible
+
+#if defined(__has_builtin)
+#if __has_builtin(__is_trivially_destructible)
+#define NANOSTL_HAS_IS_TRIVIALLY_DESTRUCTIBLE_BUILTIN
+#endif
+#endif
+
+#if defined(NANOSTL_HAS_IS_TRIVIALLY_DESTRUCTIBLE_BUILTIN)
+template <class _Tp> struct _NANOSTL_TEMPLATE_VIS is_trivially_destructible
+    : public integral_constant<bool, __is_trivially_destructible(_Tp)>
+    {};
+#else
+template <class _Tp> struct _NANOSTL_TEMPLATE_VIS is_trivially_destructible
+    : public integral_constant<bool, __has_trivial_destructor(_Tp)>
+    {};
+#endif
+
 // __is_nullptr_t
 
 template <class _Tp> struct __is_nullptr_t_impl       : public false_type {};
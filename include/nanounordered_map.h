@@ -0,0 +1,98 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_UNORDERED_MAP_H_
+#define NANOSTL_UNORDERED_MAP_H_
+
+#include "__hash_table.h"
+
+//
+// Open addressing hash map. See __hash_table.h for the table layout.
+//
+// Unlike std::unordered_map, elements are stored inline and move when the
+// table grows, so insertions invalidate iterators and references.
+//
+
+namespace nanostl {
+
+template <class Key, class T, class Hash = nanostl::hash<Key>,
+          class KeyEqual = nanostl::equal_to<Key>,
+          class Allocator = nanostl::allocator<nanostl::pair<const Key, T> > >
+class unordered_map : public __raw_hash_table<
+                          __hash_map_params<Key, T, Hash, KeyEqual, Allocator> > {
+  typedef __raw_hash_table<__hash_map_params<Key, T, Hash, KeyEqual, Allocator> >
+      base;
+
+ public:
+  typedef T mapped_type;
+  typedef typename base::key_type key_type;
+  typedef typename base::value_type value_type;
+  typedef typename base::size_type size_type;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  unordered_map() {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit unordered_map(size_type bucket_count, const Hash& hash = Hash(),
+                         const KeyEqual& eq = KeyEqual(),
+                         const Allocator& alloc = Allocator())
+      : base(bucket_count, hash, eq, alloc) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit unordered_map(const Allocator& alloc)
+      : base(0, Hash(), KeyEqual(), alloc) {}
+
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL unordered_map(
+      InputIterator first, InputIterator last, size_type bucket_count = 0,
+      const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(),
+      const Allocator& alloc = Allocator())
+      : base(bucket_count, hash, eq, alloc) {
+    this->insert(first, last);
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  T& operator[](const key_type& k) {
+    pair<size_type, bool> r = this->__find_or_prepare_insert(k);
+    typename base::iterator it = this->__iterator_at(r.first);
+    if (r.second) {
+      ::new (__placement_tag(), &(*it)) value_type(k, T());
+    }
+    return it->second;
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  T& operator[](key_type&& k) {
+    pair<size_type, bool> r = this->__find_or_prepare_insert(k);
+    typename base::iterator it = this->__iterator_at(r.first);
+    if (r.second) {
+      ::new (__placement_tag(), &(*it)) value_type(nanostl::move(k), T());
+    }
+    return it->second;
+  }
+};
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_UNORDERED_MAP_H_
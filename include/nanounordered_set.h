@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Light Transport Entertainment, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NANOSTL_UNORDERED_SET_H_
+#define NANOSTL_UNORDERED_SET_H_
+
+#include "__hash_table.h"
+
+//
+// Open addressing hash set. See __hash_table.h for the table layout.
+//
+// Insertions invalidate iterators and references.
+//
+
+namespace nanostl {
+
+template <class Key, class Hash = nanostl::hash<Key>,
+          class KeyEqual = nanostl::equal_to<Key>,
+          class Allocator = nanostl::allocator<Key> >
+class unordered_set
+    : public __raw_hash_table<__hash_set_params<Key, Hash, KeyEqual, Allocator> > {
+  typedef __raw_hash_table<__hash_set_params<Key, Hash, KeyEqual, Allocator> >
+      base;
+
+ public:
+  typedef typename base::size_type size_type;
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  unordered_set() {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit unordered_set(size_type bucket_count, const Hash& hash = Hash(),
+                         const KeyEqual& eq = KeyEqual(),
+                         const Allocator& alloc = Allocator())
+      : base(bucket_count, hash, eq, alloc) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  explicit unordered_set(const Allocator& alloc)
+      : base(0, Hash(), KeyEqual(), alloc) {}
+
+  template <class InputIterator>
+  NANOSTL_HOST_AND_DEVICE_QUAL unordered_set(
+      InputIterator first, InputIterator last, size_type bucket_count = 0,
+      const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(),
+      const Allocator& alloc = Allocator())
+      : base(bucket_count, hash, eq, alloc) {
+    this->insert(first, last);
+  }
+};
+
+}  // namespace nanostl
+
+#endif  // NANOSTL_UNORDERED_SET_H_
@@ -36,6 +36,8 @@ struct pair {
   T2 second;
   pair() {}
   pair(const T1& a, const T2& b) : first(a), second(b) {}
+  template <class U1, class U2>
+  pair(const pair<U1, U2>& p) : first(p.first), second(p.second) {}
 };
 
 template <class T1, class T2>
@@ -131,6 +133,28 @@ inline /*_LIBCPP_INLINE_VISIBILITY*/ typename decay<_Tp>::type __decay_copy(_Tp&
   return nanostl::forward<_Tp>(__t);
 }
 
+// swap is declared in nanotype_traits
+
+template <class _Tp>
+inline /*_LIBCPP_INLINE_VISIBILITY*/ __swap_result_t<_Tp>
+swap(_Tp& __x, _Tp& __y) __NANOSTL_NOEXCEPT_(is_nothrow_move_constructible<_Tp>::value &&
+                                    is_nothrow_move_assignable<_Tp>::value) {
+  _Tp __t(nanostl::move(__x));
+  __x = nanostl::move(__y);
+  __y = nanostl::move(__t);
+}
+
+template <class _Tp, size_t _Np>
+inline /*_LIBCPP_INLINE_VISIBILITY*/
+typename enable_if<
+    __is_swappable<_Tp>::value
+>::type
+swap(_Tp (&__a)[_Np], _Tp (&__b)[_Np]) __NANOSTL_NOEXCEPT_(__is_nothrow_swappable<_Tp>::value) {
+  for (size_t __i = 0; __i != _Np; ++__i) {
+    swap(__a[__i], __b[__i]);
+  }
+}
+
 
 }  // namespace nanostl
 
@@ -26,12 +26,25 @@
 #define NANOSTL_VALARRAY_H_
 
 #include "nanoallocator.h"
+#include "nanocstring.h"
 #include "nanomath.h"
 
 #ifdef NANOSTL_DEBUG
 #include <iostream>
 #endif
 
+// Type traits come straight from compiler builtins: nanotype_traits.h pulls in
+// the `nullptr` macro from __nullptr, which breaks std headers included after
+// this one.
+#if defined(__has_builtin)
+#if __has_builtin(__is_trivially_destructible)
+#define NANOSTL_VALARRAY_TRIVIALLY_DESTRUCTIBLE(T) __is_trivially_destructible(T)
+#endif
+#endif
+#if !defined(NANOSTL_VALARRAY_TRIVIALLY_DESTRUCTIBLE)
+#define NANOSTL_VALARRAY_TRIVIALLY_DESTRUCTIBLE(T) __has_trivial_destructor(T)
+#endif
+
 namespace nanostl {
 
 #ifdef __clang__
@@ -44,7 +57,6 @@ namespace nanostl {
 #endif
 #endif
 
-// TODO(LTE): Support allocator.
 template <class T, class Allocator = nanostl::allocator<T> >
 class valarray {
  public:
@@ -57,11 +69,15 @@ class valarray {
   typedef const_pointer const_iterator;
   typedef Allocator allocator_type;
 
+ private:
+  typedef nanostl::allocator_traits<Allocator> alloc_traits;
+
+ public:
   NANOSTL_HOST_AND_DEVICE_QUAL
   valarray() : elements_(0), capacity_(0), size_(0) {}
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  valarray(const valarray& rhs) {
+  valarray(const valarray& rhs) : alloc_(rhs.alloc_) {
     __initialize();
     assign(rhs.begin(), rhs.end());
   }
@@ -72,46 +88,42 @@ class valarray {
     resize(n);
   }
 
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  valarray(const size_type n, const allocator_type& alloc) : alloc_(alloc) {
+    __initialize();
+    resize(n);
+  }
+
   NANOSTL_HOST_AND_DEVICE_QUAL
   ~valarray() {
-    allocator_type allocator;
+    __destroy_range(0, size_);
     if (elements_) {
-      allocator.deallocate(elements_, capacity_);
+      alloc_traits::deallocate(alloc_, elements_, capacity_);
     }
   }
 
+  // Existing elements are kept, new ones are value-initialized.
   NANOSTL_HOST_AND_DEVICE_QUAL
   void resize(size_type count) {
-    if (count < 1) {
+    if (count < size_) {
+      __destroy_range(count, size_);
+      size_ = count;
       return;
     }
 
     if (count > capacity()) {
-      // TODO(LTE): Use memcpy() or realloc() like functionality to speed up
-      // resizing.
       size_type n = (count > recommended_size()) ? count : recommended_size();
 #ifdef NANOSTL_DEBUG
       std::cout << "valarray::resize: count " << count << ", capacity "
                 << capacity() << ", recommended_size " << recommended_size()
                 << ", n " << n << std::endl;
 #endif
-      allocator_type allocator;
-
-      value_type* new_elements = allocator.allocate(n);
-      size_type new_capacity = n;
-
-      for (size_type i = 0; i < size(); i++) {
-        new_elements[i] = elements_[i];
-      }
-
-      // delete old buffer
-      allocator.deallocate(elements_, capacity_);
-
-      elements_ = new_elements;
-      capacity_ = new_capacity;
+      __reallocate(n);
     }
 
-    size_ = count;
+    for (; size_ < count; size_++) {
+      alloc_traits::construct(alloc_, elements_ + size_);
+    }
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
@@ -121,7 +133,10 @@ class valarray {
   size_type size() const { return size_; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
-  void clear() { size_ = 0; }
+  void clear() {
+    __destroy_range(0, size_);
+    size_ = 0;
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   size_type capacity() const { return capacity_; }
@@ -149,13 +164,15 @@ class valarray {
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   inline iterator erase(iterator pos) {
+    iterator ret = pos;
     while ((pos + 1) != end()) {
       (*pos) = *(pos + 1);
       pos++;
     }
     size_--;
+    alloc_traits::destroy(alloc_, elements_ + size_);
 
-    return pos;
+    return ret;
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
@@ -172,6 +189,7 @@ class valarray {
     __swap(elements_, x.elements_);
     __swap(capacity_, x.capacity_);
     __swap(size_, x.size_);
+    __swap(alloc_, x.alloc_);
   }
 
  private:
@@ -185,10 +203,46 @@ class valarray {
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   void __push_back(const value_type& val) {
-    resize(size() + 1);
-    elements_[size_ - 1] = val;
+    if (size_ == capacity_) {
+      __reallocate((size_ + 1 > recommended_size()) ? size_ + 1
+                                                    : recommended_size());
+    }
+    alloc_traits::construct(alloc_, elements_ + size_, val);
+    size_++;
   }
 
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __destroy_range(size_type first, size_type last) {
+    if (NANOSTL_VALARRAY_TRIVIALLY_DESTRUCTIBLE(T)) {
+      return;
+    }
+    for (size_type i = first; i < last; i++) {
+      alloc_traits::destroy(alloc_, elements_ + i);
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL
+  void __reallocate(size_type n) {
+    value_type* new_elements = alloc_traits::allocate(alloc_, n);
+
+    if (__is_trivially_copyable(T)) {
+      if (size_ > 0) {
+        nanostl::memcpy(new_elements, elements_, size_ * sizeof(T));
+      }
+    } else {
+      for (size_type i = 0; i < size_; i++) {
+        alloc_traits::construct(alloc_, new_elements + i, elements_[i]);
+        alloc_traits::destroy(alloc_, elements_ + i);
+      }
+    }
+
+    if (elements_) {
+      alloc_traits::deallocate(alloc_, elements_, capacity_);
+    }
+
+    elements_ = new_elements;
+    capacity_ = n;
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL
   template<class Ty>
@@ -208,6 +262,7 @@ class valarray {
   T* elements_;
   size_type capacity_;
   size_type size_;
+  allocator_type alloc_;
 };
 
 template <class T, class Allocator>
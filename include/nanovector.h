@@ -27,6 +27,8 @@
 
 #include "nanocommon.h"
 #include "nanoallocator.h"
+#include "nanocstring.h"
+#include "nanoutility.h"
 
 #ifdef NANOSTL_DEBUG
 #include <iostream>
@@ -44,7 +46,6 @@ namespace nanostl {
 #endif
 #endif
 
-// TODO(LTE): Support allocator.
 template <class T, class Allocator = nanostl::allocator<T> >
 class vector {
  public:
@@ -57,20 +58,40 @@ class vector {
   typedef const_pointer const_iterator;
   typedef Allocator allocator_type;
 
+ private:
+  typedef nanostl::allocator_traits<Allocator> alloc_traits;
+
+ public:
   NANOSTL_HOST_AND_DEVICE_QUAL vector() : elements_(0), capacity_(0), size_(0) {}
 
-  NANOSTL_HOST_AND_DEVICE_QUAL vector(const vector& rhs) {
+  NANOSTL_HOST_AND_DEVICE_QUAL explicit vector(const allocator_type& alloc)
+      : elements_(0), capacity_(0), size_(0), alloc_(alloc) {}
+
+  NANOSTL_HOST_AND_DEVICE_QUAL vector(const vector& rhs) : alloc_(rhs.alloc_) {
     __initialize();
+    reserve(rhs.size());
     assign(rhs.begin(), rhs.end());
   }
 
+  NANOSTL_HOST_AND_DEVICE_QUAL vector(vector&& rhs)
+      : elements_(rhs.elements_),
+        capacity_(rhs.capacity_),
+        size_(rhs.size_),
+        alloc_(rhs.alloc_) {
+    rhs.__initialize();
+  }
+
   NANOSTL_HOST_AND_DEVICE_QUAL ~vector() {
-    allocator_type allocator;
+    __destroy_range(0, size_);
     if (elements_) {
-      allocator.deallocate(elements_, capacity_);
+      alloc_traits::deallocate(alloc_, elements_, capacity_);
     }
   }
 
+  NANOSTL_HOST_AND_DEVICE_QUAL allocator_type get_allocator() const {
+    return alloc_;
+  }
+
   reference at(size_type pos) {
     // TODO(LTE): out-of-range check.
     return elements_[pos];
@@ -81,51 +102,74 @@ class vector {
     return elements_[pos];
   }
 
+  // New elements are value-initialized. Shrinking destroys the tail but
+  // keeps the capacity.
   NANOSTL_HOST_AND_DEVICE_QUAL void resize(size_type count) {
-    if (count < 1) {
+    if (count < size_) {
+      __destroy_range(count, size_);
+      size_ = count;
       return;
     }
 
     if (count > capacity()) {
-      // TODO(LTE): Use memcpy() or realloc() like functionality to speed up
-      // resizing.
       size_type n = (count > recommended_size()) ? count : recommended_size();
 #ifdef NANOSTL_DEBUG
       std::cout << "vector::resize: count " << count << ", capacity "
                 << capacity() << ", recommended_size " << recommended_size()
                 << ", n " << n << std::endl;
 #endif
-      allocator_type allocator;
-
-      value_type* new_elements = allocator.allocate(n);
-      size_type new_capacity = n;
-
-      for (size_type i = 0; i < size(); i++) {
-        new_elements[i] = elements_[i];
-      }
+      __reallocate(n);
+    }
 
-      // delete old buffer
-      allocator.deallocate(elements_, capacity_);
+    for (; size_ < count; size_++) {
+      alloc_traits::construct(alloc_, elements_ + size_);
+    }
+  }
 
-      elements_ = new_elements;
-      capacity_ = new_capacity;
+  // Preallocate storage for at least `n` elements. Never shrinks.
+  NANOSTL_HOST_AND_DEVICE_QUAL void reserve(size_type n) {
+    if (n > capacity()) {
+      __reallocate(n);
     }
+  }
 
-    size_ = count;
+  // Release unused capacity.
+  NANOSTL_HOST_AND_DEVICE_QUAL void shrink_to_fit() {
+    if (capacity() > size()) {
+      __reallocate(size());
+    }
   }
 
   NANOSTL_HOST_AND_DEVICE_QUAL void push_back(const value_type& val) {
-    resize(size() + 1);
-    elements_[size_ - 1] = val;
+    emplace_back(val);
   }
 
-  // void push_back(value_type &val); // C++11
+  NANOSTL_HOST_AND_DEVICE_QUAL void push_back(value_type&& val) {
+    emplace_back(nanostl::move(val));
+  }
+
+  template <class... Args>
+  NANOSTL_HOST_AND_DEVICE_QUAL reference emplace_back(Args&&... args) {
+    if (size_ == capacity_) {
+      // Arguments may refer to an element of this vector, so construct the
+      // new element before the old buffer is released.
+      __grow_and_emplace(nanostl::forward<Args>(args)...);
+    } else {
+      alloc_traits::construct(alloc_, elements_ + size_,
+                              nanostl::forward<Args>(args)...);
+      size_++;
+    }
+    return elements_[size_ - 1];
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL bool empty() const { return size_ == 0; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL size_type size() const { return size_; }
 
-  NANOSTL_HOST_AND_DEVICE_QUAL void clear() { size_ = 0; }
+  NANOSTL_HOST_AND_DEVICE_QUAL void clear() {
+    __destroy_range(0, size_);
+    size_ = 0;
+  }
 
   NANOSTL_HOST_AND_DEVICE_QUAL size_type capacity() const { return capacity_; }
 
@@ -136,6 +180,7 @@ class vector {
   NANOSTL_HOST_AND_DEVICE_QUAL pointer data() { return elements_; }
 
   NANOSTL_HOST_AND_DEVICE_QUAL vector& operator=(const vector& rhs);
+  NANOSTL_HOST_AND_DEVICE_QUAL vector& operator=(vector&& rhs);
   NANOSTL_HOST_AND_DEVICE_QUAL vector& operator+=(const vector& rhs);
 
   inline iterator begin(void) const { return elements_ + 0; }
@@ -147,16 +192,18 @@ class vector {
       // this should be undefined behavior
     }
     size_--;
+    alloc_traits::destroy(alloc_, elements_ + size_);
   }
 
   inline iterator erase(iterator pos) {
+    iterator ret = pos;
     while ((pos + 1) != end()) {
-      (*pos) = *(pos + 1);
+      (*pos) = nanostl::move(*(pos + 1));
       pos++;
     }
-    size_--;
+    pop_back();
 
-    return pos;
+    return ret;
   }
 
   template <class InputIterator>
@@ -171,6 +218,7 @@ class vector {
     __swap(elements_, x.elements_);
     __swap(capacity_, x.capacity_);
     __swap(size_, x.size_);
+    __swap(alloc_, x.alloc_);
   }
 
  private:
@@ -193,20 +241,97 @@ class vector {
     return s;
   }
 
+  NANOSTL_HOST_AND_DEVICE_QUAL void __destroy_range(size_type first,
+                                                    size_type last) {
+    if (is_trivially_destructible<T>::value) {
+      return;
+    }
+    for (size_type i = first; i < last; i++) {
+      alloc_traits::destroy(alloc_, elements_ + i);
+    }
+  }
+
+  // Move `n` elements from `src` into raw storage `dst` and end the lifetime
+  // of the sources. Trivially copyable types are relocated with a single
+  // memcpy.
+  NANOSTL_HOST_AND_DEVICE_QUAL void __relocate(T* dst, T* src, size_type n,
+                                               true_type) {
+    if (n > 0) {
+      nanostl::memcpy(dst, src, n * sizeof(T));
+    }
+  }
+
+  NANOSTL_HOST_AND_DEVICE_QUAL void __relocate(T* dst, T* src, size_type n,
+                                               false_type) {
+    for (size_type i = 0; i < n; i++) {
+      alloc_traits::construct(alloc_, dst + i, nanostl::move(src[i]));
+      alloc_traits::destroy(alloc_, src + i);
+    }
+  }
+
+  // Replace the buffer with one of exactly `n` elements, keeping the
+  // first size() elements.
+  NANOSTL_HOST_AND_DEVICE_QUAL void __reallocate(size_type n) {
+    value_type* new_elements =
+        (n > 0) ? alloc_traits::allocate(alloc_, n) : 0;
+
+    __relocate(new_elements, elements_, size_,
+               integral_constant<bool, is_trivially_copyable<T>::value>());
+
+    if (elements_) {
+      alloc_traits::deallocate(alloc_, elements_, capacity_);
+    }
+
+    elements_ = new_elements;
+    capacity_ = n;
+  }
+
+  template <class... Args>
+  NANOSTL_HOST_AND_DEVICE_QUAL void __grow_and_emplace(Args&&... args) {
+    size_type n = (size_ + 1 > recommended_size()) ? size_ + 1
+                                                   : recommended_size();
+    value_type* new_elements = alloc_traits::allocate(alloc_, n);
+
+    alloc_traits::construct(alloc_, new_elements + size_,
+                            nanostl::forward<Args>(args)...);
+    __relocate(new_elements, elements_, size_,
+               integral_constant<bool, is_trivially_copyable<T>::value>());
+
+    if (elements_) {
+      alloc_traits::deallocate(alloc_, elements_, capacity_);
+    }
+
+    elements_ = new_elements;
+    capacity_ = n;
+    size_++;
+  }
+
   T* elements_;
   size_type capacity_;
   size_type size_;
+  allocator_type alloc_;
 };
 
 template <class T, class Allocator>
 inline vector<T, Allocator>& vector<T, Allocator>::operator=(
     const vector<T, Allocator>& rhs) {
   if (this != &rhs) {
+    reserve(rhs.size());
     assign(rhs.begin(), rhs.end());
   }
   return *this;
 }
 
+template <class T, class Allocator>
+inline vector<T, Allocator>& vector<T, Allocator>::operator=(
+    vector<T, Allocator>&& rhs) {
+  if (this != &rhs) {
+    vector<T, Allocator> tmp(nanostl::move(rhs));
+    swap(tmp);
+  }
+  return *this;
+}
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
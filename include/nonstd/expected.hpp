@@ -102,17 +102,9 @@
 #define nsel_CPP17_OR_GREATER  ( nsel_CPLUSPLUS >= 201703L )
 #define nsel_CPP20_OR_GREATER  ( nsel_CPLUSPLUS >= 202000L )
 
-// Use C++20 std::expected if available and requested:
+// nanostl never forwards to C++20 std::expected:
 
-#if nsel_CPP20_OR_GREATER && defined(__has_include )
-# if __has_include( <expected> )
-#  define nsel_HAVE_STD_EXPECTED  1
-# else
-#  define nsel_HAVE_STD_EXPECTED  0
-# endif
-#else
-# define  nsel_HAVE_STD_EXPECTED  0
-#endif
+#define  nsel_HAVE_STD_EXPECTED  0
 
 #define  nsel_USES_STD_EXPECTED  ( (nsel_CONFIG_SELECT_EXPECTED == nsel_EXPECTED_STD) || ((nsel_CONFIG_SELECT_EXPECTED == nsel_EXPECTED_DEFAULT) && nsel_HAVE_STD_EXPECTED) )
 
@@ -123,11 +115,12 @@
 #ifndef nonstd_lite_HAVE_IN_PLACE_TYPES
 #define nonstd_lite_HAVE_IN_PLACE_TYPES  1
 
-// C++17 std::in_place in <utility>:
+// C++17 std::in_place in <utility>(not provided by nanostl yet, so the
+// C++11 emulation below is always used):
 
-#if nsel_CPP17_OR_GREATER
+#if 0 // nsel_CPP17_OR_GREATER
 
-#include <utility>
+#include "nanoutility.h"
 
 namespace nonstd {
 
@@ -150,7 +143,7 @@ using nanostl::in_place_index_t;
 
 #else // nsel_CPP17_OR_GREATER
 
-#include <cstddef>
+#include "nanocommon.h"
 
 namespace nonstd {
 namespace detail {
@@ -220,6 +213,7 @@ namespace nonstd {
 
 #else // nsel_USES_STD_EXPECTED
 
+#include "nanoallocator.h"
 #include "nanocassert.h"
 #include "nanoexception.h"
 #include "nanofunctional.h"
@@ -239,7 +233,7 @@ namespace nonstd {
 // already included: <cassert>
 # endif
 #else
-# include "nanostdexcept.h"
+# include "nanoexception.h"
 #endif
 
 // C++ feature usage:
@@ -365,7 +359,8 @@ namespace nonstd { namespace expected_lite {
 
 namespace std17 {
 
-#if nsel_CPP17_OR_GREATER
+// nanostl does not provide the C++17 traits yet; use the emulation.
+#if 0 // nsel_CPP17_OR_GREATER
 
 using nanostl::conjunction;
 using nanostl::is_swappable;
@@ -428,7 +423,8 @@ struct conjunction<B1, Bn...> : nanostl::conditional<bool(B1::value), conjunctio
 
 namespace std20 {
 
-#if nsel_CPP20_OR_GREATER
+// nanostl does not provide remove_cvref yet; use the emulation.
+#if 0 // nsel_CPP20_OR_GREATER
 
 using nanostl::remove_cvref;
 
@@ -472,24 +468,24 @@ public:
 
     void construct_value( value_type const & e )
     {
-        new( &m_value ) value_type( e );
+        ::new( nanostl::__placement_tag(), &m_value ) value_type( e );
     }
 
     void construct_value( value_type && e )
     {
-        new( &m_value ) value_type( nanostl::move( e ) );
+        ::new( nanostl::__placement_tag(), &m_value ) value_type( nanostl::move( e ) );
     }
 
     template< class... Args >
     void emplace_value( Args&&... args )
     {
-        new( &m_value ) value_type( nanostl::forward<Args>(args)...);
+        ::new( nanostl::__placement_tag(), &m_value ) value_type( nanostl::forward<Args>(args)...);
     }
 
     template< class U, class... Args >
     void emplace_value( nanostl::initializer_list<U> il, Args&&... args )
     {
-        new( &m_value ) value_type( il, nanostl::forward<Args>(args)... );
+        ::new( nanostl::__placement_tag(), &m_value ) value_type( il, nanostl::forward<Args>(args)... );
     }
 
     void destruct_value()
@@ -499,24 +495,24 @@ public:
 
     void construct_error( error_type const & e )
     {
-        new( &m_error ) error_type( e );
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( e );
     }
 
     void construct_error( error_type && e )
     {
-        new( &m_error ) error_type( nanostl::move( e ) );
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( nanostl::move( e ) );
     }
 
     template< class... Args >
     void emplace_error( Args&&... args )
     {
-        new( &m_error ) error_type( nanostl::forward<Args>(args)...);
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( nanostl::forward<Args>(args)...);
     }
 
     template< class U, class... Args >
     void emplace_error( nanostl::initializer_list<U> il, Args&&... args )
     {
-        new( &m_error ) error_type( il, nanostl::forward<Args>(args)... );
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( il, nanostl::forward<Args>(args)... );
     }
 
     void destruct_error()
@@ -615,24 +611,24 @@ public:
 
     void construct_error( error_type const & e )
     {
-        new( &m_error ) error_type( e );
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( e );
     }
 
     void construct_error( error_type && e )
     {
-        new( &m_error ) error_type( nanostl::move( e ) );
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( nanostl::move( e ) );
     }
 
     template< class... Args >
     void emplace_error( Args&&... args )
     {
-        new( &m_error ) error_type( nanostl::forward<Args>(args)...);
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( nanostl::forward<Args>(args)...);
     }
 
     template< class U, class... Args >
     void emplace_error( nanostl::initializer_list<U> il, Args&&... args )
     {
-        new( &m_error ) error_type( il, nanostl::forward<Args>(args)... );
+        ::new( nanostl::__placement_tag(), &m_error ) error_type( il, nanostl::forward<Args>(args)... );
     }
 
     void destruct_error()
@@ -1281,34 +1277,11 @@ struct error_traits
     }
 };
 
-template<>
-struct error_traits< nanostl::exception_ptr >
-{
-    static void rethrow( nanostl::exception_ptr const & /*e*/ )
-    {
-#if nsel_CONFIG_NO_EXCEPTIONS_SEH
-        RaiseException( EXCEPTION_ACCESS_VIOLATION, EXCEPTION_NONCONTINUABLE, 0, NULL );
-#else
-        assert( false && detail::text("throw bad_expected_access<nanostl::exception_ptr>{ e };") );
-#endif
-    }
-};
-
-template<>
-struct error_traits< nanostl::error_code >
-{
-    static void rethrow( nanostl::error_code const & /*e*/ )
-    {
-#if nsel_CONFIG_NO_EXCEPTIONS_SEH
-        RaiseException( EXCEPTION_ACCESS_VIOLATION, EXCEPTION_NONCONTINUABLE, 0, NULL );
-#else
-        assert( false && detail::text("throw nanostl::system_error( e );") );
-#endif
-    }
-};
-
 #else // nsel_CONFIG_NO_EXCEPTIONS
 
+// NOTE: nanostl has no exception_ptr and error_code, so their
+// error_traits specializations are omitted.
+
 template< typename Error >
 struct error_traits
 {
@@ -1318,29 +1291,11 @@ struct error_traits
     }
 };
 
-template<>
-struct error_traits< nanostl::exception_ptr >
-{
-    static void rethrow( nanostl::exception_ptr const & e )
-    {
-        nanostl::rethrow_exception( e );
-    }
-};
-
-template<>
-struct error_traits< nanostl::error_code >
-{
-    static void rethrow( nanostl::error_code const & e )
-    {
-        throw nanostl::system_error( e );
-    }
-};
-
 #endif // nsel_CONFIG_NO_EXCEPTIONS
 
 } // namespace expected_lite
 
-// provide nanostl::unexpected_type:
+// provide nonstd::unexpected_type:
 
 using expected_lite::unexpected_type;
 
@@ -1362,7 +1317,7 @@ private:
 public:
     using value_type = T;
     using error_type = E;
-    using unexpected_type = nanostl::unexpected_type<E>;
+    using unexpected_type = nonstd::unexpected_type<E>;
 
     template< typename U >
     struct rebind
@@ -1488,7 +1443,7 @@ public:
             nanostl::is_constructible<T,U&&>::value
             && !nanostl::is_same<typename std20::remove_cvref<U>::type, nonstd_lite_in_place_t(U)>::value
             && !nanostl::is_same<        expected<T,E>     , typename std20::remove_cvref<U>::type>::value
-            && !nanostl::is_same<nanostl::unexpected_type<E>, typename std20::remove_cvref<U>::type>::value
+            && !nanostl::is_same<nonstd::unexpected_type<E>, typename std20::remove_cvref<U>::type>::value
             && !nanostl::is_convertible<U&&,T>::value /*=> explicit */
         )
     >
@@ -1507,7 +1462,7 @@ public:
             nanostl::is_constructible<T,U&&>::value
             && !nanostl::is_same<typename std20::remove_cvref<U>::type, nonstd_lite_in_place_t(U)>::value
             && !nanostl::is_same<        expected<T,E>     , typename std20::remove_cvref<U>::type>::value
-            && !nanostl::is_same<nanostl::unexpected_type<E>, typename std20::remove_cvref<U>::type>::value
+            && !nanostl::is_same<nonstd::unexpected_type<E>, typename std20::remove_cvref<U>::type>::value
             &&  nanostl::is_convertible<U&&,T>::value /*=> non-explicit */
         )
     >
@@ -1529,7 +1484,7 @@ public:
             && !nanostl::is_convertible< G const &, E>::value /*=> explicit */
         )
     >
-    nsel_constexpr14 explicit expected( nanostl::unexpected_type<G> const & error )
+    nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> const & error )
     : contained( false )
     {
         contained.construct_error( E{ error.value() } );
@@ -1541,7 +1496,7 @@ public:
             && nanostl::is_convertible<  G const &, E>::value /*=> non-explicit */
         )
     >
-    nsel_constexpr14 /*non-explicit*/ expected( nanostl::unexpected_type<G> const & error )
+    nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> const & error )
     : contained( false )
     {
         contained.construct_error( error.value() );
@@ -1553,7 +1508,7 @@ public:
             && !nanostl::is_convertible< G&&, E>::value /*=> explicit */
         )
     >
-    nsel_constexpr14 explicit expected( nanostl::unexpected_type<G> && error )
+    nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> && error )
     : contained( false )
     {
         contained.construct_error( E{ nanostl::move( error.value() ) } );
@@ -1565,7 +1520,7 @@ public:
             && nanostl::is_convertible<  G&&, E>::value /*=> non-explicit */
         )
     >
-    nsel_constexpr14 /*non-explicit*/ expected( nanostl::unexpected_type<G> && error )
+    nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> && error )
     : contained( false )
     {
         contained.construct_error( nanostl::move( error.value() ) );
@@ -1670,7 +1625,7 @@ public:
             && nanostl::is_copy_assignable<E>::value
         )
     >
-    expected & operator=( nanostl::unexpected_type<G> const & error )
+    expected & operator=( nonstd::unexpected_type<G> const & error )
     {
         expected( unexpect, error.value() ).swap( *this );
         return *this;
@@ -1682,7 +1637,7 @@ public:
             && nanostl::is_move_assignable<E>::value
         )
     >
-    expected & operator=( nanostl::unexpected_type<G> && error )
+    expected & operator=( nonstd::unexpected_type<G> && error )
     {
         expected( unexpect, nanostl::move( error.value() ) ).swap( *this );
         return *this;
@@ -1934,7 +1889,7 @@ private:
 public:
     using value_type = void;
     using error_type = E;
-    using unexpected_type = nanostl::unexpected_type<E>;
+    using unexpected_type = nonstd::unexpected_type<E>;
 
     // x.x.4.1 constructors
 
@@ -1954,7 +1909,7 @@ public:
             !nanostl::is_convertible<G const &, E>::value /*=> explicit */
         )
     >
-    nsel_constexpr14 explicit expected( nanostl::unexpected_type<G> const & error )
+    nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> const & error )
         : contained( false )
     {
         contained.construct_error( E{ error.value() } );
@@ -1965,7 +1920,7 @@ public:
             nanostl::is_convertible<G const &, E>::value /*=> non-explicit */
         )
     >
-    nsel_constexpr14 /*non-explicit*/ expected( nanostl::unexpected_type<G> const & error )
+    nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> const & error )
         : contained( false )
     {
         contained.construct_error( error.value() );
@@ -1976,7 +1931,7 @@ public:
             !nanostl::is_convertible<G&&, E>::value /*=> explicit */
         )
     >
-    nsel_constexpr14 explicit expected( nanostl::unexpected_type<G> && error )
+    nsel_constexpr14 explicit expected( nonstd::unexpected_type<G> && error )
         : contained( false )
     {
         contained.construct_error( E{ nanostl::move( error.value() ) } );
@@ -1987,7 +1942,7 @@ public:
             nanostl::is_convertible<G&&, E>::value /*=> non-explicit */
         )
     >
-    nsel_constexpr14 /*non-explicit*/ expected( nanostl::unexpected_type<G> && error )
+    nsel_constexpr14 /*non-explicit*/ expected( nonstd::unexpected_type<G> && error )
         : contained( false )
     {
         contained.construct_error( nanostl::move( error.value() ) );
@@ -2411,10 +2366,10 @@ constexpr auto make_expected_from_error( E e ) -> expected<T, typename nanostl::
 }
 
 template< typename F
-    nsel_REQUIRES_T( ! nanostl::is_same<typename nanostl::result_of<F()>::type, void>::value )
+    nsel_REQUIRES_T( ! nanostl::is_same<decltype( nanostl::declval<F&>()() ), void>::value )
 >
 /*nsel_constexpr14*/
-auto make_expected_from_call( F f ) -> expected< typename nanostl::result_of<F()>::type >
+auto make_expected_from_call( F f ) -> expected< decltype( nanostl::declval<F&>()() ) >
 {
     try
     {
@@ -2427,7 +2382,7 @@ auto make_expected_from_call( F f ) -> expected< typename nanostl::result_of<F()
 }
 
 template< typename F
-    nsel_REQUIRES_T( nanostl::is_same<typename nanostl::result_of<F()>::type, void>::value )
+    nsel_REQUIRES_T( nanostl::is_same<decltype( nanostl::declval<F&>()() ), void>::value )
 >
 /*nsel_constexpr14*/
 auto make_expected_from_call( F f ) -> expected<void>
@@ -2454,15 +2409,15 @@ using namespace expected_lite;
 
 } // namespace nonstd
 
-namespace std {
+namespace nanostl {
 
 // expected: hash support
 
 template< typename T, typename E >
-struct hash< nanostl::expected<T,E> >
+struct hash< nonstd::expected<T,E> >
 {
     using result_type = nanostl::size_t;
-    using argument_type = nanostl::expected<T,E>;
+    using argument_type = nonstd::expected<T,E>;
 
     constexpr result_type operator()(argument_type const & arg) const
     {
@@ -2472,10 +2427,10 @@ struct hash< nanostl::expected<T,E> >
 
 // TBD - ?? remove? see spec.
 template< typename T, typename E >
-struct hash< nanostl::expected<T&,E> >
+struct hash< nonstd::expected<T&,E> >
 {
     using result_type = nanostl::size_t;
-    using argument_type = nanostl::expected<T&,E>;
+    using argument_type = nonstd::expected<T&,E>;
 
     constexpr result_type operator()(argument_type const & arg) const
     {
@@ -2489,11 +2444,11 @@ struct hash< nanostl::expected<T&,E> >
 // a combination of hashing false and hash<E>()(e.error()).
 
 template< typename E >
-struct hash< nanostl::expected<void,E> >
+struct hash< nonstd::expected<void,E> >
 {
 };
 
-} // namespace std
+} // namespace nanostl
 
 namespace nonstd {
 
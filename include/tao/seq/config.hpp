@@ -7,9 +7,11 @@
 //#include <utility>
 
 #ifndef TAO_SEQ_USE_STD_INTEGER_SEQUENCE
-#if defined( __cpp_lib_integer_sequence )
+// The std library headers included next to nanostl do not provide these in
+// namespace nanostl. Disabled for nanostl
+#if 0 // defined( __cpp_lib_integer_sequence )
 #define TAO_SEQ_USE_STD_INTEGER_SEQUENCE
-#elif defined( _LIBCPP_VERSION ) && ( __cplusplus >= 201402L )
+#elif 0 // defined( _LIBCPP_VERSION ) && ( __cplusplus >= 201402L )
 #define TAO_SEQ_USE_STD_INTEGER_SEQUENCE
 #elif defined( _MSC_VER )
 // Disabled for nanostl
@@ -18,9 +20,10 @@
 #endif
 
 #ifndef TAO_SEQ_USE_STD_MAKE_INTEGER_SEQUENCE
-#if defined( _GLIBCXX_RELEASE ) && ( _GLIBCXX_RELEASE >= 8 ) && ( __cplusplus >= 201402L )
+// Disabled for nanostl
+#if 0 // defined( _GLIBCXX_RELEASE ) && ( _GLIBCXX_RELEASE >= 8 ) && ( __cplusplus >= 201402L )
 #define TAO_SEQ_USE_STD_MAKE_INTEGER_SEQUENCE
-#elif defined( _LIBCPP_VERSION ) && ( __cplusplus >= 201402L )
+#elif 0 // defined( _LIBCPP_VERSION ) && ( __cplusplus >= 201402L )
 #define TAO_SEQ_USE_STD_MAKE_INTEGER_SEQUENCE
 #elif defined( _MSC_VER ) && ( _MSC_FULL_VER >= 190023918 )
 // Disabled for nanostl
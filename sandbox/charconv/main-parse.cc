@@ -0,0 +1,188 @@
+//
+// Float parsing benchmark.
+//
+// Compares double parse throughput of ryu s2d_n(the previous stod
+// backend), from_chars(fast_float), stod and libc strtod on a few kinds of
+// input: shortest round-trip doubles, shortest round-trip floats(short
+// mantissas), fixed decimals("123.45") and integers. Also counts results
+// that differ from strtod, so a speedup can not hide a correctness
+// regression.
+//
+// Results are written to stdout as JSON Lines(one object per line):
+//
+//   $ ./parse-bench > before.jsonl
+//   $ ./parse-bench --quick
+//
+#include "nanocharconv.h"
+#include "nanostring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+typedef unsigned long long u64;
+
+volatile double g_sink;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+}
+
+u64 splitmix64(u64 *state) {
+  u64 z = (*state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// Input strings, stored back to back with their lengths.
+struct Dataset {
+  const char *name;
+  nanostl::vector<char> text;
+  nanostl::vector<int> offsets;  // size() == count + 1
+  nanostl::vector<nanostl::string> strings;
+
+  size_t count() const { return offsets.size() - 1; }
+  const char *str(size_t i) const { return &text[0] + offsets[i]; }
+  int len(size_t i) const { return offsets[i + 1] - offsets[i] - 1; }
+
+  void add(const char *s) {
+    if (offsets.empty()) offsets.push_back(0);
+    size_t n = strlen(s);
+    for (size_t i = 0; i <= n; i++) text.push_back(s[i]);  // keep the '\0'
+    offsets.push_back(int(text.size()));
+    strings.push_back(nanostl::string(s));
+  }
+};
+
+void make_datasets(Dataset *sets, size_t n) {
+  u64 seed = 42;
+  char buf[64];
+  sets[0].name = "double-shortest";
+  sets[1].name = "float-shortest";
+  sets[2].name = "fixed-2";
+  sets[3].name = "integer";
+  for (size_t i = 0; i < n; i++) {
+    u64 r = splitmix64(&seed);
+    double d;
+    memcpy(&d, &r, sizeof(d));
+    if (d != d || d - d != 0.0) d = double(r >> 12);  // skip nan/inf
+    nanostl::to_chars_result t = nanostl::to_chars(buf, buf + 63, d);
+    *t.ptr = '\0';
+    sets[0].add(buf);
+
+    float f = float(int64_t(r)) * 1e-9f;
+    t = nanostl::to_chars(buf, buf + 63, f);
+    *t.ptr = '\0';
+    sets[1].add(buf);
+
+    snprintf(buf, sizeof(buf), "%lld.%02d", (long long)(r % 100000),
+             int((r >> 20) % 100));
+    sets[2].add(buf);
+
+    snprintf(buf, sizeof(buf), "%lld", (long long)((r >> 8) % 10000000));
+    sets[3].add(buf);
+  }
+}
+
+// Minimum wall time per measurement.
+double g_min_time = 0.2;
+
+// Parses the whole dataset `rounds` times per measurement, doubling until
+// a measurement takes g_min_time. Reports the fastest of three runs.
+typedef double (*parse_fn)(const Dataset &, size_t);
+
+void measure(const char *parser, const Dataset &ds, parse_fn parse) {
+  // Results differing from strtod(bitwise, so -0.0 and 0.0 differ).
+  u64 mismatches = 0;
+  for (size_t i = 0; i < ds.count(); i++) {
+    double ref = strtod(ds.str(i), 0);
+    double v = parse(ds, i);
+    if (memcmp(&v, &ref, sizeof(v)) != 0) mismatches++;
+  }
+
+  u64 rounds = 1;
+  double t;
+  for (;;) {
+    double t0 = now_sec();
+    double acc = 0.0;
+    for (u64 r = 0; r < rounds; r++) {
+      for (size_t i = 0; i < ds.count(); i++) acc += parse(ds, i);
+    }
+    g_sink = acc;
+    t = now_sec() - t0;
+    if (t >= g_min_time) break;
+    rounds *= (t < g_min_time / 16) ? 8 : 2;
+  }
+  for (int k = 0; k < 2; k++) {
+    double t0 = now_sec();
+    double acc = 0.0;
+    for (u64 r = 0; r < rounds; r++) {
+      for (size_t i = 0; i < ds.count(); i++) acc += parse(ds, i);
+    }
+    g_sink = acc;
+    double tk = now_sec() - t0;
+    if (tk < t) t = tk;
+  }
+
+  double n = double(rounds) * double(ds.count());
+  double bytes = double(rounds) * double(ds.text.size() - ds.count());
+  printf(
+      "{\"kind\":\"parse\",\"parser\":\"%s\",\"input\":\"%s\","
+      "\"count\":%llu,\"ns_per_value\":%.3f,\"values_per_sec\":%.1f,"
+      "\"bytes_per_sec\":%.1f,\"mismatches\":%llu}\n",
+      parser, ds.name, u64(ds.count()), 1e9 * t / n, n / t, bytes / t,
+      mismatches);
+  fflush(stdout);
+}
+
+double ryu_d(const Dataset &ds, size_t i) {
+  double v = 0.0;
+  nanostl::ryu::s2d_n(ds.str(i), ds.len(i), &v);
+  return v;
+}
+
+double fast_float_d(const Dataset &ds, size_t i) {
+  double v = 0.0;
+  nanostl::from_chars(ds.str(i), ds.str(i) + ds.len(i), v);
+  return v;
+}
+
+double stod_d(const Dataset &ds, size_t i) {
+  return nanostl::stod(ds.strings[i]);
+}
+
+double strtod_d(const Dataset &ds, size_t i) {
+  return strtod(ds.str(i), 0);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool quick = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0) {
+      quick = true;
+    } else {
+      fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (quick) g_min_time = 0.02;
+
+  static Dataset sets[4];
+  make_datasets(sets, quick ? 10000 : 100000);
+
+  for (int s = 0; s < 4; s++) {
+    measure("ryu::s2d_n", sets[s], ryu_d);
+    measure("from_chars<double>", sets[s], fast_float_d);
+    measure("stod", sets[s], stod_d);
+    measure("strtod", sets[s], strtod_d);
+  }
+  return EXIT_SUCCESS;
+}
@@ -1,16 +1,375 @@
+//
+// Hash benchmark.
+//
+// Measures throughput of the byte hashers(SipHash-2-4, the default wyhash
+// style __hash_bytes) for input sizes from 1 byte to 1 MB, and of
+// hash<int/float/double/T*>. Then checks distribution quality: avalanche
+// (how many output bits flip per flipped input bit) and bucket collisions
+// when the low bits of the hash index a power-of-two table.
+//
+// Results are written to stdout as JSON Lines(one object per line, `"kind"`
+// tells the record type), so runs can be diffed or loaded into a script:
+//
+//   $ ./hash-bench > before.jsonl
+//   $ ./hash-bench --quick | grep '"kind":"throughput"'
+//
 #include "nanofunctional.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
-int main(int argc, char **argv)
-{
-  auto h = nanostl::hash<int>{}(argc);
-  auto f = nanostl::hash<float>{}(1.3f);
-  auto d = nanostl::hash<double>{}(1.5);
+namespace {
 
-  printf("argc = %llu\n", h);
-  printf("f = %llu\n", f);
-  printf("d = %llu\n", d);
+typedef unsigned long long u64;
 
-  return 0;
+volatile u64 g_sink;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+}
+
+u64 splitmix64(u64 *state) {
+  u64 z = (*state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+const nanostl::uint8_t kSipKey[16] = {0, 1, 2,  3,  4,  5,  6,  7,
+                                      8, 9, 10, 11, 12, 13, 14, 15};
+
+u64 sip_bytes(const void *p, size_t len) {
+  u64 out;
+  nanostl::siphash(static_cast<const nanostl::uint8_t *>(p), len, kSipKey,
+                   reinterpret_cast<nanostl::uint8_t *>(&out), 8);
+  return out;
+}
+
+u64 default_bytes(const void *p, size_t len) {
+  return nanostl::__hash_bytes(p, len);
+}
+
+typedef u64 (*bytes_fn)(const void *, size_t);
+
+struct ByteHasher {
+  const char *name;
+  bytes_fn fn;
+};
+
+const ByteHasher kByteHashers[] = {
+    {"siphash", sip_bytes},
+    {"hash_bytes", default_bytes},
+};
+const int kNumByteHashers = sizeof(kByteHashers) / sizeof(kByteHashers[0]);
+
+// Minimum wall time per measurement.
+double g_min_time = 0.2;
+
+// Runs `iters` hashes per round, doubling until a round takes g_min_time.
+// Reports the fastest of three rounds.
+template <class Bench>
+void measure(const char *hasher, size_t size, Bench bench) {
+  u64 iters = 1;
+  double t;
+  for (;;) {
+    double t0 = now_sec();
+    bench(iters);
+    t = now_sec() - t0;
+    if (t >= g_min_time) break;
+    iters *= (t < g_min_time / 16) ? 8 : 2;
+  }
+  for (int r = 0; r < 2; r++) {
+    double t0 = now_sec();
+    bench(iters);
+    double tr = now_sec() - t0;
+    if (tr < t) t = tr;
+  }
+
+  double hps = double(iters) / t;
+  printf(
+      "{\"kind\":\"throughput\",\"hasher\":\"%s\",\"size\":%llu,"
+      "\"iterations\":%llu,\"ns_per_hash\":%.3f,\"hashes_per_sec\":%.1f,"
+      "\"bytes_per_sec\":%.1f}\n",
+      hasher, u64(size), iters, 1e9 / hps, hps, hps * double(size));
+  fflush(stdout);
+}
+
+void bench_bytes(const ByteHasher &h, size_t size) {
+  // Rotate through several buffers so short keys are not served from a
+  // single cache line, and vary one byte per call so the call cannot be
+  // hoisted out of the loop.
+  const size_t kBuffers = size <= 4096 ? 64 : 1;
+  nanostl::uint8_t *buf =
+      static_cast<nanostl::uint8_t *>(malloc(size * kBuffers));
+  u64 seed = 1;
+  for (size_t i = 0; i < size * kBuffers; i++) {
+    buf[i] = nanostl::uint8_t(splitmix64(&seed));
+  }
+
+  measure(h.name, size, [&](u64 iters) {
+    u64 acc = 0;
+    for (u64 i = 0; i < iters; i++) {
+      nanostl::uint8_t *p = buf + (i % kBuffers) * size;
+      p[0] = nanostl::uint8_t(i);
+      acc += h.fn(p, size);
+    }
+    g_sink = acc;
+  });
+
+  free(buf);
+}
+
+template <class T>
+void bench_scalar(const char *name, const T *keys, size_t n) {
+  nanostl::hash<T> h;
+  measure(name, sizeof(T), [&](u64 iters) {
+    u64 acc = 0;
+    for (u64 i = 0; i < iters; i++) {
+      acc += h(keys[i & (n - 1)]);
+    }
+    g_sink = acc;
+  });
+}
+
+//
+// Avalanche: for random inputs, flip each input bit and count how often each
+// output bit changes. An ideal hash flips every output bit with probability
+// 0.5; `worst_bias` is the largest |p - 0.5| over all(input, output) bit
+// pairs.
+//
+template <class Fn>
+void avalanche(const char *hasher, size_t in_bytes, Fn fn, int samples) {
+  const int in_bits = int(in_bytes * 8);
+  static u64 flips[256 * 8][64];
+  memset(flips, 0, sizeof(flips));
+
+  nanostl::uint8_t key[256];
+  u64 seed = 42;
+  u64 total = 0;
+  for (int s = 0; s < samples; s++) {
+    for (size_t i = 0; i < in_bytes; i++) {
+      key[i] = nanostl::uint8_t(splitmix64(&seed));
+    }
+    u64 h0 = fn(key);
+    for (int b = 0; b < in_bits; b++) {
+      key[b >> 3] ^= nanostl::uint8_t(1u << (b & 7));
+      u64 d = h0 ^ fn(key);
+      key[b >> 3] ^= nanostl::uint8_t(1u << (b & 7));
+      total += u64(__builtin_popcountll(d));
+      for (int o = 0; o < 64; o++) {
+        flips[b][o] += (d >> o) & 1;
+      }
+    }
+  }
+
+  double worst = 0.0;
+  for (int b = 0; b < in_bits; b++) {
+    for (int o = 0; o < 64; o++) {
+      double bias = double(flips[b][o]) / samples - 0.5;
+      if (bias < 0) bias = -bias;
+      if (bias > worst) worst = bias;
+    }
+  }
+
+  printf(
+      "{\"kind\":\"avalanche\",\"hasher\":\"%s\",\"size\":%llu,"
+      "\"samples\":%d,\"mean_flipped_bits\":%.3f,\"worst_bias\":%.4f}\n",
+      hasher, u64(in_bytes), samples,
+      double(total) / (double(samples) * in_bits), worst);
+  fflush(stdout);
+}
+
+//
+// Collisions: insert `n` keys into a table of 2^log2_buckets buckets indexed
+// by the low bits of the hash, compare with the count expected from a
+// uniformly random hash, and report the longest chain.
+//
+template <class KeyFn, class HashFn>
+void collisions(const char *hasher, const char *keyset, int log2_buckets,
+                u64 n, KeyFn key_at, HashFn fn) {
+  const u64 m = 1ull << log2_buckets;
+  unsigned *count = static_cast<unsigned *>(calloc(m, sizeof(unsigned)));
+
+  for (u64 i = 0; i < n; i++) {
+    count[fn(key_at(i)) & (m - 1)]++;
+  }
+
+  u64 used = 0;
+  unsigned longest = 0;
+  for (u64 i = 0; i < m; i++) {
+    if (count[i]) used++;
+    if (count[i] > longest) longest = count[i];
+  }
+  free(count);
+
+  // E[used] = m * (1 - (1 - 1/m)^n)
+  double p_empty = 1.0;
+  {
+    double q = 1.0 - 1.0 / double(m);
+    u64 e = n;
+    double base = q;
+    while (e) {
+      if (e & 1) p_empty *= base;
+      base *= base;
+      e >>= 1;
+    }
+  }
+  double expected = double(n) - double(m) * (1.0 - p_empty);
+  u64 observed = n - used;
+
+  printf(
+      "{\"kind\":\"collisions\",\"hasher\":\"%s\",\"keys\":\"%s\","
+      "\"buckets\":%llu,\"n\":%llu,\"collisions\":%llu,"
+      "\"expected\":%.1f,\"ratio\":%.3f,\"longest_chain\":%u}\n",
+      hasher, keyset, m, n, observed, expected,
+      expected > 0 ? double(observed) / expected : 0.0, longest);
+  fflush(stdout);
+}
+
+template <class T>
+u64 hash_of(const nanostl::uint8_t *p) {
+  T v;
+  memcpy(&v, p, sizeof(T));
+  return nanostl::hash<T>()(v);
+}
+
+struct IntKey {
+  u64 stride;
+  int operator()(u64 i) const { return int(i * stride); }
+};
+
+struct FloatKey {
+  float scale;
+  float operator()(u64 i) const { return float(i) * scale; }
+};
+
+struct DoubleKey {
+  double scale;
+  double operator()(u64 i) const { return double(i) * scale; }
+};
+
+struct PtrKey {
+  int *operator()(u64 i) const {
+    // Addresses of 16-byte aligned heap objects.
+    return reinterpret_cast<int *>(0x10000000ull + i * 16);
+  }
+};
+
+struct TextKey {
+  char *buf;
+  const char *operator()(u64 i) const {
+    snprintf(buf, 32, "key%llu", i);
+    return buf;
+  }
+};
+
+struct TextHash {
+  bytes_fn fn;
+  u64 operator()(const char *s) const { return fn(s, strlen(s)); }
+};
+
+template <class T>
+struct ScalarHash {
+  u64 operator()(T v) const { return nanostl::hash<T>()(v); }
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool quick = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0) {
+      quick = true;
+    } else {
+      fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (quick) g_min_time = 0.02;
+
+  //
+  // Throughput
+  //
+  for (int h = 0; h < kNumByteHashers; h++) {
+    for (size_t size = 1; size <= 1024 * 1024; size *= 2) {
+      bench_bytes(kByteHashers[h], size);
+      // Odd lengths exercise the tail handling.
+      if (size >= 4 && size <= 64) {
+        bench_bytes(kByteHashers[h], size + size / 2 - 1);
+      }
+    }
+  }
+
+  {
+    const size_t n = 4096;
+    static int ints[n];
+    static float floats[n];
+    static double doubles[n];
+    static int *ptrs[n];
+    u64 seed = 7;
+    for (size_t i = 0; i < n; i++) {
+      u64 r = splitmix64(&seed);
+      ints[i] = int(r);
+      floats[i] = float(r >> 40) * 0.25f;
+      doubles[i] = double(r >> 11) * 0.5;
+      ptrs[i] = &ints[i];
+    }
+    bench_scalar("hash<int>", ints, n);
+    bench_scalar("hash<float>", floats, n);
+    bench_scalar("hash<double>", doubles, n);
+    bench_scalar("hash<int*>", ptrs, n);
+  }
+
+  //
+  // Avalanche
+  //
+  const int samples = quick ? 200 : 2000;
+  avalanche("hash<int>", sizeof(int), hash_of<int>, samples);
+  avalanche("hash<float>", sizeof(float), hash_of<float>, samples);
+  avalanche("hash<double>", sizeof(double), hash_of<double>, samples);
+  {
+    const size_t sizes[] = {3, 8, 16, 64, 256};
+    for (int h = 0; h < kNumByteHashers; h++) {
+      for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        bytes_fn fn = kByteHashers[h].fn;
+        size_t len = sizes[s];
+        avalanche(kByteHashers[h].name, len,
+                  [fn, len](const nanostl::uint8_t *p) { return fn(p, len); },
+                  quick ? samples / 10 : samples / 4);
+      }
+    }
+  }
+
+  //
+  // Power-of-two table collisions, load factor 0.5
+  //
+  const int lg = quick ? 16 : 20;
+  const u64 n = (1ull << lg) / 2;
+
+  IntKey seq = {1}, strided = {1024};
+  collisions("hash<int>", "sequential", lg, n, seq, ScalarHash<int>());
+  collisions("hash<int>", "stride1024", lg, n, strided, ScalarHash<int>());
+
+  FloatKey fint = {1.0f}, fsmall = {0.001f};
+  collisions("hash<float>", "integers", lg, n, fint, ScalarHash<float>());
+  collisions("hash<float>", "step0.001", lg, n, fsmall, ScalarHash<float>());
+
+  DoubleKey dint = {1.0}, dhalf = {0.5};
+  collisions("hash<double>", "integers", lg, n, dint, ScalarHash<double>());
+  collisions("hash<double>", "step0.5", lg, n, dhalf, ScalarHash<double>());
+
+  collisions("hash<int*>", "aligned16", lg, n, PtrKey(), ScalarHash<int *>());
+
+  char text[32];
+  TextKey tk = {text};
+  for (int h = 0; h < kNumByteHashers; h++) {
+    TextHash th = {kByteHashers[h].fn};
+    collisions(kByteHashers[h].name, "text", lg, n, tk, th);
+  }
+
+  return EXIT_SUCCESS;
 }
@@ -2,14 +2,17 @@
 #error "NANOSTL_PSTL must be defined"
 #endif
 
+#include <stdio.h>
+
 #include "nanoexecution.h"
 #include "nanovector.h"
 #include "nanoalgorithm.h"
 
-#include <stdio.h>
-
 int main(int argc, char **argv)
 {
+  (void)argc;
+  (void)argv;
+
   nanostl::vector<double> a;
   a.resize(13);
   nanostl::fill(nanostl::execution::par_unseq, a.begin(), a.end(), 42.0);
@@ -18,5 +21,17 @@ int main(int argc, char **argv)
     printf("a[%d] = %g\n", i, a[i]);
   }
 
+  // Large enough to be split across the thread pool.
+  nanostl::vector<float> b;
+  b.resize(1 << 24);
+  nanostl::fill(nanostl::execution::par_unseq, b.begin(), b.end(), 1.5f);
+  nanostl::fill(nanostl::execution::seq, b.begin(), b.begin() + 8, 0.0f);
+
+  size_t n = 0;
+  for (size_t i = 0; i < b.size(); i++) {
+    n += (b[i] == 1.5f) ? 1 : 0;
+  }
+  printf("%d of %d filled in parallel\n", int(n), int(b.size()));
+
   return 0;
 }
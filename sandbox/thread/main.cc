@@ -1,9 +1,32 @@
+#include <stdio.h>
+
 #include "nanothread.h"
+#include "nanothread_pool.h"
+
+static void hello(int i)
+{
+  printf("hello from thread %d\n", i);
+}
 
 int main(int argc, char **argv)
 {
-  nanostl::thread th;
+  (void)argc;
+  (void)argv;
+
+  nanostl::thread th(hello, 0);
+  th.join();
+
+  nanostl::thread_pool pool;
+  printf("pool size = %u\n", pool.size());
+
+  for (int i = 1; i <= 4; i++) {
+    pool.submit(hello, i);
+  }
+  pool.wait();
 
+  float data[1024];
+  pool.parallel_for(0, 1024, [&data](size_t i) { data[i] = float(i) * 0.5f; });
+  printf("data[1023] = %f\n", double(data[1023]));
 
   return 0;
 }
@@ -31,6 +31,7 @@ typedef void* thread_ptr_t;
 thread_ptr_t thread_create( int (*thread_proc)( void* ), void* user_data, char const* name, int stack_size );
 void thread_destroy( thread_ptr_t thread );
 int thread_join( thread_ptr_t thread );
+void thread_detach( thread_ptr_t thread );
 
 typedef union thread_mutex_t thread_mutex_t;
 void thread_mutex_init( thread_mutex_t* mutex );
@@ -229,6 +230,15 @@ thread_join
 Waits for the specified thread to exit. Returns the value which the thread returned when exiting.
 
 
+thread_detach
+-------------
+
+    void thread_detach( thread_ptr_t thread )
+
+Releases a thread created by calling `thread_create` without waiting for it. The thread keeps running and its
+resources are freed when it exits. Do not call `thread_join` or `thread_destroy` on it afterwards.
+
+
 thread_mutex_init
 -----------------
 
@@ -428,7 +438,8 @@ thread_tls_create
     thread_tls_t thread_tls_create( void )
 
 Creates  a thread local storage (TLS) index. Once created, each thread has its own value for that TLS index, which can
-be set or retrieved individually.
+be set or retrieved individually. Returns NULL if no index could be allocated; the handle of a valid index is never
+NULL, even when the underlying key or slot number is 0.
 
 
 thread_tls_destroy
@@ -727,7 +738,8 @@ void thread_destroy( thread_ptr_t thread )
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        pthread_join( (pthread_t) thread, NULL );
+        /* thread_join() already released the thread (joining twice is undefined). */
+        (void) thread;
 
     #else
         #error Unknown platform.
@@ -756,6 +768,22 @@ int thread_join( thread_ptr_t thread )
     }
 
 
+void thread_detach( thread_ptr_t thread )
+    {
+    #if defined( _WIN32 )
+
+        CloseHandle( (HANDLE) thread );
+
+    #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
+
+        pthread_detach( (pthread_t) thread );
+
+    #else
+        #error Unknown platform.
+    #endif
+    }
+
+
 void thread_set_high_priority( void )
     {
     #if defined( _WIN32 )
@@ -936,18 +964,19 @@ void thread_signal_raise( thread_signal_t* signal )
         #if _WIN32_WINNT >= 0x0600
             EnterCriticalSection( &internal->mutex );
             internal->value = 1;
-            LeaveCriticalSection( &internal->mutex );
             WakeConditionVariable( &internal->condition );
+            LeaveCriticalSection( &internal->mutex );
         #else
             SetEvent( internal->event );
         #endif
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
+        /* Signal while holding the mutex, so a woken waiter may terminate the signal right away. */
         pthread_mutex_lock( &internal->mutex );
         internal->value = 1;
-        pthread_mutex_unlock( &internal->mutex );
         pthread_cond_signal( &internal->condition );
+        pthread_mutex_unlock( &internal->mutex );
 
     #else
         #error Unknown platform.
@@ -1037,8 +1066,8 @@ void thread_atomic_int_store( thread_atomic_int_t* atomic, int desired )
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        __sync_lock_test_and_set( &atomic->i, desired );
-        __sync_lock_release( &atomic->i );
+        /* __sync_lock_release() would write 0 after the store. */
+        __atomic_store_n( &atomic->i, desired, __ATOMIC_SEQ_CST );
 
     #else
         #error Unknown platform.
@@ -1118,9 +1147,7 @@ int thread_atomic_int_swap( thread_atomic_int_t* atomic, int desired )
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        int old = (int)__sync_lock_test_and_set( &atomic->i, desired );
-        __sync_lock_release( &atomic->i );
-        return old;
+        return (int)__atomic_exchange_n( &atomic->i, desired, __ATOMIC_SEQ_CST );
 
     #else
         #error Unknown platform.
@@ -1174,8 +1201,7 @@ void thread_atomic_ptr_store( thread_atomic_ptr_t* atomic, void* desired )
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        __sync_lock_test_and_set( &atomic->ptr, desired );
-        __sync_lock_release( &atomic->ptr );
+        __atomic_store_n( &atomic->ptr, desired, __ATOMIC_SEQ_CST );
 
     #else
         #error Unknown platform.
@@ -1196,9 +1222,7 @@ void* thread_atomic_ptr_swap( thread_atomic_ptr_t* atomic, void* desired )
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        void* old = __sync_lock_test_and_set( &atomic->ptr, desired );
-        __sync_lock_release( &atomic->ptr );
-        return old;
+        return __atomic_exchange_n( &atomic->ptr, desired, __ATOMIC_SEQ_CST );
 
     #else
         #error Unknown platform.
@@ -1301,13 +1325,13 @@ thread_tls_t thread_tls_create( void )
         if( tls == TLS_OUT_OF_INDEXES )
             return NULL;
         else
-            return (thread_tls_t) (uintptr_t) tls;
+            return (thread_tls_t) ( (uintptr_t) tls + 1 );
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
         pthread_key_t tls;
         if( pthread_key_create( &tls, NULL ) == 0 )
-            return (thread_tls_t) (uintptr_t) tls;
+            return (thread_tls_t) ( (uintptr_t) tls + 1 );
         else
             return NULL;
 
@@ -1321,11 +1345,11 @@ void thread_tls_destroy( thread_tls_t tls )
     {
     #if defined( _WIN32 )
 
-        TlsFree( (DWORD) (uintptr_t) tls );
+        TlsFree( (DWORD) ( (uintptr_t) tls - 1 ) );
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        pthread_key_delete( (pthread_key_t) (uintptr_t) tls );
+        pthread_key_delete( (pthread_key_t) ( (uintptr_t) tls - 1 ) );
 
     #else
         #error Unknown platform.
@@ -1337,11 +1361,11 @@ void thread_tls_set( thread_tls_t tls, void* value )
     {
     #if defined( _WIN32 )
 
-        TlsSetValue( (DWORD) (uintptr_t) tls, value );
+        TlsSetValue( (DWORD) ( (uintptr_t) tls - 1 ), value );
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        pthread_setspecific( (pthread_key_t) (uintptr_t) tls, value );
+        pthread_setspecific( (pthread_key_t) ( (uintptr_t) tls - 1 ), value );
 
     #else
         #error Unknown platform.
@@ -1353,11 +1377,11 @@ void* thread_tls_get( thread_tls_t tls )
     {
     #if defined( _WIN32 )
 
-        return TlsGetValue( (DWORD) (uintptr_t) tls );
+        return TlsGetValue( (DWORD) ( (uintptr_t) tls - 1 ) );
 
     #elif defined( __linux__ ) || defined( __APPLE__ ) || defined( __ANDROID__ )
 
-        return pthread_getspecific( (pthread_key_t) (uintptr_t) tls );
+        return pthread_getspecific( (pthread_key_t) ( (uintptr_t) tls - 1 ) );
 
     #else
         #error Unknown platform.
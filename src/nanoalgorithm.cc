@@ -1,9 +1,49 @@
-#if defined(NANOSTL_PSTL)
+#include "nanoexecution.h"
+
+#if !defined(NANOSTL_NO_THREAD)
+// Declarations only. The implementation is compiled in src/nanothread.cc.
+#include "libs_thread.h"
+#endif
 
 namespace nanostl {
 
+#if !defined(NANOSTL_NO_THREAD)
+namespace __pstl {
 
-} // namespace nanostl
+// Defined regardless of NANOSTL_PSTL, so a libnanostl built without it
+// still links with code using the parallel algorithms.
+thread_pool &__default_pool() {
+  // Function local static: created thread-safely on first use, stopped at
+  // exit. The calling thread works on its own chunks too, so leave it a core.
+  static thread_pool __pool(thread::hardware_concurrency() > 1
+                                ? thread::hardware_concurrency() - 1
+                                : 1);
+  return __pool;
+}
+
+__shared_min::__shared_min(int __v) {
+  static_assert(sizeof(__v_) == sizeof(thread_atomic_int_t),
+                "__shared_min::__v_ must match thread_atomic_int_t");
+  thread_atomic_int_store(reinterpret_cast<thread_atomic_int_t *>(&__v_), __v);
+}
 
-#endif // NANOSTL_PSTL
+int __shared_min::load() {
+  return thread_atomic_int_load(reinterpret_cast<thread_atomic_int_t *>(&__v_));
+}
 
+void __shared_min::update(int __v) {
+  thread_atomic_int_t *__a = reinterpret_cast<thread_atomic_int_t *>(&__v_);
+  int __cur = thread_atomic_int_load(__a);
+  while (__v < __cur) {
+    const int __prev = thread_atomic_int_compare_and_swap(__a, __cur, __v);
+    if (__prev == __cur) {
+      break;
+    }
+    __cur = __prev;
+  }
+}
+
+} // namespace __pstl
+#endif
+
+} // namespace nanostl
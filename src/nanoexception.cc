@@ -2,6 +2,20 @@
 
 namespace nanostl {
 
+exception::exception() __NANOSTL_NOEXCEPT {}
+
+exception::exception(const exception&) __NANOSTL_NOEXCEPT {}
+
+exception& exception::operator=(const exception&) __NANOSTL_NOEXCEPT {
+  return *this;
+}
+
+exception::~exception() __NANOSTL_NOEXCEPT {}
+
+const char* exception::what() const __NANOSTL_NOEXCEPT {
+  return "nanostl::exception";
+}
+
 void terminate() {
 #if defined(NANOSTL_ENABLE_EXCEPTION)
 
@@ -0,0 +1,494 @@
+#include <stdint.h>
+
+// Declarations only. The implementation is compiled in src/nanothread.cc.
+#include "libs_thread.h"
+#include "nanotask_scheduler.h"
+
+namespace nanostl {
+
+namespace {
+
+//
+// Deque indices live in pointer-sized atomics, so they don't wrap within
+// the lifetime of a scheduler on 64-bit targets. All index arithmetic is
+// unsigned and compared through the signed difference, so wrapping on
+// 32-bit targets is harmless as well.
+//
+inline uintptr_t load_index(thread_atomic_ptr_t *a) {
+  return reinterpret_cast<uintptr_t>(thread_atomic_ptr_load(a));
+}
+
+inline void store_index(thread_atomic_ptr_t *a, uintptr_t v) {
+  thread_atomic_ptr_store(a, reinterpret_cast<void *>(v));
+}
+
+inline bool cas_index(thread_atomic_ptr_t *a, uintptr_t expected,
+                      uintptr_t desired) {
+  void *e = reinterpret_cast<void *>(expected);
+  return thread_atomic_ptr_compare_and_swap(
+             a, e, reinterpret_cast<void *>(desired)) == e;
+}
+
+inline intptr_t index_diff(uintptr_t b, uintptr_t t) {
+  return static_cast<intptr_t>(b - t);
+}
+
+struct ws_array {
+  uintptr_t mask;  // capacity - 1(capacity is a power of two)
+  thread_atomic_ptr_t *slots;
+  ws_array *retired;  // previous(smaller) array. Thieves may still read it.
+
+  explicit ws_array(uintptr_t capacity)
+      : mask(capacity - 1),
+        slots(new thread_atomic_ptr_t[capacity]),
+        retired(nullptr) {}
+  ~ws_array() { delete[] slots; }
+
+  __thread_task *get(uintptr_t i) {
+    return static_cast<__thread_task *>(thread_atomic_ptr_load(&slots[i & mask]));
+  }
+  void put(uintptr_t i, __thread_task *t) {
+    thread_atomic_ptr_store(&slots[i & mask], t);
+  }
+};
+
+//
+// Chase-Lev work-stealing deque("Dynamic Circular Work-Stealing Deque",
+// Chase and Lev 2005). Only the owner calls push() and pop(); any thread
+// may call steal(). libs_thread atomics are sequentially consistent, which
+// provides the fences the algorithm needs.
+//
+struct ws_deque {
+  thread_atomic_ptr_t top;
+  char pad0[64 - sizeof(thread_atomic_ptr_t)];  // thieves write `top`
+  thread_atomic_ptr_t bottom;
+  thread_atomic_ptr_t array;
+  char pad1[64 - 2 * sizeof(thread_atomic_ptr_t)];
+
+  void init() {
+    store_index(&top, 0);
+    store_index(&bottom, 0);
+    thread_atomic_ptr_store(&array, new ws_array(256));
+  }
+
+  void term() {
+    ws_array *a = static_cast<ws_array *>(thread_atomic_ptr_load(&array));
+    while (a) {
+      ws_array *r = a->retired;
+      delete a;
+      a = r;
+    }
+  }
+
+  void push(__thread_task *task) {
+    const uintptr_t b = load_index(&bottom);
+    const uintptr_t t = load_index(&top);
+    ws_array *a = static_cast<ws_array *>(thread_atomic_ptr_load(&array));
+    if (index_diff(b, t) > static_cast<intptr_t>(a->mask)) {
+      ws_array *g = new ws_array(2 * (a->mask + 1));
+      for (uintptr_t i = t; i != b; i++) {
+        g->put(i, a->get(i));
+      }
+      g->retired = a;
+      thread_atomic_ptr_store(&array, g);
+      a = g;
+    }
+    a->put(b, task);
+    store_index(&bottom, b + 1);
+  }
+
+  __thread_task *pop() {
+    const uintptr_t b = load_index(&bottom) - 1;
+    ws_array *a = static_cast<ws_array *>(thread_atomic_ptr_load(&array));
+    store_index(&bottom, b);
+    const uintptr_t t = load_index(&top);
+    const intptr_t size = index_diff(b, t);
+    if (size < 0) {
+      // Empty.
+      store_index(&bottom, b + 1);
+      return nullptr;
+    }
+    __thread_task *task = a->get(b);
+    if (size > 0) {
+      return task;
+    }
+    // Last one: race the thieves for it.
+    if (!cas_index(&top, t, t + 1)) {
+      task = nullptr;
+    }
+    store_index(&bottom, b + 1);
+    return task;
+  }
+
+  __thread_task *steal() {
+    for (;;) {
+      const uintptr_t t = load_index(&top);
+      const uintptr_t b = load_index(&bottom);
+      if (index_diff(b, t) <= 0) {
+        return nullptr;
+      }
+      ws_array *a = static_cast<ws_array *>(thread_atomic_ptr_load(&array));
+      __thread_task *task = a->get(t);
+      if (cas_index(&top, t, t + 1)) {
+        return task;
+      }
+      // Lost to the owner or another thief. Retry while non-empty.
+    }
+  }
+};
+
+struct scheduler_impl;
+
+struct worker {
+  ws_deque deque;
+  scheduler_impl *sched;
+  uint32_t rng;                  // victim selection(xorshift32)
+  thread_atomic_int_t sleeping;  // 1 while parked(or about to park)
+  thread_signal_t wake;
+  thread_ptr_t thread;
+};
+
+struct scheduler_impl {
+  worker *workers;
+  unsigned num_workers;
+  unsigned num_started;  // workers[num_started..] failed to start and stay empty
+
+  // Tasks spawned from threads outside the scheduler.
+  thread_mutex_t inject_mutex;
+  __thread_task *inject_head;
+  __thread_task *inject_tail;
+  thread_atomic_int_t inject_count;
+
+  thread_atomic_int_t num_sleeping;
+  thread_atomic_int_t stop;
+  thread_atomic_int_t next_wake;  // rotates the first worker tried by wake_one()
+
+  thread_tls_t tls;  // worker* of the calling thread, null outside
+};
+
+__thread_task *take_injected(scheduler_impl *impl) {
+  if (thread_atomic_int_load(&impl->inject_count) == 0) {
+    return nullptr;
+  }
+  thread_mutex_lock(&impl->inject_mutex);
+  __thread_task *task = impl->inject_head;
+  if (task) {
+    impl->inject_head = task->__next_;
+    if (!impl->inject_head) {
+      impl->inject_tail = nullptr;
+    }
+    thread_atomic_int_dec(&impl->inject_count);
+  }
+  thread_mutex_unlock(&impl->inject_mutex);
+  return task;
+}
+
+// `self` is null on threads outside the scheduler.
+__thread_task *find_task(scheduler_impl *impl, worker *self) {
+  __thread_task *task;
+  if (self) {
+    task = self->deque.pop();
+    if (task) {
+      return task;
+    }
+  }
+
+  const unsigned n = impl->num_workers;
+  if (n > 0) {
+    unsigned start = 0;
+    if (self) {
+      uint32_t x = self->rng;
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      self->rng = x;
+      start = x % n;
+    }
+    for (unsigned k = 0; k < n; k++) {
+      worker *victim = &impl->workers[(start + k) % n];
+      if (victim == self) {
+        continue;
+      }
+      task = victim->deque.steal();
+      if (task) {
+        return task;
+      }
+    }
+  }
+
+  return take_injected(impl);
+}
+
+// Claims one parked worker and raises its signal.
+void wake_one(scheduler_impl *impl) {
+  if (thread_atomic_int_load(&impl->num_sleeping) == 0) {
+    return;
+  }
+  const unsigned n = impl->num_workers;
+  const unsigned start =
+      static_cast<unsigned>(thread_atomic_int_inc(&impl->next_wake)) % n;
+  for (unsigned k = 0; k < n; k++) {
+    worker *w = &impl->workers[(start + k) % n];
+    if (thread_atomic_int_compare_and_swap(&w->sleeping, 1, 0) == 1) {
+      thread_atomic_int_dec(&impl->num_sleeping);
+      thread_signal_raise(&w->wake);
+      return;
+    }
+  }
+}
+
+//
+// Parking protocol: a worker announces itself(`sleeping` = 1,
+// `num_sleeping` + 1) and then looks for work once more. Whoever publishes
+// work does so before reading `num_sleeping`, so either the worker sees
+// the work or the publisher sees the worker. A parked worker is woken only
+// by whoever flips its `sleeping` from 1 to 0, which also raises its
+// signal exactly once.
+//
+int worker_main(void *user_data) {
+  worker *self = static_cast<worker *>(user_data);
+  scheduler_impl *impl = self->sched;
+  thread_tls_set(impl->tls, self);
+
+  for (;;) {
+    __thread_task *task = find_task(impl, self);
+    if (task) {
+      task->__execute();
+      continue;
+    }
+
+    thread_atomic_int_store(&self->sleeping, 1);
+    thread_atomic_int_inc(&impl->num_sleeping);
+
+    task = find_task(impl, self);
+    if (task || thread_atomic_int_load(&impl->stop)) {
+      if (thread_atomic_int_compare_and_swap(&self->sleeping, 1, 0) == 1) {
+        thread_atomic_int_dec(&impl->num_sleeping);
+      } else {
+        // Somebody already claimed us. Consume their wake-up.
+        thread_signal_wait(&self->wake, THREAD_SIGNAL_WAIT_INFINITE);
+      }
+      if (!task) {
+        return 0;
+      }
+      task->__execute();
+      continue;
+    }
+
+    thread_signal_wait(&self->wake, THREAD_SIGNAL_WAIT_INFINITE);
+  }
+}
+
+}  // namespace
+
+//
+// task_scheduler
+//
+
+task_scheduler::task_scheduler(unsigned num_threads) {
+  scheduler_impl *impl = new scheduler_impl;
+  impl->tls = thread_tls_create();
+
+  unsigned n = num_threads ? num_threads : thread::hardware_concurrency();
+  if (n == 0) {
+    n = 1;
+  }
+  if (!impl->tls) {
+    // Workers could not tell their own deque apart. Run tasks on sync().
+    n = 0;
+  }
+
+  thread_mutex_init(&impl->inject_mutex);
+  impl->inject_head = nullptr;
+  impl->inject_tail = nullptr;
+  thread_atomic_int_store(&impl->inject_count, 0);
+  thread_atomic_int_store(&impl->num_sleeping, 0);
+  thread_atomic_int_store(&impl->stop, 0);
+  thread_atomic_int_store(&impl->next_wake, 0);
+
+  impl->workers = new worker[n];
+  impl->num_workers = n;
+  for (unsigned i = 0; i < n; i++) {
+    worker *w = &impl->workers[i];
+    w->deque.init();
+    w->sched = impl;
+    w->rng = 2463534242u + 0x9E3779B9u * i;
+    thread_atomic_int_store(&w->sleeping, 0);
+    thread_signal_init(&w->wake);
+    w->thread = nullptr;
+  }
+
+  unsigned started = 0;
+  for (; started < n; started++) {
+    worker *w = &impl->workers[started];
+    w->thread = thread_create(&worker_main, w, "nanostl task",
+                              THREAD_STACK_SIZE_DEFAULT);
+    if (!w->thread) {
+      break;
+    }
+  }
+  impl->num_started = started;
+  __impl_ = impl;
+}
+
+task_scheduler::~task_scheduler() {
+  scheduler_impl *impl = static_cast<scheduler_impl *>(__impl_);
+
+  if (impl->num_started == 0) {
+    while (__try_run_one()) {
+    }
+  }
+
+  thread_atomic_int_store(&impl->stop, 1);
+  for (unsigned i = 0; i < impl->num_workers; i++) {
+    worker *w = &impl->workers[i];
+    if (thread_atomic_int_compare_and_swap(&w->sleeping, 1, 0) == 1) {
+      thread_atomic_int_dec(&impl->num_sleeping);
+      thread_signal_raise(&w->wake);
+    }
+  }
+  for (unsigned i = 0; i < impl->num_started; i++) {
+    thread_join(impl->workers[i].thread);
+    thread_destroy(impl->workers[i].thread);
+  }
+
+  for (unsigned i = 0; i < impl->num_workers; i++) {
+    impl->workers[i].deque.term();
+    thread_signal_term(&impl->workers[i].wake);
+  }
+  delete[] impl->workers;
+  thread_mutex_term(&impl->inject_mutex);
+  if (impl->tls) {
+    thread_tls_destroy(impl->tls);
+  }
+  delete impl;
+}
+
+unsigned task_scheduler::size() const __NANOSTL_NOEXCEPT {
+  return static_cast<const scheduler_impl *>(__impl_)->num_started;
+}
+
+void task_scheduler::__push(__thread_task *__task) {
+  scheduler_impl *impl = static_cast<scheduler_impl *>(__impl_);
+  worker *self =
+      impl->tls ? static_cast<worker *>(thread_tls_get(impl->tls)) : nullptr;
+  if (self) {
+    self->deque.push(__task);
+  } else {
+    __task->__next_ = nullptr;
+    thread_mutex_lock(&impl->inject_mutex);
+    if (impl->inject_tail) {
+      impl->inject_tail->__next_ = __task;
+    } else {
+      impl->inject_head = __task;
+    }
+    impl->inject_tail = __task;
+    thread_atomic_int_inc(&impl->inject_count);
+    thread_mutex_unlock(&impl->inject_mutex);
+  }
+  wake_one(impl);
+}
+
+bool task_scheduler::__on_worker() const {
+  const scheduler_impl *impl = static_cast<const scheduler_impl *>(__impl_);
+  return impl->tls && thread_tls_get(impl->tls);
+}
+
+bool task_scheduler::__try_run_one() {
+  scheduler_impl *impl = static_cast<scheduler_impl *>(__impl_);
+  worker *self =
+      impl->tls ? static_cast<worker *>(thread_tls_get(impl->tls)) : nullptr;
+  __thread_task *task = find_task(impl, self);
+  if (!task) {
+    return false;
+  }
+  task->__execute();
+  return true;
+}
+
+//
+// task_group
+//
+
+namespace {
+
+inline thread_atomic_int_t *group_counter(void *storage) {
+  return static_cast<thread_atomic_int_t *>(storage);
+}
+
+// Set in the group counter while sync() is parked on `__waiter_`.
+const int kGroupWaiting = 1 << 30;
+
+// Failed attempts to find a task before a thread outside the scheduler
+// parks in sync().
+const int kGroupSyncSpins = 64;
+
+}  // namespace
+
+task_group::task_group(task_scheduler &__s)
+    : __sched_(&__s), __waiter_(nullptr) {
+  static_assert(sizeof(__pending_) == sizeof(thread_atomic_int_t),
+                "task_group::__pending_ must match thread_atomic_int_t");
+  thread_atomic_int_store(group_counter(&__pending_), 0);
+}
+
+task_group::~task_group() { sync(); }
+
+void task_group::__spawn(__thread_task *__task) {
+  thread_atomic_int_inc(group_counter(&__pending_));
+  __sched_->__push(__task);
+}
+
+void task_group::__finish() {
+  // The group may be gone as soon as the counter drops to 0, unless sync()
+  // is parked: then it waits for this raise before returning.
+  if (thread_atomic_int_dec(group_counter(&__pending_)) ==
+      (kGroupWaiting | 1)) {
+    thread_signal_raise(static_cast<thread_signal_t *>(__waiter_));
+  }
+}
+
+void task_group::sync() {
+  thread_atomic_int_t *pending = group_counter(&__pending_);
+  if (thread_atomic_int_load(pending) == 0) {
+    return;
+  }
+
+  // Help with pending work. When there is none, the remaining tasks are
+  // running on other threads. Workers keep yielding, so they pick up new
+  // tasks as soon as there are any. Other threads park after a few tries
+  // instead of spinning a core next to every worker(e.g. main waiting on a
+  // whole parallel_invoke). With no workers nobody else would run the
+  // tasks, so never park then.
+  const bool may_park = (__sched_->size() > 0) && !__sched_->__on_worker();
+  int spins = 0;
+  int n;
+  while ((n = thread_atomic_int_load(pending)) != 0) {
+    if (__sched_->__try_run_one()) {
+      spins = 0;
+      continue;
+    }
+    if (!may_park || (++spins < kGroupSyncSpins)) {
+      thread_yield();
+      continue;
+    }
+
+    thread_signal_t signal;
+    thread_signal_init(&signal);
+    __waiter_ = &signal;
+    // Fails when a task finished in between; then look again.
+    const bool parked =
+        thread_atomic_int_compare_and_swap(pending, n, n | kGroupWaiting) == n;
+    if (parked) {
+      // The last __finish() raises `signal` exactly once; wait for the raise
+      // itself(not the counter), so `signal` is no longer in use when it is
+      // terminated.
+      thread_signal_wait(&signal, THREAD_SIGNAL_WAIT_INFINITE);
+      thread_atomic_int_store(pending, 0);
+    }
+    __waiter_ = nullptr;
+    thread_signal_term(&signal);
+  }
+}
+
+}  // namespace nanostl
@@ -12,39 +12,88 @@
 #define THREAD_IMPLEMENTATION
 #include "libs_thread.h"
 #include "nanothread.h"
+#include "nanothread_pool.h"
 
 namespace nanostl {
 
-thread::thread() : thread_handle_(nullptr) {
+namespace {
 
+int __thread_proxy(void *__vp) {
+  static_cast<__thread_task *>(__vp)->__execute();
+  return 0;
 }
 
-thread::~thread() {
-  if (thread_handle_) {
-    thread_ptr_t th = static_cast<thread_ptr_t>(thread_handle_);
-    thread_destroy(th);
+}  // namespace
+
+thread::thread() __NANOSTL_NOEXCEPT : thread_handle_(nullptr) {
+
+}
+
+void thread::__start(__thread_task *__task) {
+  thread_handle_ = thread_create(&__thread_proxy, __task, "nanostl thread",
+                                 THREAD_STACK_SIZE_DEFAULT);
+  if (!thread_handle_) {
+    delete __task;
   }
 }
 
-bool thread::joinable() const __NANOSTL_NOEXCEPT {
-  // TODO: Check if the thread handle is actually valid
+thread::~thread() {
+  join();
+}
 
-  if (thread_handle_) {
-    return true;
+thread::thread(thread &&t) __NANOSTL_NOEXCEPT : thread_handle_(t.thread_handle_) {
+  t.thread_handle_ = nullptr;
+}
+
+thread &thread::operator=(thread &&t) __NANOSTL_NOEXCEPT {
+  if (this != &t) {
+    join();
+    thread_handle_ = t.thread_handle_;
+    t.thread_handle_ = nullptr;
   }
+  return (*this);
+}
 
-  return false;
+void thread::swap(thread &t) __NANOSTL_NOEXCEPT {
+  void *h = thread_handle_;
+  thread_handle_ = t.thread_handle_;
+  t.thread_handle_ = h;
+}
+
+bool thread::joinable() const __NANOSTL_NOEXCEPT {
+  return thread_handle_ != nullptr;
 }
 
 void thread::join() {
   if (thread_handle_) {
     thread_ptr_t th = static_cast<thread_ptr_t>(thread_handle_);
     thread_join(th);
+    thread_destroy(th);
 
     thread_handle_ = nullptr;
   }
 }
 
+void thread::detach() {
+  if (thread_handle_) {
+    thread_detach(static_cast<thread_ptr_t>(thread_handle_));
+    thread_handle_ = nullptr;
+  }
+}
+
+thread::id thread::get_id() const __NANOSTL_NOEXCEPT {
+  if (!thread_handle_) {
+    return id();
+  }
+#if defined(_WIN32)
+  return id(reinterpret_cast<void *>(
+      static_cast<uintptr_t>(GetThreadId(static_cast<HANDLE>(thread_handle_)))));
+#else
+  // thread_create() returns the pthread_t.
+  return id(thread_handle_);
+#endif
+}
+
 unsigned thread::hardware_concurrency() __NANOSTL_NOEXCEPT {
 #if defined(_WIN32)
   SYSTEM_INFO info;
@@ -65,4 +114,303 @@ unsigned thread::hardware_concurrency() __NANOSTL_NOEXCEPT {
 #endif
 }
 
+namespace this_thread {
+
+thread::id get_id() __NANOSTL_NOEXCEPT {
+  return thread::id(thread_current_thread_id());
+}
+
+void yield() __NANOSTL_NOEXCEPT { thread_yield(); }
+
+}  // namespace this_thread
+
+//
+// thread_pool
+//
+// Workers sleep on `work`, an auto-reset signal(one raise wakes one
+// waiter). A worker that takes a task while more are queued raises it
+// again, so a burst of submits wakes workers one after another. `pending`
+// counts queued and running tasks; `idle` is raised when it drops to 0.
+//
+
+namespace {
+
+struct thread_pool_impl {
+  thread_mutex_t mutex;
+  thread_signal_t work;
+  thread_signal_t idle;
+  __thread_task *head;
+  __thread_task *tail;
+  int pending;
+  bool stop;
+  unsigned num_workers;
+  thread_ptr_t *workers;
+};
+
+// Called with the mutex held.
+void thread_pool_finish_locked(thread_pool_impl *impl, int n, bool *idle) {
+  impl->pending -= n;
+  *idle = (impl->pending == 0);
+}
+
+int thread_pool_worker(void *user_data) {
+  thread_pool_impl *impl = static_cast<thread_pool_impl *>(user_data);
+  for (;;) {
+    thread_mutex_lock(&impl->mutex);
+    while (!impl->head && !impl->stop) {
+      thread_mutex_unlock(&impl->mutex);
+      thread_signal_wait(&impl->work, THREAD_SIGNAL_WAIT_INFINITE);
+      thread_mutex_lock(&impl->mutex);
+    }
+    if (!impl->head) {
+      // Stopping and drained. Pass the wake-up on to the next worker.
+      thread_mutex_unlock(&impl->mutex);
+      thread_signal_raise(&impl->work);
+      return 0;
+    }
+    __thread_task *task = impl->head;
+    impl->head = task->__next_;
+    if (!impl->head) {
+      impl->tail = nullptr;
+    }
+    const bool more = (impl->head != nullptr);
+    thread_mutex_unlock(&impl->mutex);
+    if (more) {
+      thread_signal_raise(&impl->work);
+    }
+
+    task->__execute();
+
+    bool idle;
+    thread_mutex_lock(&impl->mutex);
+    thread_pool_finish_locked(impl, 1, &idle);
+    thread_mutex_unlock(&impl->mutex);
+    if (idle) {
+      thread_signal_raise(&impl->idle);
+    }
+  }
+}
+
+// Shared state of one parallel_for call. Helper tasks live in `helpers`
+// and are never deleted by the pool.
+struct parallel_for_batch;
+
+struct parallel_for_helper : public __thread_task {
+  parallel_for_batch *batch;
+  virtual void __execute();
+};
+
+struct parallel_for_batch {
+  void (*chunk)(void *, size_t, size_t);
+  void *body;
+  size_t first;
+  size_t last;
+  size_t grain;
+  int num_chunks;
+  thread_atomic_int_t next;     // next chunk to take
+  thread_atomic_int_t running;  // helpers dequeued but not finished
+  thread_signal_t done;         // raised when `running` drops to 0
+
+  void run() {
+    for (;;) {
+      const int c = thread_atomic_int_inc(&next);
+      if (c >= num_chunks) {
+        return;
+      }
+      const size_t begin = first + size_t(c) * grain;
+      const size_t end = (last - begin > grain) ? (begin + grain) : last;
+      chunk(body, begin, end);
+    }
+  }
+};
+
+void parallel_for_helper::__execute() {
+  batch->run();
+  if (thread_atomic_int_dec(&batch->running) == 1) {
+    thread_signal_raise(&batch->done);
+  }
+}
+
+}  // namespace
+
+thread_pool::thread_pool(unsigned num_threads) {
+  thread_pool_impl *impl = new thread_pool_impl;
+  thread_mutex_init(&impl->mutex);
+  thread_signal_init(&impl->work);
+  thread_signal_init(&impl->idle);
+  impl->head = nullptr;
+  impl->tail = nullptr;
+  impl->pending = 0;
+  impl->stop = false;
+
+  unsigned n = num_threads ? num_threads : thread::hardware_concurrency();
+  if (n == 0) {
+    n = 1;
+  }
+  impl->workers = new thread_ptr_t[n];
+  impl->num_workers = 0;
+  for (unsigned i = 0; i < n; i++) {
+    thread_ptr_t th = thread_create(&thread_pool_worker, impl,
+                                    "nanostl pool", THREAD_STACK_SIZE_DEFAULT);
+    if (!th) {
+      break;
+    }
+    impl->workers[impl->num_workers++] = th;
+  }
+  __impl_ = impl;
+}
+
+thread_pool::~thread_pool() {
+  thread_pool_impl *impl = static_cast<thread_pool_impl *>(__impl_);
+  thread_mutex_lock(&impl->mutex);
+  impl->stop = true;
+  thread_mutex_unlock(&impl->mutex);
+  thread_signal_raise(&impl->work);
+  for (unsigned i = 0; i < impl->num_workers; i++) {
+    thread_join(impl->workers[i]);
+    thread_destroy(impl->workers[i]);
+  }
+  delete[] impl->workers;
+  thread_signal_term(&impl->idle);
+  thread_signal_term(&impl->work);
+  thread_mutex_term(&impl->mutex);
+  delete impl;
+}
+
+unsigned thread_pool::size() const __NANOSTL_NOEXCEPT {
+  return static_cast<const thread_pool_impl *>(__impl_)->num_workers;
+}
+
+void thread_pool::__push(__thread_task *__task) {
+  thread_pool_impl *impl = static_cast<thread_pool_impl *>(__impl_);
+  if (impl->num_workers == 0) {
+    __task->__execute();
+    return;
+  }
+  __task->__next_ = nullptr;
+  thread_mutex_lock(&impl->mutex);
+  if (impl->tail) {
+    impl->tail->__next_ = __task;
+  } else {
+    impl->head = __task;
+  }
+  impl->tail = __task;
+  impl->pending++;
+  thread_mutex_unlock(&impl->mutex);
+  thread_signal_raise(&impl->work);
+}
+
+void thread_pool::wait() {
+  thread_pool_impl *impl = static_cast<thread_pool_impl *>(__impl_);
+  thread_mutex_lock(&impl->mutex);
+  while (impl->pending > 0) {
+    thread_mutex_unlock(&impl->mutex);
+    thread_signal_wait(&impl->idle, THREAD_SIGNAL_WAIT_INFINITE);
+    thread_mutex_lock(&impl->mutex);
+  }
+  thread_mutex_unlock(&impl->mutex);
+  // Other threads may be waiting as well.
+  thread_signal_raise(&impl->idle);
+}
+
+void thread_pool::__parallel_for(size_t __first, size_t __last, size_t __grain,
+                                 void (*__chunk)(void *, size_t, size_t),
+                                 void *__body) {
+  if (__first >= __last) {
+    return;
+  }
+  thread_pool_impl *impl = static_cast<thread_pool_impl *>(__impl_);
+  const size_t n = __last - __first;
+  const size_t threads = size_t(impl->num_workers) + 1;
+  if (__grain == 0) {
+    __grain = n / (8 * threads);
+  }
+  if (__grain == 0) {
+    __grain = 1;
+  }
+  // Chunk indices are ints.
+  if (n / __grain >= size_t(0x40000000)) {
+    __grain = n / size_t(0x40000000) + 1;
+  }
+  const int num_chunks = int((n + __grain - 1) / __grain);
+  if ((num_chunks == 1) || (impl->num_workers == 0)) {
+    __chunk(__body, __first, __last);
+    return;
+  }
+
+  parallel_for_batch batch;
+  batch.chunk = __chunk;
+  batch.body = __body;
+  batch.first = __first;
+  batch.last = __last;
+  batch.grain = __grain;
+  batch.num_chunks = num_chunks;
+  thread_atomic_int_store(&batch.next, 0);
+  thread_signal_init(&batch.done);
+
+  const unsigned num_helpers = (unsigned(num_chunks - 1) < impl->num_workers)
+                                   ? unsigned(num_chunks - 1)
+                                   : impl->num_workers;
+  parallel_for_helper *helpers = new parallel_for_helper[num_helpers];
+  thread_atomic_int_store(&batch.running, int(num_helpers));
+  thread_mutex_lock(&impl->mutex);
+  for (unsigned i = 0; i < num_helpers; i++) {
+    helpers[i].batch = &batch;
+    helpers[i].__next_ = nullptr;
+    if (impl->tail) {
+      impl->tail->__next_ = &helpers[i];
+    } else {
+      impl->head = &helpers[i];
+    }
+    impl->tail = &helpers[i];
+  }
+  impl->pending += int(num_helpers);
+  thread_mutex_unlock(&impl->mutex);
+  thread_signal_raise(&impl->work);
+
+  batch.run();
+
+  // Helpers still queued(e.g. every worker is busy) have nothing left to
+  // do: take them back instead of waiting for a worker to reach them.
+  int removed = 0;
+  bool idle = false;
+  thread_mutex_lock(&impl->mutex);
+  __thread_task *prev = nullptr;
+  for (__thread_task *t = impl->head; t;) {
+    __thread_task *next = t->__next_;
+    if ((t >= helpers) && (t < helpers + num_helpers)) {
+      if (prev) {
+        prev->__next_ = next;
+      } else {
+        impl->head = next;
+      }
+      if (impl->tail == t) {
+        impl->tail = prev;
+      }
+      removed++;
+    } else {
+      prev = t;
+    }
+    t = next;
+  }
+  if (removed) {
+    thread_pool_finish_locked(impl, removed, &idle);
+  }
+  thread_mutex_unlock(&impl->mutex);
+  if (idle) {
+    thread_signal_raise(&impl->idle);
+  }
+
+  // Whoever brings `running` to 0 is the last one. If that is a helper it
+  // raises `done` exactly once; wait for the raise itself(not `running`),
+  // so `done` is no longer in use when it is terminated.
+  const bool caller_is_last =
+      (removed > 0) && (thread_atomic_int_sub(&batch.running, removed) == removed);
+  if (!caller_is_last) {
+    thread_signal_wait(&batch.done, THREAD_SIGNAL_WAIT_INFINITE);
+  }
+  thread_signal_term(&batch.done);
+  delete[] helpers;
+}
+
 }  // namespace nanostl
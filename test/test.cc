@@ -6,15 +6,28 @@
 
 #define NANOSTL_IMPLEMENTATION
 #include "nanoalgorithm.h"
+#include "nanocharconv.h"
+#include "nanofstream.h"
 #include "nanolimits.h"
+#include "nanobtree.h"
 #include "nanomap.h"
 #include "nanomath.h"
+#include "nanonumeric.h"
+#include "nanoostream.h"
 #include "nanosstream.h"
 #include "nanostring.h"
+#include "nanostring_view.h"
+#include "nanounordered_map.h"
+#include "nanounordered_set.h"
 #include "nanoutility.h"
 #include "nanovector.h"
 #include "nanovalarray.h"
 #include "nanomemory.h"
+#include "nanomemory_resource.h"
+#include "nanoparse.h"
+#include "nanothread.h"
+#include "nanothread_pool.h"
+#include "nanotask_scheduler.h"
 
 #include "nanooptional.h"
 //#include "nanoany.h"
@@ -29,6 +42,7 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <valarray>
 
@@ -178,6 +192,37 @@ static void test_vector(void) {
   TEST_CHECK(v.size() == 0);
 }
 
+static void test_vector_growth(void) {
+  nanostl::vector<float> v;
+
+  v.reserve(16);
+  TEST_CHECK(v.capacity() == 16);
+  TEST_CHECK(v.size() == 0);
+
+  for (int i = 0; i < 1000; i++) {
+    v.push_back(float(i));
+  }
+  TEST_CHECK(v.size() == 1000);
+  TEST_CHECK(v[999] == 999.0f);
+
+  // push_back of own element across reallocation.
+  v.shrink_to_fit();
+  TEST_CHECK(v.capacity() == v.size());
+  v.push_back(v[0]);
+  TEST_CHECK(v[1000] == 0.0f);
+
+  nanostl::vector<std::string> s;
+  s.emplace_back(3, 'a');
+  s.push_back(std::string("bc"));
+  TEST_CHECK(s[0] == "aaa");
+  TEST_CHECK(s[1] == "bc");
+
+  nanostl::vector<std::string> m(nanostl::move(s));
+  TEST_CHECK(m.size() == 2);
+  TEST_CHECK(s.size() == 0);
+  TEST_CHECK(m[1] == "bc");
+}
+
 #if 0
 static void test_valarray(void) {
   nanostl::valarray<int> v;
@@ -218,6 +263,80 @@ static void test_valarray(void) {
 }
 #endif
 
+static int g_counted_ctor = 0;
+static int g_counted_dtor = 0;
+
+struct Counted {
+  int v;
+  Counted() : v(0) { g_counted_ctor++; }
+  Counted(int x) : v(x) { g_counted_ctor++; }
+  Counted(const Counted &rhs) : v(rhs.v) { g_counted_ctor++; }
+  ~Counted() { g_counted_dtor++; }
+  Counted &operator=(const Counted &rhs) {
+    v = rhs.v;
+    return *this;
+  }
+};
+
+static void test_allocator(void) {
+  g_counted_ctor = 0;
+  g_counted_dtor = 0;
+
+  {
+    nanostl::vector<Counted> v;
+    v.reserve(1024);
+
+    // reserve() must not construct anything.
+    TEST_CHECK(g_counted_ctor == 0);
+
+    v.emplace_back(1);
+    v.emplace_back(2);
+    TEST_CHECK(g_counted_ctor == 2);
+
+    v.resize(1);
+    TEST_CHECK(g_counted_dtor == 1);
+
+    nanostl::valarray<Counted> va(3);
+    TEST_CHECK(g_counted_ctor == 5);
+  }
+
+  TEST_CHECK(g_counted_ctor == g_counted_dtor);
+}
+
+static void test_arena(void) {
+  nanostl::monotonic_arena arena(256);
+
+  for (int frame = 0; frame < 2; frame++) {
+    nanostl::arena_allocator<int> alloc(&arena);
+
+    nanostl::vector<int, nanostl::arena_allocator<int> > v(alloc);
+    for (int i = 0; i < 1000; i++) {
+      v.push_back(i);
+    }
+    TEST_CHECK(v[999] == 999);
+
+    nanostl::basic_string<char, nanostl::arena_allocator<char> > s("arena",
+                                                                   alloc);
+    TEST_CHECK(s.size() == 5);
+
+    nanostl::map<int, int, nanostl::less<int>,
+                 nanostl::arena_allocator<nanostl::pair<const int, int> > >
+        m(alloc);
+    m[3] = 4;
+    TEST_CHECK(m[3] == 4);
+
+    TEST_CHECK(arena.bytes_allocated() > 0);
+    arena.reset();
+    TEST_CHECK(arena.bytes_allocated() == 0);
+  }
+
+  char buf[64];
+  nanostl::monotonic_arena fixed(buf, sizeof(buf));
+  TEST_CHECK(fixed.allocate(32) == buf);
+  // Falls back to the heap once the buffer is exhausted.
+  TEST_CHECK(fixed.allocate(64) != nullptr);
+}
+
 static void test_iterator(void) {
   nanostl::vector<float> arr;
   arr.push_back(0.3f);
@@ -248,6 +367,105 @@ static void test_algorithm(void) {
     nanostl::vector<float>::iterator ret = nanostl::max_element(arr.begin(), arr.end());
     TEST_CHECK(nanostl::distance(arr.begin(), ret) == 1);
   }
+
+  {
+    int a[5] = {3, -1, 4, -1, 5};
+    int b[5];
+    int sum = 0;
+    nanostl::for_each(a, a + 5, [&sum](int x) { sum += x; });
+    TEST_CHECK(sum == 10);
+
+    TEST_CHECK(nanostl::transform(a, a + 5, b, [](int x) { return 2 * x; }) == b + 5);
+    TEST_CHECK((b[0] == 6) && (b[4] == 10));
+    nanostl::transform(a, a + 5, b, b, [](int x, int y) { return y - x; });
+    TEST_CHECK((b[0] == 3) && (b[1] == -1));
+
+    TEST_CHECK(nanostl::copy(a, a + 5, b) == b + 5);
+    TEST_CHECK(b[2] == 4);
+
+    TEST_CHECK(nanostl::count_if(a, a + 5, [](int x) { return x < 0; }) == 2);
+    TEST_CHECK(nanostl::find_if(a, a + 5, [](int x) { return x > 3; }) == a + 2);
+    TEST_CHECK(nanostl::find_if(a, a + 5, [](int x) { return x > 9; }) == a + 5);
+  }
+}
+
+static void test_sort(void) {
+  {
+    int a[8] = {5, -2, 9, 0, 5, 3, -7, 1};
+    nanostl::sort(a, a + 8);
+    TEST_CHECK(nanostl::is_sorted(a, a + 8));
+    TEST_CHECK((a[0] == -7) && (a[7] == 9));
+  }
+
+  {
+    // Long enough for pdqsort to partition(not just insertion sort).
+    nanostl::vector<int> v;
+    unsigned int x = 12345;
+    for (int i = 0; i < 1000; i++) {
+      x = x * 1103515245u + 12345u;
+      v.push_back(int((x >> 8) % 100) - 50);
+    }
+    nanostl::vector<int> w = v;
+    nanostl::sort(v.begin(), v.end());
+    TEST_CHECK(nanostl::is_sorted(v.begin(), v.end()));
+
+    nanostl::radix_sort(w.begin(), w.end());
+    bool same = true;
+    for (size_t i = 0; i < v.size(); i++) {
+      same &= (w[i] == v[i]);
+    }
+    TEST_CHECK(same);
+
+    nanostl::sort(w.begin(), w.end(), [](int a, int b) { return a > b; });
+    TEST_CHECK(w[0] == v[v.size() - 1]);
+  }
+
+  {
+    float a[6] = {1.5f, -0.5f, 3.0f, -8.0f, 0.0f, 2.0f};
+    nanostl::radix_sort(a, a + 6);
+    TEST_CHECK((a[0] == -8.0f) && (a[1] == -0.5f) && (a[5] == 3.0f));
+  }
+
+  {
+    // Equal keys keep their order.
+    int key[6] = {2, 1, 2, 0, 1, 2};
+    int idx[6] = {0, 1, 2, 3, 4, 5};
+    nanostl::stable_sort(idx, idx + 6,
+                         [&key](int a, int b) { return key[a] < key[b]; });
+    TEST_CHECK((idx[0] == 3) && (idx[1] == 1) && (idx[2] == 4));
+    TEST_CHECK((idx[3] == 0) && (idx[4] == 2) && (idx[5] == 5));
+  }
+
+  {
+    int a[7] = {7, 6, 5, 4, 3, 2, 1};
+    nanostl::partial_sort(a, a + 3, a + 7);
+    TEST_CHECK((a[0] == 1) && (a[1] == 2) && (a[2] == 3));
+
+    int b[7] = {3, 7, 1, 6, 2, 5, 4};
+    nanostl::nth_element(b, b + 3, b + 7);
+    TEST_CHECK(b[3] == 4);
+  }
+}
+
+static void test_numeric(void) {
+  nanostl::vector<int> v;
+  for (int i = 1; i <= 100; i++) {
+    v.push_back(i);
+  }
+  TEST_CHECK(nanostl::reduce(v.begin(), v.end()) == 5050);
+  TEST_CHECK(nanostl::reduce(v.begin(), v.end(), 10) == 5060);
+  TEST_CHECK(nanostl::transform_reduce(v.begin(), v.end(), v.begin(), 0) == 338350);
+  TEST_CHECK(nanostl::transform_reduce(v.begin(), v.end(), 0, nanostl::plus<>(),
+                                       [](int x) { return x % 2; }) == 50);
+
+  int a[4] = {1, 2, 3, 4};
+  int b[4];
+  nanostl::inclusive_scan(a, a + 4, b);
+  TEST_CHECK((b[0] == 1) && (b[3] == 10));
+  nanostl::exclusive_scan(a, a + 4, b, 100);
+  TEST_CHECK((b[0] == 100) && (b[3] == 106));
+  nanostl::exclusive_scan(a, a + 4, a, 0);  // in place
+  TEST_CHECK((a[0] == 0) && (a[1] == 1) && (a[3] == 6));
 }
 
 static void test_string(void) {
@@ -269,6 +487,417 @@ static void test_string(void) {
   TEST_CHECK(nanostl::string("\0").length() == std::string("\0").length());
 }
 
+static void test_string_sso(void) {
+  nanostl::string e;
+  TEST_CHECK(e.empty());
+  TEST_CHECK(e.c_str()[0] == '\0');
+
+  // Short strings are stored inline.
+  nanostl::string s("identifier");
+  TEST_CHECK(s.capacity() == e.capacity());
+
+  nanostl::string l("a string long enough to need a heap buffer");
+  TEST_CHECK(l.capacity() >= l.size());
+  TEST_CHECK(l.size() == 42);
+
+  nanostl::string m(nanostl::move(l));
+  TEST_CHECK(m == "a string long enough to need a heap buffer");
+  TEST_CHECK(l.empty());
+
+  nanostl::string c(m.c_str(), 8);
+  TEST_CHECK(c == "a string");
+  c += m;
+  TEST_CHECK(c.size() == 50);
+  TEST_CHECK(m < c);
+
+  const char *p = "abc";
+  nanostl::string z(p, 0);
+  TEST_CHECK(z.empty());
+  nanostl::string r(p, p + 2);
+  TEST_CHECK(r == "ab");
+  nanostl::vector<char> v;
+  v.push_back('x');
+  v.push_back('y');
+  nanostl::string it(v.begin(), v.end());
+  TEST_CHECK(it == "xy");
+}
+
+static void test_string_append(void) {
+  nanostl::string s;
+  s.reserve(100);
+  TEST_CHECK(s.capacity() >= 100);
+
+  for (int i = 0; i < 10; i++) {
+    s.append("ab");
+    s.push_back('c');
+  }
+  TEST_CHECK(s.size() == 30);
+
+  s.insert(0, "<");
+  s += '>';
+  TEST_CHECK(s[0] == '<');
+  TEST_CHECK(s[s.size() - 1] == '>');
+
+  nanostl::string r("hello world");
+  r.replace(0, 5, "goodbye");
+  TEST_CHECK(r == "goodbye world");
+  r.insert(7, 3, '!');
+  TEST_CHECK(r == "goodbye!!! world");
+
+  nanostl::string a("a"), b("b"), c("c"), d("d");
+  TEST_CHECK(a + b + c + d == "abcd");
+  TEST_CHECK("x" + a + 'y' == "xay");
+}
+
+static void test_string_view(void) {
+  const char *text = "key = value; other = 42";
+  nanostl::string_view v(text);
+  TEST_CHECK(v.size() == 23);
+  TEST_CHECK(v.find("other") == 13);
+  TEST_CHECK(v.find('=') == 4);
+  TEST_CHECK(v.rfind('=') == 19);
+  TEST_CHECK(v.find_first_of(";=") == 4);
+  TEST_CHECK(v.find("missing") == nanostl::string_view::npos);
+  TEST_CHECK(v.starts_with("key"));
+  TEST_CHECK(v.substr(6, 5) == "value");
+
+  // Long enough to take the block-wise paths.
+  nanostl::string s(100, 'a');
+  s.append("needle");
+  TEST_CHECK(s.find("needle") == 100);
+  TEST_CHECK(s.rfind('a') == 99);
+  TEST_CHECK(nanostl::string_view(s).ends_with("needle"));
+  TEST_CHECK(nanostl::string(v.substr(0, 3)) == "key");
+}
+
+// Collects output through a 4 char put area.
+struct capture_buf : public nanostl::streambuf {
+  char area[4];
+  nanostl::string out;
+
+  capture_buf() { setp(area, area + 4); }
+
+  int_type overflow(int_type c) {
+    sync();
+    if (c != traits_type::eof()) {
+      *pptr() = char(c);
+      pbump(1);
+    }
+    return 0;
+  }
+
+  int sync() {
+    out.append(pbase(), size_t(pptr() - pbase()));
+    setp(area, area + 4);
+    return 0;
+  }
+};
+
+static void test_ostream(void) {
+  capture_buf buf;
+  nanostl::ostream os(&buf);
+  os << "abc" << ' ' << 42 << ' ' << -1.5 << ' ' << nanostl::string("str");
+  os.write("0123456789", 10);
+  os.put('!');
+  os << nanostl::hex << 255 << nanostl::dec << ' ' << nanostl::boolalpha
+     << true;
+  os.width(5);
+  os.fill('*');
+  os << 7 << nanostl::left;
+  os.width(3);
+  os << "x" << nanostl::flush;
+  TEST_CHECK(os.good());
+  TEST_CHECK(buf.out == "abc 42 -1.5 str0123456789!ff true****7x**");
+}
+
+// Exposes how much output is waiting in the put area.
+struct pending_filebuf : public nanostl::filebuf {
+  size_t pending() const { return size_t(pptr() - pbase()); }
+};
+
+static void test_filebuf_reopen(void) {
+  FILE *fp = tmpfile();
+  TEST_CHECK(fp != nullptr);
+  if (!fp) {
+    return;
+  }
+
+  pending_filebuf buf;
+  nanostl::ostream os(&buf);
+  TEST_CHECK(buf.attach(fp) != nullptr);
+  os << "abc";
+  TEST_CHECK(buf.pending() == 3);
+  TEST_CHECK(buf.close() != nullptr);
+
+  // Writes after attaching again are buffered too.
+  TEST_CHECK(buf.attach(fp) != nullptr);
+  for (int i = 0; i < 100; i++) {
+    os.put('x');
+  }
+  TEST_CHECK(buf.pending() == 100);
+  TEST_CHECK(buf.close() != nullptr);
+
+  char data[128];
+  rewind(fp);
+  size_t n = fread(data, 1, sizeof(data), fp);
+  TEST_CHECK(n == 103);
+  TEST_CHECK((n == 103) && (data[2] == 'c') && (data[3] == 'x') &&
+             (data[102] == 'x'));
+  fclose(fp);
+}
+
+static void test_stringstream(void) {
+  nanostl::ostringstream os;
+  os.reserve(64);
+  os << "{\"id\":" << 12 << ",\"v\":" << 0.5 << "}";
+  TEST_CHECK(os.str() == "{\"id\":12,\"v\":0.5}");
+  for (int i = 0; i < 100; i++) {
+    os << ' ' << i;  // grows past the reserved area
+  }
+  nanostl::string s = nanostl::move(os).str();
+  TEST_CHECK(s.size() == 17 + 290);
+  TEST_CHECK(os.str().empty());
+
+  nanostl::istringstream is(nanostl::move(s));
+  nanostl::string word;
+  int i = -1;
+  is >> word >> i;
+  TEST_CHECK(word == "{\"id\":12,\"v\":0.5}");
+  TEST_CHECK(i == 0);
+
+  nanostl::stringstream ss;
+  ss << "3 -2.25 true line\nrest";
+  int n = 0;
+  double d = 0.0;
+  bool b = false;
+  nanostl::string line;
+  ss >> n >> d >> nanostl::boolalpha >> b;
+  nanostl::getline(ss, line);
+  TEST_CHECK((n == 3) && (d == -2.25) && b);
+  TEST_CHECK(line == " line");
+  nanostl::getline(ss, line);
+  TEST_CHECK(line == "rest");
+  TEST_CHECK(ss.eof() && !ss.fail());
+  ss >> n;
+  TEST_CHECK(ss.fail());
+
+  // A failed sentry leaves the string alone.
+  nanostl::getline(ss, line);
+  TEST_CHECK(line == "rest");
+}
+
+static void test_istream_integer(void) {
+  // An integer longer than the scan buffer is consumed in full, saturates
+  // and fails, and the next field still reads.
+  nanostl::istringstream is("1234567890123456789012345678901234567890 7");
+  long long a = 0, b = 0;
+  is >> a;
+  TEST_CHECK(is.fail());
+  TEST_CHECK(a == nanostl::numeric_limits<long long>::max());
+  is.clear();
+  is >> b;
+  TEST_CHECK(b == 7);
+
+  nanostl::istringstream neg("-1234567890123456789012345678901234567890 -8");
+  neg >> a;
+  TEST_CHECK(neg.fail());
+  TEST_CHECK(a == nanostl::numeric_limits<long long>::min());
+  neg.clear();
+  neg >> b;
+  TEST_CHECK(b == -8);
+
+  // Leading zeros do not count against the buffer. The number ends the get
+  // area, so it goes through the scanner.
+  nanostl::istringstream zeros("0000000000000000000000000000000000000000042");
+  zeros >> a;
+  TEST_CHECK(!zeros.fail() && (a == 42));
+}
+
+static void test_istream_float(void) {
+  // A failed extraction only consumes a prefix of inf/infinity/nan.
+  nanostl::istringstream is("abc 1.5");
+  double d = 1.0;
+  is >> d;
+  TEST_CHECK(is.fail());
+  is.clear();
+  nanostl::string word;
+  is >> word >> d;
+  TEST_CHECK(word == "abc");
+  TEST_CHECK(d == 1.5);
+
+  nanostl::istringstream neg("-foo");
+  neg >> d;
+  TEST_CHECK(neg.fail());
+  neg.clear();
+  neg >> word;
+  TEST_CHECK(word == "foo");
+
+  nanostl::istringstream inf("INFo -Infinity nan iNfinityx inx");
+  double a = 0.0, b = 0.0, c = 0.0;
+  inf >> a >> word >> b >> c;
+  TEST_CHECK((a > 1e308) && (word == "o") && (b < -1e308) && (c != c));
+  inf >> d >> word;
+  TEST_CHECK((d > 1e308) && (word == "x"));
+  inf >> d;
+  TEST_CHECK(inf.fail());
+  inf.clear();
+  inf >> word;
+  TEST_CHECK(word == "x");
+
+  // A dangling exponent is consumed and fails, like std.
+  nanostl::istringstream e("1e x 2E+ y 3e-1");
+  e >> d;
+  TEST_CHECK(e.fail() && (d == 0.0));
+  e.clear();
+  e >> word >> d;
+  TEST_CHECK((word == "x") && e.fail() && (d == 0.0));
+  e.clear();
+  e >> word >> d;
+  TEST_CHECK((word == "y") && (d == 0.3));
+
+  nanostl::istringstream end("1e");
+  end >> d;
+  TEST_CHECK(end.fail() && (d == 0.0));
+
+  // Overflow fails with +-max(), underflow reads as 0, as in std.
+  nanostl::istringstream range("1e400 -0.5e309 1e-400 -0.00001e-320 x");
+  range >> d;
+  TEST_CHECK(range.fail() && (d == nanostl::numeric_limits<double>::max()));
+  range.clear();
+  range >> d;
+  TEST_CHECK(range.fail() && (d == -nanostl::numeric_limits<double>::max()));
+  range.clear();
+  range >> a >> b >> word;
+  TEST_CHECK(!range.fail() && (a == 0.0) && (b == 0.0) && (word == "x"));
+  float f = 1.0f;
+  nanostl::istringstream fr("1e39");
+  fr >> f;
+  TEST_CHECK(fr.fail() && (f == nanostl::numeric_limits<float>::max()));
+}
+
+static void add_to(int *p, int v) { *p += v; }
+
+static void test_thread(void) {
+  int x = 0;
+  nanostl::thread th(add_to, &x, 3);
+  TEST_CHECK(th.joinable());
+  TEST_CHECK(th.get_id() != nanostl::this_thread::get_id());
+  th.join();
+  TEST_CHECK(!th.joinable());
+  TEST_CHECK(x == 3);
+
+  nanostl::thread a([&x] { x += 10; });
+  nanostl::thread b(nanostl::move(a));
+  TEST_CHECK(!a.joinable());
+  b.join();
+  TEST_CHECK(x == 13);
+
+  nanostl::thread_pool pool(4);
+  TEST_CHECK(pool.size() >= 1);
+  nanostl::vector<int> v;
+  v.resize(1000);
+  for (size_t i = 0; i < v.size(); i++) {
+    pool.submit([&v](size_t k) { v[k] = int(k); }, i);
+  }
+  pool.wait();
+  bool ok = true;
+  for (size_t i = 0; i < v.size(); i++) {
+    ok = ok && (v[i] == int(i));
+  }
+  TEST_CHECK(ok);
+
+  pool.parallel_for(0, v.size(), [&v](size_t i) { v[i] *= 2; });
+  ok = true;
+  for (size_t i = 0; i < v.size(); i++) {
+    ok = ok && (v[i] == int(2 * i));
+  }
+  TEST_CHECK(ok);
+}
+
+static long fib(nanostl::task_scheduler &s, int n) {
+  if (n < 2) {
+    return n;
+  }
+  long a = 0;
+  nanostl::task_group g(s);
+  g.spawn([&s, &a, n] { a = fib(s, n - 1); });
+  long b = fib(s, n - 2);
+  g.sync();
+  return a + b;
+}
+
+static void test_task_scheduler(void) {
+  nanostl::task_scheduler sched(4);
+  TEST_CHECK(sched.size() >= 1);
+  TEST_CHECK(fib(sched, 20) == 6765);
+
+  int a = 0, b = 0, c = 0;
+  nanostl::parallel_invoke(sched, [&a] { a = 1; }, [&b] { b = 2; },
+                           [&c] { c = 3; });
+  TEST_CHECK((a == 1) && (b == 2) && (c == 3));
+
+  nanostl::vector<int> v;
+  v.resize(1000);
+  {
+    nanostl::task_group g(sched);
+    for (size_t i = 0; i < v.size(); i++) {
+      g.spawn([&v](size_t k) { v[k] = int(k); }, i);
+    }
+  }  // syncs
+  bool ok = true;
+  for (size_t i = 0; i < v.size(); i++) {
+    ok = ok && (v[i] == int(i));
+  }
+  TEST_CHECK(ok);
+}
+
+static void test_cstring(void) {
+  // Sizes around the 8/16/32 byte kernel boundaries.
+  char buf[128];
+  for (size_t n = 0; n < 80; n++) {
+    for (size_t i = 0; i < sizeof(buf); i++) {
+      buf[i] = char(i);
+    }
+    nanostl::memmove(buf + 3, buf, n);  // overlapping, copies backward
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+      ok = ok && (buf[i + 3] == char(i));
+    }
+    nanostl::memmove(buf, buf + 5, n);  // overlapping, copies forward
+    TEST_CHECK(ok);
+
+    nanostl::memset(buf, 'x', n);
+    buf[n] = '\0';
+    TEST_CHECK(nanostl::strlen(buf) == n);
+    TEST_CHECK(nanostl::memchr(buf, 'y', n) == 0);
+    if (n > 0) {
+      buf[n - 1] = 'y';
+      TEST_CHECK(nanostl::memchr(buf, 'y', n) == buf + n - 1);
+      TEST_CHECK(nanostl::strchr(buf, 'y') == buf + n - 1);
+    }
+  }
+
+  const char *a = "the quick brown fox jumps over the lazy dog";
+  const char *b = "the quick brown fox jumps over the lazy cat";
+  TEST_CHECK(nanostl::memcmp(a, b, 40) == 0);
+  TEST_CHECK(nanostl::memcmp(a, b, 41) > 0);
+  TEST_CHECK(nanostl::strcmp(a, b) > 0);
+  TEST_CHECK(nanostl::strncmp(a, b, 40) == 0);
+  TEST_CHECK(nanostl::strstr(a, "lazy") == a + 35);
+  TEST_CHECK(nanostl::strrchr(a, 'o') == a + 41);
+  TEST_CHECK(nanostl::strspn(a, "eht") == 3);
+  TEST_CHECK(nanostl::strcspn(a, "xyz") == 18);
+  TEST_CHECK(nanostl::strpbrk(a, "qz") == a + 4);
+
+  char dst[64];
+  nanostl::strcpy(dst, "foo");
+  nanostl::strcat(dst, "bar");
+  nanostl::strncat(dst, "bazqux", 3);
+  TEST_CHECK(nanostl::strcmp(dst, "foobarbaz") == 0);
+  nanostl::strncpy(dst, "ab", 8);
+  TEST_CHECK((dst[1] == 'b') && (dst[2] == '\0') && (dst[7] == '\0'));
+}
+
 static void test_map(void) {
   nanostl::map<nanostl::string, int> m;
 
@@ -281,6 +910,234 @@ static void test_map(void) {
   TEST_CHECK(m["b"] == 2);
 }
 
+static void test_map_clear(void) {
+  nanostl::map<int, nanostl::string> m;
+
+  for (int i = 0; i < 1000; i++) {
+    m[i] = "v";
+  }
+
+  nanostl::map<int, nanostl::string> c(m);
+
+  m.clear();
+  TEST_CHECK(m.empty());
+
+  // Storage is reused after clear().
+  m[1] = "a";
+  TEST_CHECK(m[1] == "a");
+  TEST_CHECK(c[999] == "v");
+}
+
+static void test_map_iteration(void) {
+  nanostl::map<int, int> m;
+
+  TEST_CHECK(m.begin() == m.end());
+
+  for (int i = 0; i < 1000; i++) {
+    int k = (i * 7919) % 1000;
+    m[k] = k * 2;
+  }
+
+  // In-order traversal visits keys in ascending order.
+  int expected = 0;
+  for (nanostl::map<int, int>::iterator it = m.begin(); it != m.end(); ++it) {
+    TEST_CHECK(it->first == expected);
+    TEST_CHECK(it->second == expected * 2);
+    expected++;
+  }
+  TEST_CHECK(expected == 1000);
+
+  // Walk backwards from end().
+  nanostl::map<int, int>::iterator it = m.end();
+  for (int i = 999; i >= 0; i--) {
+    --it;
+    TEST_CHECK(it->first == i);
+  }
+  TEST_CHECK(it == m.begin());
+
+  const nanostl::map<int, int>& cm = m;
+  nanostl::map<int, int>::const_iterator cit = cm.find(500);
+  TEST_CHECK(cit != cm.end());
+  ++cit;
+  TEST_CHECK(cit->first == 501);
+  TEST_CHECK(cm.find(1000) == cm.end());
+}
+
+static void test_map_erase(void) {
+  nanostl::map<int, nanostl::string> m;
+
+  for (int i = 0; i < 100; i++) {
+    m[i] = "v";
+  }
+  TEST_CHECK(m.size() == 100);
+
+  TEST_CHECK(m.erase(10) == 1);
+  TEST_CHECK(m.erase(10) == 0);
+  TEST_CHECK(m.count(10) == 0);
+  TEST_CHECK(m.count(11) == 1);
+  TEST_CHECK(m.size() == 99);
+
+  TEST_CHECK(m.lower_bound(10)->first == 11);
+  TEST_CHECK(m.upper_bound(11)->first == 12);
+  TEST_CHECK(m.lower_bound(100) == m.end());
+
+  // Erase odd keys while iterating.
+  nanostl::map<int, nanostl::string>::iterator it = m.begin();
+  while (it != m.end()) {
+    if (it->first & 1) {
+      it = m.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  TEST_CHECK(m.size() == 49);
+  for (it = m.begin(); it != m.end(); ++it) {
+    TEST_CHECK((it->first & 1) == 0);
+  }
+
+  m.erase(m.begin(), m.end());
+  TEST_CHECK(m.empty());
+  TEST_CHECK(m.size() == 0);
+}
+
+static void test_btree_map(void) {
+  nanostl::btree_map<int, int> m;
+
+  for (int i = 0; i < 10000; i++) {
+    int k = (i * 7919) % 10000;
+    m[k] = k * 2;
+  }
+  TEST_CHECK(m.size() == 10000);
+
+  int expected = 0;
+  for (nanostl::btree_map<int, int>::iterator it = m.begin(); it != m.end();
+       ++it) {
+    TEST_CHECK(it->first == expected);
+    TEST_CHECK(it->second == expected * 2);
+    expected++;
+  }
+
+  for (int i = 0; i < 10000; i += 2) {
+    TEST_CHECK(m.erase(i) == 1);
+  }
+  TEST_CHECK(m.size() == 5000);
+  TEST_CHECK(m.count(10) == 0);
+  TEST_CHECK(m.find(11)->second == 22);
+  TEST_CHECK(m.lower_bound(10)->first == 11);
+  TEST_CHECK(m.upper_bound(11)->first == 13);
+  TEST_CHECK((--m.end())->first == 9999);
+
+  nanostl::btree_map<int, int> c(m);
+  m.clear();
+  TEST_CHECK(m.empty());
+  TEST_CHECK(c.size() == 5000);
+}
+
+static void test_btree_bulk_load(void) {
+  nanostl::vector<nanostl::pair<int, int> > v;
+  nanostl::vector<int> keys;
+  for (int i = 0; i < 1000; i++) {
+    v.push_back(nanostl::make_pair(i * 3, i));
+    keys.push_back(i * 3);
+  }
+
+  nanostl::btree_map<int, int> m(nanostl::sorted_unique, v.begin(), v.end());
+  TEST_CHECK(m.size() == 1000);
+  TEST_CHECK(m.find(300)->second == 100);
+  TEST_CHECK(m.find(301) == m.end());
+
+  {
+    // Nodes and the scratch buffers all come from the arena.
+    nanostl::monotonic_arena arena(4096);
+    nanostl::arena_allocator<int> alloc(&arena);
+    nanostl::btree_set<int, nanostl::less<int>, nanostl::arena_allocator<int> >
+        as(nanostl::sorted_unique, keys.begin(), keys.end(),
+           nanostl::less<int>(), alloc);
+    TEST_CHECK(as.size() == 1000);
+    TEST_CHECK(*as.begin() == 0);
+    TEST_CHECK(arena.bytes_allocated() > 0);
+  }
+
+  nanostl::btree_set<int> s;
+  s.insert(3);
+  s.insert(1);
+  s.insert(2);
+  s.insert(1);
+  TEST_CHECK(s.size() == 3);
+  TEST_CHECK(*s.begin() == 1);
+}
+
+static void test_unordered_map(void) {
+  nanostl::unordered_map<int, int> m;
+
+  for (int i = 0; i < 10000; i++) {
+    m[i] = i * 2;
+  }
+  TEST_CHECK(m.size() == 10000);
+  TEST_CHECK(m.load_factor() <= m.max_load_factor());
+
+  for (int i = 0; i < 10000; i += 2) {
+    TEST_CHECK(m.erase(i) == 1);
+  }
+  TEST_CHECK(m.size() == 5000);
+  TEST_CHECK(m.count(10) == 0);
+  TEST_CHECK(m.find(11)->second == 22);
+  TEST_CHECK(m.find(10000) == m.end());
+
+  int n = 0;
+  for (nanostl::unordered_map<int, int>::iterator it = m.begin();
+       it != m.end(); ++it) {
+    TEST_CHECK(it->first & 1);
+    n++;
+  }
+  TEST_CHECK(n == 5000);
+
+  nanostl::unordered_map<int, int> c(m);
+  m.clear();
+  TEST_CHECK(m.empty());
+  TEST_CHECK(c[9999] == 19998);
+}
+
+static void test_unordered_set(void) {
+  nanostl::unordered_set<int> s;
+  s.max_load_factor(0.5f);
+  s.reserve(1000);
+  nanostl::size_type buckets = s.bucket_count();
+
+  for (int i = 0; i < 1000; i++) {
+    s.insert(i * 3);
+  }
+  TEST_CHECK(s.size() == 1000);
+  TEST_CHECK(s.bucket_count() == buckets);
+  TEST_CHECK(s.count(300) == 1);
+  TEST_CHECK(s.count(301) == 0);
+  TEST_CHECK(!s.insert(3).second);
+}
+
+static void test_hash(void) {
+  nanostl::hash<nanostl::string> hs;
+  nanostl::string a("hello");
+  TEST_CHECK(hs(a) == hs("hello"));
+  TEST_CHECK(hs(a) != hs(nanostl::string("hellp")));
+
+  nanostl::hash<int> hi;
+  TEST_CHECK(hi(1) != hi(2));
+  TEST_CHECK((hi(1) >> 32) != 0);
+
+  nanostl::hash<double> hd;
+  TEST_CHECK(hd(0.0) == hd(-0.0));
+
+  int x[2];
+  nanostl::hash<int *> hp;
+  TEST_CHECK(hp(&x[0]) != hp(&x[1]));
+
+  nanostl::unordered_map<nanostl::string, int> m;
+  m[nanostl::string("one")] = 1;
+  m[nanostl::string("two")] = 2;
+  TEST_CHECK(m.size() == 2);
+  TEST_CHECK(m[nanostl::string("two")] == 2);
+}
+
 static void test_limits(void) {
   TEST_CHECK(nanostl::numeric_limits<char>::min() ==
              std::numeric_limits<char>::min());
@@ -624,6 +1481,116 @@ static void test_to_string(void) {
     std::string str(s);
     TEST_CHECK(str.compare("-133445923") == 0);
   }
+
+  // 64-bit and unsigned
+  {
+    nanostl::string ns = nanostl::to_string(-9223372036854775807LL - 1);
+    TEST_CHECK(std::string(ns.c_str()) == "-9223372036854775808");
+    ns = nanostl::to_string(18446744073709551615ULL);
+    TEST_CHECK(std::string(ns.c_str()) == "18446744073709551615");
+    ns = nanostl::to_string(4294967295u);
+    TEST_CHECK(std::string(ns.c_str()) == "4294967295");
+  }
+}
+
+static void test_to_chars(void) {
+  char buf[8];
+  nanostl::to_chars_result r = nanostl::to_chars(buf, buf + 8, -1234567);
+  TEST_CHECK(r.ec == nanostl::errc());
+  TEST_CHECK(std::string(buf, r.ptr) == "-1234567");
+
+  r = nanostl::to_chars(buf, buf + 8, 123456789);
+  TEST_CHECK(r.ec == nanostl::errc::value_too_large);
+  TEST_CHECK(r.ptr == buf + 8);
+
+  r = nanostl::to_chars(buf, buf + 8, 255u, 16);
+  TEST_CHECK(std::string(buf, r.ptr) == "ff");
+}
+
+static void test_to_chars_float(void) {
+  char buf[64];
+  nanostl::to_chars_result r = nanostl::to_chars(buf, buf + 64, 0.1);
+  TEST_CHECK(std::string(buf, r.ptr) == "0.1");
+
+  r = nanostl::to_chars(buf, buf + 64, 1e21);
+  TEST_CHECK(std::string(buf, r.ptr) == "1e+21");
+
+  r = nanostl::to_chars(buf, buf + 64, 1.5f, nanostl::chars_format::scientific);
+  TEST_CHECK(std::string(buf, r.ptr) == "1.5e+00");
+
+  r = nanostl::to_chars(buf, buf + 64, 1e-3, nanostl::chars_format::fixed);
+  TEST_CHECK(std::string(buf, r.ptr) == "0.001");
+
+  r = nanostl::to_chars(buf, buf + 64, 1234567.0, nanostl::chars_format::general);
+  TEST_CHECK(std::string(buf, r.ptr) == "1.234567e+06");
+
+  r = nanostl::to_chars(buf, buf + 64, 3.0f, nanostl::chars_format::hex);
+  TEST_CHECK(std::string(buf, r.ptr) == "1.8p+1");
+
+  r = nanostl::to_chars(buf, buf + 4, -1.25);
+  TEST_CHECK(r.ec == nanostl::errc::value_too_large);
+}
+
+static void test_from_chars(void) {
+  const char *s = "-12.5e-1,";
+  double d = 0.0;
+  nanostl::from_chars_result r = nanostl::from_chars(s, s + 9, d);
+  TEST_CHECK(r.ec == nanostl::errc());
+  TEST_CHECK(r.ptr == s + 8);
+  TEST_CHECK(d == -1.25);
+
+  float f = 7.0f;
+  const char *big = "1e39";
+  r = nanostl::from_chars(big, big + 4, f);
+  TEST_CHECK(r.ec == nanostl::errc::result_out_of_range);
+  TEST_CHECK(f == 7.0f);
+
+  const char *bad = "+1";
+  r = nanostl::from_chars(bad, bad + 2, d);
+  TEST_CHECK(r.ec == nanostl::errc::invalid_argument);
+  TEST_CHECK(r.ptr == bad);
+
+  const char *sci = "100";
+  r = nanostl::from_chars(sci, sci + 3, d, nanostl::chars_format::scientific);
+  TEST_CHECK(r.ec == nanostl::errc::invalid_argument);
+}
+
+static void test_parse_floats(void) {
+  const char *s = "  1.5, -2\n3e2\t\t0.25  \n";
+  const char *e = s + nanostl::strlen(s);
+
+  nanostl::vector<float> v;
+  nanostl::parse_floats_result r = nanostl::parse_floats(s, e, v);
+  TEST_CHECK(r.ec == nanostl::errc());
+  TEST_CHECK(r.ptr == e);
+  TEST_CHECK(r.count == 4);
+  TEST_CHECK(v.size() == 4);
+  TEST_CHECK(v[0] == 1.5f);
+  TEST_CHECK(v[1] == -2.0f);
+  TEST_CHECK(v[2] == 300.0f);
+  TEST_CHECK(v[3] == 0.25f);
+
+  double d[2];
+  r = nanostl::parse_floats(s, e, d, 2);
+  TEST_CHECK(r.ec == nanostl::errc::value_too_large);
+  TEST_CHECK(r.count == 2);
+  TEST_CHECK(r.ptr == s + 10);
+  TEST_CHECK(d[1] == -2.0);
+
+  const char *bad = "1 2.5x 3";
+  v.clear();
+  r = nanostl::parse_floats(bad, bad + 8, v);
+  TEST_CHECK(r.ec == nanostl::errc::invalid_argument);
+  TEST_CHECK(r.ptr == bad + 2);
+  TEST_CHECK(r.count == 1);
+
+  nanostl::parse_floats_options opts;
+  opts.delimiters = ";";
+  const char *csv = "1;2;;3";
+  v.clear();
+  r = nanostl::parse_floats(csv, csv + 6, v, opts);
+  TEST_CHECK(r.ec == nanostl::errc());
+  TEST_CHECK(v.size() == 3);
 }
 
 static void test_stof(void) {
@@ -632,6 +1599,33 @@ static void test_stof(void) {
 
 static void test_stod(void) {
   TEST_CHECK(double_equals_by_ulps(nanostl::stod("1.0"), 1.0, 0));
+
+  nanostl::size_t idx = 0;
+  TEST_CHECK(nanostl::stod("  -2.5e3xyz", &idx) == -2500.0);
+  TEST_CHECK(idx == 8);
+  TEST_CHECK(nanostl::stod("+0.5", &idx) == 0.5);
+  TEST_CHECK(idx == 4);
+
+  idx = 7;
+  double d = nanostl::stod("abc", &idx);
+  TEST_CHECK(d != d);
+  TEST_CHECK(idx == 7);
+}
+
+static void test_try_stod(void) {
+  nanostl::expected<double, nanostl::errc> r = nanostl::try_stod("\t1e-3");
+  TEST_CHECK(r.has_value());
+  TEST_CHECK(*r == 1e-3);
+
+  r = nanostl::try_stod("");
+  TEST_CHECK(!r.has_value());
+  TEST_CHECK(r.error() == nanostl::errc::invalid_argument);
+
+  r = nanostl::try_stod("1e400");
+  TEST_CHECK(r.error() == nanostl::errc::result_out_of_range);
+
+  nanostl::expected<float, nanostl::errc> f = nanostl::try_stof("1e39");
+  TEST_CHECK(f.error() == nanostl::errc::result_out_of_range);
 }
 
 static void test_unique_ptr(void) {
@@ -672,10 +1666,34 @@ static void test_expected(void) {
 extern "C" void test_valarray(void);
 
 TEST_LIST = {{"test-vector", test_vector},
+             {"test-vector-growth", test_vector_growth},
+             {"test-allocator", test_allocator},
+             {"test-arena", test_arena},
              {"test-limits", test_limits},
              {"test-string", test_string},
+             {"test-string-sso", test_string_sso},
+             {"test-string-append", test_string_append},
+             {"test-string-view", test_string_view},
+             {"test-cstring", test_cstring},
+             {"test-ostream", test_ostream},
+             {"test-filebuf-reopen", test_filebuf_reopen},
+             {"test-stringstream", test_stringstream},
+             {"test-istream-integer", test_istream_integer},
+             {"test-istream-float", test_istream_float},
+             {"test-thread", test_thread},
+             {"test-task-scheduler", test_task_scheduler},
              {"test-map", test_map},
+             {"test-map-clear", test_map_clear},
+             {"test-map-iteration", test_map_iteration},
+             {"test-map-erase", test_map_erase},
+             {"test-btree-map", test_btree_map},
+             {"test-btree-bulk-load", test_btree_bulk_load},
+             {"test-unordered-map", test_unordered_map},
+             {"test-unordered-set", test_unordered_set},
+             {"test-hash", test_hash},
              {"test-algorithm", test_algorithm},
+             {"test-sort", test_sort},
+             {"test-numeric", test_numeric},
              {"test-iterator", test_iterator},
              {"test-math-func1", test_math_func1},
              {"test-math-exp", test_math_exp},
@@ -692,7 +1710,13 @@ TEST_LIST = {{"test-vector", test_vector},
              {"test-double-nan", test_double_nan},
              {"test-digits10", test_digits10},
              {"test-to_string", test_to_string},
+             {"test-to_chars", test_to_chars},
+             {"test-to_chars-float", test_to_chars_float},
+             {"test-from_chars", test_from_chars},
+             {"test-parse-floats", test_parse_floats},
              {"test-stof", test_stof},
+             {"test-stod", test_stod},
+             {"test-try_stod", test_try_stod},
              {"test-unique_ptr", test_unique_ptr},
              {"test-optional", test_optional},
              {"test-variant", test_variant},
@@ -0,0 +1,425 @@
+// Tests of the execution policy overloads. Built separately from test.cc,
+// as C++17 with NANOSTL_PSTL. The threaded parse_floats path
+// (NANOSTL_PARSE_USE_THREAD) is tested here too, as it links the same
+// thread sources.
+#ifndef NANOSTL_PSTL
+#error "NANOSTL_PSTL must be defined"
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#endif
+
+#include "acutest.h"
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#include "nanoalgorithm.h"
+#include "nanoexecution.h"
+#include "nanonumeric.h"
+#include "nanoparse.h"
+#include "nanothread_pool.h"
+#include "nanovector.h"
+
+// Large enough to be split into several chunks by parallel policies.
+static const size_t kLarge = 5 * nanostl::__pstl::__min_chunk_size + 123;
+
+template <class T>
+static size_t count_equal(const nanostl::vector<T> &v, size_t first,
+                          size_t last, const T &value) {
+  size_t n = 0;
+  for (size_t i = first; i < last; i++) {
+    n += (v[i] == value) ? 1 : 0;
+  }
+  return n;
+}
+
+static void test_fill(void) {
+  nanostl::vector<float> v;
+  v.resize(kLarge);
+
+  nanostl::fill(nanostl::execution::par, v.begin(), v.end(), 1.5f);
+  TEST_CHECK(count_equal(v, 0, kLarge, 1.5f) == kLarge);
+
+  nanostl::fill(nanostl::execution::par_unseq, v.begin(), v.end(), 2.5f);
+  TEST_CHECK(count_equal(v, 0, kLarge, 2.5f) == kLarge);
+
+  nanostl::fill(nanostl::execution::unseq, v.begin(), v.begin() + 100, 3.0f);
+  TEST_CHECK(count_equal(v, 0, 100, 3.0f) == 100);
+
+  nanostl::fill(nanostl::execution::seq, v.begin() + 100, v.end(), 4.0f);
+  TEST_CHECK(count_equal(v, 0, 100, 3.0f) == 100);
+  TEST_CHECK(count_equal(v, 100, kLarge, 4.0f) == kLarge - 100);
+
+  // Shorter than one chunk.
+  nanostl::vector<int> s;
+  s.resize(13);
+  nanostl::fill(nanostl::execution::par_unseq, s.begin(), s.end(), 42);
+  TEST_CHECK(count_equal(s, 0, 13, 42) == 13);
+}
+
+static void test_nested(void) {
+  // Policy overloads called from tasks of the shared pool(nested
+  // parallel_for on the same pool).
+  nanostl::vector<int> outer;
+  outer.resize(kLarge);
+  nanostl::vector<int> inner[3];
+  for (int k = 0; k < 3; k++) {
+    inner[k].resize(kLarge);
+  }
+  nanostl::for_each(nanostl::execution::par, outer.begin(), outer.end(),
+                    [&outer, &inner](int &x) {
+                      const size_t i = size_t(&x - &outer[0]);
+                      if ((i % (2 * nanostl::__pstl::__min_chunk_size)) == 0) {
+                        nanostl::vector<int> &w =
+                            inner[i / (2 * nanostl::__pstl::__min_chunk_size)];
+                        nanostl::fill(nanostl::execution::par, w.begin(),
+                                      w.end(), 7);
+                      }
+                      x = 1;
+                    });
+  TEST_CHECK(count_equal(outer, 0, kLarge, 1) == kLarge);
+  for (int k = 0; k < 3; k++) {
+    TEST_CHECK(count_equal(inner[k], 0, kLarge, 7) == kLarge);
+  }
+
+  // From a task of a user thread_pool.
+  nanostl::thread_pool pool(2);
+  nanostl::vector<int> v;
+  v.resize(kLarge);
+  pool.submit([&v] {
+    nanostl::fill(nanostl::execution::par_unseq, v.begin(), v.end(), 9);
+  });
+  pool.wait();
+  TEST_CHECK(count_equal(v, 0, kLarge, 9) == kLarge);
+}
+
+// x -> x * a + b. Composition is associative but not commutative, so a
+// scan combining chunks out of order gives a different result.
+struct Affine {
+  unsigned a;
+  unsigned b;
+};
+
+static Affine compose(const Affine &f, const Affine &g) {
+  Affine h;
+  h.a = f.a * g.a;
+  h.b = f.b * g.a + g.b;
+  return h;
+}
+
+static nanostl::vector<unsigned> make_data(size_t n) {
+  nanostl::vector<unsigned> v;
+  v.resize(n);
+  unsigned x = 12345u;
+  for (size_t i = 0; i < n; i++) {
+    x = x * 1103515245u + 12345u;
+    v[i] = (x >> 8) & 0xffff;
+  }
+  return v;
+}
+
+template <class T>
+static bool equal(const nanostl::vector<T> &a, const nanostl::vector<T> &b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (!(a[i] == b[i])) return false;
+  }
+  return true;
+}
+
+static void test_transform_copy(void) {
+  const nanostl::vector<unsigned> v = make_data(kLarge);
+  nanostl::vector<unsigned> ref, out;
+  ref.resize(kLarge);
+  out.resize(kLarge);
+
+  auto twice = [](unsigned x) { return 2 * x + 1; };
+  nanostl::transform(v.begin(), v.end(), ref.begin(), twice);
+  TEST_CHECK(nanostl::transform(nanostl::execution::par, v.begin(), v.end(),
+                                out.begin(), twice) == out.end());
+  TEST_CHECK(equal(out, ref));
+
+  auto sub = [](unsigned x, unsigned y) { return y - x; };
+  nanostl::transform(v.begin(), v.end(), ref.begin(), ref.begin(), sub);
+  nanostl::transform(nanostl::execution::par_unseq, v.begin(), v.end(),
+                     out.begin(), out.begin(), sub);
+  TEST_CHECK(equal(out, ref));
+
+  TEST_CHECK(nanostl::copy(nanostl::execution::par, v.begin(), v.end(),
+                           out.begin()) == out.end());
+  TEST_CHECK(equal(out, v));
+
+  nanostl::for_each(nanostl::execution::par, out.begin(), out.end(),
+                    [](unsigned &x) { x += 1; });
+  nanostl::for_each(ref.begin(), ref.end(), [](unsigned &x) { x = 0; });
+  nanostl::transform(v.begin(), v.end(), ref.begin(),
+                     [](unsigned x) { return x + 1; });
+  TEST_CHECK(equal(out, ref));
+}
+
+static void test_count_find(void) {
+  const nanostl::vector<unsigned> v = make_data(kLarge);
+  auto odd = [](unsigned x) { return (x & 1) != 0; };
+  TEST_CHECK(nanostl::count_if(nanostl::execution::par, v.begin(), v.end(),
+                               odd) == nanostl::count_if(v.begin(), v.end(),
+                                                         odd));
+
+  // Matches only in the later chunks. The first one must win, although
+  // chunks after it may finish first.
+  nanostl::vector<unsigned> w;
+  w.resize(kLarge);
+  nanostl::fill(w.begin(), w.end(), 0u);
+  const size_t first_match = 3 * nanostl::__pstl::__min_chunk_size + 17;
+  for (size_t i = first_match; i < kLarge; i += 1000) {
+    w[i] = 1;
+  }
+  auto is_one = [](unsigned x) { return x == 1; };
+  TEST_CHECK(nanostl::find_if(nanostl::execution::par, w.begin(), w.end(),
+                              is_one) == w.begin() + first_match);
+  TEST_CHECK(nanostl::find_if(nanostl::execution::par_unseq, w.begin(),
+                              w.end(), [](unsigned x) { return x == 2; }) ==
+             w.end());
+  w[kLarge - 1] = 2;
+  TEST_CHECK(nanostl::find_if(nanostl::execution::par, w.begin(), w.end(),
+                              [](unsigned x) { return x == 2; }) ==
+             w.end() - 1);
+}
+
+static void test_reduce(void) {
+  const nanostl::vector<unsigned> v = make_data(kLarge);
+  TEST_CHECK(nanostl::reduce(nanostl::execution::par, v.begin(), v.end()) ==
+             nanostl::reduce(v.begin(), v.end()));
+  TEST_CHECK(nanostl::reduce(nanostl::execution::par_unseq, v.begin(), v.end(),
+                             7u) == nanostl::reduce(v.begin(), v.end(), 7u));
+  auto max_op = [](unsigned a, unsigned b) { return (a < b) ? b : a; };
+  TEST_CHECK(nanostl::reduce(nanostl::execution::par, v.begin(), v.end(), 0u,
+                             max_op) ==
+             nanostl::reduce(v.begin(), v.end(), 0u, max_op));
+
+  TEST_CHECK(nanostl::transform_reduce(nanostl::execution::par, v.begin(),
+                                       v.end(), v.begin(), 1u) ==
+             nanostl::transform_reduce(v.begin(), v.end(), v.begin(), 1u));
+  auto low = [](unsigned x) { return x & 0xff; };
+  TEST_CHECK(nanostl::transform_reduce(nanostl::execution::par, v.begin(),
+                                       v.end(), 0u, nanostl::plus<>(), low) ==
+             nanostl::transform_reduce(v.begin(), v.end(), 0u,
+                                       nanostl::plus<>(), low));
+}
+
+static void test_scan(void) {
+  const nanostl::vector<unsigned> v = make_data(kLarge);
+  nanostl::vector<unsigned> ref, out;
+  ref.resize(kLarge);
+  out.resize(kLarge);
+
+  nanostl::inclusive_scan(v.begin(), v.end(), ref.begin());
+  TEST_CHECK(nanostl::inclusive_scan(nanostl::execution::par, v.begin(),
+                                     v.end(), out.begin()) == out.end());
+  TEST_CHECK(equal(out, ref));
+
+  nanostl::exclusive_scan(v.begin(), v.end(), ref.begin(), 5u);
+  nanostl::exclusive_scan(nanostl::execution::par_unseq, v.begin(), v.end(),
+                          out.begin(), 5u);
+  TEST_CHECK(equal(out, ref));
+
+  // In place, with an init value.
+  auto add = [](unsigned a, unsigned b) { return a + b; };
+  nanostl::inclusive_scan(v.begin(), v.end(), ref.begin(), add, 3u);
+  out = v;
+  nanostl::inclusive_scan(nanostl::execution::par, out.begin(), out.end(),
+                          out.begin(), add, 3u);
+  TEST_CHECK(equal(out, ref));
+
+  nanostl::exclusive_scan(v.begin(), v.end(), ref.begin(), 3u, add);
+  out = v;
+  nanostl::exclusive_scan(nanostl::execution::par, out.begin(), out.end(),
+                          out.begin(), 3u, add);
+  TEST_CHECK(equal(out, ref));
+
+  // Non-commutative operation: chunk carries must be applied in order.
+  nanostl::vector<Affine> f, fref, fout;
+  f.resize(kLarge);
+  fref.resize(kLarge);
+  fout.resize(kLarge);
+  for (size_t i = 0; i < kLarge; i++) {
+    f[i].a = v[i] | 1;
+    f[i].b = v[i] >> 3;
+  }
+  nanostl::inclusive_scan(f.begin(), f.end(), fref.begin(), compose);
+  nanostl::inclusive_scan(nanostl::execution::par, f.begin(), f.end(),
+                          fout.begin(), compose);
+  bool same = true;
+  for (size_t i = 0; i < kLarge; i++) {
+    same &= (fout[i].a == fref[i].a) && (fout[i].b == fref[i].b);
+  }
+  TEST_CHECK(same);
+}
+
+// Not trivially copyable: sorting must move the payload along.
+struct Record {
+  unsigned key;
+  unsigned id;
+  nanostl::vector<unsigned> payload;
+};
+
+static bool record_less(const Record &a, const Record &b) {
+  return a.key < b.key;
+}
+
+static nanostl::vector<Record> make_records(size_t n, unsigned num_keys) {
+  const nanostl::vector<unsigned> v = make_data(n);
+  nanostl::vector<Record> r;
+  r.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    r[i].key = v[i] % num_keys;
+    r[i].id = unsigned(i);
+    r[i].payload.push_back(unsigned(i));
+  }
+  return r;
+}
+
+// Sorted by key, and every record still owns its own payload.
+static bool records_sorted(const nanostl::vector<Record> &r, bool stable) {
+  nanostl::vector<unsigned> seen;
+  seen.resize(r.size());
+  nanostl::fill(seen.begin(), seen.end(), 0u);
+  for (size_t i = 0; i < r.size(); i++) {
+    if ((r[i].payload.size() != 1) || (r[i].payload[0] != r[i].id)) {
+      return false;
+    }
+    if (r[i].id >= r.size() || seen[r[i].id]++) {
+      return false;
+    }
+    if (i > 0) {
+      if (r[i].key < r[i - 1].key) return false;
+      if (stable && (r[i].key == r[i - 1].key) && (r[i].id < r[i - 1].id)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void test_sort(void) {
+  // Several chunks, so there are several merge rounds.
+  const size_t n = 9 * nanostl::__pstl::__min_chunk_size + 77;
+
+  nanostl::vector<unsigned> v = make_data(n);
+  nanostl::vector<unsigned> ref = v;
+  nanostl::sort(ref.begin(), ref.end());
+  nanostl::sort(nanostl::execution::par, v.begin(), v.end());
+  TEST_CHECK(equal(v, ref));
+
+  v = make_data(n);
+  nanostl::sort(nanostl::execution::par_unseq, v.begin(), v.end(),
+                [](unsigned a, unsigned b) { return a > b; });
+  bool descending = true;
+  for (size_t i = 0; i < n; i++) {
+    descending &= (v[i] == ref[n - 1 - i]);
+  }
+  TEST_CHECK(descending);
+
+  nanostl::vector<Record> r = make_records(n, 1000);
+  nanostl::sort(nanostl::execution::par, r.begin(), r.end(), record_less);
+  TEST_CHECK(records_sorted(r, false));
+}
+
+static void test_stable_sort(void) {
+  const size_t n = 9 * nanostl::__pstl::__min_chunk_size + 77;
+
+  // Few distinct keys: every key has equal elements in every chunk.
+  nanostl::vector<Record> r = make_records(n, 5);
+  nanostl::stable_sort(nanostl::execution::par, r.begin(), r.end(),
+                       record_less);
+  TEST_CHECK(records_sorted(r, true));
+
+  r = make_records(n, 3000);
+  nanostl::stable_sort(nanostl::execution::par_unseq, r.begin(), r.end(),
+                       record_less);
+  TEST_CHECK(records_sorted(r, true));
+
+  nanostl::vector<unsigned> v = make_data(n);
+  nanostl::vector<unsigned> ref = v;
+  nanostl::stable_sort(ref.begin(), ref.end());
+  nanostl::stable_sort(nanostl::execution::par, v.begin(), v.end());
+  TEST_CHECK(equal(v, ref));
+}
+
+// "0 0.5 1 ..." with a newline every 8 values.
+static nanostl::vector<char> make_float_text(size_t n) {
+  nanostl::vector<char> text;
+  char buf[32];
+  for (size_t i = 0; i < n; i++) {
+    int k = snprintf(buf, sizeof(buf), "%g%c", double(i) * 0.5,
+                     (i % 8 == 7) ? '\n' : ' ');
+    for (int j = 0; j < k; j++) {
+      text.push_back(buf[j]);
+    }
+  }
+  return text;
+}
+
+static void test_parse_floats_threaded(void) {
+  const size_t n = 20000;
+  nanostl::vector<char> text = make_float_text(n);
+  const char *first = &text[0];
+  const char *last = first + text.size();
+
+  nanostl::parse_floats_options opts;
+  opts.num_threads = 4;
+  opts.min_chunk_size = 1024;
+
+  nanostl::vector<float> v;
+  v.push_back(-1.0f);  // appended after existing elements
+  nanostl::parse_floats_result r = nanostl::parse_floats(first, last, v, opts);
+  TEST_CHECK(r.ec == nanostl::errc());
+  TEST_CHECK(r.ptr == last);
+  TEST_CHECK(r.count == n);
+  TEST_CHECK(v.size() == n + 1);
+  bool ok = (v[0] == -1.0f);
+  for (size_t i = 0; i < n; i++) {
+    ok &= (v[i + 1] == float(i) * 0.5f);
+  }
+  TEST_CHECK(ok);
+
+  // Span output that runs full in a later chunk.
+  nanostl::vector<double> d;
+  d.resize(n - 100);
+  r = nanostl::parse_floats(first, last, &d[0], d.size(), opts);
+  TEST_CHECK(r.ec == nanostl::errc::value_too_large);
+  TEST_CHECK(r.count == n - 100);
+  TEST_CHECK(d[n - 101] == double(n - 101) * 0.5);
+
+  // A malformed token in the third chunk.
+  const size_t bad = text.size() * 5 / 8;
+  size_t pos = bad;
+  while (text[pos] != ' ') {
+    pos++;
+  }
+  text[pos + 1] = 'x';
+  size_t before = 0;
+  for (size_t i = 0; i <= pos; i++) {
+    before += (text[i] == ' ' || text[i] == '\n') ? 1 : 0;
+  }
+  v.clear();
+  r = nanostl::parse_floats(first, last, v, opts);
+  TEST_CHECK(r.ec == nanostl::errc::invalid_argument);
+  TEST_CHECK(r.ptr == first + pos + 1);
+  TEST_CHECK(r.count == before);
+  TEST_CHECK(v.size() == before);
+}
+
+TEST_LIST = {{"test-fill", test_fill},
+             {"test-nested", test_nested},
+             {"test-transform-copy", test_transform_copy},
+             {"test-count-find", test_count_find},
+             {"test-reduce", test_reduce},
+             {"test-scan", test_scan},
+             {"test-sort", test_sort},
+             {"test-stable-sort", test_stable_sort},
+             {"test-parse-floats-threaded", test_parse_floats_threaded},
+             {NULL, NULL}};